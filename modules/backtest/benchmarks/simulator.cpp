@@ -0,0 +1,105 @@
+#include <backtest/simulator.hpp>
+#include <benchmark/benchmark.h>
+#include <perf_counters.hpp>
+
+using namespace hft::backtest;
+using hft::common::PerfCounters;
+using hft::orderbook::MarketUpdate;
+using hft::orderbook::Side;
+
+namespace {
+
+/*Keeps one bid and one ask at the touch, requoting whenever the touch moves.*/
+class QuotingStrategy : public Strategy
+{
+public:
+	void on_market_data(Simulator &sim, const MarketUpdate &) override
+	{
+		hft::orderbook::PriceLevel bid;
+		hft::orderbook::PriceLevel ask;
+		if (sim.get_book().get_bid_levels({ &bid, 1 }) == 0 || sim.get_book().get_ask_levels({ &ask, 1 }) == 0)
+		{
+			return;
+		}
+
+		requote(sim, m_bid, Side::Bid, bid.price);
+		requote(sim, m_ask, Side::Ask, ask.price);
+	}
+
+	void on_report(Simulator &, const ExecutionReport &report) override
+	{
+		if (report.remaining != 0)
+		{
+			return;
+		}
+		for (auto *quote : { &m_bid, &m_ask })
+		{
+			if (quote->id == report.order_id)
+			{
+				*quote = {};
+			}
+		}
+	}
+
+private:
+	struct Quote
+	{
+		uint64_t id {};
+
+		uint64_t price {};
+	};
+
+	static void requote(Simulator &sim, Quote &quote, Side side, uint64_t price)
+	{
+		if (quote.id != 0 && quote.price == price)
+		{
+			return;
+		}
+		if (quote.id != 0)
+		{
+			sim.cancel_order(quote.id);
+		}
+		quote = { sim.send_order(side, price, 1), price };
+	}
+
+	Quote m_bid {};
+
+	Quote m_ask {};
+};
+
+} // namespace
+
+/*Quoting strategy over one million random updates, items are simulator events.*/
+static void BM_Simulator(benchmark::State &state)
+{
+	constexpr size_t UPDATES = 1'000'000;
+
+	std::vector<MarketUpdate> updates;
+	updates.reserve(UPDATES);
+	std::mt19937_64 rng(5);
+	for (uint64_t i = 0; i < UPDATES; ++i)
+	{
+		const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+		const auto price = side == Side::Bid ? 100'000 - rng() % 8 : 100'001 + rng() % 8;
+		updates.push_back({ i * 1000, i + 1, price, rng() % 4 == 0 ? 0 : 1 + rng() % 1000, side });
+	}
+
+	QuotingStrategy strategy;
+	Simulator sim(strategy, { 20'000, 15'000, 15'000 });
+
+	PerfCounters counters;
+	counters.start();
+
+	uint64_t events = 0;
+	for (auto _ : state)
+	{
+		sim.run(updates);
+		events += sim.get_event_count();
+	}
+
+	counters.stop();
+	counters.report(state, sim.get_event_count());
+	state.SetItemsProcessed(static_cast<int64_t>(events));
+}
+
+BENCHMARK(BM_Simulator)->Unit(benchmark::kMillisecond);
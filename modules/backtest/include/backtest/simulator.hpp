@@ -0,0 +1,221 @@
+#pragma once
+
+#include <l2/market_update.hpp>
+#include <l2/orderbook.hpp>
+#include <l2/queue_tracker.hpp>
+#include <l2/types.hpp>
+
+namespace hft::backtest {
+
+struct SimulatorConfig
+{
+	// Exchange to strategy, for market data.
+	uint64_t feed_latency_ns {};
+
+	// Strategy to exchange, for new orders and cancels.
+	uint64_t order_latency_ns {};
+
+	// Exchange to strategy, for execution reports.
+	uint64_t response_latency_ns {};
+
+	orderbook::QueueModel queue_model { orderbook::QueueModel::Fifo };
+};
+
+enum class ReportType : uint8_t
+{
+	Fill,
+	Cancelled,
+
+	// Out of pending event or resting order capacity, or cancel of an unknown order.
+	Rejected
+};
+
+struct ExecutionReport
+{
+	ReportType type {};
+
+	uint64_t order_id {};
+
+	orderbook::Side side {};
+
+	// Execution price for fills, the order's limit otherwise.
+	uint64_t price {};
+
+	// Filled quantity for fills, 0 otherwise.
+	uint64_t quantity {};
+
+	// Quantity still open after this report.
+	uint64_t remaining {};
+
+	// Fill of a resting order, as opposed to one taken on arrival.
+	bool passive {};
+
+	uint64_t exchange_time_ns {};
+};
+
+class Simulator;
+
+/*Callbacks of the simulated strategy, run at the time the strategy would see the event.*/
+class Strategy
+{
+public:
+	Strategy() = default;
+
+	Strategy(const Strategy &) = delete;
+
+	Strategy(Strategy &&) = delete;
+
+	auto operator=(const Strategy &) -> Strategy & = delete;
+
+	auto operator=(Strategy &&) -> Strategy & = delete;
+
+	virtual ~Strategy() = default;
+
+	/*update is already applied to sim.get_book().*/
+	virtual void on_market_data(Simulator &sim, const orderbook::MarketUpdate &update) = 0;
+
+	virtual void on_report(Simulator &sim, const ExecutionReport &report) = 0;
+};
+
+/*
+ * Discrete event backtest over one symbol's recorded L2 updates.
+ * The exchange book replays the updates at their timestamps, the strategy sees
+ * them feed_latency_ns later on its own book, and its orders and cancels reach
+ * the exchange order_latency_ns after being sent. Orders that cross take the
+ * recorded levels up to their limit, the rest rests behind the quantity
+ * already at the price and fills as later decreases eat through the queue
+ * ahead, or in full once the recorded book trades through its price. Our
+ * orders do not move the recorded book. Pending events sit in a fixed
+ * capacity heap ordered by (time, send order), nothing is allocated per event.
+ */
+class Simulator
+{
+public:
+	// Orders, cancels and reports in flight.
+	static constexpr size_t MAX_PENDING = 1024;
+
+	explicit Simulator(Strategy &strategy, const SimulatorConfig &config = {});
+
+	Simulator(const Simulator &) = delete;
+
+	Simulator(Simulator &&) = delete;
+
+	auto operator=(const Simulator &) -> Simulator & = delete;
+
+	auto operator=(Simulator &&) -> Simulator & = delete;
+
+	~Simulator() = default;
+
+	/*Runs every update and every event they cause, starting from empty books.*/
+	void run(std::span<const orderbook::MarketUpdate> updates);
+
+	/*
+	 * Sends a limit order from the strategy, returns its id, or 0 when too
+	 * many events are in flight.
+	 */
+	auto send_order(orderbook::Side side, uint64_t price, uint64_t qty) -> uint64_t;
+
+	/*Sends a cancel from the strategy, returns false when too many events are in flight.*/
+	auto cancel_order(uint64_t order_id) -> bool;
+
+	/*Strategy clock, the time of the callback being run.*/
+	[[nodiscard]] auto now() const noexcept -> uint64_t
+	{
+		return m_now;
+	}
+
+	/*Book as seen by the strategy.*/
+	[[nodiscard]] auto get_book() const -> const orderbook::OrderBook &
+	{
+		return *m_local_book;
+	}
+
+	/*Book as seen by the exchange.*/
+	[[nodiscard]] auto get_exchange_book() const -> const orderbook::OrderBook &
+	{
+		return *m_exchange_book;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_resting_order_count() const noexcept -> size_t
+	{
+		return m_tracker->get_order_count();
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_event_count() const noexcept -> uint64_t
+	{
+		return m_events;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_config() const noexcept -> const SimulatorConfig &
+	{
+		return m_config;
+	}
+
+private:
+	enum class EventType : uint8_t
+	{
+		NewOrder,
+		Cancel,
+		Report
+	};
+
+	struct Event
+	{
+		uint64_t time {};
+
+		// Send order, breaks ties between events due at the same time.
+		uint64_t seq {};
+
+		EventType type {};
+
+		// Order fields for NewOrder and Cancel, the report to deliver for Report.
+		ExecutionReport report {};
+	};
+
+	static auto later(const Event &lhs, const Event &rhs) -> bool
+	{
+		return lhs.time != rhs.time ? lhs.time > rhs.time : lhs.seq > rhs.seq;
+	}
+
+	auto push(uint64_t time, EventType type, const ExecutionReport &report) -> bool;
+
+	void on_exchange_update(const orderbook::MarketUpdate &update);
+
+	void on_new_order(const ExecutionReport &order);
+
+	void on_cancel(uint64_t order_id);
+
+	/*Fills the side's resting orders the recorded book traded through.*/
+	void fill_crossed(orderbook::Side side);
+
+	void report(const ExecutionReport &report);
+
+	Strategy &m_strategy;
+
+	SimulatorConfig m_config;
+
+	std::unique_ptr<orderbook::OrderBook> m_local_book;
+
+	std::unique_ptr<orderbook::OrderBook> m_exchange_book;
+
+	std::unique_ptr<orderbook::QueueTracker> m_tracker;
+
+	std::array<Event, MAX_PENDING> m_pending {};
+
+	size_t m_pending_count {};
+
+	uint64_t m_seq {};
+
+	uint64_t m_next_order_id { 1 };
+
+	uint64_t m_now {};
+
+	uint64_t m_exchange_now {};
+
+	uint64_t m_events {};
+};
+
+} // namespace hft::backtest
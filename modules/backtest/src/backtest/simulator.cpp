@@ -0,0 +1,261 @@
+#include <backtest/simulator.hpp>
+
+using namespace hft::orderbook;
+
+namespace hft::backtest {
+
+namespace {
+
+constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+} // namespace
+
+Simulator::Simulator(Strategy &strategy, const SimulatorConfig &config)
+	: m_strategy(strategy)
+	, m_config(config)
+	, m_local_book(std::make_unique<OrderBook>())
+	, m_exchange_book(std::make_unique<OrderBook>())
+	, m_tracker(std::make_unique<QueueTracker>(*m_exchange_book, config.queue_model))
+{
+}
+
+void Simulator::run(std::span<const MarketUpdate> updates)
+{
+	m_local_book = std::make_unique<OrderBook>();
+	m_exchange_book = std::make_unique<OrderBook>();
+	m_tracker = std::make_unique<QueueTracker>(*m_exchange_book, m_config.queue_model);
+	m_pending_count = 0;
+	m_now = 0;
+	m_exchange_now = 0;
+	m_events = 0;
+
+	size_t exchange_cursor = 0;
+	size_t feed_cursor = 0;
+	while (true)
+	{
+		const auto exchange_time = exchange_cursor < updates.size() ? updates[exchange_cursor].timestamp_ns : NEVER;
+		const auto feed_time =
+			feed_cursor < updates.size() ? updates[feed_cursor].timestamp_ns + m_config.feed_latency_ns : NEVER;
+		const auto pending_time = m_pending_count != 0 ? m_pending[0].time : NEVER;
+
+		// At equal times the exchange moves first, then whatever was sent first.
+		if (exchange_time != NEVER && exchange_time <= pending_time && exchange_time <= feed_time)
+		{
+			on_exchange_update(updates[exchange_cursor++]);
+		}
+		else if (pending_time != NEVER && pending_time <= feed_time)
+		{
+			std::pop_heap(m_pending.begin(), m_pending.begin() + static_cast<ptrdiff_t>(m_pending_count), later);
+			const auto event = m_pending[--m_pending_count];
+
+			if (event.type == EventType::Report)
+			{
+				m_now = event.time;
+				m_strategy.on_report(*this, event.report);
+			}
+			else
+			{
+				m_exchange_now = event.time;
+				if (event.type == EventType::NewOrder)
+				{
+					on_new_order(event.report);
+				}
+				else
+				{
+					on_cancel(event.report.order_id);
+				}
+			}
+		}
+		else if (feed_time != NEVER)
+		{
+			const auto &update = updates[feed_cursor++];
+			m_now = feed_time;
+			apply_market_update(*m_local_book, update);
+			m_strategy.on_market_data(*this, update);
+		}
+		else
+		{
+			break;
+		}
+		++m_events;
+	}
+}
+
+auto Simulator::send_order(Side side, uint64_t price, uint64_t qty) -> uint64_t
+{
+	const auto id = m_next_order_id;
+	if (!push(m_now + m_config.order_latency_ns, EventType::NewOrder, { ReportType {}, id, side, price, 0, qty, {}, {} }))
+	{
+		return 0;
+	}
+	++m_next_order_id;
+	return id;
+}
+
+auto Simulator::cancel_order(uint64_t order_id) -> bool
+{
+	return push(m_now + m_config.order_latency_ns, EventType::Cancel, { ReportType {}, order_id, {}, {}, {}, {}, {}, {} });
+}
+
+auto Simulator::push(uint64_t time, EventType type, const ExecutionReport &report) -> bool
+{
+	if (m_pending_count == MAX_PENDING) [[unlikely]]
+	{
+		return false;
+	}
+
+	m_pending[m_pending_count++] = { time, m_seq++, type, report };
+	std::push_heap(m_pending.begin(), m_pending.begin() + static_cast<ptrdiff_t>(m_pending_count), later);
+	return true;
+}
+
+void Simulator::report(const ExecutionReport &report)
+{
+	if (!push(m_exchange_now + m_config.response_latency_ns, EventType::Report, report)) [[unlikely]]
+	{
+		// Reports are never dropped, a full heap delivers them without the latency.
+		m_now = std::max(m_now, m_exchange_now);
+		m_strategy.on_report(*this, report);
+	}
+}
+
+void Simulator::on_exchange_update(const MarketUpdate &update)
+{
+	m_exchange_now = update.timestamp_ns;
+
+	// Queue positions as they were before the update, front first.
+	std::array<std::pair<OwnOrder *, uint64_t>, QueueTracker::MAX_ORDERS> queued;
+	size_t count = 0;
+	m_tracker->for_each_order(
+		update.side, update.price, [&](OwnOrder &order) { queued[count++] = { &order, order.queue_ahead }; }
+	);
+	const auto old_quantity = m_tracker->get_level_quantity(update.side, update.price);
+
+	if (update.side == Side::Bid)
+	{
+		m_tracker->update_bid_side(update.price, update.quantity);
+	}
+	else
+	{
+		m_tracker->update_ask_side(update.price, update.quantity);
+	}
+	if (update.sequence != 0)
+	{
+		m_exchange_book->set_sequence(update.sequence);
+	}
+
+	// A decrease larger than the queue ahead, ours included, must have traded with us.
+	if (count != 0 && update.quantity < old_quantity)
+	{
+		const auto decrease = old_quantity - update.quantity;
+		uint64_t own_ahead = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto *order = queued[i].first;
+			const auto ahead = queued[i].second + own_ahead;
+			if (decrease <= ahead)
+			{
+				break;
+			}
+
+			const auto open = order->quantity;
+			const auto fill = std::min(open, decrease - ahead);
+			own_ahead += open;
+			report({ ReportType::Fill, order->id, order->side, order->price, fill, open - fill, true, m_exchange_now });
+			m_tracker->fill_order(order, fill);
+		}
+	}
+
+	fill_crossed(update.side == Side::Bid ? Side::Ask : Side::Bid);
+}
+
+void Simulator::fill_crossed(Side side)
+{
+	if (m_tracker->get_order_count() == 0)
+	{
+		return;
+	}
+
+	PriceLevel best;
+	const auto found = side == Side::Bid ? m_exchange_book->get_ask_levels({ &best, 1 })
+										 : m_exchange_book->get_bid_levels({ &best, 1 });
+	if (found == 0)
+	{
+		return;
+	}
+
+	m_tracker->for_each_order(
+		side,
+		[&](OwnOrder &order)
+		{
+			const auto crossed = side == Side::Bid ? order.price > best.price : order.price < best.price;
+			if (crossed)
+			{
+				report({ ReportType::Fill, order.id, side, order.price, order.quantity, 0, true, m_exchange_now });
+				m_tracker->remove_order(&order);
+			}
+		}
+	);
+}
+
+void Simulator::on_new_order(const ExecutionReport &order)
+{
+	const auto side = order.side;
+	auto remaining = order.remaining;
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> levels;
+	const auto count = side == Side::Bid ? m_exchange_book->get_ask_levels(levels) : m_exchange_book->get_bid_levels(levels);
+	for (size_t i = 0; i < count && remaining != 0; ++i)
+	{
+		const auto &level = levels[i];
+		const auto crosses = side == Side::Bid ? level.price <= order.price : level.price >= order.price;
+		if (!crosses)
+		{
+			break;
+		}
+
+		const auto fill = std::min(remaining, level.quantity);
+		remaining -= fill;
+		report({ ReportType::Fill, order.order_id, side, level.price, fill, remaining, false, m_exchange_now });
+	}
+
+	if (remaining == 0)
+	{
+		return;
+	}
+
+	if (!m_tracker->add_order(order.order_id, side, order.price, remaining))
+	{
+		report({ ReportType::Rejected, order.order_id, side, order.price, 0, 0, false, m_exchange_now });
+	}
+}
+
+void Simulator::on_cancel(uint64_t order_id)
+{
+	OwnOrder *found = nullptr;
+	for (const auto side : { Side::Bid, Side::Ask })
+	{
+		m_tracker->for_each_order(
+			side,
+			[&](OwnOrder &order)
+			{
+				if (order.id == order_id)
+				{
+					found = &order;
+				}
+			}
+		);
+	}
+
+	// Already filled or never rested, the strategy learns from the earlier reports.
+	if (!found)
+	{
+		report({ ReportType::Rejected, order_id, {}, 0, 0, 0, false, m_exchange_now });
+		return;
+	}
+
+	report({ ReportType::Cancelled, order_id, found->side, found->price, 0, 0, false, m_exchange_now });
+	m_tracker->remove_order(found);
+}
+
+} // namespace hft::backtest
@@ -0,0 +1,277 @@
+#include <backtest/simulator.hpp>
+#include <gtest/gtest.h>
+
+using namespace hft::backtest;
+using hft::orderbook::MarketUpdate;
+using hft::orderbook::Side;
+
+namespace {
+
+/*Sends the scripted orders on the first market data at or after their time and records everything.*/
+class ScriptedStrategy : public Strategy
+{
+public:
+	struct Action
+	{
+		uint64_t time {};
+
+		Side side {};
+
+		uint64_t price {};
+
+		uint64_t quantity {};
+
+		// Cancels the order sent by this action index instead, when set.
+		std::optional<size_t> cancel_of {};
+	};
+
+	explicit ScriptedStrategy(std::vector<Action> actions)
+		: m_actions(std::move(actions))
+	{
+	}
+
+	void on_market_data(Simulator &sim, const MarketUpdate &) override
+	{
+		market_data_times.push_back(sim.now());
+		while (m_next < m_actions.size() && m_actions[m_next].time <= sim.now())
+		{
+			const auto &action = m_actions[m_next++];
+			if (action.cancel_of)
+			{
+				sim.cancel_order(ids[*action.cancel_of]);
+				ids.push_back(0);
+			}
+			else
+			{
+				ids.push_back(sim.send_order(action.side, action.price, action.quantity));
+			}
+		}
+	}
+
+	void on_report(Simulator &sim, const ExecutionReport &report) override
+	{
+		reports.push_back(report);
+		report_times.push_back(sim.now());
+	}
+
+	[[nodiscard]] auto filled(uint64_t id) const -> uint64_t
+	{
+		uint64_t total = 0;
+		for (const auto &report : reports)
+		{
+			total += report.type == ReportType::Fill && report.order_id == id ? report.quantity : 0;
+		}
+		return total;
+	}
+
+	std::vector<uint64_t> ids;
+
+	std::vector<ExecutionReport> reports;
+
+	std::vector<uint64_t> report_times;
+
+	std::vector<uint64_t> market_data_times;
+
+private:
+	std::vector<Action> m_actions;
+
+	size_t m_next {};
+};
+
+// Two sided book at 100 / 101 with 50 on each touch, one update per microsecond.
+auto opening_book() -> std::vector<MarketUpdate>
+{
+	return {
+		{ 1000, 1, 100, 50, Side::Bid },
+		{ 2000, 2, 99, 80, Side::Bid },
+		{ 3000, 3, 101, 50, Side::Ask },
+		{ 4000, 4, 102, 70, Side::Ask },
+	};
+}
+
+} // namespace
+
+TEST(SimulatorTest, Latencies_DelayMarketDataOrdersAndReports)
+{
+	auto updates = opening_book();
+	updates.push_back({ 100'000, 5, 100, 60, Side::Bid });
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 101, 10 } });
+	Simulator sim(strategy, { 500, 2000, 300 });
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.market_data_times.size(), updates.size());
+	for (size_t i = 0; i < updates.size(); ++i)
+	{
+		EXPECT_EQ(strategy.market_data_times[i], updates[i].timestamp_ns + 500);
+	}
+
+	// Sent on the 4500 market data, arrives at 6500 and takes 10 at 101.
+	ASSERT_EQ(strategy.reports.size(), 1);
+	EXPECT_EQ(strategy.reports[0].type, ReportType::Fill);
+	EXPECT_EQ(strategy.reports[0].exchange_time_ns, 6500);
+	EXPECT_EQ(strategy.reports[0].price, 101);
+	EXPECT_EQ(strategy.reports[0].quantity, 10);
+	EXPECT_FALSE(strategy.reports[0].passive);
+	EXPECT_EQ(strategy.report_times[0], 6800);
+	EXPECT_EQ(sim.get_event_count(), updates.size() * 2 + 2);
+}
+
+TEST(SimulatorTest, Order_SeesBookAtArrivalNotAtSend)
+{
+	auto updates = opening_book();
+	// The ask is pulled while our order is on the way.
+	updates.push_back({ 5000, 5, 101, 0, Side::Ask });
+	updates.push_back({ 100'000, 6, 99, 10, Side::Bid });
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 101, 10 } });
+	Simulator sim(strategy, { 0, 2000, 0 });
+	sim.run(updates);
+
+	// Nothing left at 101 at 6000, the order rests and the book never trades through it.
+	EXPECT_TRUE(strategy.reports.empty());
+	EXPECT_EQ(sim.get_resting_order_count(), 1);
+}
+
+TEST(SimulatorTest, AggressiveOrder_WalksLevelsUpToLimit)
+{
+	auto updates = opening_book();
+	updates.push_back({ 100'000, 5, 99, 10, Side::Bid });
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 102, 200 } });
+	Simulator sim(strategy);
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.reports.size(), 2);
+	EXPECT_EQ(strategy.reports[0].price, 101);
+	EXPECT_EQ(strategy.reports[0].quantity, 50);
+	EXPECT_EQ(strategy.reports[0].remaining, 150);
+	EXPECT_EQ(strategy.reports[1].price, 102);
+	EXPECT_EQ(strategy.reports[1].quantity, 70);
+	EXPECT_EQ(strategy.reports[1].remaining, 80);
+
+	// The rest is left at 102.
+	EXPECT_EQ(sim.get_resting_order_count(), 1);
+}
+
+TEST(SimulatorTest, PassiveOrder_FillsOnceQueueAheadTrades)
+{
+	auto updates = opening_book();
+	updates.push_back({ 10'000, 5, 100, 80, Side::Bid }); // 30 joins behind us
+	updates.push_back({ 11'000, 6, 100, 40, Side::Bid }); // 40 off the 50 ahead
+	updates.push_back({ 12'000, 7, 100, 25, Side::Bid }); // the last 10 ahead and 5 of ours
+	updates.push_back({ 13'000, 8, 100, 20, Side::Bid }); // 5 more of ours
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 100, 20 } });
+	Simulator sim(strategy);
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.reports.size(), 2);
+	const auto id = strategy.ids[0];
+	EXPECT_EQ(strategy.reports[0].order_id, id);
+	EXPECT_TRUE(strategy.reports[0].passive);
+	EXPECT_EQ(strategy.reports[0].price, 100);
+	EXPECT_EQ(strategy.reports[0].quantity, 5);
+	EXPECT_EQ(strategy.reports[0].remaining, 15);
+	EXPECT_EQ(strategy.reports[0].exchange_time_ns, 12'000);
+	EXPECT_EQ(strategy.reports[1].quantity, 5);
+	EXPECT_EQ(strategy.reports[1].remaining, 10);
+	EXPECT_EQ(strategy.filled(id), 10);
+	EXPECT_EQ(sim.get_resting_order_count(), 1);
+}
+
+TEST(SimulatorTest, OwnOrders_QueueBehindEachOther)
+{
+	auto updates = opening_book();
+	updates.push_back({ 10'000, 5, 100, 90, Side::Bid }); // 40 joins behind us
+	updates.push_back({ 11'000, 6, 100, 10, Side::Bid }); // 50 ahead, then 10 and 20 of ours
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 100, 10 }, { 4000, Side::Bid, 100, 30 } });
+	Simulator sim(strategy);
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.reports.size(), 2);
+	EXPECT_EQ(strategy.reports[0].order_id, strategy.ids[0]);
+	EXPECT_EQ(strategy.reports[0].quantity, 10);
+	EXPECT_EQ(strategy.reports[0].remaining, 0);
+	EXPECT_EQ(strategy.reports[1].order_id, strategy.ids[1]);
+	EXPECT_EQ(strategy.reports[1].quantity, 20);
+	EXPECT_EQ(strategy.reports[1].remaining, 10);
+	EXPECT_EQ(sim.get_resting_order_count(), 1);
+}
+
+TEST(SimulatorTest, ProRata_KeepsPartOfQueueAhead)
+{
+	auto updates = opening_book();
+	updates.push_back({ 10'000, 5, 100, 100, Side::Bid });
+	updates.push_back({ 11'000, 6, 100, 50, Side::Bid });
+	updates.push_back({ 12'000, 7, 100, 30, Side::Bid });
+
+	// Fifo takes the 50 off the queue ahead, the next 20 are ours.
+	ScriptedStrategy fifo({ { 4000, Side::Bid, 100, 20 } });
+	Simulator fifo_sim(fifo, { 0, 0, 0, hft::orderbook::QueueModel::Fifo });
+	fifo_sim.run(updates);
+	EXPECT_EQ(fifo.filled(fifo.ids[0]), 20);
+
+	// Pro rata halves it to 25, the 20 after that are still ahead of us.
+	ScriptedStrategy pro_rata({ { 4000, Side::Bid, 100, 20 } });
+	Simulator pro_rata_sim(pro_rata, { 0, 0, 0, hft::orderbook::QueueModel::ProRata });
+	pro_rata_sim.run(updates);
+	EXPECT_EQ(pro_rata.filled(pro_rata.ids[0]), 0);
+}
+
+TEST(SimulatorTest, BookTradingThrough_FillsRestingOrder)
+{
+	auto updates = opening_book();
+	updates.push_back({ 10'000, 5, 99, 40, Side::Ask }); // asks now from 99
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 100, 20 } });
+	Simulator sim(strategy);
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.reports.size(), 1);
+	EXPECT_EQ(strategy.reports[0].type, ReportType::Fill);
+	EXPECT_EQ(strategy.reports[0].price, 100);
+	EXPECT_EQ(strategy.reports[0].quantity, 20);
+	EXPECT_EQ(strategy.reports[0].remaining, 0);
+	EXPECT_EQ(strategy.reports[0].exchange_time_ns, 10'000);
+	EXPECT_EQ(sim.get_resting_order_count(), 0);
+}
+
+TEST(SimulatorTest, Cancel_RemovesRestingOrder)
+{
+	auto updates = opening_book();
+	updates.push_back({ 10'000, 5, 100, 60, Side::Bid });
+
+	ScriptedStrategy strategy({ { 4000, Side::Bid, 100, 20 }, { 10'000, {}, 0, 0, 0 } });
+	Simulator sim(strategy, { 0, 100, 0 });
+	sim.run(updates);
+
+	ASSERT_EQ(strategy.reports.size(), 1);
+	EXPECT_EQ(strategy.reports[0].type, ReportType::Cancelled);
+	EXPECT_EQ(strategy.reports[0].order_id, strategy.ids[0]);
+	EXPECT_EQ(strategy.reports[0].exchange_time_ns, 10'100);
+	EXPECT_EQ(sim.get_resting_order_count(), 0);
+
+	// A cancel that arrives after the fill is rejected.
+	ScriptedStrategy late({ { 4000, Side::Bid, 101, 10 }, { 10'000, {}, 0, 0, 0 } });
+	Simulator again(late, { 0, 100, 0 });
+	again.run(updates);
+	ASSERT_EQ(late.reports.size(), 2);
+	EXPECT_EQ(late.reports[0].type, ReportType::Fill);
+	EXPECT_EQ(late.reports[1].type, ReportType::Rejected);
+}
+
+TEST(SimulatorTest, Run_StartsFromEmptyBooks)
+{
+	const auto updates = opening_book();
+	ScriptedStrategy strategy({});
+	Simulator sim(strategy);
+
+	sim.run(updates);
+	sim.run(updates);
+
+	EXPECT_EQ(sim.get_book().get_bid_count(), 2);
+	EXPECT_EQ(sim.get_exchange_book().get_ask_count(), 2);
+	EXPECT_EQ(sim.get_exchange_book().get_sequence(), 4);
+}
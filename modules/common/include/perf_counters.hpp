@@ -0,0 +1,190 @@
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef BENCHMARKING
+	#include <benchmark/benchmark.h>
+#endif
+
+namespace hft::common {
+
+/*
+ * Hardware counters of the calling thread through perf_event_open.
+ * Every event is opened on its own so the kernel can multiplex them when the
+ * PMU has fewer counters than events, readings are scaled by the enabled and
+ * running times. Events the machine or the sandbox refuses (no PMU in a VM,
+ * perf_event_paranoid) are left out rather than failing the benchmark.
+ */
+class PerfCounters
+{
+public:
+	enum Event : uint8_t
+	{
+		Cycles,
+		Instructions,
+		L1DMisses,
+		LLCMisses,
+		BranchMisses,
+		DTLBMisses,
+		EVENT_COUNT
+	};
+
+	static constexpr std::array<std::string_view, EVENT_COUNT> NAMES {
+		"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+	};
+
+	PerfCounters()
+	{
+		constexpr auto cache_miss = [](uint64_t cache)
+		{
+			return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		};
+
+		open(Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		open(Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		open(L1DMisses, PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+		open(LLCMisses, PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+		open(BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+		open(DTLBMisses, PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+	}
+
+	PerfCounters(const PerfCounters &) = delete;
+
+	PerfCounters(PerfCounters &&) = delete;
+
+	auto operator=(const PerfCounters &) -> PerfCounters & = delete;
+
+	auto operator=(PerfCounters &&) -> PerfCounters & = delete;
+
+	~PerfCounters()
+	{
+		for (const auto fd : m_fds)
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+		}
+	}
+
+	/*Zeroes and starts every available counter.*/
+	void start()
+	{
+		for (const auto fd : m_fds)
+		{
+			if (fd >= 0)
+			{
+				::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+	}
+
+	/*Stops counting, e.g. around per-iteration setup, start() is not needed to go on.*/
+	void pause()
+	{
+		for (const auto fd : m_fds)
+		{
+			if (fd >= 0)
+			{
+				::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+	}
+
+	void resume()
+	{
+		for (const auto fd : m_fds)
+		{
+			if (fd >= 0)
+			{
+				::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+	}
+
+	/*Stops counting and latches the scaled values.*/
+	void stop()
+	{
+		pause();
+
+		for (size_t i = 0; i < EVENT_COUNT; ++i)
+		{
+			if (m_fds[i] < 0)
+			{
+				continue;
+			}
+
+			// value, time_enabled, time_running
+			std::array<uint64_t, 3> reading {};
+			if (::read(m_fds[i], reading.data(), sizeof(reading)) != sizeof(reading) || reading[2] == 0)
+			{
+				m_values[i] = 0;
+				continue;
+			}
+			const auto scale = static_cast<double>(reading[1]) / static_cast<double>(reading[2]);
+			m_values[i] = static_cast<uint64_t>(static_cast<double>(reading[0]) * scale);
+		}
+	}
+
+	[[nodiscard]] auto is_available(Event event) const -> bool
+	{
+		return m_fds[event] >= 0;
+	}
+
+	[[nodiscard]] auto any_available() const -> bool
+	{
+		return std::ranges::any_of(m_fds, [](int fd) { return fd >= 0; });
+	}
+
+	/*Value latched by the last stop().*/
+	[[nodiscard]] auto get(Event event) const -> uint64_t
+	{
+		return m_values[event];
+	}
+
+#ifdef BENCHMARKING
+	/*Publishes the latched values as per-operation benchmark counters.*/
+	void report(benchmark::State &state, size_t ops_per_iteration = 1) const
+	{
+		for (size_t i = 0; i < EVENT_COUNT; ++i)
+		{
+			if (m_fds[i] >= 0)
+			{
+				const auto per_iteration = static_cast<double>(m_values[i]) / static_cast<double>(ops_per_iteration);
+				state.counters[std::string(NAMES[i])] =
+					benchmark::Counter(per_iteration, benchmark::Counter::kAvgIterations);
+			}
+		}
+		if (m_fds[Cycles] >= 0 && m_fds[Instructions] >= 0 && m_values[Cycles] != 0)
+		{
+			state.counters["ipc"] =
+				static_cast<double>(m_values[Instructions]) / static_cast<double>(m_values[Cycles]);
+		}
+	}
+#endif
+
+private:
+	void open(Event event, uint32_t type, uint64_t config)
+	{
+		perf_event_attr attr {};
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		m_fds[event] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	std::array<int, EVENT_COUNT> m_fds {};
+
+	std::array<uint64_t, EVENT_COUNT> m_values {};
+};
+
+} // namespace hft::common
@@ -0,0 +1,222 @@
+#pragma once
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+	#include <immintrin.h>
+	#define HFT_CRC32_PCLMUL 1
+#endif
+
+#if defined(__SSE4_2__)
+	#include <nmmintrin.h>
+	#define HFT_CRC32C_SSE42 1
+#endif
+
+namespace hft::core {
+
+namespace detail {
+
+// Bit-reflected polynomials.
+inline constexpr uint32_t CRC32_POLY = 0xEDB88320U;
+
+inline constexpr uint32_t CRC32C_POLY = 0x82F63B78U;
+
+/*Slicing-by-8 lookup tables for a reflected polynomial.*/
+consteval auto make_crc_tables(uint32_t poly) -> std::array<std::array<uint32_t, 256>, 8>
+{
+	std::array<std::array<uint32_t, 256>, 8> tables {};
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc & 1U) ? (crc >> 1) ^ poly : crc >> 1;
+		}
+		tables[0][i] = crc;
+	}
+	for (size_t i = 0; i < 256; ++i)
+	{
+		for (size_t t = 1; t < 8; ++t)
+		{
+			const auto prev = tables[t - 1][i];
+			tables[t][i] = (prev >> 8) ^ tables[0][prev & 0xFFU];
+		}
+	}
+	return tables;
+}
+
+inline constexpr auto CRC32_TABLES = make_crc_tables(CRC32_POLY);
+
+inline constexpr auto CRC32C_TABLES = make_crc_tables(CRC32C_POLY);
+
+/*Table driven update on the inverted crc state.*/
+inline auto crc_table_update(
+	const std::array<std::array<uint32_t, 256>, 8> &tables,
+	uint32_t crc,
+	const uint8_t *data,
+	size_t len
+) noexcept -> uint32_t
+{
+	while (len >= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		word ^= crc;
+		crc = tables[7][word & 0xFFU] ^ tables[6][(word >> 8) & 0xFFU]
+			^ tables[5][(word >> 16) & 0xFFU] ^ tables[4][(word >> 24) & 0xFFU]
+			^ tables[3][(word >> 32) & 0xFFU] ^ tables[2][(word >> 40) & 0xFFU]
+			^ tables[1][(word >> 48) & 0xFFU] ^ tables[0][word >> 56];
+		data += 8;
+		len -= 8;
+	}
+	while (len-- > 0)
+	{
+		crc = (crc >> 8) ^ tables[0][(crc ^ *data++) & 0xFFU];
+	}
+	return crc;
+}
+
+#ifdef HFT_CRC32_PCLMUL
+
+/*
+ * Carry-less multiplication folding of the IEEE polynomial (Intel, "Fast CRC
+ * Computation for Generic Polynomials Using PCLMULQDQ"). Works on the inverted
+ * crc state, len must be >= 64 and a multiple of 16.
+ */
+inline auto crc32_pclmul_update(uint32_t crc, const uint8_t *buf, size_t len) noexcept -> uint32_t
+{
+	alignas(16) static constexpr uint64_t k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+	alignas(16) static constexpr uint64_t k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+	alignas(16) static constexpr uint64_t k5k0[] = { 0x0163cd6124, 0x0000000000 };
+	alignas(16) static constexpr uint64_t poly[] = { 0x01db710641, 0x01f7011641 };
+
+	const auto load = [](const uint8_t *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)); };
+
+	auto x1 = load(buf + 0x00);
+	auto x2 = load(buf + 0x10);
+	auto x3 = load(buf + 0x20);
+	auto x4 = load(buf + 0x30);
+
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+	auto x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+
+	buf += 64;
+	len -= 64;
+
+	// Fold 4x128 bits in parallel.
+	while (len >= 64)
+	{
+		const auto x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		const auto x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		const auto x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		const auto x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), load(buf + 0x00));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), load(buf + 0x10));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), load(buf + 0x20));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), load(buf + 0x30));
+
+		buf += 64;
+		len -= 64;
+	}
+
+	// Fold into 128 bits.
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+
+	const auto fold = [&x0](__m128i acc, __m128i next)
+	{
+		const auto lo = _mm_clmulepi64_si128(acc, x0, 0x00);
+		const auto hi = _mm_clmulepi64_si128(acc, x0, 0x11);
+		return _mm_xor_si128(_mm_xor_si128(hi, next), lo);
+	};
+
+	x1 = fold(x1, x2);
+	x1 = fold(x1, x3);
+	x1 = fold(x1, x4);
+
+	while (len >= 16)
+	{
+		x1 = fold(x1, load(buf));
+		buf += 16;
+		len -= 16;
+	}
+
+	// Fold 128 bits to 64 bits.
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32 bits.
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#endif
+
+} // namespace detail
+
+/*IEEE 802.3 CRC32 as published by exchanges (zlib crc32()), continues from crc.*/
+inline auto crc32(const void *data, size_t len, uint32_t crc = 0) noexcept -> uint32_t
+{
+	const auto *bytes = static_cast<const uint8_t *>(data);
+	crc = ~crc;
+
+#ifdef HFT_CRC32_PCLMUL
+	if (len >= 64)
+	{
+		const auto chunk = len & ~size_t { 15 };
+		crc = detail::crc32_pclmul_update(crc, bytes, chunk);
+		bytes += chunk;
+		len -= chunk;
+	}
+#endif
+
+	return ~detail::crc_table_update(detail::CRC32_TABLES, crc, bytes, len);
+}
+
+/*Castagnoli CRC32C, uses the SSE4.2 crc32 instruction when available. Meant for our own formats.*/
+inline auto crc32c(const void *data, size_t len, uint32_t crc = 0) noexcept -> uint32_t
+{
+	const auto *bytes = static_cast<const uint8_t *>(data);
+
+#ifdef HFT_CRC32C_SSE42
+	uint64_t state = ~crc;
+	while (len >= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes, sizeof(word));
+		state = _mm_crc32_u64(state, word);
+		bytes += 8;
+		len -= 8;
+	}
+	auto state32 = static_cast<uint32_t>(state);
+	while (len-- > 0)
+	{
+		state32 = _mm_crc32_u8(state32, *bytes++);
+	}
+	return ~state32;
+#else
+	return ~detail::crc_table_update(detail::CRC32C_TABLES, ~crc, bytes, len);
+#endif
+}
+
+} // namespace hft::core
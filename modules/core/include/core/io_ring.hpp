@@ -0,0 +1,207 @@
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace hft::core {
+
+/*
+ * Minimal io_uring instance over the raw syscalls, enough to queue fixed
+ * buffer writes and reap their completions from one thread. The kernel
+ * owns the other end of both rings, so indices are exchanged with acquire
+ * and release through std::atomic_ref on the shared mapping.
+ */
+class IoRing
+{
+public:
+	/*Throws std::runtime_error when the kernel refuses io_uring (too old, seccomp, sysctl).*/
+	explicit IoRing(unsigned entries)
+	{
+		io_uring_params params {};
+		m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		if (m_fd < 0)
+		{
+			throw std::runtime_error(std::string("Cannot set up io_uring: ") + std::strerror(errno));
+		}
+
+		m_sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+		}
+		m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+		m_sq = map(m_sq_size, IORING_OFF_SQ_RING);
+		m_cq = (params.features & IORING_FEAT_SINGLE_MMAP) ? m_sq : map(m_cq_size, IORING_OFF_CQ_RING);
+		m_sqes = static_cast<io_uring_sqe *>(map(m_sqes_size, IORING_OFF_SQES));
+		if (m_sq == MAP_FAILED || m_cq == MAP_FAILED || m_sqes == MAP_FAILED)
+		{
+			const auto error = errno;
+			unmap();
+			::close(m_fd);
+			throw std::runtime_error(std::string("Cannot map io_uring: ") + std::strerror(error));
+		}
+
+		auto *sq = static_cast<std::byte *>(m_sq);
+		m_sq_head = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+		m_sq_tail = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+		m_sq_mask = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+		m_sq_entries = params.sq_entries;
+
+		// Slot i of the index array always names sqe i, sqes are used in ring order.
+		auto *array = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+		for (uint32_t i = 0; i < params.sq_entries; ++i)
+		{
+			array[i] = i;
+		}
+
+		auto *cq = static_cast<std::byte *>(m_cq);
+		m_cq_head = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+		m_cq_tail = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+		m_cq_mask = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+		m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+		m_tail = *m_sq_tail;
+		m_submitted = m_tail;
+	}
+
+	IoRing(const IoRing &) = delete;
+
+	IoRing(IoRing &&) = delete;
+
+	auto operator=(const IoRing &) -> IoRing & = delete;
+
+	auto operator=(IoRing &&) -> IoRing & = delete;
+
+	~IoRing()
+	{
+		unmap();
+		::close(m_fd);
+	}
+
+	/*Pins buffers for IORING_OP_WRITE_FIXED, buf_index is the position in buffers. Returns false on failure.*/
+	auto register_buffers(std::span<const iovec> buffers) noexcept -> bool
+	{
+		return ::syscall(
+				   __NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers.data(),
+				   static_cast<unsigned>(buffers.size())
+			   ) == 0;
+	}
+
+	/*Zeroed sqe to fill, queued by the next submit(). nullptr when the ring is full.*/
+	[[nodiscard]] auto get_sqe() noexcept -> io_uring_sqe *
+	{
+		const auto head = std::atomic_ref(*m_sq_head).load(std::memory_order_acquire);
+		if (m_tail - head >= m_sq_entries)
+		{
+			return nullptr;
+		}
+		auto *sqe = &m_sqes[m_tail & m_sq_mask];
+		std::memset(sqe, 0, sizeof(*sqe));
+		++m_tail;
+		return sqe;
+	}
+
+	/*Submits every queued sqe and waits for wait_for completions. Returns the sqes consumed or -errno.*/
+	auto submit(unsigned wait_for = 0) noexcept -> int
+	{
+		std::atomic_ref(*m_sq_tail).store(m_tail, std::memory_order_release);
+		const auto pending = m_tail - m_submitted;
+		while (true)
+		{
+			const auto result = ::syscall(
+				__NR_io_uring_enter, m_fd, pending, wait_for, wait_for != 0 ? IORING_ENTER_GETEVENTS : 0U, nullptr,
+				0
+			);
+			if (result >= 0)
+			{
+				m_submitted += static_cast<uint32_t>(result);
+				return static_cast<int>(result);
+			}
+			if (errno != EINTR)
+			{
+				return -errno;
+			}
+		}
+	}
+
+	/*Oldest completion not yet marked seen, nullptr when there is none.*/
+	[[nodiscard]] auto peek() noexcept -> const io_uring_cqe *
+	{
+		const auto head = *m_cq_head;
+		if (head == std::atomic_ref(*m_cq_tail).load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &m_cqes[head & m_cq_mask];
+	}
+
+	/*Releases the completion returned by peek() back to the kernel.*/
+	void seen() noexcept
+	{
+		std::atomic_ref(*m_cq_head).store(*m_cq_head + 1, std::memory_order_release);
+	}
+
+private:
+	[[nodiscard]] auto map(size_t size, off_t offset) const noexcept -> void *
+	{
+		return ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+	}
+
+	void unmap() noexcept
+	{
+		if (m_sqes && m_sqes != MAP_FAILED)
+		{
+			::munmap(m_sqes, m_sqes_size);
+		}
+		if (m_cq && m_cq != MAP_FAILED && m_cq != m_sq)
+		{
+			::munmap(m_cq, m_cq_size);
+		}
+		if (m_sq && m_sq != MAP_FAILED)
+		{
+			::munmap(m_sq, m_sq_size);
+		}
+	}
+
+	int m_fd = -1;
+
+	void *m_sq {};
+
+	void *m_cq {};
+
+	io_uring_sqe *m_sqes {};
+
+	size_t m_sq_size {};
+
+	size_t m_cq_size {};
+
+	size_t m_sqes_size {};
+
+	uint32_t *m_sq_head {};
+
+	uint32_t *m_sq_tail {};
+
+	uint32_t m_sq_mask {};
+
+	uint32_t m_sq_entries {};
+
+	uint32_t *m_cq_head {};
+
+	uint32_t *m_cq_tail {};
+
+	uint32_t m_cq_mask {};
+
+	io_uring_cqe *m_cqes {};
+
+	// Local tail, published to the kernel on submit().
+	uint32_t m_tail {};
+
+	uint32_t m_submitted {};
+};
+
+} // namespace hft::core
@@ -54,6 +54,16 @@ public:
 		return m_free_list.empty();
 	}
 
+	/*Returns every object to the pool, later allocations walk the storage front to back. Nothing may be in use.*/
+	void reset() noexcept
+	{
+		m_free_list.clear();
+		for (auto it = m_storage.rbegin(); it != m_storage.rend(); ++it)
+		{
+			m_free_list.push_back(&*it);
+		}
+	}
+
 	/*Trivial getter*/
 	[[nodiscard]] auto capacity() const noexcept -> std::size_t
 	{
@@ -66,6 +76,18 @@ public:
 		return m_storage;
 	}
 
+	/*Trivial getter*/
+	[[nodiscard]] const auto &get_storage() const noexcept
+	{
+		return m_storage;
+	}
+
+	/*Slot of obj inside the storage, stable for the lifetime of the pool.*/
+	[[nodiscard]] auto index_of(const T *obj) const noexcept -> std::size_t
+	{
+		return static_cast<std::size_t>(obj - m_storage.data());
+	}
+
 public:
 	std::array<T, N> m_storage;
 
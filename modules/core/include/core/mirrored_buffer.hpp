@@ -0,0 +1,126 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace hft::core {
+
+/*
+ * Byte ring whose pages are mapped twice back to back, so the readable and
+ * writable regions are always one contiguous span each, wherever they sit
+ * in the ring. Stream parsers can then work on frames that wrap around the
+ * end without copying them out. Capacity is a power of two multiple of the
+ * page size. Single threaded, the caller writes into writable() and
+ * commits, then reads readable() and consumes.
+ */
+class MirroredBuffer
+{
+public:
+	/*Rounds min_capacity up, throws std::runtime_error when the mapping fails.*/
+	explicit MirroredBuffer(size_t min_capacity)
+	{
+		const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		m_capacity = std::bit_ceil(std::max(min_capacity, page));
+
+		const auto fd = ::memfd_create("mirrored_buffer", MFD_CLOEXEC);
+		if (fd < 0)
+		{
+			throw std::runtime_error(std::string("Cannot create mirrored buffer: ") + std::strerror(errno));
+		}
+
+		// Reserve both halves first so the two views land next to each other.
+		auto *base = ::mmap(nullptr, 2 * m_capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		const auto ok = base != MAP_FAILED && ::ftruncate(fd, static_cast<off_t>(m_capacity)) == 0 &&
+						map_view(fd, base, 0) && map_view(fd, base, m_capacity);
+		const auto error = errno;
+		::close(fd);
+		if (!ok)
+		{
+			if (base != MAP_FAILED)
+			{
+				::munmap(base, 2 * m_capacity);
+			}
+			throw std::runtime_error(std::string("Cannot map mirrored buffer: ") + std::strerror(error));
+		}
+		m_data = static_cast<std::byte *>(base);
+	}
+
+	MirroredBuffer(const MirroredBuffer &) = delete;
+
+	MirroredBuffer(MirroredBuffer &&) = delete;
+
+	auto operator=(const MirroredBuffer &) -> MirroredBuffer & = delete;
+
+	auto operator=(MirroredBuffer &&) -> MirroredBuffer & = delete;
+
+	~MirroredBuffer()
+	{
+		::munmap(m_data, 2 * m_capacity);
+	}
+
+	/*Bytes committed and not yet consumed, writable in place.*/
+	[[nodiscard]] auto readable() noexcept -> std::span<std::byte>
+	{
+		return { m_data + (m_read & (m_capacity - 1)), size() };
+	}
+
+	/*Free space following the readable bytes.*/
+	[[nodiscard]] auto writable() noexcept -> std::span<std::byte>
+	{
+		return { m_data + (m_write & (m_capacity - 1)), m_capacity - size() };
+	}
+
+	/*Makes count bytes written into writable() readable.*/
+	void commit(size_t count) noexcept
+	{
+		assert(count <= m_capacity - size());
+		m_write += count;
+	}
+
+	/*Drops count bytes from the front of readable().*/
+	void consume(size_t count) noexcept
+	{
+		assert(count <= size());
+		m_read += count;
+	}
+
+	/*Drops everything.*/
+	void clear() noexcept
+	{
+		m_read = m_write;
+	}
+
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return static_cast<size_t>(m_write - m_read);
+	}
+
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return m_write == m_read;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto capacity() const noexcept -> size_t
+	{
+		return m_capacity;
+	}
+
+private:
+	[[nodiscard]] auto map_view(int fd, void *base, size_t offset) const -> bool
+	{
+		auto *view = static_cast<std::byte *>(base) + offset;
+		return ::mmap(view, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == view;
+	}
+
+	std::byte *m_data {};
+
+	size_t m_capacity {};
+
+	// Running byte counts, the ring offset is the low bits.
+	uint64_t m_read {};
+
+	uint64_t m_write {};
+};
+
+} // namespace hft::core
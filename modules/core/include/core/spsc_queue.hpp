@@ -0,0 +1,125 @@
+#pragma once
+
+namespace hft::core {
+
+/*
+ * Bounded ring between exactly one producer and one consumer thread. Each
+ * side keeps a private copy of the other's index and only reloads it when the
+ * ring looks full (or empty), so in steady state a push or pop touches no
+ * cache line owned by the other thread besides the slot itself. Slots are
+ * reused in place: claim()/publish() let the producer fill one without an
+ * extra copy, front()/pop() let the consumer read it where it lies.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+	static_assert(std::is_trivially_copyable_v<T>, "Slots are reused without running destructors");
+
+	/*Holds at least capacity elements, rounded up to a power of two.*/
+	explicit SpscQueue(size_t capacity)
+		: m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+		, m_slots(std::make_unique<T[]>(m_mask + 1))
+	{
+	}
+
+	SpscQueue(const SpscQueue &) = delete;
+
+	SpscQueue(SpscQueue &&) = delete;
+
+	auto operator=(const SpscQueue &) -> SpscQueue & = delete;
+
+	auto operator=(SpscQueue &&) -> SpscQueue & = delete;
+
+	~SpscQueue() = default;
+
+	/*Producer: next free slot to fill, nullptr when the ring is full. Invisible until publish().*/
+	[[nodiscard]] auto claim() noexcept -> T *
+	{
+		const auto tail = m_producer.index;
+		if (tail - m_producer.cached > m_mask) [[unlikely]]
+		{
+			m_producer.cached = m_head.load(std::memory_order_acquire);
+			if (tail - m_producer.cached > m_mask)
+			{
+				return nullptr;
+			}
+		}
+		return &m_slots[tail & m_mask];
+	}
+
+	/*Producer: hands the slot returned by the last claim() to the consumer.*/
+	void publish() noexcept
+	{
+		m_tail.store(++m_producer.index, std::memory_order_release);
+	}
+
+	/*Producer: copies value in, false when the ring is full.*/
+	[[nodiscard]] auto try_push(const T &value) noexcept -> bool
+	{
+		auto *slot = claim();
+		if (!slot)
+		{
+			return false;
+		}
+		*slot = value;
+		publish();
+		return true;
+	}
+
+	/*Consumer: oldest published element, nullptr when there is none.*/
+	[[nodiscard]] auto front() noexcept -> T *
+	{
+		const auto head = m_consumer.index;
+		if (head == m_consumer.cached)
+		{
+			m_consumer.cached = m_tail.load(std::memory_order_acquire);
+			if (head == m_consumer.cached)
+			{
+				return nullptr;
+			}
+		}
+		return &m_slots[head & m_mask];
+	}
+
+	/*Consumer: releases the element returned by front() back to the producer.*/
+	void pop() noexcept
+	{
+		m_head.store(++m_consumer.index, std::memory_order_release);
+	}
+
+	/*Elements published and not popped yet, exact only when called from one of the two threads while the other is idle.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return static_cast<size_t>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto capacity() const noexcept -> size_t
+	{
+		return m_mask + 1;
+	}
+
+private:
+	// Own index and last seen index of the other side, touched by one thread only.
+	struct alignas(64) Cursor
+	{
+		uint64_t index {};
+
+		uint64_t cached {};
+	};
+
+	const size_t m_mask;
+
+	std::unique_ptr<T[]> m_slots;
+
+	alignas(64) std::atomic<uint64_t> m_head {};
+
+	alignas(64) std::atomic<uint64_t> m_tail {};
+
+	Cursor m_producer {};
+
+	Cursor m_consumer {};
+};
+
+} // namespace hft::core
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace hft::core {
+
+/*
+ * Counter with exactly one writing thread and any number of readers,
+ * possibly in other processes through shared memory. The writer bumps it
+ * with a relaxed load and store instead of a locked read-modify-write, so
+ * counting costs the same as a plain increment. Readers may see a value a
+ * moment old, never a torn one.
+ */
+class StatCounter
+{
+public:
+	void add(uint64_t count = 1) noexcept
+	{
+		m_value.store(m_value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] auto get() const noexcept -> uint64_t
+	{
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+	/*Only while no writer runs.*/
+	void reset() noexcept
+	{
+		m_value.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "Counters in shared memory must not need a lock");
+
+	std::atomic<uint64_t> m_value {};
+};
+
+} // namespace hft::core
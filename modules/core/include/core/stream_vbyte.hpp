@@ -0,0 +1,121 @@
+#pragma once
+
+#if defined(__SSSE3__)
+	#include <tmmintrin.h>
+	#define HFT_STREAM_VBYTE_SSSE3 1
+#endif
+
+namespace hft::core {
+
+/*
+ * Stream VByte coding of 32 bit integers: a control stream of 2 bit byte
+ * lengths, four values per control byte, followed by the value bytes with
+ * nothing in between. Keeping the lengths apart lets the decoder expand four
+ * values with one shuffle instead of branching per byte.
+ */
+namespace detail {
+
+struct StreamVByteTables
+{
+	// Shuffle taking the data bytes of one control byte to four 32 bit lanes, 0x80 zeroes a byte.
+	std::array<std::array<uint8_t, 16>, 256> shuffle {};
+
+	// Data bytes used by the four values of a control byte.
+	std::array<uint8_t, 256> length {};
+};
+
+consteval auto make_stream_vbyte_tables() -> StreamVByteTables
+{
+	StreamVByteTables tables {};
+	for (size_t control = 0; control < 256; ++control)
+	{
+		uint8_t offset = 0;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const auto bytes = ((control >> (2 * i)) & 3) + 1;
+			for (size_t b = 0; b < 4; ++b)
+			{
+				tables.shuffle[control][i * 4 + b] = b < bytes ? static_cast<uint8_t>(offset + b) : 0x80;
+			}
+			offset = static_cast<uint8_t>(offset + bytes);
+		}
+		tables.length[control] = offset;
+	}
+	return tables;
+}
+
+inline constexpr auto STREAM_VBYTE_TABLES = make_stream_vbyte_tables();
+
+} // namespace detail
+
+/*Upper bound of the encoded size of count values.*/
+[[nodiscard]] constexpr auto stream_vbyte_max_size(size_t count) noexcept -> size_t
+{
+	return (count + 3) / 4 + count * sizeof(uint32_t);
+}
+
+/*Encodes count values to dst, returns the position after them.*/
+inline auto stream_vbyte_encode(const uint32_t *values, size_t count, std::byte *dst) noexcept -> std::byte *
+{
+	auto *control = dst;
+	auto *data = dst + (count + 3) / 4;
+	std::memset(control, 0, (count + 3) / 4);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto value = values[i];
+		const auto code = static_cast<unsigned>(value > 0xff) + static_cast<unsigned>(value > 0xffff) +
+						  static_cast<unsigned>(value > 0xffffff);
+		control[i / 4] |= static_cast<std::byte>(code << (2 * (i % 4)));
+		std::memcpy(data, &value, code + 1);
+		data += code + 1;
+	}
+	return data;
+}
+
+/*
+ * Decodes count values from [src, end), returns the position after them or
+ * nullptr when the input is truncated. Reads up to 16 bytes ahead of the
+ * data, never past end.
+ */
+inline auto stream_vbyte_decode(const std::byte *src, const std::byte *end, uint32_t *values, size_t count) noexcept
+	-> const std::byte *
+{
+	const auto control_size = (count + 3) / 4;
+	if (static_cast<size_t>(end - src) < control_size)
+	{
+		return nullptr;
+	}
+
+	const auto *control = reinterpret_cast<const uint8_t *>(src);
+	const auto *data = src + control_size;
+	const auto &tables = detail::STREAM_VBYTE_TABLES;
+
+	size_t i = 0;
+#if HFT_STREAM_VBYTE_SSSE3
+	for (; i + 4 <= count && end - data >= 16; i += 4)
+	{
+		const auto c = control[i / 4];
+		const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+		const auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.shuffle[c].data()));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(values + i), _mm_shuffle_epi8(bytes, shuffle));
+		data += tables.length[c];
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const auto bytes = static_cast<size_t>((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+		if (static_cast<size_t>(end - data) < bytes)
+		{
+			return nullptr;
+		}
+		uint32_t value = 0;
+		std::memcpy(&value, data, bytes);
+		values[i] = value;
+		data += bytes;
+	}
+	return data;
+}
+
+} // namespace hft::core
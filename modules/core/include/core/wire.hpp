@@ -0,0 +1,68 @@
+#pragma once
+
+namespace hft::core {
+
+static_assert(std::endian::native == std::endian::little, "Wire formats are read in place as little endian");
+
+/*Unaligned little endian read of a trivially copyable value.*/
+template<typename T>
+[[nodiscard]] inline auto load_le(const std::byte *src) noexcept -> T
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	T value;
+	std::memcpy(&value, src, sizeof(T));
+	return value;
+}
+
+/*Unaligned little endian write, returns the position after the value.*/
+template<typename T>
+inline auto store_le(std::byte *dst, T value) noexcept -> std::byte *
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	std::memcpy(dst, &value, sizeof(T));
+	return dst + sizeof(T);
+}
+
+/*Maps small magnitudes of either sign to small unsigned values.*/
+[[nodiscard]] constexpr auto zigzag_encode(int64_t value) noexcept -> uint64_t
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+[[nodiscard]] constexpr auto zigzag_decode(uint64_t value) noexcept -> int64_t
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// LEB128 needs at most 10 bytes for 64 bits.
+inline constexpr size_t MAX_VARINT_SIZE = 10;
+
+/*Writes value as LEB128 varint, returns the position after it.*/
+inline auto write_varint(std::byte *dst, uint64_t value) noexcept -> std::byte *
+{
+	while (value >= 0x80)
+	{
+		*dst++ = static_cast<std::byte>(value | 0x80);
+		value >>= 7;
+	}
+	*dst++ = static_cast<std::byte>(value);
+	return dst;
+}
+
+/*Reads a LEB128 varint from [src, end), returns nullptr if it is truncated or too long.*/
+inline auto read_varint(const std::byte *src, const std::byte *end, uint64_t &value) noexcept -> const std::byte *
+{
+	value = 0;
+	for (unsigned shift = 0; shift < 64 && src != end; shift += 7)
+	{
+		const auto byte = static_cast<uint64_t>(*src++);
+		value |= (byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return src;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace hft::core
@@ -0,0 +1,215 @@
+#pragma once
+
+namespace hft::core {
+
+/*
+ * Fixed set of worker threads running index based parallel loops.
+ * parallel_for splits the indices into one contiguous run per worker, each
+ * worker takes from the back of its own deque and, once empty, steals from the
+ * front of the others, so long tasks on one worker do not hold up the rest.
+ * The calling thread takes part as worker 0. Meant for coarse tasks (a symbol,
+ * a file), the deques are guarded by plain mutexes.
+ */
+class WorkStealingPool
+{
+public:
+	explicit WorkStealingPool(size_t threads = std::max(1U, std::thread::hardware_concurrency()))
+		: m_queues(std::max<size_t>(threads, 1))
+	{
+		for (size_t i = 1; i < m_queues.size(); ++i)
+		{
+			m_threads.emplace_back([this, i] { worker_loop(i); });
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool &) = delete;
+
+	WorkStealingPool(WorkStealingPool &&) = delete;
+
+	auto operator=(const WorkStealingPool &) -> WorkStealingPool & = delete;
+
+	auto operator=(WorkStealingPool &&) -> WorkStealingPool & = delete;
+
+	~WorkStealingPool()
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto &thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	/*
+	 * Calls fn(task, worker) for every task in [0, tasks) and returns once all
+	 * of them ran. The first exception thrown by fn is rethrown here after the
+	 * remaining tasks finished. Not reentrant.
+	 */
+	template<typename Fn>
+	void parallel_for(size_t tasks, Fn &&fn)
+	{
+		if (tasks == 0)
+		{
+			return;
+		}
+
+		const auto workers = m_queues.size();
+		for (size_t w = 0; w < workers; ++w)
+		{
+			auto &queue = m_queues[w];
+			std::scoped_lock lock(queue.mutex);
+			queue.tasks.clear();
+			for (auto task = tasks * w / workers; task < tasks * (w + 1) / workers; ++task)
+			{
+				queue.tasks.push_back(task);
+			}
+		}
+
+		{
+			std::scoped_lock lock(m_mutex);
+			m_job = { &invoke<std::remove_reference_t<Fn>>, &fn };
+			m_error = nullptr;
+			m_finished = 0;
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		run_tasks(0);
+
+		std::unique_lock lock(m_mutex);
+		m_done.wait(lock, [this] { return m_finished == m_threads.size(); });
+		if (m_error)
+		{
+			std::rethrow_exception(m_error);
+		}
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_queues.size();
+	}
+
+private:
+	struct Job
+	{
+		void (*call)(void *context, size_t task, size_t worker) {};
+
+		void *context {};
+	};
+
+	struct alignas(64) Queue
+	{
+		std::mutex mutex;
+
+		std::deque<size_t> tasks;
+	};
+
+	template<typename Fn>
+	static void invoke(void *context, size_t task, size_t worker)
+	{
+		(*static_cast<Fn *>(context))(task, worker);
+	}
+
+	void worker_loop(size_t worker)
+	{
+		uint64_t seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_mutex);
+				m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+				if (m_stop)
+				{
+					return;
+				}
+				seen = m_generation;
+			}
+
+			run_tasks(worker);
+
+			{
+				std::scoped_lock lock(m_mutex);
+				++m_finished;
+			}
+			m_done.notify_one();
+		}
+	}
+
+	void run_tasks(size_t worker)
+	{
+		const auto job = m_job;
+		size_t task;
+		while (pop(worker, task) || steal(worker, task))
+		{
+			try
+			{
+				job.call(job.context, task, worker);
+			}
+			catch (...)
+			{
+				std::scoped_lock lock(m_mutex);
+				if (!m_error)
+				{
+					m_error = std::current_exception();
+				}
+			}
+		}
+	}
+
+	auto pop(size_t worker, size_t &task) -> bool
+	{
+		auto &queue = m_queues[worker];
+		std::scoped_lock lock(queue.mutex);
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+		task = queue.tasks.back();
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	auto steal(size_t thief, size_t &task) -> bool
+	{
+		const auto workers = m_queues.size();
+		for (size_t i = 1; i < workers; ++i)
+		{
+			auto &queue = m_queues[(thief + i) % workers];
+			std::scoped_lock lock(queue.mutex);
+			if (!queue.tasks.empty())
+			{
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::vector<Queue> m_queues;
+
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+
+	std::condition_variable m_wake;
+
+	std::condition_variable m_done;
+
+	// Guarded by m_mutex, workers copy the job when they wake up for a generation.
+	Job m_job {};
+
+	uint64_t m_generation {};
+
+	size_t m_finished {};
+
+	std::exception_ptr m_error;
+
+	bool m_stop {};
+};
+
+} // namespace hft::core
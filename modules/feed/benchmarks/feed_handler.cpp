@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include <feed/feed_handler.hpp>
+#include <feed/multicast_publisher.hpp>
+#include <l2/delta_codec.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::feed;
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+constexpr auto GROUP = "239.255.42.2";
+
+/*One compact message of four changes per packet, sequences from first on.*/
+auto make_packets(size_t count, uint64_t first) -> std::vector<std::vector<std::byte>>
+{
+	const DeltaEncoder encoder;
+	std::mt19937_64 rng(first);
+	std::vector<std::vector<std::byte>> packets(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::array<LevelChange, 4> changes;
+		for (auto &change : changes)
+		{
+			change.side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			change.price = change.side == Side::Bid ? 1000 - rng() % 20 : 1001 + rng() % 20;
+			change.quantity = 1 + rng() % 100;
+			change.action = LevelAction::Change;
+		}
+		packets[i].resize(DeltaFormat::max_size(encoder.get_encoding(), changes.size()));
+		packets[i].resize(encoder.encode(packets[i], first + i, changes, 1000, 1001));
+	}
+	return packets;
+}
+
+constexpr size_t ITERATIONS = 256;
+
+} // namespace
+
+/*
+ * Send a batch over loopback multicast, then receive and apply it, all on
+ * one thread. Per packet time therefore includes the send side, the
+ * latency counters cover only kernel receive to book update.
+ */
+static void BM_FeedHandler_LoopbackBatch(benchmark::State &state)
+{
+	const auto mode = static_cast<ReceiveMode>(state.range(0));
+	const auto batch = static_cast<size_t>(state.range(1));
+
+	auto book = std::make_unique<OrderBook>();
+	std::unique_ptr<FeedHandler> handler;
+	std::unique_ptr<MulticastPublisher> publisher;
+	try
+	{
+		FeedConfig config;
+		config.group = GROUP;
+		config.interface = "127.0.0.1";
+		config.mode = mode;
+		config.receive_buffer = 8 << 20;
+		handler = std::make_unique<FeedHandler>(config, *book);
+		publisher = std::make_unique<MulticastPublisher>(GROUP, handler->get_port());
+	}
+	catch (const std::runtime_error &error)
+	{
+		state.SkipWithError(error.what());
+		return;
+	}
+
+	// Fresh sequences every iteration keep the handler from dropping them as stale.
+	const auto packets = make_packets(batch * ITERATIONS, 1);
+	std::vector<std::span<const std::byte>> spans(packets.begin(), packets.end());
+	size_t round = 0;
+
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		const auto expected = handler->get_stats().packets + batch;
+		publisher->send_batch(std::span(spans).subspan(round++ * batch, batch));
+		while (handler->get_stats().packets < expected)
+		{
+			handler->poll();
+		}
+	}
+	counters.stop();
+
+	const auto &stats = handler->get_stats();
+	state.counters["packets/s"] =
+		benchmark::Counter(static_cast<double>(stats.packets), benchmark::Counter::kIsRate);
+	state.counters["latency_mean_ns"] = static_cast<double>(stats.latency_total_ns) / static_cast<double>(stats.packets);
+	state.counters["latency_max_ns"] = static_cast<double>(stats.latency_max_ns);
+	state.counters["packets/batch"] = static_cast<double>(stats.packets) / static_cast<double>(stats.batches);
+	counters.report(state, batch);
+}
+BENCHMARK(BM_FeedHandler_LoopbackBatch)
+	->ArgsProduct({ { static_cast<int64_t>(ReceiveMode::Blocking), static_cast<int64_t>(ReceiveMode::Spin) }, { 1, 16, 64 } })
+	->Iterations(ITERATIONS)
+	->ArgNames({ "mode", "batch" });
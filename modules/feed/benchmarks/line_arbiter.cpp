@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <feed/line_arbiter.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::feed;
+using hft::common::PerfCounters;
+
+namespace {
+
+/*
+ * Every line carries every sequence, each copy jittered by up to 16
+ * positions and a hundredth of them dropped, then all merged by arrival.
+ */
+auto make_arrivals(size_t lines, size_t sequences) -> std::vector<std::pair<uint64_t, uint8_t>>
+{
+	std::mt19937_64 rng(5);
+	std::vector<std::tuple<uint64_t, uint64_t, uint8_t>> timed;
+	for (uint64_t sequence = 1; sequence <= sequences; ++sequence)
+	{
+		for (size_t line = 0; line < lines; ++line)
+		{
+			if (rng() % 100 != 0)
+			{
+				timed.emplace_back(sequence * 16 + rng() % 256, sequence, static_cast<uint8_t>(line));
+			}
+		}
+	}
+	std::ranges::sort(timed);
+
+	std::vector<std::pair<uint64_t, uint8_t>> arrivals;
+	arrivals.reserve(timed.size());
+	for (const auto &[time, sequence, line] : timed)
+	{
+		arrivals.emplace_back(sequence, line);
+	}
+	return arrivals;
+}
+
+} // namespace
+
+static void BM_LineArbiter_Accept(benchmark::State &state)
+{
+	const auto lines = static_cast<size_t>(state.range(0));
+	const auto arrivals = make_arrivals(lines, 1 << 20);
+
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		LineArbiter arbiter(lines);
+		for (const auto &[sequence, line] : arrivals)
+		{
+			benchmark::DoNotOptimize(arbiter.accept(line, sequence));
+		}
+		benchmark::DoNotOptimize(arbiter.get_stats());
+	}
+	counters.stop();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(arrivals.size()));
+	counters.report(state, arrivals.size());
+}
+BENCHMARK(BM_LineArbiter_Accept)->Arg(1)->Arg(2)->Arg(4)->ArgName("lines");
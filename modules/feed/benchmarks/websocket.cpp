@@ -0,0 +1,161 @@
+#include <benchmark/benchmark.h>
+#include <feed/websocket_client.hpp>
+#include <feed/websocket_server.hpp>
+#include <l2/sbe_depth.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::feed;
+using hft::common::PerfCounters;
+using hft::core::MirroredBuffer;
+
+namespace {
+
+constexpr size_t MESSAGES = 4096;
+
+/*MESSAGES frames of the given payload size, masked with a fixed key when asked.*/
+auto make_stream(size_t payload_size, bool masked) -> std::vector<std::byte>
+{
+	std::mt19937_64 rng(3);
+	std::vector<std::byte> stream;
+	std::vector<std::byte> payload(payload_size);
+	for (size_t i = 0; i < MESSAGES; ++i)
+	{
+		for (auto &byte : payload)
+		{
+			byte = static_cast<std::byte>(rng());
+		}
+		const auto offset = stream.size();
+		stream.resize(offset + WsFormat::MAX_HEADER_SIZE + payload_size);
+		const auto key = masked ? std::optional<uint32_t> { static_cast<uint32_t>(rng()) } : std::nullopt;
+		const auto header_size = write_ws_header(stream.data() + offset, WsOpcode::Binary, true, payload_size, key);
+		std::memcpy(stream.data() + offset + header_size, payload.data(), payload_size);
+		stream.resize(offset + header_size + payload_size);
+	}
+	return stream;
+}
+
+} // namespace
+
+/*
+ * Stream pushed through a 64 KiB ring in 16 KiB reads, as recv would
+ * deliver it. Time per message is what framing adds between the bytes
+ * arriving and the payload reaching the parser.
+ */
+static void BM_WebSocketDecoder_Decode(benchmark::State &state)
+{
+	const auto payload_size = static_cast<size_t>(state.range(0));
+	const auto masked = state.range(1) != 0;
+	const auto stream = make_stream(payload_size, masked);
+
+	MirroredBuffer buffer(64 << 10);
+	constexpr size_t READ = 16 << 10;
+
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		WebSocketDecoder decoder(buffer);
+		uint64_t checksum = 0;
+		for (size_t offset = 0; offset < stream.size();)
+		{
+			const auto count = std::min({ READ, buffer.writable().size(), stream.size() - offset });
+			std::memcpy(buffer.writable().data(), stream.data() + offset, count);
+			buffer.commit(count);
+			offset += count;
+
+			decoder.decode(
+				[&](std::span<const std::byte> payload, WsOpcode) { checksum += static_cast<uint64_t>(payload[0]); },
+				[](WsOpcode, std::span<const std::byte>) {}
+			);
+		}
+		benchmark::DoNotOptimize(checksum);
+	}
+	counters.stop();
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(MESSAGES));
+	counters.report(state, MESSAGES);
+}
+BENCHMARK(BM_WebSocketDecoder_Decode)
+	->ArgsProduct({ { 64, 512, 4096 }, { 0, 1 } })
+	->ArgNames({ "payload", "masked" });
+
+static void BM_WebSocket_Mask(benchmark::State &state)
+{
+	std::vector<std::byte> data(static_cast<size_t>(state.range(0)), std::byte { 0x5a });
+	for (auto _ : state)
+	{
+		websocket_mask(data, 0x12345678);
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_WebSocket_Mask)->Arg(64)->Arg(512)->Arg(4096)->ArgName("bytes");
+
+/*
+ * Venue thread replaying small depth diffs over TCP loopback in bursts of
+ * 64 messages, client polling and handing them to the SBE decoder.
+ */
+static void BM_WebSocket_LoopbackReplay(benchmark::State &state)
+{
+	std::unique_ptr<WebSocketReplayServer> server;
+	try
+	{
+		server = std::make_unique<WebSocketReplayServer>();
+	}
+	catch (const std::runtime_error &error)
+	{
+		state.SkipWithError(error.what());
+		return;
+	}
+
+	// Diffs that fail the sequence check, parsing is what is measured here.
+	constexpr size_t BURST = 64;
+	std::vector<std::byte> diff(hft::orderbook::sbe::MessageHeader::SIZE + 64);
+	std::vector<std::span<const std::byte>> burst(BURST, diff);
+
+	std::atomic<bool> stop { false };
+	std::thread venue(
+		[&]
+		{
+			server->accept();
+			while (!stop.load(std::memory_order_relaxed) && server->send_batch(burst))
+			{
+			}
+		}
+	);
+
+	{
+		WebSocketClient client({ .port = server->get_port() });
+		hft::orderbook::OrderBook book;
+		const hft::orderbook::SbeDepthDecoder depth;
+		uint64_t received = 0;
+
+		PerfCounters counters;
+		counters.start();
+		for (auto _ : state)
+		{
+			const auto target = received + BURST;
+			while (received < target)
+			{
+				client.poll(
+					[&](std::span<const std::byte> payload, WsOpcode)
+					{
+						benchmark::DoNotOptimize(depth.apply(payload, book));
+						++received;
+					}
+				);
+			}
+		}
+		counters.stop();
+		stop = true;
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BURST));
+		state.counters["bytes/read"] =
+			static_cast<double>(client.get_stats().bytes) / static_cast<double>(client.get_stats().reads);
+		counters.report(state, BURST);
+	}
+	// Closing the client fails the venue's next send.
+	venue.join();
+}
+BENCHMARK(BM_WebSocket_LoopbackReplay);
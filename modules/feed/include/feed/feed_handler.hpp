@@ -0,0 +1,201 @@
+#pragma once
+
+#include <feed/line_arbiter.hpp>
+#include <l2/delta_codec.hpp>
+#include <l2/orderbook.hpp>
+#include <sys/socket.h>
+
+namespace hft::feed {
+
+enum class ReceiveMode : uint8_t
+{
+	// recvmmsg sleeps until a packet arrives or poll_timeout_ms passes.
+	Blocking,
+
+	// Non-blocking recvmmsg, poll() returns at once when nothing is waiting.
+	Spin
+};
+
+struct FeedConfig
+{
+	// Multicast group, dotted quad.
+	std::string group;
+
+	// 0 binds an ephemeral port, see get_port().
+	uint16_t port {};
+
+	// Address of the local interface joining the group, 0.0.0.0 lets the kernel pick.
+	std::string interface { "0.0.0.0" };
+
+	ReceiveMode mode { ReceiveMode::Spin };
+
+	// SO_BUSY_POLL in microseconds, 0 leaves it off.
+	uint32_t busy_poll_us {};
+
+	// SO_RCVBUF in bytes, 0 keeps the system default.
+	int receive_buffer {};
+
+	// How often run() in blocking mode wakes up to check for stop.
+	uint32_t poll_timeout_ms { 100 };
+};
+
+struct FeedStats
+{
+	uint64_t batches {};
+
+	uint64_t packets {};
+
+	uint64_t messages {};
+
+	uint64_t changes {};
+
+	// Packets or trailing bytes that do not parse as a delta message.
+	uint64_t malformed {};
+
+	// Messages older than the last one applied, or copies the arbiter turned down, dropped.
+	uint64_t stale {};
+
+	// Sequence jumps, the missing messages are not recovered here. With an arbiter, gaps no line filled in time.
+	uint64_t gaps {};
+
+	// Packets that carried a kernel software receive timestamp.
+	uint64_t timestamped {};
+
+	// Packets that carried a NIC hardware receive timestamp as well.
+	uint64_t hardware_timestamped {};
+
+	// Receive timestamp to the packet's last change being applied.
+	uint64_t latency_total_ns {};
+
+	uint64_t latency_max_ns {};
+};
+
+/*
+ * Multicast receiver applying delta messages (see DeltaMessageView) to an
+ * OrderBook. Packets come in batches of up to BATCH per recvmmsg into fixed
+ * buffers and are decoded in place, several messages per packet are allowed.
+ * Receive times, which latency and the arbiter's hold time are measured
+ * from, are the kernel's software stamp, else the time recvmmsg returned.
+ * Both are wall clock. The NIC's hardware stamp counts on the NIC's own clock
+ * and is only kept as is, see get_last_hardware_ns(). Not thread safe, one
+ * handler per receiving thread.
+ */
+class FeedHandler
+{
+public:
+	static constexpr size_t BATCH = 64;
+
+	static constexpr size_t MAX_PACKET = 2048;
+
+	static constexpr size_t CONTROL_SIZE = 128;
+
+	/*Opens and joins, throws std::runtime_error on failure.*/
+	FeedHandler(const FeedConfig &config, orderbook::OrderBook &book);
+
+	FeedHandler(const FeedHandler &) = delete;
+
+	FeedHandler(FeedHandler &&) = delete;
+
+	auto operator=(const FeedHandler &) -> FeedHandler & = delete;
+
+	auto operator=(FeedHandler &&) -> FeedHandler & = delete;
+
+	~FeedHandler();
+
+	/*Receives and applies one batch, returns the number of packets in it.*/
+	auto poll() -> size_t;
+
+	/*Polls until stop is set.*/
+	void run(const std::atomic<bool> &stop);
+
+	/*
+	 * Makes this handler one line of the arbiter, which then decides which
+	 * messages get applied and in which order. Handlers of the other lines
+	 * share the book. A message filling a gap the arbiter gave up on comes
+	 * after newer ones were applied and is dropped as stale.
+	 */
+	void set_arbiter(LineArbiter &arbiter, size_t line);
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_stats() const noexcept -> const FeedStats &
+	{
+		return m_stats;
+	}
+
+	/*
+	 * Raw hardware stamp of the last packet received, 0 when it had none or
+	 * the interface is not set up for them. On the NIC's clock, which only
+	 * matches wall time where something like phc2sys keeps it in sync.
+	 */
+	[[nodiscard]] auto get_last_hardware_ns() const noexcept -> uint64_t
+	{
+		return m_last_hardware_ns;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_port() const noexcept -> uint16_t
+	{
+		return m_port;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_book() const -> const orderbook::OrderBook &
+	{
+		return m_book;
+	}
+
+private:
+	void on_packet(const std::byte *data, size_t size, uint64_t receive_ns);
+
+	/*Applies, holds or drops a message the arbiter delivered, keeping the book in sequence order.*/
+	void deliver(const orderbook::DeltaMessageView &view, std::span<const std::byte> message, uint64_t receive_ns);
+
+	void apply(const orderbook::DeltaMessageView &view, uint64_t sequence);
+
+	/*Applies held messages while the next sequence is among them.*/
+	void release_held();
+
+	/*Gives up on the open gap once it has been waited on for the arbiter's hold time.*/
+	void expire_held(uint64_t now_ns);
+
+	struct ReceiveStamps
+	{
+		// Kernel software stamp, wall clock.
+		uint64_t software_ns {};
+
+		// NIC hardware stamp, NIC clock.
+		uint64_t hardware_ns {};
+	};
+
+	/*Stamps in the control message of a packet, 0 for the ones missing.*/
+	[[nodiscard]] static auto kernel_timestamps(const msghdr &header) -> ReceiveStamps;
+
+	int m_fd = -1;
+
+	orderbook::OrderBook &m_book;
+
+	ReceiveMode m_mode;
+
+	uint16_t m_port {};
+
+	// Sequence of the last message applied, 0 before the first.
+	uint64_t m_sequence {};
+
+	LineArbiter *m_arbiter {};
+
+	size_t m_line {};
+
+	FeedStats m_stats {};
+
+	uint64_t m_last_hardware_ns {};
+
+	std::array<mmsghdr, BATCH> m_headers {};
+
+	std::array<iovec, BATCH> m_iovecs {};
+
+	alignas(64) std::array<std::array<std::byte, MAX_PACKET>, BATCH> m_buffers {};
+
+	alignas(8) std::array<std::array<std::byte, CONTROL_SIZE>, BATCH> m_control {};
+};
+
+} // namespace hft::feed
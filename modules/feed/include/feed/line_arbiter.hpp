@@ -0,0 +1,191 @@
+#pragma once
+
+namespace hft::feed {
+
+struct ArbiterStats
+{
+	// First copies, handed on to be applied.
+	uint64_t delivered {};
+
+	// Copies of a sequence already delivered.
+	uint64_t duplicates {};
+
+	// Too old for the window, dropped without knowing whether they were duplicates.
+	uint64_t late {};
+
+	// Sequences jumped over by a newer message, they may still be filled.
+	uint64_t skipped {};
+
+	// Deliveries that filled a skipped sequence.
+	uint64_t filled {};
+
+	// Skipped sequences that left the window with no line having filled them.
+	uint64_t lost {};
+
+	// Messages held back behind a gap.
+	uint64_t held {};
+
+	// Gaps given up on, the book missed their messages.
+	uint64_t abandoned {};
+};
+
+/*
+ * Merges redundant feed lines carrying the same sequence numbers, A/B
+ * style. Each sequence is delivered once, on whichever line brings it
+ * first, including ones older than the newest seen as long as they are
+ * still in the window. The window is a ring bitmap of the last WINDOW
+ * sequences. Sequences falling out of it unseen are counted lost.
+ * Sequences start at 1.
+ *
+ * Messages carry absolute quantities, so applying a filled gap after newer
+ * messages would put back stale levels. The arbiter therefore also keeps the
+ * apply order: a message delivered ahead of a gap is copied into a hold of
+ * HOLD slots until the gap fills, and released in sequence order. A gap still
+ * open hold_ns after the first message behind it arrived, or one too wide
+ * for the hold, is given up on and the book is left to be resynced.
+ * Not thread safe, poll all lines from one thread.
+ */
+class LineArbiter
+{
+public:
+	static constexpr size_t MAX_LINES = 8;
+
+	static constexpr uint64_t WINDOW = 4096;
+
+	static constexpr uint64_t HOLD = 64;
+
+	// Largest message the hold copies, a whole packet.
+	static constexpr size_t MAX_MESSAGE = 2048;
+
+	/*Throws std::runtime_error unless 1 <= lines <= MAX_LINES.*/
+	explicit LineArbiter(size_t lines, uint64_t hold_ns = 1'000'000);
+
+	/*Returns true when this is the first copy of sequence, which the caller then applies.*/
+	[[nodiscard]] auto accept(size_t line, uint64_t sequence) -> bool;
+
+	/*Skipped sequences still inside the window and unfilled.*/
+	[[nodiscard]] auto get_pending() const -> uint64_t;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_stats() const noexcept -> const ArbiterStats &
+	{
+		return m_stats;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_line_count() const noexcept -> size_t
+	{
+		return m_lines;
+	}
+
+	/*Sequences the line delivered first.*/
+	[[nodiscard]] auto get_wins(size_t line) const -> uint64_t
+	{
+		assert(line < m_lines);
+		return m_wins[line];
+	}
+
+	/*Messages the line brought, first copies or not.*/
+	[[nodiscard]] auto get_received(size_t line) const -> uint64_t
+	{
+		assert(line < m_lines);
+		return m_received[line];
+	}
+
+	/*Newest sequence delivered, 0 before the first.*/
+	[[nodiscard]] auto get_highest() const noexcept -> uint64_t
+	{
+		return m_highest;
+	}
+
+	/*Sequence the book has to see next to stay in order, 0 before the first was applied.*/
+	[[nodiscard]] auto get_next_apply() const noexcept -> uint64_t
+	{
+		return m_next_apply;
+	}
+
+	/*Records that the message of sequence was applied.*/
+	void set_applied(uint64_t sequence) noexcept
+	{
+		m_next_apply = sequence + 1;
+	}
+
+	/*
+	 * Copies a delivered message that is ahead of the next one to apply.
+	 * False when it is HOLD or more sequences ahead or larger than
+	 * MAX_MESSAGE, the caller then gives up on the gap.
+	 */
+	[[nodiscard]] auto hold(uint64_t sequence, std::span<const std::byte> message, uint64_t receive_ns) -> bool;
+
+	/*
+	 * Releases the held message of the next sequence to apply, empty when
+	 * that one is not held. The bytes stay valid until the next hold().
+	 */
+	[[nodiscard]] auto take_next() -> std::span<const std::byte>;
+
+	/*
+	 * Gives up on the sequences missing before the oldest held message,
+	 * which becomes the next to apply. Returns how many were given up on.
+	 */
+	auto skip_gap() -> uint64_t;
+
+	/*Receive time of the first message held behind the open gap, 0 when nothing is held.*/
+	[[nodiscard]] auto get_held_since() const -> uint64_t;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_held() const noexcept -> size_t
+	{
+		return m_held_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_hold_ns() const noexcept -> uint64_t
+	{
+		return m_hold_ns;
+	}
+
+private:
+	struct HeldMessage
+	{
+		// 0 while the slot is free.
+		uint64_t sequence {};
+
+		uint64_t receive_ns {};
+
+		size_t size {};
+
+		std::array<std::byte, MAX_MESSAGE> data;
+	};
+
+	static constexpr size_t WORDS = WINDOW / 64;
+
+	/*Moves the window up to end at sequence, counting unseen sequences pushed out.*/
+	void advance(uint64_t sequence);
+
+	size_t m_lines;
+
+	// First sequence seen, anything older is late.
+	uint64_t m_first {};
+
+	uint64_t m_highest {};
+
+	ArbiterStats m_stats {};
+
+	std::array<uint64_t, MAX_LINES> m_wins {};
+
+	std::array<uint64_t, MAX_LINES> m_received {};
+
+	// Bit sequence % WINDOW is set once that sequence was delivered.
+	std::array<uint64_t, WORDS> m_seen {};
+
+	uint64_t m_hold_ns;
+
+	uint64_t m_next_apply {};
+
+	// Slot sequence % HOLD, every held sequence is less than HOLD ahead of m_next_apply.
+	std::vector<HeldMessage> m_held;
+
+	size_t m_held_count {};
+};
+
+} // namespace hft::feed
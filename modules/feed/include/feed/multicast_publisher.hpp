@@ -0,0 +1,37 @@
+#pragma once
+
+namespace hft::feed {
+
+/*
+ * Sends packets to a multicast group, for replaying captures and tests.
+ * Loops packets back to local receivers, the TTL keeps them on the host by
+ * default.
+ */
+class MulticastPublisher
+{
+public:
+	static constexpr size_t BATCH = 64;
+
+	/*Throws std::runtime_error on failure.*/
+	MulticastPublisher(const std::string &group, uint16_t port, const std::string &interface = "127.0.0.1", int ttl = 0);
+
+	MulticastPublisher(const MulticastPublisher &) = delete;
+
+	MulticastPublisher(MulticastPublisher &&) = delete;
+
+	auto operator=(const MulticastPublisher &) -> MulticastPublisher & = delete;
+
+	auto operator=(MulticastPublisher &&) -> MulticastPublisher & = delete;
+
+	~MulticastPublisher();
+
+	auto send(std::span<const std::byte> packet) -> bool;
+
+	/*Sends up to BATCH packets with one sendmmsg, returns how many went out.*/
+	auto send_batch(std::span<const std::span<const std::byte>> packets) -> size_t;
+
+private:
+	int m_fd = -1;
+};
+
+} // namespace hft::feed
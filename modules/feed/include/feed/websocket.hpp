@@ -0,0 +1,366 @@
+#pragma once
+
+#include <core/mirrored_buffer.hpp>
+#include <core/wire.hpp>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define HFT_WEBSOCKET_AVX2 1
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+	#define HFT_WEBSOCKET_SSE2 1
+#endif
+
+namespace hft::feed {
+
+enum class WsOpcode : uint8_t
+{
+	Continuation = 0x0,
+	Text = 0x1,
+	Binary = 0x2,
+	Close = 0x8,
+	Ping = 0x9,
+	Pong = 0xa
+};
+
+/*
+ * RFC 6455 frame header.
+ *
+ *   u8  fin << 7 | rsv << 4 | opcode
+ *   u8  mask << 7 | length, 126 and 127 select the extended length
+ *   u16 or u64 extended length, big endian
+ *   u8[4] masking key when masked
+ */
+struct WsFrameHeader
+{
+	uint64_t payload_size {};
+
+	size_t header_size {};
+
+	// Key bytes in wire order, loaded little endian.
+	uint32_t mask_key {};
+
+	WsOpcode opcode {};
+
+	uint8_t rsv {};
+
+	bool fin {};
+
+	bool masked {};
+};
+
+struct WsFormat
+{
+	static constexpr size_t MAX_HEADER_SIZE = 14;
+
+	static constexpr size_t MAX_CONTROL_PAYLOAD = 125;
+};
+
+[[nodiscard]] constexpr auto is_control(WsOpcode opcode) noexcept -> bool
+{
+	return (static_cast<uint8_t>(opcode) & 0x8) != 0;
+}
+
+/*Header at the front of in, nullopt until all of it has arrived.*/
+[[nodiscard]] inline auto parse_ws_header(std::span<const std::byte> in) noexcept -> std::optional<WsFrameHeader>
+{
+	if (in.size() < 2)
+	{
+		return std::nullopt;
+	}
+
+	const auto first = static_cast<uint8_t>(in[0]);
+	const auto second = static_cast<uint8_t>(in[1]);
+	WsFrameHeader header;
+	header.fin = (first & 0x80) != 0;
+	header.rsv = static_cast<uint8_t>((first >> 4) & 0x7);
+	header.opcode = static_cast<WsOpcode>(first & 0xf);
+	header.masked = (second & 0x80) != 0;
+	header.payload_size = second & 0x7f;
+	header.header_size = 2;
+
+	if (header.payload_size >= 126)
+	{
+		const auto extended = header.payload_size == 126 ? sizeof(uint16_t) : sizeof(uint64_t);
+		if (in.size() < 2 + extended)
+		{
+			return std::nullopt;
+		}
+		header.payload_size = extended == sizeof(uint16_t) ? std::byteswap(core::load_le<uint16_t>(in.data() + 2))
+														   : std::byteswap(core::load_le<uint64_t>(in.data() + 2));
+		header.header_size += extended;
+	}
+
+	if (header.masked)
+	{
+		if (in.size() < header.header_size + 4)
+		{
+			return std::nullopt;
+		}
+		header.mask_key = core::load_le<uint32_t>(in.data() + header.header_size);
+		header.header_size += 4;
+	}
+	return header;
+}
+
+/*Writes a frame header into dst (MAX_HEADER_SIZE bytes), returns its size.*/
+inline auto write_ws_header(
+	std::byte *dst, WsOpcode opcode, bool fin, uint64_t payload_size, std::optional<uint32_t> mask_key = std::nullopt
+) noexcept -> size_t
+{
+	dst[0] = static_cast<std::byte>((fin ? 0x80 : 0) | static_cast<uint8_t>(opcode));
+	const auto mask_bit = mask_key ? 0x80 : 0;
+	size_t size = 2;
+	if (payload_size < 126)
+	{
+		dst[1] = static_cast<std::byte>(mask_bit | static_cast<int>(payload_size));
+	}
+	else if (payload_size <= UINT16_MAX)
+	{
+		dst[1] = static_cast<std::byte>(mask_bit | 126);
+		core::store_le(dst + 2, std::byteswap(static_cast<uint16_t>(payload_size)));
+		size += sizeof(uint16_t);
+	}
+	else
+	{
+		dst[1] = static_cast<std::byte>(mask_bit | 127);
+		core::store_le(dst + 2, std::byteswap(payload_size));
+		size += sizeof(uint64_t);
+	}
+
+	if (mask_key)
+	{
+		core::store_le(dst + size, *mask_key);
+		size += 4;
+	}
+	return size;
+}
+
+/*XORs data in place with the masking key, the first byte takes the key's first byte.*/
+inline void websocket_mask(std::span<std::byte> data, uint32_t key) noexcept
+{
+	auto *pos = data.data();
+	auto *const end = pos + data.size();
+
+#if HFT_WEBSOCKET_AVX2
+	const auto wide = _mm256_set1_epi32(static_cast<int>(key));
+	for (; end - pos >= 32; pos += 32)
+	{
+		auto *lane = reinterpret_cast<__m256i *>(pos);
+		_mm256_storeu_si256(lane, _mm256_xor_si256(_mm256_loadu_si256(lane), wide));
+	}
+#elif HFT_WEBSOCKET_SSE2
+	const auto wide = _mm_set1_epi32(static_cast<int>(key));
+	for (; end - pos >= 16; pos += 16)
+	{
+		auto *lane = reinterpret_cast<__m128i *>(pos);
+		_mm_storeu_si128(lane, _mm_xor_si128(_mm_loadu_si128(lane), wide));
+	}
+#endif
+
+	// Chunks above are multiples of four, so the key phase is unchanged here.
+	const auto key64 = static_cast<uint64_t>(key) << 32 | key;
+	for (; end - pos >= 8; pos += 8)
+	{
+		core::store_le(pos, core::load_le<uint64_t>(pos) ^ key64);
+	}
+	for (size_t i = 0; pos != end; ++pos, ++i)
+	{
+		*pos ^= static_cast<std::byte>(key >> (8 * (i % 4)));
+	}
+}
+
+[[nodiscard]] auto base64_encode(std::span<const uint8_t> data) -> std::string;
+
+/*Sec-WebSocket-Accept value answering a Sec-WebSocket-Key.*/
+[[nodiscard]] auto websocket_accept_key(std::string_view key) -> std::string;
+
+enum class WsStatus : uint8_t
+{
+	Ok,
+
+	// A close frame arrived, or the connection ended.
+	Closed,
+
+	// Reserved bits, unknown opcodes, bad fragmentation or oversized control frames.
+	ProtocolError,
+
+	// A message that cannot fit in the buffer.
+	TooLarge
+};
+
+struct WsDecoderStats
+{
+	uint64_t frames {};
+
+	uint64_t messages {};
+
+	// Messages that came in more than one frame.
+	uint64_t fragmented {};
+
+	uint64_t control_frames {};
+
+	uint64_t payload_bytes {};
+};
+
+/*
+ * Turns the bytes in a MirroredBuffer into WebSocket messages without
+ * copying them out. Frames are unmasked where they lie. A message split
+ * into fragments is put together by moving each fragment's payload back
+ * over the headers before it, so the whole message ends up contiguous at
+ * the front of the buffer. Control frames may come between fragments and
+ * are handed over as they arrive. Extensions are not supported, frames
+ * with reserved bits set are protocol errors.
+ */
+class WebSocketDecoder
+{
+public:
+	explicit WebSocketDecoder(core::MirroredBuffer &buffer)
+		: m_buffer(buffer)
+	{
+	}
+
+	/*
+	 * Decodes every complete frame in the buffer and consumes it. Messages go
+	 * to on_message(payload, opcode), control frames to on_control(opcode,
+	 * payload). Payloads are spans into the buffer, valid until the callback
+	 * returns. Once anything but Ok is returned the decoder stays in that
+	 * state.
+	 */
+	template<typename OnMessage, typename OnControl>
+	auto decode(OnMessage &&on_message, OnControl &&on_control) -> WsStatus
+	{
+		while (m_status == WsStatus::Ok)
+		{
+			const auto data = m_buffer.readable();
+			const auto frame = data.subspan(m_scan);
+			const auto header = parse_ws_header(frame);
+			if (!header)
+			{
+				break;
+			}
+
+			m_status = validate(*header);
+			if (m_status != WsStatus::Ok) [[unlikely]]
+			{
+				break;
+			}
+			const auto frame_size = header->header_size + header->payload_size;
+			if (frame.size() < frame_size)
+			{
+				break;
+			}
+
+			auto *payload = frame.data() + header->header_size;
+			const auto size = static_cast<size_t>(header->payload_size);
+			if (header->masked)
+			{
+				websocket_mask({ payload, size }, header->mask_key);
+			}
+			++m_stats.frames;
+
+			if (is_control(header->opcode))
+			{
+				++m_stats.control_frames;
+				on_control(header->opcode, std::span<const std::byte> { payload, size });
+				m_status = header->opcode == WsOpcode::Close ? WsStatus::Closed : m_status;
+				// Inside a fragmented message the frame stays until the message is done.
+				if (m_scan == 0)
+				{
+					m_buffer.consume(frame_size);
+				}
+				else
+				{
+					m_scan += frame_size;
+				}
+				continue;
+			}
+
+			if (header->fin && !m_assembling) [[likely]]
+			{
+				++m_stats.messages;
+				m_stats.payload_bytes += size;
+				on_message(std::span<const std::byte> { payload, size }, header->opcode);
+				m_buffer.consume(frame_size);
+				continue;
+			}
+
+			if (!m_assembling)
+			{
+				m_assembling = true;
+				m_opcode = header->opcode;
+			}
+			std::memmove(data.data() + m_assembled, payload, size);
+			m_assembled += size;
+			m_scan += frame_size;
+
+			if (header->fin)
+			{
+				++m_stats.messages;
+				++m_stats.fragmented;
+				m_stats.payload_bytes += m_assembled;
+				on_message(std::span<const std::byte> { data.data(), m_assembled }, m_opcode);
+				m_buffer.consume(m_scan);
+				m_scan = 0;
+				m_assembled = 0;
+				m_assembling = false;
+			}
+		}
+		return m_status;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_stats() const noexcept -> const WsDecoderStats &
+	{
+		return m_stats;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_status() const noexcept -> WsStatus
+	{
+		return m_status;
+	}
+
+private:
+	[[nodiscard]] auto validate(const WsFrameHeader &header) const noexcept -> WsStatus
+	{
+		const auto opcode = static_cast<uint8_t>(header.opcode);
+		const auto known = opcode <= 0x2 || (opcode >= 0x8 && opcode <= 0xa);
+		if (header.rsv != 0 || !known)
+		{
+			return WsStatus::ProtocolError;
+		}
+		if (is_control(header.opcode) && (!header.fin || header.payload_size > WsFormat::MAX_CONTROL_PAYLOAD))
+		{
+			return WsStatus::ProtocolError;
+		}
+		// Continuations only inside a fragmented message, new messages only outside one.
+		if ((header.opcode == WsOpcode::Continuation) != m_assembling && !is_control(header.opcode))
+		{
+			return WsStatus::ProtocolError;
+		}
+		if (header.payload_size > m_buffer.capacity() - m_scan - header.header_size)
+		{
+			return WsStatus::TooLarge;
+		}
+		return WsStatus::Ok;
+	}
+
+	core::MirroredBuffer &m_buffer;
+
+	// Start of the next frame relative to the front of the buffer, nonzero only while assembling.
+	size_t m_scan {};
+
+	// Payload bytes of the fragmented message moved to the front so far.
+	size_t m_assembled {};
+
+	bool m_assembling {};
+
+	WsOpcode m_opcode {};
+
+	WsStatus m_status { WsStatus::Ok };
+
+	WsDecoderStats m_stats {};
+};
+
+} // namespace hft::feed
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <feed/websocket.hpp>
+
+namespace hft::feed {
+
+struct WebSocketConfig
+{
+	// IPv4 address of the server, dotted quad.
+	std::string host { "127.0.0.1" };
+
+	uint16_t port {};
+
+	std::string path { "/" };
+
+	// Receive ring, the largest message has to fit.
+	size_t buffer_size { 1 << 20 };
+};
+
+struct WebSocketStats
+{
+	uint64_t reads {};
+
+	uint64_t bytes {};
+
+	uint64_t pings {};
+
+	uint64_t pongs_sent {};
+};
+
+/*
+ * Client side of a WebSocket stream over plain TCP. After the upgrade the
+ * socket is non-blocking and poll() reads whatever arrived straight into
+ * the mirrored receive ring and hands complete messages to the caller in
+ * place (see WebSocketDecoder). Pings are answered from within poll(), a
+ * close from the server is echoed. TLS is left to a terminating proxy.
+ */
+class WebSocketClient
+{
+public:
+	/*Connects and upgrades, throws std::runtime_error on failure.*/
+	explicit WebSocketClient(const WebSocketConfig &config);
+
+	WebSocketClient(const WebSocketClient &) = delete;
+
+	WebSocketClient(WebSocketClient &&) = delete;
+
+	auto operator=(const WebSocketClient &) -> WebSocketClient & = delete;
+
+	auto operator=(WebSocketClient &&) -> WebSocketClient & = delete;
+
+	~WebSocketClient();
+
+	/*
+	 * One read, then on_message(payload, opcode) for every message now
+	 * complete. Returns Ok while the connection is usable.
+	 */
+	template<typename OnMessage>
+	auto poll(OnMessage &&on_message) -> WsStatus
+	{
+		if (!receive()) [[unlikely]]
+		{
+			return WsStatus::Closed;
+		}
+		return m_decoder.decode(
+			on_message, [this](WsOpcode opcode, std::span<const std::byte> payload) { on_control(opcode, payload); }
+		);
+	}
+
+	/*Sends one masked frame, blocking until it is written.*/
+	auto send(std::span<const std::byte> payload, WsOpcode opcode = WsOpcode::Text) -> bool;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_stats() const noexcept -> const WebSocketStats &
+	{
+		return m_stats;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_decoder() const noexcept -> const WebSocketDecoder &
+	{
+		return m_decoder;
+	}
+
+private:
+	void handshake(const WebSocketConfig &config);
+
+	/*Reads what the socket has into the ring, false once the connection is gone.*/
+	auto receive() -> bool;
+
+	void on_control(WsOpcode opcode, std::span<const std::byte> payload);
+
+	int m_fd = -1;
+
+	core::MirroredBuffer m_buffer;
+
+	WebSocketDecoder m_decoder { m_buffer };
+
+	std::mt19937 m_mask_keys { std::random_device {}() };
+
+	WebSocketStats m_stats {};
+
+	// Set once a close went out, no frames may follow it.
+	bool m_closing {};
+};
+
+} // namespace hft::feed
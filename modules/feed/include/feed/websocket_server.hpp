@@ -0,0 +1,71 @@
+#pragma once
+
+#include <feed/websocket.hpp>
+
+namespace hft::feed {
+
+/*
+ * Minimal blocking WebSocket server on the loopback interface, standing in
+ * for a venue when replaying captures to a WebSocketClient in tests and
+ * benchmarks. Serves one client at a time, sends unmasked frames.
+ */
+class WebSocketReplayServer
+{
+public:
+	/*Listens on 127.0.0.1, 0 picks a free port. Throws std::runtime_error on failure.*/
+	explicit WebSocketReplayServer(uint16_t port = 0);
+
+	WebSocketReplayServer(const WebSocketReplayServer &) = delete;
+
+	WebSocketReplayServer(WebSocketReplayServer &&) = delete;
+
+	auto operator=(const WebSocketReplayServer &) -> WebSocketReplayServer & = delete;
+
+	auto operator=(WebSocketReplayServer &&) -> WebSocketReplayServer & = delete;
+
+	~WebSocketReplayServer();
+
+	/*
+	 * Waits for a client and answers its upgrade request, throws
+	 * std::runtime_error on failure. lowercase_headers answers the way some
+	 * proxies do: lowercase names, no space after the colon, extra tokens.
+	 */
+	void accept(bool lowercase_headers = false);
+
+	/*Sends payload as one message, in frames of at most fragment bytes when that is nonzero.*/
+	auto send(std::span<const std::byte> payload, WsOpcode opcode = WsOpcode::Binary, size_t fragment = 0) -> bool;
+
+	/*Sends one binary message per payload with a single write.*/
+	auto send_batch(std::span<const std::span<const std::byte>> payloads) -> bool;
+
+	auto send_frame(WsOpcode opcode, bool fin, std::span<const std::byte> payload) -> bool;
+
+	/*Writes bytes as they are, for malformed frames.*/
+	auto send_raw(std::span<const std::byte> bytes) -> bool;
+
+	/*Next frame from the client, unmasked, blocking. nullopt once the connection ends.*/
+	auto receive() -> std::optional<std::pair<WsOpcode, std::vector<std::byte>>>;
+
+	/*Drops the client connection.*/
+	void disconnect();
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_port() const noexcept -> uint16_t
+	{
+		return m_port;
+	}
+
+private:
+	int m_listen_fd = -1;
+
+	int m_fd = -1;
+
+	uint16_t m_port {};
+
+	// Client bytes read past the last frame returned.
+	std::vector<std::byte> m_received;
+
+	std::vector<std::byte> m_frames;
+};
+
+} // namespace hft::feed
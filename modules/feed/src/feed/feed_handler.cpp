@@ -0,0 +1,338 @@
+#include <arpa/inet.h>
+#include <feed/feed_handler.hpp>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+using namespace hft::orderbook;
+
+namespace hft::feed {
+
+namespace {
+
+static_assert(CMSG_SPACE(sizeof(scm_timestamping)) <= FeedHandler::CONTROL_SIZE);
+
+auto realtime_ns() -> uint64_t
+{
+	timespec now {};
+	::clock_gettime(CLOCK_REALTIME, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(now.tv_nsec);
+}
+
+auto to_ns(const timespec &ts) -> uint64_t
+{
+	return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+FeedHandler::FeedHandler(const FeedConfig &config, OrderBook &book)
+	: m_book(book)
+	, m_mode(config.mode)
+{
+	const auto fail = [&](const std::string &what)
+	{
+		const auto error = errno;
+		if (m_fd >= 0)
+		{
+			::close(m_fd);
+		}
+		throw std::runtime_error(what + " " + config.group + ":" + std::to_string(config.port) + ": " + std::strerror(error));
+	};
+
+	const auto flags = config.mode == ReceiveMode::Spin ? SOCK_NONBLOCK : 0;
+	m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | flags, 0);
+	if (m_fd < 0)
+	{
+		fail("Cannot open feed socket for");
+	}
+
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(config.port);
+	ip_mreq membership {};
+	if (::inet_pton(AF_INET, config.group.c_str(), &address.sin_addr) != 1 ||
+		::inet_pton(AF_INET, config.interface.c_str(), &membership.imr_interface) != 1)
+	{
+		errno = EINVAL;
+		fail("Bad feed address");
+	}
+	membership.imr_multiaddr = address.sin_addr;
+
+	// Bound to the group so datagrams for other groups on the port stay out.
+	const int reuse = 1;
+	if (::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+		::bind(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		fail("Cannot bind feed");
+	}
+
+	socklen_t length = sizeof(address);
+	::getsockname(m_fd, reinterpret_cast<sockaddr *>(&address), &length);
+	m_port = ntohs(address.sin_port);
+
+	if (::setsockopt(m_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0)
+	{
+		fail("Cannot join feed");
+	}
+
+	if (config.receive_buffer != 0 &&
+		::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &config.receive_buffer, sizeof(config.receive_buffer)) != 0)
+	{
+		fail("Cannot size receive buffer of feed");
+	}
+
+	if (config.busy_poll_us != 0)
+	{
+		const auto busy_poll = static_cast<int>(config.busy_poll_us);
+		if (::setsockopt(m_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)) != 0)
+		{
+			fail("Cannot enable busy polling on feed");
+		}
+	}
+
+	if (config.mode == ReceiveMode::Blocking)
+	{
+		const timeval timeout {
+			static_cast<time_t>(config.poll_timeout_ms / 1000),
+			static_cast<suseconds_t>(config.poll_timeout_ms % 1000 * 1000),
+		};
+		if (::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0)
+		{
+			fail("Cannot set receive timeout of feed");
+		}
+	}
+
+	// Hardware stamps only show up once the interface is configured for them, software ones always do.
+	const int stamping = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+						 SOF_TIMESTAMPING_RAW_HARDWARE;
+	if (::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPING, &stamping, sizeof(stamping)) != 0)
+	{
+		fail("Cannot enable timestamping on feed");
+	}
+
+	for (size_t i = 0; i < BATCH; ++i)
+	{
+		m_iovecs[i] = { m_buffers[i].data(), MAX_PACKET };
+		m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+		m_headers[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+FeedHandler::~FeedHandler()
+{
+	::close(m_fd);
+}
+
+auto FeedHandler::poll() -> size_t
+{
+	// The kernel shrinks msg_controllen to what it wrote, every batch starts from the full size.
+	for (size_t i = 0; i < BATCH; ++i)
+	{
+		m_headers[i].msg_hdr.msg_control = m_control[i].data();
+		m_headers[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+	}
+
+	const auto flags = m_mode == ReceiveMode::Spin ? MSG_DONTWAIT : MSG_WAITFORONE;
+	const auto received = ::recvmmsg(m_fd, m_headers.data(), BATCH, flags, nullptr);
+	if (received <= 0)
+	{
+		if (m_arbiter && m_arbiter->get_held() != 0)
+		{
+			expire_held(realtime_ns());
+		}
+		return 0;
+	}
+
+	const auto returned_ns = realtime_ns();
+	const auto count = static_cast<size_t>(received);
+	++m_stats.batches;
+	m_stats.packets += count;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto &header = m_headers[i];
+		const auto stamps = kernel_timestamps(header.msg_hdr);
+		m_stats.timestamped += stamps.software_ns != 0 ? 1U : 0U;
+		m_stats.hardware_timestamped += stamps.hardware_ns != 0 ? 1U : 0U;
+		m_last_hardware_ns = stamps.hardware_ns;
+		// The hardware stamp is on the NIC's clock, subtracting it from wall time would measure the clock offset.
+		const auto receive_ns = stamps.software_ns != 0 ? stamps.software_ns : returned_ns;
+
+		if ((header.msg_hdr.msg_flags & MSG_TRUNC) != 0) [[unlikely]]
+		{
+			++m_stats.malformed;
+			continue;
+		}
+		on_packet(m_buffers[i].data(), header.msg_len, receive_ns);
+	}
+
+	if (m_arbiter && m_arbiter->get_held() != 0)
+	{
+		expire_held(realtime_ns());
+	}
+	return count;
+}
+
+void FeedHandler::run(const std::atomic<bool> &stop)
+{
+	while (!stop.load(std::memory_order_relaxed))
+	{
+		poll();
+	}
+}
+
+void FeedHandler::set_arbiter(LineArbiter &arbiter, size_t line)
+{
+	assert(line < arbiter.get_line_count());
+	m_arbiter = &arbiter;
+	m_line = line;
+}
+
+void FeedHandler::on_packet(const std::byte *data, size_t size, uint64_t receive_ns)
+{
+	std::span<const std::byte> rest { data, size };
+	while (!rest.empty())
+	{
+		const auto view = DeltaMessageView::parse(rest);
+		if (!view) [[unlikely]]
+		{
+			++m_stats.malformed;
+			break;
+		}
+		const auto message = rest.first(view->get_message_size());
+		rest = rest.subspan(view->get_message_size());
+		++m_stats.messages;
+
+		const auto sequence = view->get_sequence();
+		if (m_arbiter)
+		{
+			if (!m_arbiter->accept(m_line, sequence))
+			{
+				++m_stats.stale;
+				continue;
+			}
+			deliver(*view, message, receive_ns);
+			continue;
+		}
+
+		if (m_sequence != 0 && sequence <= m_sequence) [[unlikely]]
+		{
+			++m_stats.stale;
+			continue;
+		}
+		if (m_sequence != 0 && sequence != m_sequence + 1) [[unlikely]]
+		{
+			++m_stats.gaps;
+		}
+		m_sequence = sequence;
+		apply(*view, sequence);
+	}
+
+	const auto applied_ns = realtime_ns();
+	const auto latency = applied_ns > receive_ns ? applied_ns - receive_ns : 0;
+	m_stats.latency_total_ns += latency;
+	m_stats.latency_max_ns = std::max(m_stats.latency_max_ns, latency);
+}
+
+void FeedHandler::deliver(const DeltaMessageView &view, std::span<const std::byte> message, uint64_t receive_ns)
+{
+	const auto sequence = view.get_sequence();
+	const auto next = m_arbiter->get_next_apply();
+	if (next == 0 || sequence == next) [[likely]]
+	{
+		apply(view, sequence);
+		m_arbiter->set_applied(sequence);
+		release_held();
+		return;
+	}
+
+	if (sequence < next) [[unlikely]]
+	{
+		// Fills a gap given up on, the book already holds newer state for its levels.
+		++m_stats.stale;
+		return;
+	}
+
+	if (m_arbiter->hold(sequence, message, receive_ns))
+	{
+		return;
+	}
+
+	// Too far ahead to wait for the gap: apply what is held, then this one.
+	while (m_arbiter->get_held() != 0)
+	{
+		m_arbiter->skip_gap();
+		++m_stats.gaps;
+		release_held();
+	}
+	++m_stats.gaps;
+	apply(view, sequence);
+	m_arbiter->set_applied(sequence);
+}
+
+void FeedHandler::apply(const DeltaMessageView &view, uint64_t sequence)
+{
+	for (const auto change : view)
+	{
+		const auto qty = change.action == LevelAction::Remove ? 0 : change.quantity;
+		if (change.side == Side::Bid)
+		{
+			m_book.update_bid_side(change.price, qty);
+		}
+		else
+		{
+			m_book.update_ask_side(change.price, qty);
+		}
+	}
+	m_stats.changes += view.size();
+	m_book.set_sequence(sequence);
+}
+
+void FeedHandler::release_held()
+{
+	for (auto held = m_arbiter->take_next(); !held.empty(); held = m_arbiter->take_next())
+	{
+		// Parsed once already when it arrived.
+		const auto view = DeltaMessageView::parse(held);
+		assert(view);
+		apply(*view, view->get_sequence());
+		m_arbiter->set_applied(view->get_sequence());
+	}
+}
+
+void FeedHandler::expire_held(uint64_t now_ns)
+{
+	while (m_arbiter->get_held() != 0)
+	{
+		const auto since_ns = m_arbiter->get_held_since();
+		if (now_ns < since_ns + m_arbiter->get_hold_ns())
+		{
+			return;
+		}
+		m_arbiter->skip_gap();
+		++m_stats.gaps;
+		release_held();
+	}
+}
+
+auto FeedHandler::kernel_timestamps(const msghdr &header) -> ReceiveStamps
+{
+	for (auto *cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr *>(&header), cmsg))
+	{
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING)
+		{
+			scm_timestamping stamps;
+			std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+			// ts[0] is the software stamp, ts[2] the raw hardware one, ts[1] is unused.
+			return {
+				.software_ns = stamps.ts[0].tv_sec != 0 ? to_ns(stamps.ts[0]) : 0,
+				.hardware_ns = stamps.ts[2].tv_sec != 0 ? to_ns(stamps.ts[2]) : 0,
+			};
+		}
+	}
+	return {};
+}
+
+} // namespace hft::feed
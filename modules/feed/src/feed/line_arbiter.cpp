@@ -0,0 +1,166 @@
+#include <feed/line_arbiter.hpp>
+
+namespace hft::feed {
+
+LineArbiter::LineArbiter(size_t lines, uint64_t hold_ns)
+	: m_lines(lines)
+	, m_hold_ns(hold_ns)
+	, m_held(HOLD)
+{
+	if (lines == 0 || lines > MAX_LINES)
+	{
+		throw std::runtime_error("Line arbiter takes 1 to " + std::to_string(MAX_LINES) + " lines");
+	}
+}
+
+auto LineArbiter::accept(size_t line, uint64_t sequence) -> bool
+{
+	assert(line < m_lines);
+	++m_received[line];
+
+	if (sequence > m_highest) [[likely]]
+	{
+		if (m_first == 0) [[unlikely]]
+		{
+			// Everything before the first message counts as seen, so none of it is reported lost.
+			m_first = sequence;
+			m_highest = sequence - 1;
+			m_seen.fill(~uint64_t {});
+		}
+		m_stats.skipped += sequence - m_highest - 1;
+		advance(sequence);
+		m_highest = sequence;
+	}
+	else
+	{
+		if (m_first == 0 || sequence < m_first || m_highest - sequence >= WINDOW) [[unlikely]]
+		{
+			++m_stats.late;
+			return false;
+		}
+
+		const auto slot = sequence % WINDOW;
+		const auto bit = uint64_t { 1 } << (slot % 64);
+		if ((m_seen[slot / 64] & bit) != 0)
+		{
+			++m_stats.duplicates;
+			return false;
+		}
+		++m_stats.filled;
+	}
+
+	const auto slot = sequence % WINDOW;
+	m_seen[slot / 64] |= uint64_t { 1 } << (slot % 64);
+	++m_stats.delivered;
+	++m_wins[line];
+	return true;
+}
+
+auto LineArbiter::get_pending() const -> uint64_t
+{
+	if (m_first == 0)
+	{
+		return 0;
+	}
+
+	uint64_t seen = 0;
+	for (const auto word : m_seen)
+	{
+		seen += static_cast<uint64_t>(std::popcount(word));
+	}
+	return WINDOW - seen;
+}
+
+auto LineArbiter::hold(uint64_t sequence, std::span<const std::byte> message, uint64_t receive_ns) -> bool
+{
+	assert(sequence > m_next_apply);
+	if (sequence - m_next_apply >= HOLD || message.size() > MAX_MESSAGE)
+	{
+		return false;
+	}
+
+	auto &held = m_held[sequence % HOLD];
+	assert(held.sequence == 0);
+	held.sequence = sequence;
+	held.receive_ns = receive_ns;
+	held.size = message.size();
+	std::memcpy(held.data.data(), message.data(), message.size());
+	++m_held_count;
+	++m_stats.held;
+	return true;
+}
+
+auto LineArbiter::take_next() -> std::span<const std::byte>
+{
+	if (m_held_count == 0)
+	{
+		return {};
+	}
+
+	auto &held = m_held[m_next_apply % HOLD];
+	if (held.sequence != m_next_apply)
+	{
+		return {};
+	}
+	held.sequence = 0;
+	--m_held_count;
+	return { held.data.data(), held.size };
+}
+
+auto LineArbiter::skip_gap() -> uint64_t
+{
+	for (uint64_t ahead = 1; m_held_count != 0 && ahead < HOLD; ++ahead)
+	{
+		if (m_held[(m_next_apply + ahead) % HOLD].sequence == m_next_apply + ahead)
+		{
+			m_next_apply += ahead;
+			++m_stats.abandoned;
+			return ahead;
+		}
+	}
+	return 0;
+}
+
+auto LineArbiter::get_held_since() const -> uint64_t
+{
+	for (uint64_t ahead = 1; m_held_count != 0 && ahead < HOLD; ++ahead)
+	{
+		const auto &held = m_held[(m_next_apply + ahead) % HOLD];
+		if (held.sequence == m_next_apply + ahead)
+		{
+			return held.receive_ns;
+		}
+	}
+	return 0;
+}
+
+void LineArbiter::advance(uint64_t sequence)
+{
+	const auto count = sequence - m_highest;
+	if (count >= WINDOW) [[unlikely]]
+	{
+		// The whole window leaves, along with whatever was jumped over beyond it.
+		m_stats.lost += get_pending() + (count - WINDOW);
+		m_seen.fill(0);
+		return;
+	}
+
+	// Slot of each new sequence held the one WINDOW before it, which now leaves the window.
+	auto slot = (m_highest + 1) % WINDOW;
+	auto remaining = count;
+	while (remaining != 0)
+	{
+		const auto offset = slot % 64;
+		const auto bits = std::min<uint64_t>(64 - offset, remaining);
+		const auto mask = (bits == 64 ? ~uint64_t {} : (uint64_t { 1 } << bits) - 1) << offset;
+		auto &word = m_seen[slot / 64];
+
+		m_stats.lost += bits - static_cast<uint64_t>(std::popcount(word & mask));
+		word &= ~mask;
+
+		slot = (slot + bits) % WINDOW;
+		remaining -= bits;
+	}
+}
+
+} // namespace hft::feed
@@ -0,0 +1,67 @@
+#include <arpa/inet.h>
+#include <feed/multicast_publisher.hpp>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace hft::feed {
+
+MulticastPublisher::MulticastPublisher(const std::string &group, uint16_t port, const std::string &interface, int ttl)
+{
+	m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error(std::string("Cannot open publisher socket: ") + std::strerror(errno));
+	}
+
+	in_addr local {};
+	sockaddr_in destination {};
+	destination.sin_family = AF_INET;
+	destination.sin_port = htons(port);
+
+	const int loop = 1;
+	const auto ok = ::inet_pton(AF_INET, interface.c_str(), &local) == 1 &&
+					::inet_pton(AF_INET, group.c_str(), &destination.sin_addr) == 1 &&
+					::setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) == 0 &&
+					::setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0 &&
+					::setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) == 0 &&
+					// Connected, so sends need no address.
+					::connect(m_fd, reinterpret_cast<const sockaddr *>(&destination), sizeof(destination)) == 0;
+	if (!ok)
+	{
+		const auto error = errno;
+		::close(m_fd);
+		throw std::runtime_error(
+			"Cannot publish to " + group + ":" + std::to_string(port) + " via " + interface + ": " + std::strerror(error)
+		);
+	}
+}
+
+MulticastPublisher::~MulticastPublisher()
+{
+	::close(m_fd);
+}
+
+auto MulticastPublisher::send(std::span<const std::byte> packet) -> bool
+{
+	return ::send(m_fd, packet.data(), packet.size(), 0) == static_cast<ssize_t>(packet.size());
+}
+
+auto MulticastPublisher::send_batch(std::span<const std::span<const std::byte>> packets) -> size_t
+{
+	const auto count = std::min(packets.size(), BATCH);
+
+	std::array<iovec, BATCH> iovecs;
+	std::array<mmsghdr, BATCH> headers {};
+	for (size_t i = 0; i < count; ++i)
+	{
+		iovecs[i] = { const_cast<std::byte *>(packets[i].data()), packets[i].size() };
+		headers[i].msg_hdr.msg_iov = &iovecs[i];
+		headers[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	const auto sent = ::sendmmsg(m_fd, headers.data(), static_cast<unsigned>(count), 0);
+	return sent > 0 ? static_cast<size_t>(sent) : 0;
+}
+
+} // namespace hft::feed
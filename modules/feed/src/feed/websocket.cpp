@@ -0,0 +1,114 @@
+#include <feed/websocket.hpp>
+
+namespace hft::feed {
+
+namespace {
+
+constexpr std::string_view HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+/*Plain SHA-1, only ever run over the short handshake key.*/
+auto sha1(std::string_view input) -> std::array<uint8_t, 20>
+{
+	std::array<uint32_t, 5> state { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+	std::string message(input);
+	message.push_back('\x80');
+	while (message.size() % 64 != 56)
+	{
+		message.push_back('\0');
+	}
+	const auto bits = static_cast<uint64_t>(input.size()) * 8;
+	for (int shift = 56; shift >= 0; shift -= 8)
+	{
+		message.push_back(static_cast<char>(bits >> shift));
+	}
+
+	for (size_t chunk = 0; chunk < message.size(); chunk += 64)
+	{
+		std::array<uint32_t, 80> w {};
+		for (size_t i = 0; i < 16; ++i)
+		{
+			for (size_t b = 0; b < 4; ++b)
+			{
+				w[i] = w[i] << 8 | static_cast<uint8_t>(message[chunk + 4 * i + b]);
+			}
+		}
+		for (size_t i = 16; i < 80; ++i)
+		{
+			w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		}
+
+		auto [a, b, c, d, e] = state;
+		for (size_t i = 0; i < 80; ++i)
+		{
+			uint32_t f = 0;
+			uint32_t k = 0;
+			if (i < 20)
+			{
+				f = (b & c) | (~b & d);
+				k = 0x5a827999;
+			}
+			else if (i < 40)
+			{
+				f = b ^ c ^ d;
+				k = 0x6ed9eba1;
+			}
+			else if (i < 60)
+			{
+				f = (b & c) | (b & d) | (c & d);
+				k = 0x8f1bbcdc;
+			}
+			else
+			{
+				f = b ^ c ^ d;
+				k = 0xca62c1d6;
+			}
+			const auto next = std::rotl(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = std::rotl(b, 30);
+			b = a;
+			a = next;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+	}
+
+	std::array<uint8_t, 20> digest {};
+	for (size_t i = 0; i < digest.size(); ++i)
+	{
+		digest[i] = static_cast<uint8_t>(state[i / 4] >> (24 - 8 * (i % 4)));
+	}
+	return digest;
+}
+
+} // namespace
+
+auto base64_encode(std::span<const uint8_t> data) -> std::string
+{
+	constexpr std::string_view ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string out;
+	for (size_t i = 0; i < data.size(); i += 3)
+	{
+		const auto remaining = data.size() - i;
+		const uint32_t group = static_cast<uint32_t>(data[i]) << 16 |
+							   (remaining > 1 ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+							   (remaining > 2 ? static_cast<uint32_t>(data[i + 2]) : 0);
+		out.push_back(ALPHABET[group >> 18 & 0x3f]);
+		out.push_back(ALPHABET[group >> 12 & 0x3f]);
+		out.push_back(remaining > 1 ? ALPHABET[group >> 6 & 0x3f] : '=');
+		out.push_back(remaining > 2 ? ALPHABET[group & 0x3f] : '=');
+	}
+	return out;
+}
+
+auto websocket_accept_key(std::string_view key) -> std::string
+{
+	const auto digest = sha1(std::string(key) + std::string(HANDSHAKE_GUID));
+	return base64_encode(digest);
+}
+
+} // namespace hft::feed
@@ -0,0 +1,250 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <feed/websocket_client.hpp>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace hft::feed {
+
+namespace {
+
+/*Writes all of data, waiting out a full send buffer.*/
+auto write_all(int fd, std::span<const std::byte> data) -> bool
+{
+	while (!data.empty())
+	{
+		const auto sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+		if (sent > 0)
+		{
+			data = data.subspan(static_cast<size_t>(sent));
+			continue;
+		}
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		{
+			pollfd waiting { fd, POLLOUT, 0 };
+			::poll(&waiting, 1, -1);
+			continue;
+		}
+		return false;
+	}
+	return true;
+}
+
+auto equals_ignore_case(std::string_view a, std::string_view b) -> bool
+{
+	return std::ranges::equal(a, b, [](unsigned char x, unsigned char y) { return std::tolower(x) == std::tolower(y); });
+}
+
+auto trim(std::string_view text) -> std::string_view
+{
+	const auto first = text.find_first_not_of(" \t");
+	if (first == std::string_view::npos)
+	{
+		return {};
+	}
+	return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+/*Value of the first header line called name, names compare case insensitively. nullopt when there is none.*/
+auto find_header(std::string_view head, std::string_view name) -> std::optional<std::string_view>
+{
+	// Past the status line.
+	auto rest = head.substr(std::min(head.find("\r\n"), head.size()));
+	while (!rest.empty())
+	{
+		rest.remove_prefix(std::min<size_t>(2, rest.size()));
+		const auto line = rest.substr(0, rest.find("\r\n"));
+		rest.remove_prefix(line.size());
+
+		const auto colon = line.find(':');
+		if (colon != std::string_view::npos && equals_ignore_case(trim(line.substr(0, colon)), name))
+		{
+			return trim(line.substr(colon + 1));
+		}
+	}
+	return std::nullopt;
+}
+
+/*Whether the comma separated header value lists token, as in Connection: keep-alive, Upgrade.*/
+auto has_token(std::string_view value, std::string_view token) -> bool
+{
+	while (!value.empty())
+	{
+		const auto comma = std::min(value.find(','), value.size());
+		if (equals_ignore_case(trim(value.substr(0, comma)), token))
+		{
+			return true;
+		}
+		value.remove_prefix(std::min(comma + 1, value.size()));
+	}
+	return false;
+}
+
+} // namespace
+
+WebSocketClient::WebSocketClient(const WebSocketConfig &config)
+	: m_buffer(config.buffer_size)
+{
+	const auto fail = [&](const std::string &what)
+	{
+		const auto error = errno;
+		if (m_fd >= 0)
+		{
+			::close(m_fd);
+		}
+		throw std::runtime_error(
+			what + " " + config.host + ":" + std::to_string(config.port) + config.path + ": " + std::strerror(error)
+		);
+	};
+
+	m_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (m_fd < 0)
+	{
+		fail("Cannot open socket for");
+	}
+
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(config.port);
+	if (::inet_pton(AF_INET, config.host.c_str(), &address.sin_addr) != 1)
+	{
+		errno = EINVAL;
+		fail("Bad address");
+	}
+
+	// Depth messages are small, they should not wait for more to coalesce with.
+	const int on = 1;
+	const timeval timeout { 5, 0 };
+	if (::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) != 0 ||
+		::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+		::connect(m_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		fail("Cannot connect to");
+	}
+
+	try
+	{
+		handshake(config);
+	}
+	catch (const std::runtime_error &error)
+	{
+		fail(error.what());
+	}
+
+	if (::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK) != 0)
+	{
+		fail("Cannot make socket non-blocking for");
+	}
+}
+
+WebSocketClient::~WebSocketClient()
+{
+	::close(m_fd);
+}
+
+auto WebSocketClient::send(std::span<const std::byte> payload, WsOpcode opcode) -> bool
+{
+	if (m_closing)
+	{
+		return false;
+	}
+
+	std::vector<std::byte> frame(WsFormat::MAX_HEADER_SIZE + payload.size());
+	const auto key = static_cast<uint32_t>(m_mask_keys());
+	const auto header_size = write_ws_header(frame.data(), opcode, true, payload.size(), key);
+	std::memcpy(frame.data() + header_size, payload.data(), payload.size());
+	websocket_mask({ frame.data() + header_size, payload.size() }, key);
+
+	m_closing = opcode == WsOpcode::Close;
+	return write_all(m_fd, std::span(frame).first(header_size + payload.size()));
+}
+
+void WebSocketClient::handshake(const WebSocketConfig &config)
+{
+	std::array<uint8_t, 16> nonce {};
+	for (auto &byte : nonce)
+	{
+		byte = static_cast<uint8_t>(m_mask_keys());
+	}
+	const auto key = base64_encode(nonce);
+
+	const auto request = "GET " + config.path + " HTTP/1.1\r\nHost: " + config.host + ":" + std::to_string(config.port) +
+						 "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+						 "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+	if (!write_all(m_fd, std::as_bytes(std::span(request))))
+	{
+		throw std::runtime_error("Cannot send upgrade request to");
+	}
+
+	// Frames may follow the response in the same read, they stay in the ring.
+	while (true)
+	{
+		const auto received = m_buffer.readable();
+		const std::string_view response(reinterpret_cast<const char *>(received.data()), received.size());
+		const auto end = response.find("\r\n\r\n");
+		if (end != std::string_view::npos)
+		{
+			// Header names are case insensitive and the space after the colon optional, proxies vary.
+			const auto head = response.substr(0, end);
+			const auto upgrade = find_header(head, "Upgrade");
+			const auto connection = find_header(head, "Connection");
+			const auto accept = find_header(head, "Sec-WebSocket-Accept");
+			if (!head.starts_with("HTTP/1.1 101") || !upgrade || !equals_ignore_case(*upgrade, "websocket") ||
+				!connection || !has_token(*connection, "Upgrade") || accept != websocket_accept_key(key))
+			{
+				errno = EPROTO;
+				throw std::runtime_error("Upgrade refused by");
+			}
+			m_buffer.consume(end + 4);
+			return;
+		}
+
+		const auto space = m_buffer.writable();
+		const auto count = space.empty() ? -1 : ::recv(m_fd, space.data(), space.size(), 0);
+		if (count <= 0)
+		{
+			errno = count == 0 ? ECONNRESET : errno;
+			throw std::runtime_error("No upgrade response from");
+		}
+		m_buffer.commit(static_cast<size_t>(count));
+	}
+}
+
+auto WebSocketClient::receive() -> bool
+{
+	const auto space = m_buffer.writable();
+	if (space.empty()) [[unlikely]]
+	{
+		// Nothing to read into, the decoder reports the message as too large.
+		return true;
+	}
+
+	const auto count = ::recv(m_fd, space.data(), space.size(), 0);
+	if (count > 0)
+	{
+		++m_stats.reads;
+		m_stats.bytes += static_cast<uint64_t>(count);
+		m_buffer.commit(static_cast<size_t>(count));
+		return true;
+	}
+	return count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+}
+
+void WebSocketClient::on_control(WsOpcode opcode, std::span<const std::byte> payload)
+{
+	if (opcode == WsOpcode::Ping)
+	{
+		++m_stats.pings;
+		m_stats.pongs_sent += send(payload, WsOpcode::Pong) ? 1U : 0U;
+	}
+	else if (opcode == WsOpcode::Close && !m_closing)
+	{
+		// Echo the status code only.
+		send(payload.first(std::min<size_t>(payload.size(), 2)), WsOpcode::Close);
+	}
+}
+
+} // namespace hft::feed
@@ -0,0 +1,196 @@
+#include <arpa/inet.h>
+#include <feed/websocket_server.hpp>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace hft::feed {
+
+namespace {
+
+void append_frame(std::vector<std::byte> &out, WsOpcode opcode, bool fin, std::span<const std::byte> payload)
+{
+	const auto offset = out.size();
+	out.resize(offset + WsFormat::MAX_HEADER_SIZE + payload.size());
+	const auto header_size = write_ws_header(out.data() + offset, opcode, fin, payload.size());
+	std::memcpy(out.data() + offset + header_size, payload.data(), payload.size());
+	out.resize(offset + header_size + payload.size());
+}
+
+} // namespace
+
+WebSocketReplayServer::WebSocketReplayServer(uint16_t port)
+{
+	m_listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const int reuse = 1;
+	socklen_t length = sizeof(address);
+	if (m_listen_fd < 0 || ::setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+		::bind(m_listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+		::listen(m_listen_fd, 1) != 0 ||
+		::getsockname(m_listen_fd, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+	{
+		const auto error = errno;
+		if (m_listen_fd >= 0)
+		{
+			::close(m_listen_fd);
+		}
+		throw std::runtime_error(
+			"Cannot listen on 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(error)
+		);
+	}
+	m_port = ntohs(address.sin_port);
+}
+
+WebSocketReplayServer::~WebSocketReplayServer()
+{
+	disconnect();
+	::close(m_listen_fd);
+}
+
+void WebSocketReplayServer::accept(bool lowercase_headers)
+{
+	disconnect();
+	m_fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error(std::string("Cannot accept: ") + std::strerror(errno));
+	}
+	const int on = 1;
+	::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+	std::string request;
+	std::array<char, 1024> chunk {};
+	while (request.find("\r\n\r\n") == std::string::npos)
+	{
+		const auto count = ::recv(m_fd, chunk.data(), chunk.size(), 0);
+		if (count <= 0)
+		{
+			disconnect();
+			throw std::runtime_error("Client left before upgrading");
+		}
+		request.append(chunk.data(), static_cast<size_t>(count));
+	}
+
+	constexpr std::string_view KEY_HEADER = "Sec-WebSocket-Key: ";
+	const auto key_start = request.find(KEY_HEADER);
+	if (key_start == std::string::npos)
+	{
+		disconnect();
+		throw std::runtime_error("Upgrade request without a key");
+	}
+	const auto key_begin = key_start + KEY_HEADER.size();
+	const auto key = std::string_view(request).substr(key_begin, request.find("\r\n", key_begin) - key_begin);
+
+	// The client sends nothing but the request before the response, so no frames are lost here.
+	const std::string headers = lowercase_headers
+									? "upgrade:websocket\r\nconnection: keep-alive, upgrade\r\nsec-websocket-accept:"
+									: "Upgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ";
+	const auto response =
+		"HTTP/1.1 101 Switching Protocols\r\n" + headers + websocket_accept_key(key) + "\r\n\r\n";
+	if (!send_raw(std::as_bytes(std::span(response))))
+	{
+		disconnect();
+		throw std::runtime_error("Cannot answer upgrade request");
+	}
+}
+
+auto WebSocketReplayServer::send(std::span<const std::byte> payload, WsOpcode opcode, size_t fragment) -> bool
+{
+	m_frames.clear();
+	if (fragment == 0 || payload.size() <= fragment)
+	{
+		append_frame(m_frames, opcode, true, payload);
+	}
+	else
+	{
+		for (size_t offset = 0; offset < payload.size(); offset += fragment)
+		{
+			const auto size = std::min(fragment, payload.size() - offset);
+			append_frame(
+				m_frames, offset == 0 ? opcode : WsOpcode::Continuation, offset + size == payload.size(),
+				payload.subspan(offset, size)
+			);
+		}
+	}
+	return send_raw(m_frames);
+}
+
+auto WebSocketReplayServer::send_batch(std::span<const std::span<const std::byte>> payloads) -> bool
+{
+	m_frames.clear();
+	for (const auto payload : payloads)
+	{
+		append_frame(m_frames, WsOpcode::Binary, true, payload);
+	}
+	return send_raw(m_frames);
+}
+
+auto WebSocketReplayServer::send_frame(WsOpcode opcode, bool fin, std::span<const std::byte> payload) -> bool
+{
+	m_frames.clear();
+	append_frame(m_frames, opcode, fin, payload);
+	return send_raw(m_frames);
+}
+
+auto WebSocketReplayServer::send_raw(std::span<const std::byte> bytes) -> bool
+{
+	while (!bytes.empty())
+	{
+		const auto sent = ::send(m_fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+		if (sent <= 0)
+		{
+			if (sent < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		bytes = bytes.subspan(static_cast<size_t>(sent));
+	}
+	return true;
+}
+
+auto WebSocketReplayServer::receive() -> std::optional<std::pair<WsOpcode, std::vector<std::byte>>>
+{
+	while (true)
+	{
+		const auto header = parse_ws_header(m_received);
+		if (header && m_received.size() >= header->header_size + header->payload_size)
+		{
+			const auto begin = m_received.begin() + static_cast<ptrdiff_t>(header->header_size);
+			std::vector<std::byte> payload(begin, begin + static_cast<ptrdiff_t>(header->payload_size));
+			if (header->masked)
+			{
+				websocket_mask(payload, header->mask_key);
+			}
+			m_received.erase(m_received.begin(), begin + static_cast<ptrdiff_t>(header->payload_size));
+			return std::pair { header->opcode, std::move(payload) };
+		}
+
+		std::array<std::byte, 4096> chunk {};
+		const auto count = ::recv(m_fd, chunk.data(), chunk.size(), 0);
+		if (count <= 0)
+		{
+			return std::nullopt;
+		}
+		m_received.insert(m_received.end(), chunk.begin(), chunk.begin() + count);
+	}
+}
+
+void WebSocketReplayServer::disconnect()
+{
+	if (m_fd >= 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+	m_received.clear();
+}
+
+} // namespace hft::feed
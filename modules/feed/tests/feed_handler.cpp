@@ -0,0 +1,386 @@
+#include <feed/feed_handler.hpp>
+#include <feed/multicast_publisher.hpp>
+#include <gtest/gtest.h>
+#include <l2/delta_codec.hpp>
+
+using namespace hft::feed;
+using namespace hft::orderbook;
+
+namespace {
+
+constexpr auto GROUP = "239.255.42.1";
+
+/*Encoded packets with the book they leave behind when applied in order.*/
+struct Capture
+{
+	std::vector<std::vector<std::byte>> packets;
+
+	std::unique_ptr<OrderBook> book = std::make_unique<OrderBook>();
+
+	size_t messages {};
+};
+
+void apply(OrderBook &book, const LevelChange &change)
+{
+	const auto qty = change.action == LevelAction::Remove ? 0 : change.quantity;
+	if (change.side == Side::Bid)
+	{
+		book.update_bid_side(change.price, qty);
+	}
+	else
+	{
+		book.update_ask_side(change.price, qty);
+	}
+}
+
+/*Up to three messages per packet, first sequence 1.*/
+auto make_capture(size_t packets) -> Capture
+{
+	Capture capture;
+	const DeltaEncoder encoder;
+	std::mt19937_64 rng(7);
+	uint64_t sequence = 0;
+
+	for (size_t p = 0; p < packets; ++p)
+	{
+		auto &packet = capture.packets.emplace_back();
+		const auto messages = 1 + rng() % 3;
+		for (size_t m = 0; m < messages; ++m)
+		{
+			std::vector<LevelChange> changes(1 + rng() % 8);
+			for (auto &change : changes)
+			{
+				change.side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+				change.price = change.side == Side::Bid ? 1000 - rng() % 20 : 1001 + rng() % 20;
+				change.quantity = rng() % 4 == 0 ? 0 : 1 + rng() % 100;
+				change.action = change.quantity == 0 ? LevelAction::Remove : LevelAction::Change;
+			}
+
+			const auto offset = packet.size();
+			packet.resize(offset + DeltaFormat::max_size(encoder.get_encoding(), changes.size()));
+			const auto size = encoder.encode(std::span(packet).subspan(offset), ++sequence, changes, *capture.book);
+			packet.resize(offset + size);
+
+			for (const auto &change : changes)
+			{
+				apply(*capture.book, change);
+			}
+			++capture.messages;
+		}
+	}
+	capture.book->set_sequence(sequence);
+	return capture;
+}
+
+auto levels(const OrderBook &book, Side side) -> std::vector<PriceLevel>
+{
+	std::vector<PriceLevel> out(OrderBook::MAX_LEVELS);
+	out.resize(side == Side::Bid ? book.get_bid_levels(out) : book.get_ask_levels(out));
+	return out;
+}
+
+auto make_config(ReceiveMode mode) -> FeedConfig
+{
+	FeedConfig config;
+	config.group = GROUP;
+	config.interface = "127.0.0.1";
+	config.mode = mode;
+	config.receive_buffer = 4 << 20;
+	return config;
+}
+
+/*Polls until the handler has seen packets in total or a second passes.*/
+void receive(FeedHandler &handler, uint64_t packets)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	while (handler.get_stats().packets < packets && std::chrono::steady_clock::now() < deadline)
+	{
+		handler.poll();
+	}
+}
+
+void send_packet(MulticastPublisher &publisher, const std::vector<std::byte> &packet)
+{
+	ASSERT_TRUE(publisher.send(packet));
+}
+
+/*Two handlers on their own groups feeding one book through an arbiter.*/
+struct ArbitratedLines
+{
+	explicit ArbitratedLines(uint64_t hold_ns = 1'000'000)
+		: arbiter(2, hold_ns)
+	{
+		for (size_t line = 0; line < 2; ++line)
+		{
+			auto config = make_config(ReceiveMode::Spin);
+			config.group = line == 0 ? GROUP : "239.255.42.3";
+			handlers[line] = std::make_unique<FeedHandler>(config, *book);
+			handlers[line]->set_arbiter(arbiter, line);
+			publishers[line] = std::make_unique<MulticastPublisher>(config.group, handlers[line]->get_port());
+		}
+	}
+
+	/*Sends packet on line and polls that line until it arrived.*/
+	void send(size_t line, const std::vector<std::byte> &packet)
+	{
+		send_packet(*publishers[line], packet);
+		receive(*handlers[line], ++sent[line]);
+	}
+
+	std::unique_ptr<OrderBook> book = std::make_unique<OrderBook>();
+
+	LineArbiter arbiter;
+
+	std::array<std::unique_ptr<FeedHandler>, 2> handlers;
+
+	std::array<std::unique_ptr<MulticastPublisher>, 2> publishers;
+
+	std::array<uint64_t, 2> sent {};
+};
+
+/*One message setting a bid level.*/
+auto make_bid_message(uint64_t sequence, uint64_t price, uint64_t qty) -> std::vector<std::byte>
+{
+	const DeltaEncoder encoder;
+	const std::array changes { LevelChange { Side::Bid, LevelAction::Change, price, qty } };
+	std::vector<std::byte> packet(DeltaFormat::max_size(encoder.get_encoding(), changes.size()));
+	packet.resize(encoder.encode(packet, sequence, changes, 0, 0));
+	return packet;
+}
+
+} // namespace
+
+class FeedHandlerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		try
+		{
+			m_handler = std::make_unique<FeedHandler>(make_config(ReceiveMode::Spin), *m_book);
+			m_publisher = std::make_unique<MulticastPublisher>(GROUP, m_handler->get_port());
+		}
+		catch (const std::runtime_error &error)
+		{
+			GTEST_SKIP() << "No loopback multicast: " << error.what();
+		}
+	}
+
+	std::unique_ptr<OrderBook> m_book = std::make_unique<OrderBook>();
+
+	std::unique_ptr<FeedHandler> m_handler;
+
+	std::unique_ptr<MulticastPublisher> m_publisher;
+};
+
+TEST_F(FeedHandlerTest, LoopbackReplay_MatchesSequentialApply)
+{
+	const auto capture = make_capture(2000);
+
+	std::vector<std::span<const std::byte>> spans(capture.packets.begin(), capture.packets.end());
+	for (size_t sent = 0; sent < spans.size();)
+	{
+		const auto batch = m_publisher->send_batch(std::span(spans).subspan(sent));
+		ASSERT_GT(batch, 0);
+		sent += batch;
+		receive(*m_handler, sent);
+	}
+
+	const auto &stats = m_handler->get_stats();
+	EXPECT_EQ(stats.packets, capture.packets.size());
+	EXPECT_EQ(stats.messages, capture.messages);
+	EXPECT_EQ(stats.malformed, 0);
+	EXPECT_EQ(stats.gaps, 0);
+	EXPECT_EQ(stats.stale, 0);
+	EXPECT_LE(stats.batches, stats.packets);
+	EXPECT_GE(stats.latency_max_ns, stats.latency_total_ns / stats.packets);
+	// Measured on the wall clock from the software stamp, a NIC clock offset would show up as seconds or years.
+	// The kernel turns stamping on in the background, the first packets may come without.
+	EXPECT_NE(stats.timestamped, 0U);
+	EXPECT_LT(stats.latency_max_ns, 1'000'000'000U);
+
+	EXPECT_EQ(levels(*m_book, Side::Bid), levels(*capture.book, Side::Bid));
+	EXPECT_EQ(levels(*m_book, Side::Ask), levels(*capture.book, Side::Ask));
+	EXPECT_EQ(m_book->get_sequence(), capture.book->get_sequence());
+}
+
+TEST_F(FeedHandlerTest, OutOfOrderMessages_CountGapsAndDropStale)
+{
+	const DeltaEncoder encoder;
+	const auto message = [&](uint64_t sequence, uint64_t price)
+	{
+		const std::array changes { LevelChange { Side::Bid, LevelAction::Insert, price, 10 } };
+		std::vector<std::byte> packet(DeltaFormat::max_size(encoder.get_encoding(), changes.size()));
+		packet.resize(encoder.encode(packet, sequence, changes, 0, 0));
+		return packet;
+	};
+
+	send_packet(*m_publisher, message(1, 1000));
+	send_packet(*m_publisher, message(2, 1001));
+	send_packet(*m_publisher, message(4, 1003));
+	send_packet(*m_publisher, message(3, 1002));
+	receive(*m_handler, 4);
+
+	const auto &stats = m_handler->get_stats();
+	EXPECT_EQ(stats.messages, 4);
+	EXPECT_EQ(stats.gaps, 1);
+	EXPECT_EQ(stats.stale, 1);
+	EXPECT_EQ(m_book->get_sequence(), 4);
+	EXPECT_EQ(levels(*m_book, Side::Bid), (std::vector<PriceLevel> { { 1003, 10 }, { 1001, 10 }, { 1000, 10 } }));
+}
+
+TEST_F(FeedHandlerTest, GarbagePacket_CountsMalformed)
+{
+	send_packet(*m_publisher, std::vector<std::byte>(100, std::byte { 0xab }));
+
+	// A valid message followed by trailing bytes is applied, the tail counted.
+	auto packet = make_capture(1).packets.front();
+	packet.push_back(std::byte { 1 });
+	send_packet(*m_publisher, packet);
+	receive(*m_handler, 2);
+
+	const auto &stats = m_handler->get_stats();
+	EXPECT_EQ(stats.malformed, 2);
+	EXPECT_GE(stats.messages, 1);
+	EXPECT_NE(m_book->get_sequence(), 0);
+}
+
+TEST_F(FeedHandlerTest, Spin_ReturnsAtOnceWhenIdle)
+{
+	EXPECT_EQ(m_handler->poll(), 0);
+	EXPECT_EQ(m_handler->get_stats().batches, 0);
+}
+
+TEST(FeedHandlerBlockingTest, Run_AppliesUntilStopped)
+{
+	auto book = std::make_unique<OrderBook>();
+	std::unique_ptr<FeedHandler> handler;
+	std::unique_ptr<MulticastPublisher> publisher;
+	try
+	{
+		auto config = make_config(ReceiveMode::Blocking);
+		config.poll_timeout_ms = 10;
+		handler = std::make_unique<FeedHandler>(config, *book);
+		publisher = std::make_unique<MulticastPublisher>(GROUP, handler->get_port());
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << "No loopback multicast: " << error.what();
+	}
+
+	// Queued in the socket before the handler runs, so the book is only read after the join.
+	const auto capture = make_capture(100);
+	for (const auto &packet : capture.packets)
+	{
+		send_packet(*publisher, packet);
+	}
+
+	std::atomic<bool> stop { false };
+	std::thread receiver([&] { handler->run(stop); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	stop = true;
+	receiver.join();
+
+	EXPECT_EQ(handler->get_stats().packets, capture.packets.size());
+	EXPECT_EQ(levels(*book, Side::Bid), levels(*capture.book, Side::Bid));
+	EXPECT_EQ(levels(*book, Side::Ask), levels(*capture.book, Side::Ask));
+}
+
+TEST(FeedHandlerArbiterTest, TwoLossyLines_RebuildTheBook)
+{
+	std::unique_ptr<ArbitratedLines> lines;
+	try
+	{
+		lines = std::make_unique<ArbitratedLines>();
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << "No loopback multicast: " << error.what();
+	}
+	const auto &arbiter = lines->arbiter;
+	const auto &book = lines->book;
+
+	// A drops every third packet, B the ones after those, so each packet gets through somewhere.
+	const auto capture = make_capture(600);
+	for (size_t i = 0; i < capture.packets.size(); ++i)
+	{
+		for (size_t line = 0; line < 2; ++line)
+		{
+			if (i % 3 != line)
+			{
+				lines->send(line, capture.packets[i]);
+			}
+		}
+	}
+
+	const auto &handlers = lines->handlers;
+	EXPECT_EQ(arbiter.get_stats().delivered, capture.messages);
+	EXPECT_EQ(arbiter.get_stats().lost + arbiter.get_pending(), 0);
+	EXPECT_GT(arbiter.get_wins(0), 0);
+	EXPECT_GT(arbiter.get_wins(1), 0);
+	EXPECT_EQ(handlers[0]->get_stats().stale + handlers[1]->get_stats().stale, arbiter.get_stats().duplicates);
+	EXPECT_EQ(levels(*book, Side::Bid), levels(*capture.book, Side::Bid));
+	EXPECT_EQ(levels(*book, Side::Ask), levels(*capture.book, Side::Ask));
+	EXPECT_EQ(book->get_sequence(), capture.book->get_sequence());
+}
+
+TEST(FeedHandlerArbiterTest, GapFilledOnOtherLine_AppliedBeforeNewerMessage)
+{
+	std::unique_ptr<ArbitratedLines> lines;
+	try
+	{
+		lines = std::make_unique<ArbitratedLines>();
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << "No loopback multicast: " << error.what();
+	}
+
+	// A loses 2 and brings 3 first, both set the same price. B's copy of 2 must not undo 3.
+	lines->send(0, make_bid_message(1, 1000, 10));
+	lines->send(0, make_bid_message(3, 1000, 30));
+	EXPECT_EQ(lines->book->get_sequence(), 1);
+	EXPECT_EQ(lines->arbiter.get_held(), 1);
+
+	lines->send(1, make_bid_message(2, 1000, 20));
+	lines->send(1, make_bid_message(3, 1000, 30));
+
+	EXPECT_EQ(lines->book->get_sequence(), 3);
+	EXPECT_EQ(levels(*lines->book, Side::Bid), (std::vector<PriceLevel> { { 1000, 30 } }));
+	EXPECT_EQ(lines->arbiter.get_held(), 0);
+	EXPECT_EQ(lines->arbiter.get_stats().held, 1);
+	EXPECT_EQ(lines->handlers[0]->get_stats().gaps + lines->handlers[1]->get_stats().gaps, 0);
+}
+
+TEST(FeedHandlerArbiterTest, GapNeverFilled_GivenUpAndLateFillDropped)
+{
+	std::unique_ptr<ArbitratedLines> lines;
+	try
+	{
+		lines = std::make_unique<ArbitratedLines>(0);
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << "No loopback multicast: " << error.what();
+	}
+
+	// With no hold time the gap is given up on by the end of the poll that held 3.
+	lines->send(0, make_bid_message(1, 1000, 10));
+	lines->send(0, make_bid_message(3, 1000, 30));
+	EXPECT_EQ(lines->book->get_sequence(), 3);
+	EXPECT_EQ(lines->arbiter.get_stats().abandoned, 1);
+	EXPECT_EQ(lines->handlers[0]->get_stats().gaps, 1);
+
+	lines->send(1, make_bid_message(2, 1000, 20));
+	EXPECT_EQ(lines->handlers[1]->get_stats().stale, 1);
+	EXPECT_EQ(levels(*lines->book, Side::Bid), (std::vector<PriceLevel> { { 1000, 30 } }));
+}
+
+TEST(FeedHandlerConfigTest, BadGroup_Throws)
+{
+	OrderBook book;
+	FeedConfig config;
+	config.group = "not an address";
+	EXPECT_THROW(FeedHandler(config, book), std::runtime_error);
+	EXPECT_THROW(MulticastPublisher("239.255.42.1", 1, "nowhere"), std::runtime_error);
+}
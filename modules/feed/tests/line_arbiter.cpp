@@ -0,0 +1,194 @@
+#include <feed/line_arbiter.hpp>
+#include <gtest/gtest.h>
+
+using namespace hft::feed;
+
+TEST(LineArbiterTest, LaggingCopy_IsDeliveredOnce)
+{
+	LineArbiter arbiter(2);
+	for (uint64_t sequence = 1; sequence <= 100; ++sequence)
+	{
+		EXPECT_TRUE(arbiter.accept(0, sequence));
+		if (sequence > 3)
+		{
+			EXPECT_FALSE(arbiter.accept(1, sequence - 3));
+		}
+	}
+
+	const auto &stats = arbiter.get_stats();
+	EXPECT_EQ(stats.delivered, 100);
+	EXPECT_EQ(stats.duplicates, 97);
+	EXPECT_EQ(arbiter.get_wins(0), 100);
+	EXPECT_EQ(arbiter.get_wins(1), 0);
+	EXPECT_EQ(arbiter.get_received(1), 97);
+	EXPECT_EQ(arbiter.get_highest(), 100);
+}
+
+TEST(LineArbiterTest, ComplementaryDrops_FillEachOther)
+{
+	LineArbiter arbiter(2);
+	std::vector<uint64_t> delivered;
+
+	// A loses the even sequences, B the odd ones and runs two behind.
+	for (uint64_t sequence = 1; sequence <= 102; ++sequence)
+	{
+		if (sequence <= 100 && sequence % 2 == 1 && arbiter.accept(0, sequence))
+		{
+			delivered.push_back(sequence);
+		}
+		if (sequence > 2 && sequence % 2 == 0 && arbiter.accept(1, sequence - 2))
+		{
+			delivered.push_back(sequence - 2);
+		}
+	}
+
+	std::ranges::sort(delivered);
+	ASSERT_EQ(delivered.size(), 100);
+	for (uint64_t i = 0; i < delivered.size(); ++i)
+	{
+		EXPECT_EQ(delivered[i], i + 1);
+	}
+
+	const auto &stats = arbiter.get_stats();
+	EXPECT_EQ(arbiter.get_wins(0), 50);
+	EXPECT_EQ(arbiter.get_wins(1), 50);
+	EXPECT_EQ(stats.skipped, 49);
+	EXPECT_EQ(stats.filled, 49);
+	EXPECT_EQ(stats.lost, 0);
+	EXPECT_EQ(stats.duplicates, 0);
+	EXPECT_EQ(arbiter.get_pending(), 0);
+}
+
+TEST(LineArbiterTest, HoleNeitherLineFills_IsLostOnceOutOfWindow)
+{
+	LineArbiter arbiter(2);
+	for (uint64_t sequence = 1; sequence <= 10; ++sequence)
+	{
+		if (sequence != 5)
+		{
+			EXPECT_TRUE(arbiter.accept(0, sequence));
+			EXPECT_FALSE(arbiter.accept(1, sequence));
+		}
+	}
+	EXPECT_EQ(arbiter.get_stats().skipped, 1);
+	EXPECT_EQ(arbiter.get_pending(), 1);
+	EXPECT_EQ(arbiter.get_stats().lost, 0);
+
+	for (uint64_t sequence = 11; sequence < 5 + LineArbiter::WINDOW; ++sequence)
+	{
+		EXPECT_TRUE(arbiter.accept(0, sequence));
+	}
+	EXPECT_EQ(arbiter.get_stats().lost, 0);
+
+	// Sequence 5 leaves the window, a copy turning up now is too late.
+	EXPECT_TRUE(arbiter.accept(1, 5 + LineArbiter::WINDOW));
+	EXPECT_EQ(arbiter.get_stats().lost, 1);
+	EXPECT_EQ(arbiter.get_pending(), 0);
+	EXPECT_FALSE(arbiter.accept(1, 5));
+	EXPECT_EQ(arbiter.get_stats().late, 1);
+}
+
+TEST(LineArbiterTest, JumpBeyondWindow_CountsEverythingPassedOver)
+{
+	LineArbiter arbiter(1);
+	EXPECT_TRUE(arbiter.accept(0, 1000));
+
+	// Sequences before the first one seen never count as missing.
+	EXPECT_FALSE(arbiter.accept(0, 999));
+	EXPECT_EQ(arbiter.get_stats().late, 1);
+
+	EXPECT_TRUE(arbiter.accept(0, 1000 + LineArbiter::WINDOW + 10));
+	const auto &stats = arbiter.get_stats();
+	EXPECT_EQ(stats.skipped, LineArbiter::WINDOW + 9);
+	EXPECT_EQ(stats.lost, 10);
+	EXPECT_EQ(arbiter.get_pending(), LineArbiter::WINDOW - 1);
+
+	EXPECT_TRUE(arbiter.accept(0, 1011));
+	EXPECT_FALSE(arbiter.accept(0, 1010));
+	EXPECT_EQ(stats.filled, 1);
+	EXPECT_EQ(stats.late, 2);
+}
+
+TEST(LineArbiterTest, RandomLines_MatchReference)
+{
+	constexpr size_t LINES = 3;
+	LineArbiter arbiter(LINES);
+	std::set<uint64_t> seen;
+	uint64_t highest = 0;
+
+	// Each line drops a tenth of the messages and delivers the rest up to 64 positions late, a few far later.
+	std::mt19937_64 rng(11);
+	// Arrival time, sequence, line.
+	std::vector<std::tuple<uint64_t, uint64_t, size_t>> arrivals;
+	for (uint64_t sequence = 1; sequence <= 200'000; ++sequence)
+	{
+		for (size_t line = 0; line < LINES; ++line)
+		{
+			if (rng() % 10 != 0)
+			{
+				const auto delay = rng() % 1'000 == 0 ? 5'000 * 100 : rng() % 6'400;
+				arrivals.emplace_back(sequence * 100 + delay, sequence, line);
+			}
+		}
+	}
+	std::ranges::sort(arrivals);
+
+	for (const auto &[time, sequence, line] : arrivals)
+	{
+		const auto expected =
+			sequence + LineArbiter::WINDOW > highest && !seen.contains(sequence) && (seen.empty() || sequence >= *seen.begin());
+		ASSERT_EQ(arbiter.accept(line, sequence), expected) << sequence;
+		if (expected)
+		{
+			seen.insert(sequence);
+			highest = std::max(highest, sequence);
+		}
+	}
+
+	const auto &stats = arbiter.get_stats();
+	EXPECT_EQ(stats.delivered, seen.size());
+	EXPECT_EQ(stats.skipped, stats.filled + stats.lost + arbiter.get_pending());
+	EXPECT_EQ(stats.delivered + stats.duplicates + stats.late, arrivals.size());
+
+	uint64_t wins = 0;
+	for (size_t line = 0; line < LINES; ++line)
+	{
+		wins += arbiter.get_wins(line);
+	}
+	EXPECT_EQ(wins, stats.delivered);
+}
+
+TEST(LineArbiterTest, InvalidLineCount_Throws)
+{
+	EXPECT_THROW(LineArbiter(0), std::runtime_error);
+	EXPECT_THROW(LineArbiter(LineArbiter::MAX_LINES + 1), std::runtime_error);
+}
+
+TEST(LineArbiterTest, Hold_ReleasesInSequenceOrder)
+{
+	LineArbiter arbiter(1, 1000);
+	const std::array<std::byte, 3> message { std::byte { 1 }, std::byte { 2 }, std::byte { 3 } };
+
+	arbiter.set_applied(10);
+	EXPECT_TRUE(arbiter.hold(13, message, 500));
+	EXPECT_TRUE(arbiter.hold(12, std::span(message).first(2), 600));
+	EXPECT_FALSE(arbiter.hold(11 + LineArbiter::HOLD, message, 700));
+	EXPECT_EQ(arbiter.get_held(), 2);
+	EXPECT_EQ(arbiter.get_held_since(), 600);
+
+	// 11 is missing, nothing can be released.
+	EXPECT_TRUE(arbiter.take_next().empty());
+	EXPECT_EQ(arbiter.skip_gap(), 1);
+	EXPECT_EQ(arbiter.get_next_apply(), 12);
+
+	EXPECT_EQ(arbiter.take_next().size(), 2);
+	arbiter.set_applied(12);
+	const auto held = arbiter.take_next();
+	EXPECT_TRUE(std::ranges::equal(held, message));
+	arbiter.set_applied(13);
+
+	EXPECT_EQ(arbiter.get_held(), 0);
+	EXPECT_EQ(arbiter.get_held_since(), 0);
+	EXPECT_EQ(arbiter.get_stats().held, 2);
+	EXPECT_EQ(arbiter.get_stats().abandoned, 1);
+}
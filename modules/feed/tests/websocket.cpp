@@ -0,0 +1,410 @@
+#include <feed/websocket_client.hpp>
+#include <feed/websocket_server.hpp>
+#include <gtest/gtest.h>
+#include <l2/sbe_depth.hpp>
+
+using namespace hft::feed;
+using namespace hft::orderbook;
+using hft::core::MirroredBuffer;
+using hft::core::store_le;
+
+namespace {
+
+using Levels = std::vector<std::pair<int64_t, int64_t>>;
+
+/*Depth message of the venue's SBE schema, prices with 2 decimals, quantities with 3.*/
+auto build_depth(bool snapshot, int64_t first, int64_t last, const Levels &bids, const Levels &asks)
+	-> std::vector<std::byte>
+{
+	const size_t block_length =
+		snapshot ? sbe::DepthSnapshotStreamEvent::BLOCK_LENGTH : sbe::DepthDiffStreamEvent::BLOCK_LENGTH;
+	constexpr std::string_view symbol = "BTCUSDT";
+
+	std::vector<std::byte> buffer(
+		sbe::MessageHeader::SIZE + block_length + 2 * sbe::GroupSize16Encoding::SIZE +
+		(bids.size() + asks.size()) * sbe::LevelEntry::BLOCK_LENGTH + 1 + symbol.size()
+	);
+
+	auto *pos = buffer.data();
+	pos = store_le(pos, static_cast<uint16_t>(block_length));
+	pos = store_le(
+		pos, snapshot ? sbe::DepthSnapshotStreamEvent::TEMPLATE_ID : sbe::DepthDiffStreamEvent::TEMPLATE_ID
+	);
+	pos = store_le(pos, sbe::SCHEMA_ID);
+	pos = store_le(pos, uint16_t { 0 });
+
+	pos = store_le(pos, int64_t { 1'700'000'000'000'000 });
+	pos = store_le(pos, first);
+	if (!snapshot)
+	{
+		pos = store_le(pos, last);
+	}
+	pos = store_le(pos, int8_t { -2 });
+	pos = store_le(pos, int8_t { -3 });
+
+	for (const auto *levels : { &bids, &asks })
+	{
+		pos = store_le(pos, static_cast<uint16_t>(sbe::LevelEntry::BLOCK_LENGTH));
+		pos = store_le(pos, static_cast<uint16_t>(levels->size()));
+		for (const auto &[price, qty] : *levels)
+		{
+			pos = store_le(pos, price);
+			pos = store_le(pos, qty);
+		}
+	}
+
+	pos = store_le(pos, static_cast<uint8_t>(symbol.size()));
+	std::memcpy(pos, symbol.data(), symbol.size());
+	return buffer;
+}
+
+/*A snapshot followed by diffs with consecutive update ids.*/
+auto make_depth_capture(size_t diffs) -> std::vector<std::vector<std::byte>>
+{
+	std::mt19937_64 rng(9);
+	std::vector<std::vector<std::byte>> messages;
+	messages.push_back(build_depth(true, 100, 100, { { 100'000, 5'000 }, { 99'900, 1'000 } }, { { 100'100, 2'000 } }));
+
+	int64_t id = 100;
+	for (size_t i = 0; i < diffs; ++i)
+	{
+		Levels bids(rng() % 4);
+		Levels asks(rng() % 4);
+		for (auto &[price, qty] : bids)
+		{
+			price = 100'000 - static_cast<int64_t>(rng() % 50) * 10;
+			qty = rng() % 4 == 0 ? 0 : static_cast<int64_t>(1 + rng() % 10'000);
+		}
+		for (auto &[price, qty] : asks)
+		{
+			price = 100'100 + static_cast<int64_t>(rng() % 50) * 10;
+			qty = rng() % 4 == 0 ? 0 : static_cast<int64_t>(1 + rng() % 10'000);
+		}
+		const auto count = static_cast<int64_t>(1 + rng() % 3);
+		messages.push_back(build_depth(false, id + 1, id + count, bids, asks));
+		id += count;
+	}
+	return messages;
+}
+
+auto levels(const OrderBook &book, Side side) -> std::vector<PriceLevel>
+{
+	std::vector<PriceLevel> out(OrderBook::MAX_LEVELS);
+	out.resize(side == Side::Bid ? book.get_bid_levels(out) : book.get_ask_levels(out));
+	return out;
+}
+
+auto random_bytes(std::mt19937_64 &rng, size_t size) -> std::vector<std::byte>
+{
+	std::vector<std::byte> bytes(size);
+	for (auto &byte : bytes)
+	{
+		byte = static_cast<std::byte>(rng());
+	}
+	return bytes;
+}
+
+void append_frame(
+	std::vector<std::byte> &out, WsOpcode opcode, bool fin, std::span<const std::byte> payload, std::optional<uint32_t> key
+)
+{
+	const auto offset = out.size();
+	out.resize(offset + WsFormat::MAX_HEADER_SIZE + payload.size());
+	const auto header_size = write_ws_header(out.data() + offset, opcode, fin, payload.size(), key);
+	std::memcpy(out.data() + offset + header_size, payload.data(), payload.size());
+	if (key)
+	{
+		websocket_mask({ out.data() + offset + header_size, payload.size() }, *key);
+	}
+	out.resize(offset + header_size + payload.size());
+}
+
+/*Decodes stream in one go and collects the data messages.*/
+auto decode_all(std::span<const std::byte> stream, WsStatus &status) -> std::vector<std::vector<std::byte>>
+{
+	MirroredBuffer buffer(4096);
+	WebSocketDecoder decoder(buffer);
+	std::ranges::copy(stream, buffer.writable().begin());
+	buffer.commit(stream.size());
+
+	std::vector<std::vector<std::byte>> messages;
+	status = decoder.decode(
+		[&](std::span<const std::byte> payload, WsOpcode) { messages.emplace_back(payload.begin(), payload.end()); },
+		[](WsOpcode, std::span<const std::byte>) {}
+	);
+	return messages;
+}
+
+} // namespace
+
+TEST(WebSocketTest, Mask_MatchesBytewiseXor)
+{
+	std::mt19937_64 rng(1);
+	constexpr uint32_t KEY = 0x37fa213d;
+	for (const size_t size : std::initializer_list<size_t> { 0, 1, 3, 4, 7, 8, 15, 16, 31, 32, 33, 63, 100, 1000 })
+	{
+		const auto original = random_bytes(rng, size);
+		auto masked = original;
+		websocket_mask(masked, KEY);
+		for (size_t i = 0; i < size; ++i)
+		{
+			ASSERT_EQ(masked[i], original[i] ^ static_cast<std::byte>(KEY >> (8 * (i % 4)))) << size << " " << i;
+		}
+		websocket_mask(masked, KEY);
+		EXPECT_EQ(masked, original);
+	}
+}
+
+TEST(WebSocketTest, AcceptKey_MatchesRfcExample)
+{
+	EXPECT_EQ(websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+TEST(WebSocketTest, Header_RoundTripsEveryLengthForm)
+{
+	for (const uint64_t size : std::initializer_list<uint64_t> { 0, 125, 126, 65'535, 65'536, 1ULL << 40 })
+	{
+		for (const auto key : { std::optional<uint32_t> {}, std::optional<uint32_t> { 0x01020304 } })
+		{
+			std::array<std::byte, WsFormat::MAX_HEADER_SIZE> header {};
+			const auto written = write_ws_header(header.data(), WsOpcode::Binary, false, size, key);
+
+			EXPECT_FALSE(parse_ws_header(std::span(header).first(written - 1)));
+			const auto parsed = parse_ws_header(std::span(header).first(written));
+			ASSERT_TRUE(parsed);
+			EXPECT_EQ(parsed->header_size, written);
+			EXPECT_EQ(parsed->payload_size, size);
+			EXPECT_EQ(parsed->opcode, WsOpcode::Binary);
+			EXPECT_FALSE(parsed->fin);
+			EXPECT_EQ(parsed->masked, key.has_value());
+			EXPECT_EQ(parsed->mask_key, key.value_or(0));
+		}
+	}
+}
+
+TEST(WebSocketTest, Decoder_StreamsWrappingFragmentedMaskedMessages)
+{
+	std::mt19937_64 rng(2);
+	std::vector<std::vector<std::byte>> expected;
+	std::vector<std::byte> stream;
+	size_t pings = 0;
+
+	// Random sizes, masks and fragment counts with pings between the fragments.
+	for (size_t m = 0; m < 2'000; ++m)
+	{
+		const auto &payload = expected.emplace_back(random_bytes(rng, rng() % 600));
+		const auto fragments = rng() % 3 == 0 ? 1 + rng() % 4 : 1;
+		const auto mask = [&] { return rng() % 2 == 0 ? std::optional<uint32_t> {} : static_cast<uint32_t>(rng()); };
+
+		size_t offset = 0;
+		for (size_t f = 0; f < fragments; ++f)
+		{
+			const auto size = f + 1 == fragments ? payload.size() - offset : (payload.size() - offset) / 2;
+			append_frame(
+				stream, f == 0 ? WsOpcode::Binary : WsOpcode::Continuation, f + 1 == fragments,
+				std::span(payload).subspan(offset, size), mask()
+			);
+			offset += size;
+			if (rng() % 4 == 0)
+			{
+				const auto ping = random_bytes(rng, rng() % 126);
+				append_frame(stream, WsOpcode::Ping, true, ping, mask());
+				++pings;
+			}
+		}
+	}
+
+	// A small ring fed in uneven reads, so frames keep wrapping around its end.
+	MirroredBuffer buffer(4096);
+	WebSocketDecoder decoder(buffer);
+	std::vector<std::vector<std::byte>> received;
+	size_t controls = 0;
+	for (size_t offset = 0; offset < stream.size();)
+	{
+		const auto space = buffer.writable();
+		const auto count = std::min({ space.size(), stream.size() - offset, static_cast<size_t>(1 + rng() % 1500) });
+		std::memcpy(space.data(), stream.data() + offset, count);
+		buffer.commit(count);
+		offset += count;
+
+		const auto status = decoder.decode(
+			[&](std::span<const std::byte> payload, WsOpcode opcode)
+			{
+				EXPECT_EQ(opcode, WsOpcode::Binary);
+				received.emplace_back(payload.begin(), payload.end());
+			},
+			[&](WsOpcode opcode, std::span<const std::byte>)
+			{
+				EXPECT_EQ(opcode, WsOpcode::Ping);
+				++controls;
+			}
+		);
+		ASSERT_EQ(status, WsStatus::Ok);
+	}
+
+	EXPECT_TRUE(buffer.empty());
+	EXPECT_EQ(controls, pings);
+	EXPECT_EQ(decoder.get_stats().messages, expected.size());
+	ASSERT_EQ(received.size(), expected.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		ASSERT_EQ(received[i], expected[i]) << i;
+	}
+}
+
+TEST(WebSocketTest, Decoder_RejectsProtocolErrors)
+{
+	const std::vector<std::byte> payload(10, std::byte { 1 });
+	WsStatus status {};
+
+	std::vector<std::byte> stream;
+	append_frame(stream, WsOpcode::Binary, true, payload, {});
+	append_frame(stream, WsOpcode::Continuation, true, payload, {});
+	EXPECT_EQ(decode_all(stream, status).size(), 1);
+	EXPECT_EQ(status, WsStatus::ProtocolError);
+
+	stream.clear();
+	append_frame(stream, WsOpcode::Text, false, payload, {});
+	append_frame(stream, WsOpcode::Text, true, payload, {});
+	EXPECT_TRUE(decode_all(stream, status).empty());
+	EXPECT_EQ(status, WsStatus::ProtocolError);
+
+	stream.clear();
+	append_frame(stream, WsOpcode::Ping, false, payload, {});
+	decode_all(stream, status);
+	EXPECT_EQ(status, WsStatus::ProtocolError);
+
+	stream.clear();
+	append_frame(stream, WsOpcode::Binary, true, payload, {});
+	stream[0] |= std::byte { 0x40 };
+	decode_all(stream, status);
+	EXPECT_EQ(status, WsStatus::ProtocolError);
+
+	// Only the header has to be there to tell the message will never fit.
+	stream.resize(WsFormat::MAX_HEADER_SIZE);
+	stream.resize(write_ws_header(stream.data(), WsOpcode::Binary, true, 5000));
+	decode_all(stream, status);
+	EXPECT_EQ(status, WsStatus::TooLarge);
+
+	stream.clear();
+	append_frame(stream, WsOpcode::Close, true, std::span(payload).first(2), {});
+	append_frame(stream, WsOpcode::Binary, true, payload, {});
+	EXPECT_TRUE(decode_all(stream, status).empty());
+	EXPECT_EQ(status, WsStatus::Closed);
+}
+
+TEST(WebSocketTest, Loopback_ReplaysDepthIntoBook)
+{
+	std::unique_ptr<WebSocketReplayServer> server;
+	try
+	{
+		server = std::make_unique<WebSocketReplayServer>();
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << error.what();
+	}
+
+	const auto capture = make_depth_capture(500);
+	const SbeDepthDecoder depth { { 2, 3 } };
+	OrderBook expected;
+	for (const auto &message : capture)
+	{
+		ASSERT_EQ(depth.apply(message, expected), SbeApplyResult::Applied);
+	}
+
+	// Every seventh message fragmented, a ping after every hundredth.
+	std::optional<std::pair<WsOpcode, std::vector<std::byte>>> pong;
+	std::optional<std::pair<WsOpcode, std::vector<std::byte>>> close;
+	std::thread venue(
+		[&]
+		{
+			server->accept();
+			for (size_t i = 0; i < capture.size(); ++i)
+			{
+				server->send(capture[i], WsOpcode::Binary, i % 7 == 0 ? 16 : 0);
+				if (i == 100)
+				{
+					const std::array ping { std::byte { 'h' }, std::byte { 'i' } };
+					server->send_frame(WsOpcode::Ping, true, ping);
+					pong = server->receive();
+				}
+			}
+			const std::array status { std::byte { 0x03 }, std::byte { 0xe8 } };
+			server->send_frame(WsOpcode::Close, true, status);
+			close = server->receive();
+		}
+	);
+
+	OrderBook book;
+	WebSocketClient client({ .port = server->get_port() });
+	auto status = WsStatus::Ok;
+	size_t applied = 0;
+	while (status == WsStatus::Ok)
+	{
+		status = client.poll(
+			[&](std::span<const std::byte> payload, WsOpcode)
+			{ applied += depth.apply(payload, book) == SbeApplyResult::Applied ? 1U : 0U; }
+		);
+	}
+	venue.join();
+
+	EXPECT_EQ(status, WsStatus::Closed);
+	EXPECT_EQ(applied, capture.size());
+	EXPECT_EQ(client.get_decoder().get_stats().fragmented, (capture.size() + 6) / 7);
+	EXPECT_EQ(client.get_stats().pongs_sent, 1);
+	ASSERT_TRUE(pong);
+	EXPECT_EQ(pong->first, WsOpcode::Pong);
+	EXPECT_EQ(pong->second.size(), 2);
+	ASSERT_TRUE(close);
+	EXPECT_EQ(close->first, WsOpcode::Close);
+	EXPECT_EQ(levels(book, Side::Bid), levels(expected, Side::Bid));
+	EXPECT_EQ(levels(book, Side::Ask), levels(expected, Side::Ask));
+}
+
+TEST(WebSocketTest, Client_AcceptsLowercaseUpgradeHeaders)
+{
+	std::unique_ptr<WebSocketReplayServer> server;
+	try
+	{
+		server = std::make_unique<WebSocketReplayServer>();
+	}
+	catch (const std::runtime_error &error)
+	{
+		GTEST_SKIP() << error.what();
+	}
+
+	const std::array payload { std::byte { 1 }, std::byte { 2 } };
+	std::thread venue(
+		[&]
+		{
+			server->accept(true);
+			server->send(payload);
+			const std::array status { std::byte { 0x03 }, std::byte { 0xe8 } };
+			server->send_frame(WsOpcode::Close, true, status);
+			static_cast<void>(server->receive());
+		}
+	);
+
+	WebSocketClient client({ .port = server->get_port() });
+	std::vector<std::byte> received;
+	auto status = WsStatus::Ok;
+	while (status == WsStatus::Ok)
+	{
+		status = client.poll(
+			[&](std::span<const std::byte> message, WsOpcode) { received.assign(message.begin(), message.end()); }
+		);
+	}
+	venue.join();
+
+	EXPECT_EQ(status, WsStatus::Closed);
+	EXPECT_EQ(received, std::vector(payload.begin(), payload.end()));
+}
+
+TEST(WebSocketTest, Client_FailsWithoutServer)
+{
+	auto server = std::make_unique<WebSocketReplayServer>();
+	const auto port = server->get_port();
+	server.reset();
+	EXPECT_THROW(WebSocketClient({ .port = port }), std::runtime_error);
+}
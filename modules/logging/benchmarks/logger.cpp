@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <logging/logger.hpp>
+#include <perf_counters.hpp>
+#include <spdlog/sinks/null_sink.h>
+
+using namespace hft::logging;
+using hft::common::PerfCounters;
+
+namespace {
+
+auto null_logger() -> std::shared_ptr<spdlog::logger>
+{
+	return std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_st>());
+}
+
+} // namespace
+
+/*
+ * Cost of one HFT_LOG call on the logging thread: the level check, the
+ * timestamp and copying three arguments into the ring. The backend drains
+ * the ring outside the timed region every BURST lines, so what is timed is
+ * the copy and not the drop path of a backend starved of CPU.
+ */
+static void BM_Logger_Deferred(benchmark::State &state)
+{
+	constexpr size_t BURST = 4096;
+	start(null_logger(), { .buffer_records = BURST });
+
+	uint64_t price = 10'000;
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < BURST; ++i)
+		{
+			HFT_LOG_ERROR("Pool exhausted adding {} at {} qty {}", "bid", ++price, i);
+		}
+
+		state.PauseTiming();
+		counters.pause();
+		flush();
+		counters.resume();
+		state.ResumeTiming();
+	}
+	counters.stop();
+	stop();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BURST));
+	state.counters["dropped"] = static_cast<double>(get_dropped());
+	counters.report(state, BURST);
+}
+BENCHMARK(BM_Logger_Deferred);
+
+/*The same statement below the logger level, one relaxed load.*/
+static void BM_Logger_Disabled(benchmark::State &state)
+{
+	auto logger = null_logger();
+	logger->set_level(Level::critical);
+	start(logger);
+
+	uint64_t price = 10'000;
+	for (auto _ : state)
+	{
+		HFT_LOG_ERROR("Pool exhausted adding {} at {} qty {}", "bid", ++price, 1);
+		benchmark::DoNotOptimize(price);
+	}
+	stop();
+}
+BENCHMARK(BM_Logger_Disabled);
+
+/*Formatting on the calling thread through spdlog into a sink that discards, what the deferred path avoids.*/
+static void BM_Logger_SpdlogInline(benchmark::State &state)
+{
+	auto logger = null_logger();
+	logger->set_level(Level::err);
+
+	uint64_t price = 10'000;
+	for (auto _ : state)
+	{
+		logger->error("Pool exhausted adding {} at {} qty {}", "bid", ++price, 1);
+	}
+}
+BENCHMARK(BM_Logger_SpdlogInline);
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <core/spsc_queue.hpp>
+#include <core/stat_counter.hpp>
+#include <spdlog/logger.h>
+
+#if defined(__x86_64__)
+	#include <x86intrin.h>
+#endif
+
+namespace hft::logging {
+
+/*
+ * Deferred formatting logger for hot paths. A call copies a pointer to its
+ * static call site, a raw timestamp and its arguments into a 64 byte slot of
+ * a per-thread SPSC ring and returns; a background thread formats the slots
+ * with fmt and hands the lines to an spdlog logger. No lock, allocation or
+ * syscall happens on the calling thread after its first call, a full ring
+ * drops the line and counts it.
+ *
+ * Arguments must be trivially copyable and together fit ARGS_SIZE bytes.
+ * They are formatted later on another thread, so pointers, C strings
+ * included, must point at data that outlives the logger (string literals).
+ */
+using Level = spdlog::level::level_enum;
+
+struct LoggerConfig
+{
+	// Lines in flight per logging thread.
+	size_t buffer_records = 4096;
+
+	// Backend sleep when every ring is empty.
+	std::chrono::microseconds poll_interval { 200 };
+};
+
+/*Where a line comes from, one static instance per HFT_LOG statement.*/
+struct LogSite
+{
+	Level level;
+
+	std::string_view format;
+
+	const char *file;
+
+	int line;
+};
+
+struct LogRecord;
+
+using FormatFn = void (*)(const LogRecord &record, fmt::memory_buffer &out);
+
+struct LogRecord
+{
+	static constexpr size_t ARGS_SIZE = 40;
+
+	const LogSite *site;
+
+	// Unpacks args with the types they were written with.
+	FormatFn format;
+
+	// Raw read_timestamp() value, converted to wall time by the backend.
+	uint64_t timestamp;
+
+	std::array<std::byte, ARGS_SIZE> args;
+};
+
+static_assert(sizeof(LogRecord) == 64);
+
+/*Ring of one logging thread, owned by the backend.*/
+struct ThreadBuffer
+{
+	explicit ThreadBuffer(size_t records)
+		: queue(records)
+	{
+	}
+
+	core::SpscQueue<LogRecord> queue;
+
+	core::StatCounter dropped;
+
+	// Set when the thread exits, the backend frees the ring once drained.
+	std::atomic<bool> closed {};
+};
+
+/*
+ * Starts the backend thread formatting into logger, stopping a running one
+ * first. Lines below the level the logger has at this point are skipped at
+ * the call site.
+ */
+void start(std::shared_ptr<spdlog::logger> logger, const LoggerConfig &config = {});
+
+/*Formats whatever is queued, then stops the backend. Logging stays off until the next start().*/
+void stop();
+
+/*Returns once every line logged before the call reached the spdlog logger, which is flushed too.*/
+void flush();
+
+/*Lines dropped on full rings since the process started, all threads together.*/
+[[nodiscard]] auto get_dropped() -> uint64_t;
+
+namespace detail {
+
+// Off until start(), so logging costs one load when nobody listens.
+inline std::atomic<int> g_min_level { Level::off };
+
+/*Ring of the calling thread, registered with the backend on first use.*/
+auto register_thread() -> ThreadBuffer *;
+
+// Ring of the calling thread, a plain pointer so reading it needs no thread_local guard.
+inline thread_local ThreadBuffer *t_buffer {};
+
+// What an argument is kept as, string literals become pointers to const char.
+template<typename T>
+using Stored = std::decay_t<const T>;
+
+template<typename T>
+void pack(std::byte *&out, const T &value) noexcept
+{
+	std::memcpy(out, &value, sizeof(T));
+	out += sizeof(T);
+}
+
+template<typename T>
+auto unpack(const LogRecord &record, size_t &offset) noexcept -> T
+{
+	T value;
+	std::memcpy(&value, record.args.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return value;
+}
+
+template<typename... Args>
+void format_record(const LogRecord &record, fmt::memory_buffer &out)
+{
+	[[maybe_unused]] size_t offset = 0;
+	// Braced initialisation evaluates left to right, the arguments come back in order.
+	const std::tuple<Args...> args { unpack<Args>(record, offset)... };
+	std::apply(
+		[&](const auto &...values)
+		{ fmt::vformat_to(fmt::appender(out), record.site->format, fmt::make_format_args(values...)); },
+		args
+	);
+}
+
+} // namespace detail
+
+[[nodiscard]] inline auto is_enabled(Level level) noexcept -> bool
+{
+	return static_cast<int>(level) >= detail::g_min_level.load(std::memory_order_relaxed);
+}
+
+/*Cycle counter where there is one, converted against the wall clock by the backend.*/
+[[nodiscard]] inline auto read_timestamp() noexcept -> uint64_t
+{
+#if defined(__x86_64__)
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/*Queues one line, use the HFT_LOG macros instead. The format string is checked against args at compile time.*/
+template<typename... Args>
+void write(const LogSite &site, [[maybe_unused]] fmt::format_string<Args...> check, const Args &...args) noexcept
+{
+	static_assert((std::is_trivially_copyable_v<detail::Stored<Args>> && ...), "Arguments are copied as raw bytes");
+	static_assert((sizeof(detail::Stored<Args>) + ... + 0) <= LogRecord::ARGS_SIZE, "Arguments do not fit a log record");
+
+	auto *buffer = detail::t_buffer;
+	if (!buffer) [[unlikely]]
+	{
+		buffer = detail::register_thread();
+	}
+
+	auto *record = buffer->queue.claim();
+	if (!record) [[unlikely]]
+	{
+		buffer->dropped.add();
+		return;
+	}
+
+	record->site = &site;
+	// String literals arrive as arrays and are stored as pointers.
+	record->format = &detail::format_record<detail::Stored<Args>...>;
+	record->timestamp = read_timestamp();
+	[[maybe_unused]] auto *out = record->args.data();
+	(detail::pack<detail::Stored<Args>>(out, args), ...);
+	buffer->queue.publish();
+}
+
+} // namespace hft::logging
+
+#define HFT_LOG(level, format, ...)                                                                                    \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if (::hft::logging::is_enabled(level)) [[unlikely]]                                                            \
+		{                                                                                                              \
+			static constexpr ::hft::logging::LogSite HFT_LOG_SITE { level, format, __FILE__, __LINE__ };               \
+			::hft::logging::write(HFT_LOG_SITE, format __VA_OPT__(, ) __VA_ARGS__);                                    \
+		}                                                                                                              \
+	} while (false)
+
+#define HFT_LOG_DEBUG(format, ...) HFT_LOG(::hft::logging::Level::debug, format __VA_OPT__(, ) __VA_ARGS__)
+
+#define HFT_LOG_INFO(format, ...) HFT_LOG(::hft::logging::Level::info, format __VA_OPT__(, ) __VA_ARGS__)
+
+#define HFT_LOG_WARN(format, ...) HFT_LOG(::hft::logging::Level::warn, format __VA_OPT__(, ) __VA_ARGS__)
+
+#define HFT_LOG_ERROR(format, ...) HFT_LOG(::hft::logging::Level::err, format __VA_OPT__(, ) __VA_ARGS__)
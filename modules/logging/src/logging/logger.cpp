@@ -0,0 +1,365 @@
+#include <logging/logger.hpp>
+
+namespace hft::logging {
+
+namespace {
+
+// First estimate of the timestamp rate, refined against every later anchor.
+constexpr auto CALIBRATION = std::chrono::milliseconds(10);
+
+constexpr auto REANCHOR_INTERVAL = std::chrono::seconds(1);
+
+auto wall_clock_ns() noexcept -> int64_t
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+/*
+ * Maps raw timestamps to wall clock nanoseconds through the last pair of
+ * readings taken together. The rate comes from the distance between the
+ * first pair and the latest, so it gets more precise the longer the backend
+ * runs while re-anchoring keeps wall clock steps from accumulating.
+ */
+class TimestampClock
+{
+public:
+	void calibrate()
+	{
+		m_first = read_anchor();
+		std::this_thread::sleep_for(CALIBRATION);
+		reanchor();
+	}
+
+	void reanchor() noexcept
+	{
+		m_anchor = read_anchor();
+		if (m_anchor.timestamp > m_first.timestamp && m_anchor.wall_ns > m_first.wall_ns)
+		{
+			m_ns_per_tick = static_cast<double>(m_anchor.wall_ns - m_first.wall_ns) /
+							static_cast<double>(m_anchor.timestamp - m_first.timestamp);
+		}
+	}
+
+	[[nodiscard]] auto to_time_point(uint64_t timestamp) const noexcept -> spdlog::log_clock::time_point
+	{
+		// Signed, lines may have been stamped before the anchor was taken.
+		const auto ticks = static_cast<double>(static_cast<int64_t>(timestamp - m_anchor.timestamp));
+		const auto ns = m_anchor.wall_ns + static_cast<int64_t>(ticks * m_ns_per_tick);
+		return spdlog::log_clock::time_point(
+			std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(ns))
+		);
+	}
+
+private:
+	struct Anchor
+	{
+		uint64_t timestamp {};
+
+		int64_t wall_ns {};
+	};
+
+	static auto read_anchor() noexcept -> Anchor
+	{
+		// The midpoint of two reads around the clock call cancels most of its latency.
+		const auto before = read_timestamp();
+		const auto wall_ns = wall_clock_ns();
+		const auto after = read_timestamp();
+		return { before + (after - before) / 2, wall_ns };
+	}
+
+	Anchor m_first;
+
+	Anchor m_anchor;
+
+	double m_ns_per_tick = 1.0;
+};
+
+/*Every ring ever handed to a thread and the backend formatting them.*/
+struct Registry
+{
+	std::mutex mutex;
+
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+	// Bumped on every change to buffers so the backend only copies the list when it moved.
+	std::atomic<uint64_t> version {};
+
+	// Drops of rings already freed.
+	uint64_t retired_dropped {};
+
+	size_t buffer_records = LoggerConfig {}.buffer_records;
+
+	std::shared_ptr<spdlog::logger> logger;
+
+	std::chrono::microseconds poll_interval {};
+
+	std::atomic<bool> stop {};
+
+	std::atomic<uint64_t> flush_requested {};
+
+	std::atomic<uint64_t> flush_done {};
+
+	std::thread backend;
+};
+
+// Leaked: threads may log while statics are destroyed at exit.
+auto registry() -> Registry &
+{
+	static auto *instance = new Registry();
+	return *instance;
+}
+
+/*Marks the ring of its thread closed when the thread exits.*/
+struct ThreadHandle
+{
+	ThreadBuffer *buffer {};
+
+	ThreadHandle() = default;
+
+	ThreadHandle(const ThreadHandle &) = delete;
+
+	ThreadHandle(ThreadHandle &&) = delete;
+
+	auto operator=(const ThreadHandle &) -> ThreadHandle & = delete;
+
+	auto operator=(ThreadHandle &&) -> ThreadHandle & = delete;
+
+	~ThreadHandle()
+	{
+		if (buffer)
+		{
+			detail::t_buffer = nullptr;
+			buffer->closed.store(true, std::memory_order_release);
+		}
+	}
+};
+
+thread_local ThreadHandle t_handle;
+
+class Backend
+{
+public:
+	explicit Backend(Registry &shared)
+		: m_shared(shared)
+		, m_logger(*shared.logger)
+	{
+	}
+
+	void run()
+	{
+		m_clock.calibrate();
+		auto next_anchor = std::chrono::steady_clock::now() + REANCHOR_INTERVAL;
+
+		while (true)
+		{
+			// Read before the pass: every line queued when flush() asked is in the rings now.
+			const auto flush = m_shared.flush_requested.load(std::memory_order_acquire);
+			const auto stopping = m_shared.stop.load(std::memory_order_acquire);
+
+			const auto formatted = drain();
+			if (flush != m_shared.flush_done.load(std::memory_order_relaxed))
+			{
+				m_logger.flush();
+				m_shared.flush_done.store(flush, std::memory_order_release);
+				m_shared.flush_done.notify_all();
+			}
+
+			if (stopping)
+			{
+				m_logger.flush();
+				return;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now >= next_anchor)
+			{
+				m_clock.reanchor();
+				next_anchor = now + REANCHOR_INTERVAL;
+			}
+			if (formatted == 0)
+			{
+				std::this_thread::sleep_for(m_shared.poll_interval);
+			}
+		}
+	}
+
+private:
+	/*One pass over every ring, at most a ring's capacity from each so a busy thread cannot starve the others.*/
+	auto drain() -> size_t
+	{
+		refresh_buffers();
+
+		size_t formatted = 0;
+		bool retire = false;
+		for (auto *buffer : m_buffers)
+		{
+			const auto closed = buffer->closed.load(std::memory_order_acquire);
+			auto &queue = buffer->queue;
+			for (auto remaining = queue.capacity(); remaining != 0; --remaining)
+			{
+				const auto *record = queue.front();
+				if (!record)
+				{
+					break;
+				}
+				emit(*record);
+				queue.pop();
+				++formatted;
+			}
+			// The thread is gone, nothing can be published after the closed flag.
+			retire |= closed && queue.front() == nullptr;
+		}
+
+		if (retire)
+		{
+			retire_closed();
+		}
+		return formatted;
+	}
+
+	void emit(const LogRecord &record)
+	{
+		const auto &site = *record.site;
+		m_text.clear();
+		record.format(record, m_text);
+		m_logger.log(
+			m_clock.to_time_point(record.timestamp), spdlog::source_loc { site.file, site.line, "" }, site.level,
+			spdlog::string_view_t(m_text.data(), m_text.size())
+		);
+	}
+
+	void refresh_buffers()
+	{
+		const auto version = m_shared.version.load(std::memory_order_acquire);
+		if (version == m_version)
+		{
+			return;
+		}
+		const std::lock_guard lock(m_shared.mutex);
+		m_buffers.clear();
+		for (const auto &buffer : m_shared.buffers)
+		{
+			m_buffers.push_back(buffer.get());
+		}
+		m_version = m_shared.version.load(std::memory_order_relaxed);
+	}
+
+	void retire_closed()
+	{
+		const std::lock_guard lock(m_shared.mutex);
+		std::erase_if(
+			m_shared.buffers,
+			[&](const std::unique_ptr<ThreadBuffer> &buffer)
+			{
+				if (!buffer->closed.load(std::memory_order_acquire) || buffer->queue.front() != nullptr)
+				{
+					return false;
+				}
+				m_shared.retired_dropped += buffer->dropped.get();
+				return true;
+			}
+		);
+		// Forces refresh_buffers() before the freed rings are touched again.
+		m_shared.version.fetch_add(1, std::memory_order_release);
+	}
+
+	Registry &m_shared;
+
+	spdlog::logger &m_logger;
+
+	TimestampClock m_clock;
+
+	std::vector<ThreadBuffer *> m_buffers;
+
+	uint64_t m_version {};
+
+	fmt::memory_buffer m_text;
+};
+
+void stop_backend(Registry &shared)
+{
+	detail::g_min_level.store(Level::off, std::memory_order_relaxed);
+	if (!shared.backend.joinable())
+	{
+		return;
+	}
+	shared.stop.store(true, std::memory_order_release);
+	shared.backend.join();
+	shared.stop.store(false, std::memory_order_relaxed);
+	shared.logger.reset();
+}
+
+} // namespace
+
+void start(std::shared_ptr<spdlog::logger> logger, const LoggerConfig &config)
+{
+	if (!logger)
+	{
+		throw std::invalid_argument("Logger must not be null");
+	}
+
+	auto &shared = registry();
+	stop_backend(shared);
+
+	{
+		const std::lock_guard lock(shared.mutex);
+		shared.buffer_records = std::max<size_t>(config.buffer_records, 2);
+	}
+	shared.poll_interval = config.poll_interval;
+	shared.logger = std::move(logger);
+	shared.flush_done.store(shared.flush_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	shared.backend = std::thread([&shared] { Backend(shared).run(); });
+
+	detail::g_min_level.store(shared.logger->level(), std::memory_order_relaxed);
+}
+
+void stop()
+{
+	stop_backend(registry());
+}
+
+void flush()
+{
+	auto &shared = registry();
+	if (!shared.backend.joinable())
+	{
+		return;
+	}
+	const auto request = shared.flush_requested.fetch_add(1, std::memory_order_acq_rel) + 1;
+	auto done = shared.flush_done.load(std::memory_order_acquire);
+	while (done < request)
+	{
+		shared.flush_done.wait(done, std::memory_order_acquire);
+		done = shared.flush_done.load(std::memory_order_acquire);
+	}
+}
+
+auto get_dropped() -> uint64_t
+{
+	auto &shared = registry();
+	const std::lock_guard lock(shared.mutex);
+	auto dropped = shared.retired_dropped;
+	for (const auto &buffer : shared.buffers)
+	{
+		dropped += buffer->dropped.get();
+	}
+	return dropped;
+}
+
+namespace detail {
+
+auto register_thread() -> ThreadBuffer *
+{
+	auto &shared = registry();
+	const std::lock_guard lock(shared.mutex);
+	auto &buffer = shared.buffers.emplace_back(std::make_unique<ThreadBuffer>(shared.buffer_records));
+	shared.version.fetch_add(1, std::memory_order_release);
+	t_handle.buffer = buffer.get();
+	t_buffer = buffer.get();
+	return t_buffer;
+}
+
+} // namespace detail
+
+} // namespace hft::logging
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <logging/logger.hpp>
+#include <spdlog/sinks/base_sink.h>
+
+using namespace hft::logging;
+
+namespace {
+
+struct Line
+{
+	spdlog::log_clock::time_point time;
+
+	Level level;
+
+	std::string text;
+
+	int source_line;
+};
+
+/*Keeps every line, can hold the backend inside the first one to let rings fill up.*/
+class RecordingSink: public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+	std::vector<Line> lines;
+
+	std::atomic<bool> hold {};
+
+	std::atomic<bool> holding {};
+
+protected:
+	void sink_it_(const spdlog::details::log_msg &msg) override
+	{
+		while (hold.load())
+		{
+			holding.store(true);
+			std::this_thread::yield();
+		}
+		lines.push_back({ msg.time, msg.level, std::string(msg.payload.data(), msg.payload.size()), msg.source.line });
+	}
+
+	void flush_() override
+	{
+	}
+};
+
+} // namespace
+
+class LoggerTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		sink = std::make_shared<RecordingSink>();
+		logger = std::make_shared<spdlog::logger>("test", sink);
+		logger->set_level(Level::debug);
+	}
+
+	void TearDown() override
+	{
+		stop();
+	}
+
+	std::shared_ptr<RecordingSink> sink;
+
+	std::shared_ptr<spdlog::logger> logger;
+};
+
+TEST_F(LoggerTest, Format_ArgumentsFormattedOnBackend)
+{
+	start(logger);
+	const auto before = std::chrono::system_clock::now();
+	const uint64_t price = 10'050;
+	const int32_t quantity = -3;
+	HFT_LOG_INFO("{} level {} qty {} ratio {:.2f} side {}", "bid", price, quantity, 0.5, 'B');
+	const auto line = __LINE__ - 1;
+	HFT_LOG_WARN("no arguments");
+	flush();
+	const auto after = std::chrono::system_clock::now();
+
+	ASSERT_EQ(sink->lines.size(), 2);
+	EXPECT_EQ(sink->lines[0].text, "bid level 10050 qty -3 ratio 0.50 side B");
+	EXPECT_EQ(sink->lines[0].level, Level::info);
+	EXPECT_EQ(sink->lines[0].source_line, line);
+	EXPECT_EQ(sink->lines[1].text, "no arguments");
+	EXPECT_EQ(sink->lines[1].level, Level::warn);
+
+	// Raw timestamps come back as wall time, allow for the conversion being an estimate.
+	const auto slack = std::chrono::milliseconds(50);
+	EXPECT_GE(sink->lines[0].time, before - slack);
+	EXPECT_LE(sink->lines[0].time, after + slack);
+	EXPECT_LE(sink->lines[0].time, sink->lines[1].time);
+}
+
+TEST_F(LoggerTest, Level_BelowLoggerLevelSkippedAtCallSite)
+{
+	logger->set_level(Level::warn);
+	start(logger);
+	EXPECT_FALSE(is_enabled(Level::info));
+	EXPECT_TRUE(is_enabled(Level::err));
+
+	HFT_LOG_DEBUG("hidden {}", 1);
+	HFT_LOG_INFO("hidden {}", 2);
+	HFT_LOG_ERROR("shown {}", 3);
+	flush();
+
+	ASSERT_EQ(sink->lines.size(), 1);
+	EXPECT_EQ(sink->lines[0].text, "shown 3");
+}
+
+TEST_F(LoggerTest, Stop_LoggingOffUntilStarted)
+{
+	EXPECT_FALSE(is_enabled(Level::critical));
+	HFT_LOG_ERROR("before start {}", 1);
+
+	start(logger);
+	HFT_LOG_ERROR("while running {}", 2);
+	stop();
+	EXPECT_FALSE(is_enabled(Level::critical));
+	HFT_LOG_ERROR("after stop {}", 3);
+	flush();
+
+	ASSERT_EQ(sink->lines.size(), 1);
+	EXPECT_EQ(sink->lines[0].text, "while running 2");
+}
+
+TEST_F(LoggerTest, Threads_EveryLineInOrderPerThread)
+{
+	constexpr size_t THREADS = 4;
+	constexpr uint64_t LINES = 2000;
+	start(logger, { .buffer_records = LINES });
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back(
+			[t]
+			{
+				for (uint64_t i = 0; i < LINES; ++i)
+				{
+					HFT_LOG_INFO("{} {}", t, i);
+				}
+			}
+		);
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	flush();
+
+	ASSERT_EQ(sink->lines.size(), THREADS * LINES);
+	std::array<uint64_t, THREADS> next {};
+	for (const auto &line : sink->lines)
+	{
+		size_t thread = 0;
+		uint64_t index = 0;
+		std::istringstream(line.text) >> thread >> index;
+		ASSERT_LT(thread, THREADS);
+		EXPECT_EQ(index, next[thread]++);
+	}
+	EXPECT_EQ(get_dropped(), 0);
+}
+
+TEST_F(LoggerTest, FullRing_DropsAndCounts)
+{
+	start(logger, { .buffer_records = 16 });
+	const auto dropped_before = get_dropped();
+
+	// The backend sits in the first line, the logging thread fills its ring behind it.
+	sink->hold = true;
+	std::thread producer(
+		[&]
+		{
+			HFT_LOG_INFO("first");
+			while (!sink->holding.load())
+			{
+				std::this_thread::yield();
+			}
+			for (int i = 0; i < 100; ++i)
+			{
+				HFT_LOG_INFO("line {}", i);
+			}
+		}
+	);
+	producer.join();
+	// The first line keeps its slot until the sink returns.
+	EXPECT_EQ(get_dropped() - dropped_before, 100 - 15);
+
+	sink->hold = false;
+	flush();
+	ASSERT_EQ(sink->lines.size(), 16);
+	EXPECT_EQ(sink->lines.back().text, "line 14");
+}
+
+TEST_F(LoggerTest, Start_NullLoggerThrows)
+{
+	EXPECT_THROW(start(nullptr), std::invalid_argument);
+	EXPECT_FALSE(is_enabled(Level::critical));
+}
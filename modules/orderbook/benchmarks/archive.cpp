@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <l2/archive.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+// 64M updates, about 2.7 GB on disk.
+constexpr uint64_t UPDATES = 64ULL << 20;
+
+constexpr uint64_t UPDATE_SPACING_NS = 1000;
+
+auto archive_path() -> std::string
+{
+	return (std::filesystem::temp_directory_path() / "orderbook_bench_archive.bin").string();
+}
+
+/*Writes the archive once per checkpoint interval, later runs of the binary reuse it.*/
+auto prepare_archive(size_t interval) -> std::string
+{
+	const auto path = archive_path() + "." + std::to_string(interval);
+	if (std::filesystem::exists(path))
+	{
+		try
+		{
+			ArchiveReader reader(path);
+			if (reader.get_update_count() == UPDATES)
+			{
+				return path;
+			}
+		}
+		catch (const std::runtime_error &)
+		{
+		}
+	}
+
+	ArchiveWriter writer(path, interval);
+	std::mt19937_64 rng(11);
+	for (uint64_t i = 0; i < UPDATES; ++i)
+	{
+		const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+		const auto price = side == Side::Bid ? 100'000 - rng() % 16 : 100'001 + rng() % 16;
+		writer.append({ i * UPDATE_SPACING_NS, i + 1, price, rng() % 4 == 0 ? 0 : rng() % 1000, side });
+	}
+	writer.finish();
+	return path;
+}
+
+} // namespace
+
+/*Book state at uniformly random timestamps, state.range(0) updates between checkpoints.*/
+static void BM_ArchiveSeek(benchmark::State &state)
+{
+	const ArchiveReader reader(prepare_archive(static_cast<size_t>(state.range(0))));
+	auto book = std::make_unique<OrderBook>();
+	std::mt19937_64 rng(13);
+
+	PerfCounters counters;
+	counters.start();
+
+	uint64_t replayed = 0;
+	for (auto _ : state)
+	{
+		replayed += reader.seek_time(rng() % (UPDATES * UPDATE_SPACING_NS), *book);
+		benchmark::DoNotOptimize(book->get_sequence());
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.counters["file_gb"] = static_cast<double>(reader.size()) / 1e9;
+	state.counters["replayed"] = benchmark::Counter(static_cast<double>(replayed), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ArchiveSeek)->Arg(256)->Arg(4096)->Arg(65536)->Unit(benchmark::kMicrosecond);
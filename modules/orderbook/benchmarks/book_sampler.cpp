@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <l2/book_sampler.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+/*
+ * Closing one tick over a universe of full books, a tenth of them updated
+ * since the previous tick. Time is per tick, the per book cost is in the
+ * counters.
+ */
+static void BM_BookSampler_Tick(benchmark::State &state)
+{
+	const auto count = static_cast<size_t>(state.range(0));
+
+	std::vector<std::unique_ptr<OrderBook>> books;
+	std::vector<const OrderBook *> pointers;
+	for (size_t b = 0; b < count; ++b)
+	{
+		auto &book = books.emplace_back(std::make_unique<OrderBook>());
+		for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+		{
+			book->update_bid_side(1000 - i, 10 + i);
+			book->update_ask_side(1001 + i, 10 + i);
+		}
+		pointers.push_back(book.get());
+	}
+
+	constexpr uint64_t INTERVAL = 10'000'000;
+	BookSampler sampler(pointers, { .interval_ns = INTERVAL, .ring_ticks = 64 });
+
+	uint64_t now = 0;
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		counters.pause();
+		for (size_t b = now / INTERVAL % 10; b < count; b += 10)
+		{
+			sampler.on_update(b, now + 1);
+		}
+		counters.resume();
+		state.ResumeTiming();
+
+		now += INTERVAL;
+		benchmark::DoNotOptimize(sampler.advance(now));
+	}
+	counters.stop();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+	counters.report(state, count);
+}
+BENCHMARK(BM_BookSampler_Tick)->Arg(1000)->Arg(5000)->ArgName("books");
+
+/*Cost added to every book update by folding it into the running averages.*/
+static void BM_BookSampler_OnUpdate(benchmark::State &state)
+{
+	OrderBook book;
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		book.update_bid_side(1000 - i, 10 + i);
+		book.update_ask_side(1001 + i, 10 + i);
+	}
+	const std::array<const OrderBook *, 1> pointers { &book };
+	BookSampler sampler(pointers, { .interval_ns = 1'000'000 });
+
+	uint64_t now = 0;
+	for (auto _ : state)
+	{
+		sampler.on_update(0, ++now);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BookSampler_OnUpdate);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <l2/book_store.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+constexpr size_t BOOKS = 1000;
+
+auto store_path() -> std::string
+{
+	return (std::filesystem::temp_directory_path() / "orderbook_bench_store.bin").string();
+}
+
+auto make_books() -> std::vector<std::unique_ptr<OrderBook>>
+{
+	std::vector<std::unique_ptr<OrderBook>> books;
+	for (size_t b = 0; b < BOOKS; ++b)
+	{
+		auto &book = books.emplace_back(std::make_unique<OrderBook>());
+		for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+		{
+			book->update_bid_side(1000 - i, 10 + i);
+			book->update_ask_side(1001 + i, 10 + i);
+		}
+	}
+	return books;
+}
+
+} // namespace
+
+static void BM_Checkpoint(benchmark::State &state)
+{
+	auto books = make_books();
+	BookStore store(store_path(), BOOKS);
+
+	PerfCounters counters;
+	counters.start();
+
+	size_t index = 0;
+	uint64_t sequence = 0;
+	for (auto _ : state)
+	{
+		auto &book = *books[index];
+		book.set_sequence(++sequence);
+		benchmark::DoNotOptimize(store.checkpoint(index, book));
+		index = index + 1 == BOOKS ? 0 : index + 1;
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Checkpoint);
+
+/*Restoring every book of a store, i.e. the warm start itself.*/
+static void BM_RestoreAll(benchmark::State &state)
+{
+	auto books = make_books();
+	BookStore store(store_path(), BOOKS);
+	for (size_t i = 0; i < BOOKS; ++i)
+	{
+		store.checkpoint(i, *books[i]);
+	}
+
+	PerfCounters counters;
+	counters.start();
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < BOOKS; ++i)
+		{
+			benchmark::DoNotOptimize(store.restore(i, *books[i]));
+		}
+	}
+
+	counters.stop();
+	counters.report(state, BOOKS);
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BOOKS));
+	std::filesystem::remove(store_path());
+}
+
+BENCHMARK(BM_RestoreAll)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <l2/capture_codec.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+constexpr size_t UPDATES = 4 << 20;
+
+/*
+ * Capture shaped like a liquid symbol: bursts of updates microseconds apart
+ * between quieter stretches, prices around a slowly drifting mid, mostly
+ * small quantities and a quarter of deletes.
+ */
+auto make_capture() -> const std::vector<MarketUpdate> &
+{
+	static const auto updates = []
+	{
+		std::vector<MarketUpdate> result;
+		result.reserve(UPDATES);
+		std::mt19937_64 rng(17);
+		std::exponential_distribution<double> burst_gap(1.0 / 2'000);
+		std::exponential_distribution<double> quiet_gap(1.0 / 300'000);
+		std::lognormal_distribution<double> size(4.0, 1.2);
+
+		uint64_t timestamp = 1'700'000'000'000'000'000;
+		uint64_t mid = 2'500'000;
+		bool burst = true;
+		for (uint64_t i = 0; i < UPDATES; ++i)
+		{
+			burst = rng() % 64 == 0 ? !burst : burst;
+			timestamp += static_cast<uint64_t>(burst ? burst_gap(rng) : quiet_gap(rng));
+			if (rng() % 16 == 0)
+			{
+				mid = mid + rng() % 3 - 1;
+			}
+			const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			const auto depth = std::min<uint64_t>(rng() % 4 == 0 ? rng() % 20 : rng() % 3, 20);
+			const auto price = side == Side::Bid ? mid - depth : mid + 1 + depth;
+			const auto qty = rng() % 4 == 0 ? 0 : 1 + static_cast<uint64_t>(size(rng));
+			result.push_back({ timestamp, i + 1, price, qty, side });
+		}
+		return result;
+	}();
+	return updates;
+}
+
+auto encode_capture(const std::vector<MarketUpdate> &updates) -> std::vector<std::byte>
+{
+	CaptureEncoder encoder;
+	std::vector<std::byte> buffer;
+	buffer.reserve(updates.size() * sizeof(MarketUpdate) / 2);
+	size_t size = 0;
+	for (size_t offset = 0; offset < updates.size();)
+	{
+		buffer.resize(size + CaptureFormat::max_block_size(CaptureFormat::MAX_UPDATES));
+		const auto block = encoder.encode_block(std::span(updates).subspan(offset), std::span(buffer).subspan(size));
+		offset += block.count;
+		size += block.size;
+	}
+	buffer.resize(size);
+	return buffer;
+}
+
+void report_sizes(benchmark::State &state, size_t compressed)
+{
+	const auto raw = UPDATES * sizeof(MarketUpdate);
+	state.counters["ratio"] = static_cast<double>(raw) / static_cast<double>(compressed);
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(raw));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(UPDATES));
+}
+
+} // namespace
+
+/*Capture encode, bytes are uncompressed MarketUpdate bytes.*/
+static void BM_CaptureEncode(benchmark::State &state)
+{
+	const auto &updates = make_capture();
+	size_t compressed = 0;
+	for (auto _ : state)
+	{
+		compressed = encode_capture(updates).size();
+	}
+	report_sizes(state, compressed);
+}
+
+/*Capture decode into a reused block buffer, bytes are uncompressed MarketUpdate bytes.*/
+static void BM_CaptureDecode(benchmark::State &state)
+{
+	const auto capture = encode_capture(make_capture());
+	CaptureDecoder decoder;
+	std::vector<MarketUpdate> out(CaptureFormat::MAX_UPDATES);
+
+	PerfCounters counters;
+	counters.start();
+
+	for (auto _ : state)
+	{
+		for (size_t offset = 0; offset < capture.size();)
+		{
+			const auto block = decoder.decode_block(std::span(capture).subspan(offset), out);
+			offset += block->size;
+			benchmark::DoNotOptimize(out.data());
+		}
+		benchmark::ClobberMemory();
+	}
+
+	counters.stop();
+	counters.report(state, UPDATES);
+	report_sizes(state, capture.size());
+}
+
+/*Decode straight into an OrderBook.*/
+static void BM_CaptureReplay(benchmark::State &state)
+{
+	const auto capture = encode_capture(make_capture());
+	CaptureDecoder decoder;
+	std::vector<MarketUpdate> out(CaptureFormat::MAX_UPDATES);
+
+	for (auto _ : state)
+	{
+		auto book = std::make_unique<OrderBook>();
+		for (size_t offset = 0; offset < capture.size();)
+		{
+			const auto block = decoder.decode_block(std::span(capture).subspan(offset), out);
+			for (size_t i = 0; i < block->count; ++i)
+			{
+				apply_market_update(*book, out[i]);
+			}
+			offset += block->size;
+		}
+		benchmark::DoNotOptimize(book->get_sequence());
+	}
+	report_sizes(state, capture.size());
+}
+
+/*Baseline for BM_CaptureReplay: the same updates uncompressed and already in memory.*/
+static void BM_RawReplay(benchmark::State &state)
+{
+	const auto &updates = make_capture();
+	for (auto _ : state)
+	{
+		auto book = std::make_unique<OrderBook>();
+		for (const auto &update : updates)
+		{
+			apply_market_update(*book, update);
+		}
+		benchmark::DoNotOptimize(book->get_sequence());
+	}
+	report_sizes(state, UPDATES * sizeof(MarketUpdate));
+}
+
+BENCHMARK(BM_CaptureEncode)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CaptureDecode)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CaptureReplay)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RawReplay)->Unit(benchmark::kMillisecond);
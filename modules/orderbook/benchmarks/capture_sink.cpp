@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <l2/capture_sink.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+auto bench_path() -> std::string
+{
+	return (std::filesystem::temp_directory_path() / "bm_capture_sink.bin").string();
+}
+
+auto writer_name(bool io_uring, bool direct) -> std::string
+{
+	return std::string(io_uring ? "io_uring" : "pwrite") + (direct ? "+O_DIRECT" : "+buffered");
+}
+
+} // namespace
+
+/*
+ * Cost of append() on the hot thread. The writer drains the ring outside the
+ * timed region every 4096 records, so what is timed is the copy into the ring
+ * and not the drop path of a writer starved of CPU.
+ */
+static void BM_CaptureSink_Append(benchmark::State &state)
+{
+	constexpr size_t BURST = 4096;
+	const auto path = bench_path();
+	CaptureSink sink(path, { .queue_capacity = BURST });
+
+	MarketUpdate update { 1, 1, 1000, 10, Side::Bid };
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < BURST; ++i)
+		{
+			++update.timestamp_ns;
+			benchmark::DoNotOptimize(sink.append(update));
+		}
+
+		state.PauseTiming();
+		counters.pause();
+		while (sink.get_pending() != 0)
+		{
+			std::this_thread::yield();
+		}
+		counters.resume();
+		state.ResumeTiming();
+	}
+	counters.stop();
+	sink.finish();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BURST));
+	state.counters["dropped"] = static_cast<double>(sink.get_stats().dropped);
+	counters.report(state, BURST);
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_CaptureSink_Append);
+
+/*
+ * Sustained bandwidth to disk: 64 MiB of records pushed as fast as the
+ * writer takes them, timed until finish() returns with everything written.
+ */
+static void BM_CaptureSink_Sustained(benchmark::State &state)
+{
+	const auto io_uring = state.range(0) != 0;
+	const auto direct = state.range(1) != 0;
+	constexpr size_t RECORDS = (64 << 20) / sizeof(MarketUpdate);
+	const auto path = bench_path();
+
+	uint64_t bytes = 0;
+	uint64_t disk_waits = 0;
+	bool used_io_uring = false;
+	for (auto _ : state)
+	{
+		CaptureSink sink(path, { .direct = direct, .io_uring = io_uring });
+		used_io_uring = sink.uses_io_uring();
+
+		MarketUpdate update { 1, 1, 1000, 10, Side::Bid };
+		for (size_t i = 0; i < RECORDS;)
+		{
+			update.timestamp_ns = i;
+			if (sink.append(update))
+			{
+				++i;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		sink.finish();
+
+		bytes += sink.get_stats().bytes_written;
+		disk_waits += sink.get_stats().disk_waits;
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(bytes));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(RECORDS));
+	state.counters["disk_waits"] = static_cast<double>(disk_waits) / static_cast<double>(state.iterations());
+	state.SetLabel(writer_name(used_io_uring, direct));
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_CaptureSink_Sustained)
+	->ArgsProduct({ { 1, 0 }, { 1, 0 } })
+	->ArgNames({ "io_uring", "direct" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
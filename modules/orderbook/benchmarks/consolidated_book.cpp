@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <l2/consolidated_book.hpp>
+
+using namespace hft::orderbook;
+
+namespace {
+
+struct VenueUpdate
+{
+	VenueId venue;
+
+	Side side;
+
+	uint64_t price;
+
+	uint64_t qty;
+};
+
+auto make_updates(size_t venue_count, size_t count) -> std::vector<VenueUpdate>
+{
+	std::mt19937_64 rng(42);
+	std::uniform_int_distribution<uint64_t> offset(0, 15);
+	std::uniform_int_distribution<uint64_t> qty(0, 100);
+
+	std::vector<VenueUpdate> updates;
+	updates.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto venue = static_cast<VenueId>(i % venue_count);
+		const auto side = (i / venue_count) % 2 == 0 ? Side::Bid : Side::Ask;
+		const auto price = side == Side::Bid ? 10000 - offset(rng) : 10001 + offset(rng);
+		// Roughly one in five updates deletes a level.
+		const auto q = qty(rng);
+		updates.push_back({ venue, side, price, q < 20 ? 0 : q });
+	}
+	return updates;
+}
+
+} // namespace
+
+static void BM_ConsolidatedUpdate(benchmark::State &state)
+{
+	const auto venue_count = static_cast<size_t>(state.range(0));
+
+	auto venues = std::make_unique<std::array<OrderBook, ConsolidatedBook::MAX_VENUES>>();
+	auto consolidated = std::make_unique<ConsolidatedBook>();
+	for (size_t i = 0; i < venue_count; ++i)
+	{
+		consolidated->add_venue((*venues)[i]);
+	}
+
+	const auto updates = make_updates(venue_count, 1 << 16);
+	size_t i = 0;
+
+	for (auto _ : state)
+	{
+		const auto &update = updates[i++ & (updates.size() - 1)];
+		if (update.side == Side::Bid)
+		{
+			consolidated->update_bid_side(update.venue, update.price, update.qty);
+		}
+		else
+		{
+			consolidated->update_ask_side(update.venue, update.price, update.qty);
+		}
+		benchmark::DoNotOptimize(consolidated->best_bid());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConsolidatedUpdate)->DenseRange(5, 10, 1);
+
+static void BM_ConsolidatedBest(benchmark::State &state)
+{
+	const auto venue_count = static_cast<size_t>(state.range(0));
+
+	auto venues = std::make_unique<std::array<OrderBook, ConsolidatedBook::MAX_VENUES>>();
+	auto consolidated = std::make_unique<ConsolidatedBook>();
+	for (size_t i = 0; i < venue_count; ++i)
+	{
+		consolidated->add_venue((*venues)[i]);
+	}
+
+	for (const auto &update : make_updates(venue_count, 1024))
+	{
+		if (update.side == Side::Bid)
+		{
+			consolidated->update_bid_side(update.venue, update.price, update.qty);
+		}
+		else
+		{
+			consolidated->update_ask_side(update.venue, update.price, update.qty);
+		}
+	}
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(consolidated->best_bid());
+		benchmark::DoNotOptimize(consolidated->best_ask());
+	}
+}
+
+BENCHMARK(BM_ConsolidatedBest)->Arg(5)->Arg(10);
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <l2/ladder_view.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+constexpr std::array<uint64_t, LadderView::MAX_WIDTHS> WIDTHS { 1, 10, 100, 1000 };
+
+auto make_updates() -> std::vector<std::pair<uint64_t, uint64_t>>
+{
+	std::vector<std::pair<uint64_t, uint64_t>> updates(1 << 16);
+	std::mt19937_64 rng(9);
+	for (auto &[price, qty] : updates)
+	{
+		price = 100'000 - rng() % 200;
+		qty = rng() % 4 == 0 ? 0 : 1 + rng() % 1000;
+	}
+	return updates;
+}
+
+} // namespace
+
+/*Bid updates over a 200 tick range with the cold tier on, through state.range(0) ladders (0 is the bare book).*/
+static void BM_LadderUpdate(benchmark::State &state)
+{
+	const auto ladders = static_cast<size_t>(state.range(0));
+	const auto updates = make_updates();
+
+	auto book = std::make_unique<OrderBook>();
+	book->set_cold_tier_enabled(true);
+	auto view = std::make_unique<LadderView>(*book, std::span(WIDTHS).first(ladders));
+
+	PerfCounters counters;
+	counters.start();
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto &[price, qty] = updates[i++ & (updates.size() - 1)];
+		if (ladders == 0)
+		{
+			book->update_bid_side(price, qty);
+		}
+		else
+		{
+			view->update_bid_side(price, qty);
+		}
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+/*Reads the 20 best 10 tick buckets, the recompute alternative walks every level.*/
+static void BM_LadderRead(benchmark::State &state)
+{
+	const auto updates = make_updates();
+	auto book = std::make_unique<OrderBook>();
+	book->set_cold_tier_enabled(true);
+	auto view = std::make_unique<LadderView>(*book, WIDTHS);
+	for (const auto &[price, qty] : updates)
+	{
+		view->update_bid_side(price, qty);
+	}
+
+	for (auto _ : state)
+	{
+		uint64_t total = 0;
+		for (uint64_t bucket = 0; bucket < 20; ++bucket)
+		{
+			total += view->get_quantity(1, Side::Bid, 100'000 - bucket * 10);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * 20);
+}
+
+BENCHMARK(BM_LadderUpdate)->DenseRange(0, LadderView::MAX_WIDTHS);
+BENCHMARK(BM_LadderRead);
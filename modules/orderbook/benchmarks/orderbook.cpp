@@ -0,0 +1,232 @@
+#include <benchmark/benchmark.h>
+#include <l2/orderbook.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+// Books touched per iteration, amortises the cost of pausing around the reset.
+constexpr size_t BATCH = 16;
+
+using Books = std::vector<std::unique_ptr<OrderBook>>;
+
+auto make_books(uint64_t first_price, size_t levels) -> Books
+{
+	Books books;
+	for (size_t b = 0; b < BATCH; ++b)
+	{
+		auto &book = books.emplace_back(std::make_unique<OrderBook>());
+		for (size_t i = 0; i < levels; ++i)
+		{
+			book->update_bid_side(first_price + i, 10);
+		}
+	}
+	return books;
+}
+
+/*
+ * Applies op to every book of the batch with hardware counters around it. reset
+ * restores the books for the next iteration and is excluded from both time and
+ * counters. Time and counters are reported per op.
+ */
+template<typename Op, typename Reset>
+void run_scenario(benchmark::State &state, Books &books, Op &&op, Reset &&reset)
+{
+	PerfCounters counters;
+	counters.start();
+
+	for (auto _ : state)
+	{
+		for (auto &book : books)
+		{
+			op(*book);
+		}
+
+		state.PauseTiming();
+		counters.pause();
+		for (auto &book : books)
+		{
+			reset(*book);
+		}
+		counters.resume();
+		state.ResumeTiming();
+	}
+
+	counters.stop();
+	counters.report(state, BATCH);
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BATCH));
+}
+
+/*levels snapshot levels from best, step apart in price.*/
+auto make_snapshot_side(uint64_t best, int64_t step, size_t levels) -> std::vector<PriceLevel>
+{
+	std::vector<PriceLevel> side;
+	for (size_t i = 0; i < levels; ++i)
+	{
+		side.push_back({ static_cast<uint64_t>(static_cast<int64_t>(best) + step * static_cast<int64_t>(i)), 1 + i });
+	}
+	return side;
+}
+
+} // namespace
+
+static void BM_HeadInsert(benchmark::State &state)
+{
+	auto books = make_books(1000, OrderBook::MAX_LEVELS - 1);
+
+	run_scenario(
+		state,
+		books,
+		[](OrderBook &book) { book.update_bid_side(2000, 10); },
+		[](OrderBook &book) { book.update_bid_side(2000, 0); }
+	);
+}
+
+BENCHMARK(BM_HeadInsert);
+
+static void BM_TailInsert(benchmark::State &state)
+{
+	auto books = make_books(1000, OrderBook::MAX_LEVELS - 1);
+
+	run_scenario(
+		state,
+		books,
+		[](OrderBook &book) { book.update_bid_side(500, 10); },
+		[](OrderBook &book) { book.update_bid_side(500, 0); }
+	);
+}
+
+BENCHMARK(BM_TailInsert);
+
+static void BM_Eviction(benchmark::State &state)
+{
+	auto books = make_books(1000, OrderBook::MAX_LEVELS);
+
+	run_scenario(
+		state,
+		books,
+		[](OrderBook &book) { book.update_bid_side(2000, 10); },
+		[](OrderBook &book)
+		{
+			book.update_bid_side(2000, 0);
+			book.update_bid_side(1000, 10);
+		}
+	);
+}
+
+BENCHMARK(BM_Eviction);
+
+static void BM_Delete(benchmark::State &state)
+{
+	auto books = make_books(1000, OrderBook::MAX_LEVELS);
+
+	run_scenario(
+		state,
+		books,
+		[](OrderBook &book) { book.update_bid_side(1002, 0); },
+		[](OrderBook &book) { book.update_bid_side(1002, 10); }
+	);
+}
+
+BENCHMARK(BM_Delete);
+
+static void BM_QuantityUpdate(benchmark::State &state)
+{
+	auto books = make_books(1000, OrderBook::MAX_LEVELS);
+	auto &book = books.front();
+
+	PerfCounters counters;
+	counters.start();
+
+	uint64_t qty = 1;
+	for (auto _ : state)
+	{
+		book->update_bid_side(1002, ++qty);
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_QuantityUpdate);
+
+static void BM_HashTableChurn(benchmark::State &state)
+{
+	// A sliding window of live prices keeps inserting and removing, which
+	// leaves tombstones behind and stretches the probe chains.
+	constexpr uint64_t LIVE = 64;
+
+	auto table = std::make_unique<L2HashTable>();
+	std::vector<Level> levels(LIVE);
+
+	uint64_t next = 1;
+	for (; next <= LIVE; ++next)
+	{
+		table->insert(next * 7919, &levels[next % LIVE]);
+	}
+
+	PerfCounters counters;
+	counters.start();
+
+	for (auto _ : state)
+	{
+		table->remove((next - LIVE) * 7919);
+		table->insert(next * 7919, &levels[next % LIVE]);
+		benchmark::DoNotOptimize(table->lookup((next - LIVE / 2) * 7919));
+		++next;
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HashTableChurn);
+
+/*
+ * Resync from a REST snapshot of state.range(0) levels per side into a book
+ * with the cold tier enabled, level by level through add_*_side against one
+ * load_snapshot call.
+ */
+static void BM_SnapshotLoad(benchmark::State &state)
+{
+	const auto levels = static_cast<size_t>(state.range(0));
+	const auto bulk = state.range(1) != 0;
+	const auto bids = make_snapshot_side(100'000, -1, levels);
+	const auto asks = make_snapshot_side(100'001, 1, levels);
+
+	OrderBook book;
+	book.set_cold_tier_enabled(true);
+
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		if (bulk)
+		{
+			book.load_snapshot(bids, asks);
+		}
+		else
+		{
+			book.clear_bid_side();
+			book.clear_ask_side();
+			for (const auto &level : bids)
+			{
+				book.add_bid_side(level.price, level.quantity);
+			}
+			for (const auto &level : asks)
+			{
+				book.add_ask_side(level.price, level.quantity);
+			}
+		}
+		benchmark::DoNotOptimize(book.get_bid_count());
+	}
+	counters.stop();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * levels));
+	counters.report(state, 2 * levels);
+}
+BENCHMARK(BM_SnapshotLoad)->ArgsProduct({ { 20, 1000 }, { 0, 1 } })->ArgNames({ "levels", "bulk" });
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <l2/queue_tracker.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+/*
+ * Quantity updates cycling over the top levels through the tracker, with
+ * state.range(0) tracked prices on the side and every update hitting one of
+ * them when that is non-zero.
+ */
+static void BM_TrackerUpdate(benchmark::State &state)
+{
+	const auto tracked = static_cast<uint64_t>(state.range(0));
+
+	auto book = std::make_unique<OrderBook>();
+	auto tracker = std::make_unique<QueueTracker>(*book, QueueModel::ProRata);
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		tracker->update_bid_side(1000 - i, 1000);
+	}
+	for (uint64_t i = 0; i < tracked; ++i)
+	{
+		tracker->add_order(i, Side::Bid, 1000 - i % OrderBook::MAX_LEVELS, 1);
+	}
+
+	const auto levels = tracked != 0 ? std::min<uint64_t>(tracked, OrderBook::MAX_LEVELS) : OrderBook::MAX_LEVELS;
+
+	PerfCounters counters;
+	counters.start();
+
+	uint64_t qty = 1000;
+	uint64_t level = 0;
+	for (auto _ : state)
+	{
+		tracker->update_bid_side(1000 - level, qty);
+		level = level + 1 == levels ? 0 : level + 1;
+		qty = qty == 1 ? 1000 : qty - 1;
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TrackerUpdate)->Arg(0)->Arg(1)->Arg(5)->Arg(QueueTracker::MAX_ORDERS);
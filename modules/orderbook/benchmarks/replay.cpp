@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <l2/replay.hpp>
+
+using namespace hft::orderbook;
+using hft::core::WorkStealingPool;
+
+/*Replay of 512 symbols with skewed stream lengths on state.range(0) threads.*/
+static void BM_Replay(benchmark::State &state)
+{
+	constexpr size_t SYMBOLS = 512;
+
+	std::vector<std::vector<MarketUpdate>> streams(SYMBOLS);
+	std::mt19937_64 rng(3);
+	size_t total = 0;
+	for (size_t s = 0; s < SYMBOLS; ++s)
+	{
+		// A few liquid symbols carry most of the updates.
+		const auto count = s % 64 == 0 ? 200'000 : 5'000 + rng() % 5'000;
+		streams[s].reserve(count);
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			const auto price = side == Side::Bid ? 100'000 - rng() % 16 : 100'001 + rng() % 16;
+			streams[s].push_back({ i, i + 1, price, rng() % 4 == 0 ? 0 : rng() % 1000, side });
+		}
+		total += count;
+	}
+	const std::vector<std::span<const MarketUpdate>> spans(streams.begin(), streams.end());
+
+	WorkStealingPool pool(static_cast<size_t>(state.range(0)));
+	ReplayRunner runner(pool, SYMBOLS);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(runner.run(spans));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(total));
+}
+
+BENCHMARK(BM_Replay)
+	->Apply(
+		[](benchmark::internal::Benchmark *bench)
+		{
+			// Powers of two up to every core.
+			const auto cores = static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency()));
+			for (int64_t threads = 1; threads < cores; threads *= 2)
+			{
+				bench->Arg(threads);
+			}
+			bench->Arg(cores);
+		}
+	)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
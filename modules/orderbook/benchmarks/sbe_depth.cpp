@@ -0,0 +1,263 @@
+#include <benchmark/benchmark.h>
+#include <l2/sbe_depth.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+using hft::core::store_le;
+
+namespace {
+
+constexpr size_t MESSAGES = 1024;
+
+constexpr size_t LEVELS_PER_SIDE = 10;
+
+constexpr uint8_t PRICE_DECIMALS = 2;
+
+constexpr uint8_t QTY_DECIMALS = 5;
+
+struct Update
+{
+	int64_t first_id {};
+
+	int64_t last_id {};
+
+	std::vector<std::pair<int64_t, int64_t>> bids;
+
+	std::vector<std::pair<int64_t, int64_t>> asks;
+};
+
+/*Depth diffs around a slowly moving mid, a fifth of them deletes.*/
+auto make_updates() -> std::vector<Update>
+{
+	std::mt19937_64 rng(7);
+	std::vector<Update> updates(MESSAGES);
+	int64_t mid = 6'500'000;
+	int64_t id = 1;
+	for (auto &update : updates)
+	{
+		mid += static_cast<int64_t>(rng() % 5) - 2;
+		update.first_id = id;
+		id += 1 + static_cast<int64_t>(rng() % 3);
+		update.last_id = id - 1;
+		for (size_t i = 0; i < LEVELS_PER_SIDE; ++i)
+		{
+			const auto qty = rng() % 5 == 0 ? 0 : static_cast<int64_t>(rng() % 10'000'000);
+			update.bids.emplace_back(mid - 1 - static_cast<int64_t>(rng() % 20), qty);
+			update.asks.emplace_back(mid + 1 + static_cast<int64_t>(rng() % 20), qty);
+		}
+	}
+	return updates;
+}
+
+auto encode_sbe(const Update &update) -> std::vector<std::byte>
+{
+	constexpr std::string_view symbol = "BTCUSDT";
+	std::vector<std::byte> buffer(
+		sbe::MessageHeader::SIZE + sbe::DepthDiffStreamEvent::BLOCK_LENGTH + 2 * sbe::GroupSize16Encoding::SIZE +
+		2 * LEVELS_PER_SIDE * sbe::LevelEntry::BLOCK_LENGTH + 1 + symbol.size()
+	);
+
+	auto *pos = buffer.data();
+	pos = store_le(pos, static_cast<uint16_t>(sbe::DepthDiffStreamEvent::BLOCK_LENGTH));
+	pos = store_le(pos, sbe::DepthDiffStreamEvent::TEMPLATE_ID);
+	pos = store_le(pos, sbe::SCHEMA_ID);
+	pos = store_le(pos, uint16_t { 0 });
+	pos = store_le(pos, int64_t { 1'700'000'000'000'000 });
+	pos = store_le(pos, update.first_id);
+	pos = store_le(pos, update.last_id);
+	pos = store_le(pos, static_cast<int8_t>(-PRICE_DECIMALS));
+	pos = store_le(pos, static_cast<int8_t>(-QTY_DECIMALS));
+	for (const auto *levels : { &update.bids, &update.asks })
+	{
+		pos = store_le(pos, static_cast<uint16_t>(sbe::LevelEntry::BLOCK_LENGTH));
+		pos = store_le(pos, static_cast<uint16_t>(levels->size()));
+		for (const auto &[price, qty] : *levels)
+		{
+			pos = store_le(pos, price);
+			pos = store_le(pos, qty);
+		}
+	}
+	pos = store_le(pos, static_cast<uint8_t>(symbol.size()));
+	std::memcpy(pos, symbol.data(), symbol.size());
+	return buffer;
+}
+
+auto decimal(int64_t mantissa, uint8_t decimals) -> std::string
+{
+	auto text = std::to_string(mantissa);
+	if (text.size() <= decimals)
+	{
+		text.insert(0, decimals + 1 - text.size(), '0');
+	}
+	text.insert(text.size() - decimals, ".");
+	return text;
+}
+
+/*The same diff as the venue's JSON depthUpdate event.*/
+auto encode_json(const Update &update) -> std::string
+{
+	std::string json = R"({"e":"depthUpdate","E":1700000000000,"s":"BTCUSDT","U":)" +
+		std::to_string(update.first_id) + R"(,"u":)" + std::to_string(update.last_id);
+	for (const auto &[key, levels] : { std::pair { ",\"b\":[", &update.bids }, std::pair { ",\"a\":[", &update.asks } })
+	{
+		json += key;
+		for (size_t i = 0; i < levels->size(); ++i)
+		{
+			json += (i == 0 ? "[\"" : ",[\"") + decimal((*levels)[i].first, PRICE_DECIMALS) + "\",\"" +
+				decimal((*levels)[i].second, QTY_DECIMALS) + "\"]";
+		}
+		json += "]";
+	}
+	return json + "}";
+}
+
+/*
+ * Baseline JSON path: a single pass scanner specialised for depthUpdate, far
+ * cheaper than a general parser, converting decimal strings to fixed point.
+ */
+class JsonDepthParser
+{
+public:
+	void apply(std::string_view json, OrderBook &book) const
+	{
+		m_pos = json.data();
+		m_end = json.data() + json.size();
+
+		seek("\"U\":");
+		const auto first = integer();
+		seek("\"u\":");
+		const auto last = integer();
+		if (last <= book.get_sequence() || first > book.get_sequence() + 1)
+		{
+			return;
+		}
+
+		seek("\"b\":[");
+		levels([&](uint64_t price, uint64_t qty) { book.update_bid_side(price, qty); });
+		seek("\"a\":[");
+		levels([&](uint64_t price, uint64_t qty) { book.update_ask_side(price, qty); });
+		book.set_sequence(last);
+	}
+
+private:
+	void seek(std::string_view key) const
+	{
+		const auto found = std::string_view(m_pos, m_end).find(key);
+		m_pos += found + key.size();
+	}
+
+	auto integer() const -> uint64_t
+	{
+		uint64_t value = 0;
+		while (m_pos != m_end && *m_pos >= '0' && *m_pos <= '9')
+		{
+			value = value * 10 + static_cast<uint64_t>(*m_pos++ - '0');
+		}
+		return value;
+	}
+
+	auto fixed_point(uint8_t decimals) const -> uint64_t
+	{
+		// Opening quote.
+		++m_pos;
+		uint64_t value = integer();
+		uint8_t fraction = 0;
+		if (*m_pos == '.')
+		{
+			++m_pos;
+			while (*m_pos >= '0' && *m_pos <= '9')
+			{
+				if (fraction < decimals)
+				{
+					value = value * 10 + static_cast<uint64_t>(*m_pos - '0');
+					++fraction;
+				}
+				++m_pos;
+			}
+		}
+		for (; fraction < decimals; ++fraction)
+		{
+			value *= 10;
+		}
+		// Closing quote.
+		++m_pos;
+		return value;
+	}
+
+	template<typename Apply>
+	void levels(Apply &&apply) const
+	{
+		while (*m_pos == '[' || *m_pos == ',')
+		{
+			m_pos += *m_pos == ',' ? 2 : 1;
+			const auto price = fixed_point(PRICE_DECIMALS);
+			++m_pos;
+			const auto qty = fixed_point(QTY_DECIMALS);
+			++m_pos;
+			apply(price, qty);
+		}
+	}
+
+	mutable const char *m_pos {};
+
+	mutable const char *m_end {};
+};
+
+/*Applies the messages to one book in a loop, rewinding the book sequence on wrap.*/
+template<typename Messages, typename Apply>
+void run(benchmark::State &state, const Messages &messages, Apply &&apply)
+{
+	auto book = std::make_unique<OrderBook>();
+
+	PerfCounters counters;
+	counters.start();
+
+	size_t i = 0;
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		apply(messages[i], *book);
+		bytes += messages[i].size();
+		if (++i == messages.size())
+		{
+			i = 0;
+			book->set_sequence(0);
+		}
+	}
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+} // namespace
+
+static void BM_DepthDiffSbe(benchmark::State &state)
+{
+	std::vector<std::vector<std::byte>> messages;
+	for (const auto &update : make_updates())
+	{
+		messages.push_back(encode_sbe(update));
+	}
+
+	const SbeDepthDecoder decoder({ PRICE_DECIMALS, QTY_DECIMALS });
+	run(state, messages, [&](const auto &message, OrderBook &book) { decoder.apply(message, book); });
+}
+
+BENCHMARK(BM_DepthDiffSbe);
+
+static void BM_DepthDiffJson(benchmark::State &state)
+{
+	std::vector<std::string> messages;
+	for (const auto &update : make_updates())
+	{
+		messages.push_back(encode_json(update));
+	}
+
+	const JsonDepthParser parser;
+	run(state, messages, [&](const auto &message, OrderBook &book) { parser.apply(message, book); });
+}
+
+BENCHMARK(BM_DepthDiffJson);
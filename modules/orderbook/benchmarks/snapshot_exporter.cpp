@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <l2/snapshot_exporter.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+/*
+ * Sampling cost seen by the hot thread, one pass over 64 full books per
+ * iteration. Every 64 passes the writer gets to drain the ring outside the
+ * timed region, so what is timed is the copy into the ring and not the drop
+ * path of a writer starved of CPU.
+ */
+static void BM_SnapshotExporter_Sample(benchmark::State &state)
+{
+	constexpr size_t BOOKS = 64;
+	const auto depth = static_cast<size_t>(state.range(0));
+
+	std::vector<std::unique_ptr<OrderBook>> books;
+	for (size_t b = 0; b < BOOKS; ++b)
+	{
+		auto &book = books.emplace_back(std::make_unique<OrderBook>());
+		for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+		{
+			book->update_bid_side(1000 - i, 10 + b);
+			book->update_ask_side(1001 + i, 10 + b);
+		}
+	}
+
+	const auto path = std::filesystem::temp_directory_path() / "bm_snapshot_exporter.bin";
+	SnapshotExporter exporter(path.string(), { .depth = depth, .queue_capacity = BOOKS * 64 });
+
+	uint64_t timestamp = 0;
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		if (++timestamp % 64 == 0)
+		{
+			state.PauseTiming();
+			counters.pause();
+			while (exporter.get_pending() != 0)
+			{
+				std::this_thread::yield();
+			}
+			counters.resume();
+			state.ResumeTiming();
+		}
+		for (size_t b = 0; b < BOOKS; ++b)
+		{
+			benchmark::DoNotOptimize(exporter.sample(timestamp, static_cast<uint32_t>(b), *books[b]));
+		}
+	}
+	counters.stop();
+	exporter.finish();
+
+	const auto stats = exporter.get_stats();
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(BOOKS));
+	state.counters["dropped"] = static_cast<double>(stats.dropped) / static_cast<double>(stats.samples);
+	counters.report(state, BOOKS);
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_SnapshotExporter_Sample)->Arg(1)->Arg(5)->ArgName("depth");
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <l2/orderbook.hpp>
+#include <l2/stats_region.hpp>
+#include <perf_counters.hpp>
+
+using namespace hft::orderbook;
+using hft::common::PerfCounters;
+
+namespace {
+
+struct Update
+{
+	bool bid;
+
+	uint64_t price;
+
+	uint64_t qty;
+};
+
+/*Updates around a drifting mid, a fifth of them deletes, so every counter moves.*/
+auto make_updates(size_t count) -> std::vector<Update>
+{
+	std::mt19937_64 rng(11);
+	std::vector<Update> updates;
+	updates.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto bid = (rng() & 1) != 0;
+		const auto offset = rng() % 16;
+		const auto mid = 100'000 + (i >> 10) % 64;
+		updates.push_back({ bid, bid ? mid - 1 - offset : mid + offset, rng() % 5 == 0 ? 0 : 1 + rng() % 100 });
+	}
+	return updates;
+}
+
+} // namespace
+
+/*Same stream with and without counters in a shared region, the difference is what counting costs.*/
+static void BM_StatsRegion_UpdateOverhead(benchmark::State &state)
+{
+	const auto counted = state.range(0) != 0;
+	const auto updates = make_updates(1 << 16);
+
+	const auto path = std::filesystem::temp_directory_path() / "bm_stats_region.bin";
+	BookStatsRegion region(path.string(), 1);
+
+	OrderBook book;
+	book.set_counters(counted ? &region.get(0) : nullptr);
+
+	PerfCounters counters;
+	counters.start();
+	for (auto _ : state)
+	{
+		for (const auto &update : updates)
+		{
+			if (update.bid)
+			{
+				book.update_bid_side(update.price, update.qty);
+			}
+			else
+			{
+				book.update_ask_side(update.price, update.qty);
+			}
+		}
+		benchmark::DoNotOptimize(book.get_bid_count());
+	}
+	counters.stop();
+
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(updates.size()));
+	counters.report(state, updates.size());
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_StatsRegion_UpdateOverhead)->Arg(0)->Arg(1)->ArgName("counted");
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <l2/book_store.hpp>
+#include <l2/market_update.hpp>
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * On disk layout shared by ArchiveWriter and ArchiveReader, native endian:
+ *
+ *   FileHeader
+ *   block 0:  Checkpoint, MarketUpdate x n0
+ *   block 1:  Checkpoint, MarketUpdate x n1
+ *   ...
+ *   IndexEntry x blocks
+ *   Footer
+ *
+ * Every checkpoint holds the book after all updates written before it, the
+ * updates of a block follow it in feed order. The index is written last, an
+ * archive that was never finished has no footer and is refused.
+ */
+namespace archive {
+
+constexpr uint64_t MAGIC = 0x5643'5241'4c32'5446ULL;
+
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader
+{
+	uint64_t magic {};
+
+	uint32_t version {};
+
+	uint32_t max_levels {};
+};
+
+struct Checkpoint
+{
+	// Timestamp of the last update included, 0 before the first one.
+	uint64_t timestamp_ns {};
+
+	BookSnapshot book {};
+};
+
+struct IndexEntry
+{
+	uint64_t timestamp_ns {};
+
+	uint64_t sequence {};
+
+	// File offset of the block's Checkpoint.
+	uint64_t offset {};
+
+	uint64_t update_count {};
+};
+
+struct Footer
+{
+	uint64_t index_offset {};
+
+	uint64_t block_count {};
+
+	uint64_t update_count {};
+
+	uint64_t magic {};
+};
+
+static_assert(std::is_trivially_copyable_v<MarketUpdate> && sizeof(MarketUpdate) == 40);
+static_assert(sizeof(FileHeader) % alignof(Checkpoint) == 0 && sizeof(Checkpoint) % alignof(MarketUpdate) == 0);
+
+} // namespace archive
+
+/*
+ * Appends a symbol's updates to an archive, checkpointing its book every
+ * checkpoint_interval updates so a reader never replays more than that.
+ * Timestamps must not go backwards and neither may sequences other than 0,
+ * a venue that resets its sequence starts a new archive. The book runs
+ * without the cold tier, a
+ * reader restores into a book that has it disabled as well.
+ */
+class ArchiveWriter
+{
+public:
+	static constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 4096;
+
+	/*Creates or truncates the file at path, throws std::runtime_error on failure.*/
+	explicit ArchiveWriter(const std::string &path, size_t checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL);
+
+	ArchiveWriter(const ArchiveWriter &) = delete;
+
+	ArchiveWriter(ArchiveWriter &&) = delete;
+
+	auto operator=(const ArchiveWriter &) -> ArchiveWriter & = delete;
+
+	auto operator=(ArchiveWriter &&) -> ArchiveWriter & = delete;
+
+	/*Finishes the archive if that was not done, errors are lost.*/
+	~ArchiveWriter();
+
+	/*Returns false and writes nothing when the timestamp or a nonzero sequence is older than the previous one.*/
+	auto append(const MarketUpdate &update) -> bool;
+
+	/*Writes the index, throws std::runtime_error on failure. Nothing can be appended afterwards.*/
+	void finish();
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_update_count() const noexcept -> uint64_t
+	{
+		return m_update_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_book() const -> const OrderBook &
+	{
+		return *m_book;
+	}
+
+private:
+	void write_checkpoint();
+
+	void write(const void *data, size_t size);
+
+	void flush();
+
+	static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+	std::string m_path;
+
+	int m_fd = -1;
+
+	size_t m_checkpoint_interval;
+
+	std::unique_ptr<OrderBook> m_book;
+
+	std::vector<archive::IndexEntry> m_index;
+
+	std::vector<std::byte> m_buffer;
+
+	uint64_t m_offset {};
+
+	uint64_t m_update_count {};
+
+	uint64_t m_last_timestamp {};
+
+	// Last nonzero sequence, updates without one keep the book's.
+	uint64_t m_last_sequence {};
+};
+
+/*
+ * Read only mapping of a finished archive. A seek binary searches the index
+ * for the last checkpoint at or before the target, restores it and replays
+ * the rest of its block up to the target, touching only those pages.
+ */
+class ArchiveReader
+{
+public:
+	/*Maps the archive at path, throws std::runtime_error when it cannot or the file is not a finished archive.*/
+	explicit ArchiveReader(const std::string &path);
+
+	ArchiveReader(const ArchiveReader &) = delete;
+
+	ArchiveReader(ArchiveReader &&) = delete;
+
+	auto operator=(const ArchiveReader &) -> ArchiveReader & = delete;
+
+	auto operator=(ArchiveReader &&) -> ArchiveReader & = delete;
+
+	~ArchiveReader();
+
+	/*
+	 * Rebuilds the book as it was after every update with a timestamp up to
+	 * timestamp_ns. Returns the number of updates replayed on top of the checkpoint.
+	 */
+	auto seek_time(uint64_t timestamp_ns, OrderBook &book) const -> size_t;
+
+	/*As seek_time for the last update with a sequence up to sequence, for feeds that carry one.*/
+	auto seek_sequence(uint64_t sequence, OrderBook &book) const -> size_t;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_update_count() const noexcept -> uint64_t
+	{
+		return m_footer.update_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_index() const noexcept -> std::span<const archive::IndexEntry>
+	{
+		return m_index;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_mapping_size;
+	}
+
+private:
+	template<typename Key>
+	auto seek(uint64_t target, OrderBook &book, Key &&key) const -> size_t;
+
+	int m_fd = -1;
+
+	const std::byte *m_mapping {};
+
+	size_t m_mapping_size {};
+
+	archive::Footer m_footer {};
+
+	std::span<const archive::IndexEntry> m_index;
+};
+
+} // namespace hft::orderbook
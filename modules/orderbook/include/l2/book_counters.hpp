@@ -0,0 +1,43 @@
+#pragma once
+
+#include <core/stat_counter.hpp>
+#include <l2/hashtable.hpp>
+
+namespace hft::orderbook {
+
+/*Events of one side of a book, counted by the thread applying updates.*/
+struct SideCounters
+{
+	// Every update_*_side call.
+	core::StatCounter updates;
+
+	// New hot levels, including the ones replacing an evicted tail.
+	core::StatCounter inserts;
+
+	// Hot levels removed by a zero quantity.
+	core::StatCounter deletes;
+
+	// Hot tails pushed out by a better price on a full side.
+	core::StatCounter evictions;
+
+	// Prices worse than the tail of a full side dropped for lack of a cold tier.
+	core::StatCounter out_of_range;
+
+	// Levels lost because the pool had no slot left.
+	core::StatCounter pool_exhausted;
+
+	ProbeHistogram probes;
+};
+
+/*Counters of one book, a cache line of their own so books on different threads never share one.*/
+struct alignas(64) BookCounters
+{
+	// NUL padded, set by whoever lays out the region.
+	std::array<char, 32> name {};
+
+	SideCounters bids;
+
+	SideCounters asks;
+};
+
+} // namespace hft::orderbook
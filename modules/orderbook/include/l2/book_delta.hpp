@@ -0,0 +1,32 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+/*Effective change of one level as seen by the book, quantity 0 means absent.*/
+struct LevelDelta
+{
+	Side side {};
+
+	uint64_t price {};
+
+	uint64_t old_quantity {};
+
+	uint64_t new_quantity {};
+
+	friend auto operator==(const LevelDelta &lhs, const LevelDelta &rhs) -> bool = default;
+};
+
+/*
+ * Applies an update to the book and reports what actually changed in it: the
+ * updated level and, when a full side evicted its tail, the evicted level, or
+ * when a delete pulled a level up from the cold tier, the promoted level.
+ * Updates the book ignores (out of range prices, deletes of unknown levels)
+ * produce no deltas. Returns the number of deltas written to out.
+ */
+auto apply_update(OrderBook &book, Side side, uint64_t price, uint64_t qty, std::span<LevelDelta, 2> out)
+	-> size_t;
+
+} // namespace hft::orderbook
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+struct SamplerConfig
+{
+	uint64_t interval_ns = 10'000'000;
+
+	// Start of the first interval, every interval between it and the first update gets closed.
+	uint64_t start_ns {};
+
+	// Levels per side captured, at most OrderBook::MAX_LEVELS.
+	size_t depth = OrderBook::MAX_LEVELS;
+
+	// Ticks kept before their slots are reused, at least 2.
+	size_t ring_ticks = 1024;
+};
+
+/*One book at the end of one interval.*/
+struct BookSample
+{
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> bids {};
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> asks {};
+
+	uint64_t sequence {};
+
+	uint8_t bid_count {};
+
+	uint8_t ask_count {};
+
+	// False when the levels were carried over from the previous tick.
+	bool changed {};
+
+	// Averages weighted by how long each state lasted within the interval, NaN for a spread never two sided.
+	// Crossed books count with a negative spread, locked ones with 0.
+	double spread {};
+
+	double bid_depth {};
+
+	double ask_depth {};
+};
+
+/*
+ * Samples a fixed set of books on a fixed clock. The thread applying
+ * updates calls on_update after changing a book, which folds the state the
+ * book was in since its previous update into time weighted sums of spread
+ * and top depth. At every interval boundary the levels of every book go into
+ * a preallocated ring slot, books not updated during the interval are copied
+ * from their previous slot without touching the book. No allocation happens
+ * after construction.
+ */
+class BookSampler
+{
+public:
+	/*The books must outlive the sampler, their current state opens the first interval.*/
+	BookSampler(std::span<const OrderBook *const> books, const SamplerConfig &config);
+
+	/*
+	 * Records that book changed at timestamp_ns, closing every interval that
+	 * ended before. Intervals closed here already see the new levels, call
+	 * advance(timestamp_ns) before applying the update to keep them exact.
+	 */
+	void on_update(size_t book, uint64_t timestamp_ns);
+
+	/*Closes every interval ending at or before now_ns, returns how many.*/
+	auto advance(uint64_t now_ns) -> size_t;
+
+	/*Ticks closed so far, tick t covers [start + t * interval, start + (t + 1) * interval).*/
+	[[nodiscard]] auto get_tick_count() const noexcept -> uint64_t
+	{
+		return m_ticks;
+	}
+
+	/*Samples of every book at the end of tick, which must be one of the last ring_ticks ones.*/
+	[[nodiscard]] auto get_tick(uint64_t tick) const noexcept -> std::span<const BookSample>
+	{
+		assert(tick < m_ticks && m_ticks - tick <= m_ring_ticks);
+		return { m_slots.data() + (tick % m_ring_ticks) * m_books.size(), m_books.size() };
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_next_boundary() const noexcept -> uint64_t
+	{
+		return m_next_boundary;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_books.size();
+	}
+
+private:
+	// Last state seen of a book and its sums over the open interval.
+	struct State
+	{
+		uint64_t since_ns {};
+
+		int64_t spread {};
+
+		uint64_t bid_depth {};
+
+		uint64_t ask_depth {};
+
+		bool two_sided {};
+
+		bool dirty {};
+
+		double spread_area {};
+
+		double spread_time {};
+
+		double bid_depth_area {};
+
+		double ask_depth_area {};
+	};
+
+	void accumulate(State &state, uint64_t until_ns) const noexcept;
+
+	void refresh(size_t book) noexcept;
+
+	void close_tick() noexcept;
+
+	std::vector<const OrderBook *> m_books;
+
+	std::vector<State> m_states;
+
+	// ring_ticks rows of one BookSample per book.
+	std::vector<BookSample> m_slots;
+
+	uint64_t m_interval_ns;
+
+	size_t m_depth;
+
+	size_t m_ring_ticks;
+
+	uint64_t m_next_boundary;
+
+	uint64_t m_ticks {};
+};
+
+} // namespace hft::orderbook
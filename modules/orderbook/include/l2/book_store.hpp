@@ -0,0 +1,134 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+/*Plain copy of the hot levels of a book, best first, with the last applied sequence.*/
+struct BookSnapshot
+{
+	uint64_t sequence {};
+
+	uint32_t bid_count {};
+
+	uint32_t ask_count {};
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> bids {};
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> asks {};
+
+	auto operator==(const BookSnapshot &) const -> bool = default;
+};
+
+[[nodiscard]] auto make_snapshot(const OrderBook &book) -> BookSnapshot;
+
+/*Replaces the levels of the book with the snapshot, the cold tier is emptied.*/
+void restore_snapshot(OrderBook &book, const BookSnapshot &snapshot);
+
+/*
+ * Book snapshots persisted in a shared file mapping for warm restarts.
+ * Every book owns two slots written alternately, each stamped with a
+ * generation and a CRC32C, so a process dying halfway through a checkpoint
+ * leaves the previous slot intact. A checkpoint is a memcpy into the mapping,
+ * the kernel writes the pages back; sync() only requests write back for when
+ * the host itself may go down. A file written by another version or for
+ * another book count is reinitialised empty. The cold tier is not persisted,
+ * it refills from deltas.
+ */
+class BookStore
+{
+public:
+	static constexpr uint64_t MAGIC = 0x4b4f4f42'4c325446ULL;
+
+	static constexpr uint32_t VERSION = 1;
+
+	/*Opens or creates the file at path for books entries, throws std::runtime_error on failure.*/
+	BookStore(const std::string &path, size_t books);
+
+	BookStore(const BookStore &) = delete;
+
+	BookStore(BookStore &&) = delete;
+
+	auto operator=(const BookStore &) -> BookStore & = delete;
+
+	auto operator=(BookStore &&) -> BookStore & = delete;
+
+	~BookStore();
+
+	/*Stores the book in its spare slot, returns false when nothing changed since the last checkpoint.*/
+	auto checkpoint(size_t index, const OrderBook &book) -> bool;
+
+	/*Loads the newest valid slot into the book, returns false if there is none.*/
+	auto restore(size_t index, OrderBook &book) const -> bool;
+
+	/*Schedules write back of the whole mapping to disk.*/
+	void sync() const;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_size;
+	}
+
+	/*True when the file was created or reinitialised instead of reopened.*/
+	[[nodiscard]] auto is_fresh() const noexcept -> bool
+	{
+		return m_fresh;
+	}
+
+private:
+	struct alignas(64) Header
+	{
+		uint64_t magic {};
+
+		uint32_t version {};
+
+		uint32_t max_levels {};
+
+		uint64_t book_count {};
+
+		uint32_t slot_size {};
+
+		uint32_t checksum {};
+	};
+
+	struct alignas(64) Slot
+	{
+		// 0 marks a slot that was never written.
+		uint64_t generation {};
+
+		BookSnapshot snapshot {};
+
+		// CRC32C of generation and snapshot.
+		uint32_t checksum {};
+	};
+
+	[[nodiscard]] auto make_header() const -> Header;
+
+	[[nodiscard]] auto slots(size_t index) const -> Slot *
+	{
+		return m_slots + index * 2;
+	}
+
+	/*Newest slot whose checksum holds, nullptr if none.*/
+	[[nodiscard]] auto latest_slot(size_t index) const -> const Slot *;
+
+	[[nodiscard]] static auto slot_checksum(const Slot &slot) -> uint32_t;
+
+	int m_fd = -1;
+
+	void *m_mapping {};
+
+	size_t m_mapping_size {};
+
+	Slot *m_slots {};
+
+	size_t m_size {};
+
+	bool m_fresh {};
+
+	// Generation of the newest slot per book, the next checkpoint goes to the other one.
+	std::vector<uint64_t> m_generations;
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <core/stream_vbyte.hpp>
+#include <core/wire.hpp>
+#include <l2/market_update.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * Columnar block of consecutive updates for compressed captures.
+ *
+ *   header  u32 count, u32 size, u64 timestamp, u64 sequence, u64 price, u64 quantity
+ *   sides   one bit per update, set for asks
+ *   columns stream vbyte of zigzag(delta of delta) timestamps,
+ *           zigzag(delta of delta) sequences, zigzag(delta) prices, zigzag(delta) quantities
+ *
+ * The header holds the first update, so every column starts at 0. Regular
+ * timestamps and sequences come down to a single byte, prices and quantities
+ * to one or two. A block ends early at a value that does not fit 32 bits
+ * (a gap of seconds, a huge quantity), the next one starts over from it.
+ */
+struct CaptureFormat
+{
+	static constexpr size_t HEADER_SIZE = 40;
+
+	static constexpr size_t MAX_UPDATES = 1024;
+
+	static constexpr size_t COLUMNS = 4;
+
+	/*Buffer size that always fits a block of count updates.*/
+	static constexpr auto max_block_size(size_t count) -> size_t
+	{
+		return HEADER_SIZE + (count + 7) / 8 + COLUMNS * core::stream_vbyte_max_size(count);
+	}
+};
+
+struct CaptureBlockInfo
+{
+	// Updates in the block.
+	size_t count {};
+
+	// Bytes of the block.
+	size_t size {};
+};
+
+/*Writes blocks into caller buffers, the column scratch is kept inside.*/
+class CaptureEncoder
+{
+public:
+	/*
+	 * Encodes a block from the front of updates. Returns how many updates it
+	 * took and its size, both 0 when updates is empty or out is smaller than
+	 * max_block_size of the updates it would take.
+	 */
+	auto encode_block(std::span<const MarketUpdate> updates, std::span<std::byte> out) -> CaptureBlockInfo;
+
+private:
+	std::array<std::array<uint32_t, CaptureFormat::MAX_UPDATES>, CaptureFormat::COLUMNS> m_columns {};
+};
+
+/*Reads blocks back, the columns are expanded with SSSE3 where available.*/
+class CaptureDecoder
+{
+public:
+	/*Decodes the block at the front of in into out, nullopt when it is malformed or out is too small.*/
+	auto decode_block(std::span<const std::byte> in, std::span<MarketUpdate> out) -> std::optional<CaptureBlockInfo>;
+
+private:
+	std::array<std::array<uint32_t, CaptureFormat::MAX_UPDATES>, CaptureFormat::COLUMNS> m_columns {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <core/io_ring.hpp>
+#include <core/spsc_queue.hpp>
+#include <l2/market_update.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * On disk layout written by CaptureSink, native endian: a sequence of
+ * block_size blocks, each a BlockHeader followed by count MarketUpdates and
+ * zero padding. Blocks are page aligned and page sized so they can be written
+ * with O_DIRECT; the last one is padded like the others. A file whose writer
+ * died may end in a block cut short after its last flushed page, or in zeroed
+ * blocks that were preallocated and never written.
+ */
+namespace capture_file {
+
+constexpr uint64_t MAGIC = 0x4b43'4c42'5043'4c32ULL;
+
+struct alignas(64) BlockHeader
+{
+	uint64_t magic {};
+
+	// Position of the block in the file, catches blocks written out of place.
+	uint64_t index {};
+
+	// Bytes of every block in the file, header included.
+	uint64_t block_size {};
+
+	uint32_t count {};
+
+	uint32_t record_size {};
+};
+
+static_assert(std::is_trivially_copyable_v<MarketUpdate> && sizeof(BlockHeader) % alignof(MarketUpdate) == 0);
+
+} // namespace capture_file
+
+struct CaptureSinkConfig
+{
+	// Bytes per block, rounded up to a multiple of 4096.
+	size_t block_size = 1 << 20;
+
+	// Blocks in flight to the disk plus the one being filled.
+	size_t blocks = 8;
+
+	// Records between the hot thread and the writer.
+	size_t queue_capacity = 1 << 16;
+
+	// Oldest unwritten record a partly filled block may hold before its filled pages are rewritten in place.
+	std::chrono::milliseconds flush_interval { 100 };
+
+	// Bypass the page cache, falls back to buffered writes where the filesystem refuses it.
+	bool direct = true;
+
+	// Falls back to pwrite from the writer thread when false or when io_uring is unavailable.
+	bool io_uring = true;
+};
+
+struct CaptureSinkStats
+{
+	// Records accepted from the hot thread.
+	uint64_t records {};
+
+	// Records refused because the queue was full, the disk fell behind for longer than the queue covers.
+	uint64_t dropped {};
+
+	// Full blocks, each written once.
+	uint64_t blocks_written {};
+
+	// Partly filled blocks written in place on the flush interval, only their header and new pages.
+	uint64_t flushes {};
+
+	uint64_t bytes_written {};
+
+	// Times the writer had every block in flight and had to wait for the disk.
+	uint64_t disk_waits {};
+
+	// Most records ever seen waiting in the queue by the writer.
+	uint64_t queue_high_water {};
+};
+
+/*
+ * Records updates to disk without syscalls or waiting on the thread that
+ * applies them. append() copies the record into an SPSC ring; a background
+ * writer packs records into registered, page aligned blocks and writes
+ * them with io_uring fixed buffer writes, several blocks in flight. When the
+ * disk cannot keep up the blocks run out, the ring fills and append() starts
+ * refusing records, which is counted rather than waited on.
+ */
+class CaptureSink
+{
+public:
+	/*Creates or truncates the file at path and starts the writer, throws std::runtime_error on failure.*/
+	explicit CaptureSink(const std::string &path, const CaptureSinkConfig &config = {});
+
+	CaptureSink(const CaptureSink &) = delete;
+
+	CaptureSink(CaptureSink &&) = delete;
+
+	auto operator=(const CaptureSink &) -> CaptureSink & = delete;
+
+	auto operator=(CaptureSink &&) -> CaptureSink & = delete;
+
+	/*Finishes the file if that was not done, errors are lost.*/
+	~CaptureSink();
+
+	/*Queues the record, false if it was dropped. Only one thread may append.*/
+	auto append(const MarketUpdate &update) noexcept -> bool
+	{
+		if (!m_queue.try_push(update)) [[unlikely]]
+		{
+			++m_dropped;
+			return false;
+		}
+		++m_records;
+		return true;
+	}
+
+	/*
+	 * Writes every record appended so far, stops the writer and closes the
+	 * file. Rethrows the first write error as std::runtime_error. Nothing can
+	 * be appended afterwards.
+	 */
+	void finish();
+
+	/*From the appending thread, the writer's counters may lag.*/
+	[[nodiscard]] auto get_stats() const noexcept -> CaptureSinkStats;
+
+	/*Records queued and not yet taken by the writer.*/
+	[[nodiscard]] auto get_pending() const noexcept -> size_t
+	{
+		return m_queue.size();
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto uses_io_uring() const noexcept -> bool
+	{
+		return m_ring != nullptr;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto is_direct() const noexcept -> bool
+	{
+		return m_direct;
+	}
+
+	/*Records a block of block_size bytes holds.*/
+	[[nodiscard]] static constexpr auto records_per_block(size_t block_size) -> size_t
+	{
+		return (block_size - sizeof(capture_file::BlockHeader)) / sizeof(MarketUpdate);
+	}
+
+private:
+	void writer_loop();
+
+	void reap_completions();
+
+	/*Block to fill next, waits for the disk when every block is in flight.*/
+	void acquire_block();
+
+	/*Waits for the flushes of the current block, a later write to the same pages must not overtake them.*/
+	void wait_for_flushes();
+
+	/*Fills in the header of the current block for count records and reserves file space up to its end.*/
+	void write_header(size_t count);
+
+	/*Writes the pages of the current block holding records since the last flush, the block stays current.*/
+	void flush_block();
+
+	/*Writes the current block in full and moves on to the next.*/
+	void write_block();
+
+	void write_range(size_t begin, size_t length, bool flush);
+
+	[[nodiscard]] auto block_data(size_t block) const noexcept -> std::byte *
+	{
+		return m_blocks + block * m_block_size;
+	}
+
+	std::string m_path;
+
+	int m_fd = -1;
+
+	bool m_direct {};
+
+	size_t m_block_size;
+
+	size_t m_block_count;
+
+	size_t m_records_per_block;
+
+	std::chrono::nanoseconds m_flush_interval;
+
+	core::SpscQueue<MarketUpdate> m_queue;
+
+	// Appending thread only.
+	uint64_t m_records {};
+
+	uint64_t m_dropped {};
+
+	// Writer thread only, published for get_stats().
+	std::atomic<uint64_t> m_blocks_written {};
+
+	std::atomic<uint64_t> m_flushes {};
+
+	std::atomic<uint64_t> m_bytes_written {};
+
+	std::atomic<uint64_t> m_disk_waits {};
+
+	std::atomic<uint64_t> m_queue_high_water {};
+
+	// Page aligned blocks, registered with the ring when m_registered.
+	std::byte *m_blocks {};
+
+	std::unique_ptr<core::IoRing> m_ring;
+
+	bool m_registered {};
+
+	std::vector<size_t> m_free_blocks;
+
+	size_t m_in_flight {};
+
+	size_t m_flushes_in_flight {};
+
+	// Block being filled, its record count, the count when it was last flushed and when the first record after that arrived.
+	size_t m_current {};
+
+	size_t m_current_count {};
+
+	size_t m_flushed_count {};
+
+	std::chrono::steady_clock::time_point m_current_since {};
+
+	uint64_t m_next_index {};
+
+	// File size reserved with fallocate ahead of the writes.
+	uint64_t m_allocated {};
+
+	std::atomic<bool> m_stop {};
+
+	std::exception_ptr m_error;
+
+	std::thread m_writer;
+};
+
+/*
+ * Every record of a capture file in order, up to the first block never
+ * written. Throws std::runtime_error when a block is malformed.
+ */
+[[nodiscard]] auto read_capture_file(const std::string &path) -> std::vector<MarketUpdate>;
+
+} // namespace hft::orderbook
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+enum class ChecksumFormat : uint8_t
+{
+	// "bid_px:bid_qty:ask_px:ask_qty:..." interleaved, the longer side continues alone.
+	Okx,
+
+	// Same string layout as OKX.
+	Bitget,
+
+	// Asks then bids, each price and qty printed without decimal point and leading zeros.
+	Kraken
+};
+
+struct ChecksumConfig
+{
+	ChecksumFormat format = ChecksumFormat::Okx;
+
+	// Venues checksum 25 (OKX, Bitget) or 10 (Kraken) levels, at most BookChecksum::MAX_DEPTH.
+	size_t depth = 25;
+
+	// Fixed point scale of prices and quantities stored in the book.
+	uint8_t price_decimals {};
+
+	uint8_t qty_decimals {};
+
+	// Strip trailing fractional zeros, for venues that print "3366.1" rather than "3366.10".
+	bool trim_trailing_zeros = true;
+};
+
+/*
+ * Venue checksum of the top levels of a book.
+ * The level string is formatted into a stack buffer and hashed with the
+ * PCLMUL folded CRC32, so it is cheap enough to verify every message.
+ * Levels past the hot ones come from the cold tier, so a book checked deeper
+ * than OrderBook::MAX_LEVELS needs its cold tier enabled.
+ */
+class BookChecksum
+{
+public:
+	static constexpr size_t MAX_DEPTH = 25;
+
+	// 20 digits, a decimal point and a separator per number, four numbers per level.
+	static constexpr size_t MAX_STRING_SIZE = MAX_DEPTH * 4 * 22;
+
+	/*Throws std::runtime_error for a depth of 0 or above MAX_DEPTH.*/
+	explicit BookChecksum(ChecksumConfig config);
+
+	/*
+	 * CRC32 of the venue string, compare against the (sign-cast) value sent by
+	 * the venue. Throws std::runtime_error when the book cannot hold the
+	 * configured depth, a cut string would only ever report divergence.
+	 */
+	[[nodiscard]] auto compute(const OrderBook &book) const -> uint32_t;
+
+	/*Verifies the book against the checksum sent by the venue.*/
+	[[nodiscard]] auto verify(const OrderBook &book, uint32_t expected) const -> bool
+	{
+		return compute(book) == expected;
+	}
+
+	/*Writes the venue string into out and returns its length, out must hold MAX_STRING_SIZE chars. Throws like compute().*/
+	auto format(const OrderBook &book, std::span<char> out) const -> size_t;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_config() const -> const ChecksumConfig &
+	{
+		return m_config;
+	}
+
+private:
+	/*Best depth levels of one side, the hot ones followed by the cold tier's.*/
+	auto collect(const OrderBook &book, Side side, std::span<PriceLevel, MAX_DEPTH> out) const -> size_t;
+
+	auto append_fixed(char *pos, uint64_t value, uint8_t decimals) const -> char *;
+
+	ChecksumConfig m_config;
+};
+
+} // namespace hft::orderbook
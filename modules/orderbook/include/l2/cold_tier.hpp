@@ -0,0 +1,142 @@
+#pragma once
+
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * Compact sorted array of the levels beyond the hot top-N of one side.
+ * Stored worst to best, so the levels the hot tier evicts and later takes back
+ * are pushed and popped at the back. When full the worst level is dropped.
+ */
+template<Side SIDE, size_t N>
+class ColdTier
+{
+public:
+	/*Inserts or updates a level, qty 0 removes it.*/
+	void update(uint64_t price, uint64_t qty)
+	{
+		auto *begin = m_levels.data();
+		auto *end = begin + m_size;
+		auto *pos = std::lower_bound(
+			begin,
+			end,
+			price,
+			[](const PriceLevel &level, uint64_t value) { return is_worse(level.price, value); }
+		);
+
+		if (pos != end && pos->price == price)
+		{
+			if (qty == 0)
+			{
+				std::move(pos + 1, end, pos);
+				--m_size;
+			}
+			else
+			{
+				pos->quantity = qty;
+			}
+			return;
+		}
+
+		if (qty == 0)
+		{
+			return;
+		}
+
+		if (m_size == N)
+		{
+			if (pos == begin)
+			{
+				// Worse than everything we keep.
+				return;
+			}
+			std::move(begin + 1, pos, begin);
+			*(pos - 1) = { price, qty };
+			return;
+		}
+
+		std::move_backward(pos, end, end + 1);
+		*pos = { price, qty };
+		++m_size;
+	}
+
+	/*Replaces every level with the best N of levels, which must be sorted best first.*/
+	void assign(std::span<const PriceLevel> levels)
+	{
+		m_size = std::min(levels.size(), N);
+		std::reverse_copy(levels.begin(), levels.begin() + static_cast<ptrdiff_t>(m_size), m_levels.begin());
+	}
+
+	[[nodiscard]] auto find(uint64_t price) const -> const PriceLevel *
+	{
+		const auto *begin = m_levels.data();
+		const auto *end = begin + m_size;
+		const auto *pos = std::lower_bound(
+			begin,
+			end,
+			price,
+			[](const PriceLevel &level, uint64_t value) { return is_worse(level.price, value); }
+		);
+		return pos != end && pos->price == price ? pos : nullptr;
+	}
+
+	[[nodiscard]] auto best() const -> const PriceLevel &
+	{
+		assert(m_size > 0);
+		return m_levels[m_size - 1];
+	}
+
+	auto pop_best() -> PriceLevel
+	{
+		assert(m_size > 0);
+		return m_levels[--m_size];
+	}
+
+	/*Every level, worst first.*/
+	[[nodiscard]] auto levels() const noexcept -> std::span<const PriceLevel>
+	{
+		return { m_levels.data(), m_size };
+	}
+
+	void clear()
+	{
+		m_size = 0;
+	}
+
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_size;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto capacity() const noexcept -> size_t
+	{
+		return N;
+	}
+
+private:
+	static constexpr auto is_worse(uint64_t lhs, uint64_t rhs) -> bool
+	{
+		if constexpr (SIDE == Side::Bid)
+		{
+			return lhs < rhs;
+		}
+		else
+		{
+			return lhs > rhs;
+		}
+	}
+
+	std::array<PriceLevel, N> m_levels {};
+
+	size_t m_size {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+enum class LevelAction : uint8_t
+{
+	Insert,
+	Remove,
+	Change
+};
+
+struct LevelChange
+{
+	Side side {};
+
+	LevelAction action {};
+
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	friend auto operator==(const LevelChange &lhs, const LevelChange &rhs) -> bool = default;
+};
+
+/*Minimal top-N difference between two published states of a book.*/
+struct BookDiff
+{
+	// Per side a diff can at worst remove every published level and insert a full new top-N.
+	static constexpr size_t MAX_CHANGES = 4 * OrderBook::MAX_LEVELS;
+
+	std::array<LevelChange, MAX_CHANGES> changes {};
+
+	size_t count {};
+
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return count == 0;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_changes() const noexcept -> std::span<const LevelChange>
+	{
+		return { changes.data(), count };
+	}
+};
+
+struct ConflatorConfig
+{
+	// Number of levels per side that consumers see.
+	size_t depth = OrderBook::MAX_LEVELS;
+
+	// Flush once this many updates are pending, 0 disables the count threshold.
+	size_t max_updates = 0;
+
+	// Flush once the oldest pending update is this old, 0 disables the time threshold.
+	uint64_t max_delay_ns = 0;
+};
+
+/*
+ * Conflation stage on top of an OrderBook.
+ * Updates are forwarded to the book as usual while the touched pool slots are
+ * recorded in a dirty bitset. A flush compares the current top-N against the
+ * last published one and emits only the inserted, removed and changed levels,
+ * no matter how many intermediate updates hit the book in between.
+ */
+class Conflator
+{
+public:
+	explicit Conflator(OrderBook &book, ConflatorConfig config = {});
+
+	Conflator(const Conflator &) = delete;
+
+	Conflator(Conflator &&) = delete;
+
+	auto operator=(const Conflator &) -> Conflator & = delete;
+
+	auto operator=(Conflator &&) -> Conflator & = delete;
+
+	~Conflator() = default;
+
+	void update_bid_side(uint64_t price, uint64_t qty, uint64_t now_ns = 0);
+
+	void update_ask_side(uint64_t price, uint64_t qty, uint64_t now_ns = 0);
+
+	/*True when the count or time threshold of the current batch has been reached.*/
+	[[nodiscard]] auto flush_due(uint64_t now_ns) const -> bool;
+
+	/*Ends the batch and returns the diff against the previously published top-N.*/
+	auto flush() -> const BookDiff &;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_pending_updates() const -> size_t
+	{
+		return m_pending_updates;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_book() const -> const OrderBook &
+	{
+		return m_book;
+	}
+
+private:
+	using DirtySet = std::bitset<OrderBook::POOL_SIZE>;
+
+	using Snapshot = std::array<PriceLevel, OrderBook::MAX_LEVELS>;
+
+	void begin_update(uint64_t now_ns);
+
+	void diff_side(
+		Side side,
+		const core::ci_dllist *list,
+		const core::MemoryPool<Level, OrderBook::POOL_SIZE> &pool,
+		const DirtySet &dirty,
+		Snapshot &published,
+		size_t &published_count
+	);
+
+	void push_change(Side side, LevelAction action, uint64_t price, uint64_t quantity)
+	{
+		m_diff.changes[m_diff.count++] = { side, action, price, quantity };
+	}
+
+	OrderBook &m_book;
+
+	ConflatorConfig m_config;
+
+	DirtySet m_bids_dirty {};
+
+	DirtySet m_asks_dirty {};
+
+	Snapshot m_published_bids {};
+
+	Snapshot m_published_asks {};
+
+	size_t m_published_bid_count {};
+
+	size_t m_published_ask_count {};
+
+	size_t m_pending_updates {};
+
+	uint64_t m_batch_start_ns {};
+
+	BookDiff m_diff {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <core/dllist.hpp>
+#include <core/memory_pool.hpp>
+#include <l2/book_delta.hpp>
+#include <l2/hashtable.hpp>
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+using VenueId = uint8_t;
+
+/*Merged price level, embeds a Level so the L2HashTable and list helpers work unchanged.*/
+struct ConsolidatedLevel
+{
+	static constexpr size_t MAX_VENUES = 10;
+
+	// level.quantity holds the sum over all venues.
+	Level level {};
+
+	std::array<uint64_t, MAX_VENUES> venue_quantity {};
+
+	uint16_t venue_mask {};
+};
+
+/*Best merged price with the venue attribution.*/
+struct ConsolidatedBest
+{
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	// Venue contributing the largest quantity at this price.
+	VenueId venue {};
+
+	// Every venue quoting this price.
+	uint16_t venue_mask {};
+};
+
+/*
+ * Merged ladder of several per-venue OrderBooks.
+ * Updates are applied to the venue book first and only the resulting level
+ * deltas (including evictions) are folded into the merged ladder, so nothing
+ * is ever re-merged from scratch.
+ */
+class ConsolidatedBook
+{
+public:
+	static constexpr size_t MAX_VENUES = ConsolidatedLevel::MAX_VENUES;
+
+	// Every venue can contribute a full side of distinct prices.
+	static constexpr size_t POOL_SIZE = MAX_VENUES * OrderBook::MAX_LEVELS;
+
+	ConsolidatedBook()
+	{
+		ci_dllist_init(&m_bids_list);
+		ci_dllist_init(&m_asks_list);
+	}
+
+	ConsolidatedBook(const ConsolidatedBook &) = delete;
+
+	ConsolidatedBook(ConsolidatedBook &&) = delete;
+
+	auto operator=(const ConsolidatedBook &) -> ConsolidatedBook & = delete;
+
+	auto operator=(ConsolidatedBook &&) -> ConsolidatedBook & = delete;
+
+	~ConsolidatedBook() = default;
+
+	/*Registers a venue book and merges the levels it already holds.*/
+	auto add_venue(OrderBook &book) -> VenueId;
+
+	void update_bid_side(VenueId venue, uint64_t price, uint64_t qty);
+
+	void update_ask_side(VenueId venue, uint64_t price, uint64_t qty);
+
+	/*Folds a delta produced elsewhere (see apply_update) into the merged ladder.*/
+	void apply_delta(VenueId venue, const LevelDelta &delta);
+
+	[[nodiscard]] auto best_bid() const -> std::optional<ConsolidatedBest>;
+
+	[[nodiscard]] auto best_ask() const -> std::optional<ConsolidatedBest>;
+
+	[[nodiscard]] auto lookup_bid(uint64_t price) const -> const ConsolidatedLevel *;
+
+	[[nodiscard]] auto lookup_ask(uint64_t price) const -> const ConsolidatedLevel *;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_venue_count() const -> size_t
+	{
+		return m_venue_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_bid_count() const -> size_t
+	{
+		return m_bid_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_ask_count() const -> size_t
+	{
+		return m_ask_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_bids_list() const noexcept -> const core::ci_dllist *
+	{
+		return &m_bids_list;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_asks_list() const noexcept -> const core::ci_dllist *
+	{
+		return &m_asks_list;
+	}
+
+private:
+	void update_side(VenueId venue, Side side, uint64_t price, uint64_t qty);
+
+	void apply_bid_quantity(VenueId venue, uint64_t price, uint64_t qty);
+
+	void apply_ask_quantity(VenueId venue, uint64_t price, uint64_t qty);
+
+	void insert_bid_sorted(ConsolidatedLevel *level);
+
+	void insert_ask_sorted(ConsolidatedLevel *level);
+
+	[[nodiscard]] static auto make_best(const core::ci_dllist *list) -> std::optional<ConsolidatedBest>;
+
+	std::array<OrderBook *, MAX_VENUES> m_venues {};
+
+	size_t m_venue_count {};
+
+	size_t m_bid_count {};
+
+	size_t m_ask_count {};
+
+	core::ci_dllist m_bids_list {};
+
+	core::ci_dllist m_asks_list {};
+
+	L2HashTable m_bids_hash {};
+
+	L2HashTable m_asks_hash {};
+
+	core::MemoryPool<ConsolidatedLevel, POOL_SIZE> m_bids_pool {};
+
+	core::MemoryPool<ConsolidatedLevel, POOL_SIZE> m_asks_pool {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <core/wire.hpp>
+#include <l2/conflator.hpp>
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+enum class DeltaEncoding : uint8_t
+{
+	// Every change is a fixed 18 byte entry.
+	Fixed,
+
+	// Prices as zigzag varint offsets from the side's best price, quantities as varints.
+	Compact
+};
+
+/*
+ * SBE style message carrying a batch of level changes.
+ *
+ *   header  u16 block_length, u16 template_id, u16 schema_id, u16 version
+ *   root    u64 sequence, u64 bid_reference, u64 ask_reference
+ *   group   u16 entry_length, u16 count
+ *   entries fixed:   u64 price, u64 quantity, u8 side, u8 action
+ *           compact: u8 side | action << 1, varint zigzag(price - reference), varint quantity
+ *
+ * All integers little endian. The template id selects the encoding, the
+ * references are the best bid and ask the compact offsets are relative to.
+ */
+struct DeltaFormat
+{
+	static constexpr uint16_t SCHEMA_ID = 0x4c32;
+
+	static constexpr uint16_t VERSION = 1;
+
+	static constexpr uint16_t FIXED_TEMPLATE_ID = 1;
+
+	static constexpr uint16_t COMPACT_TEMPLATE_ID = 2;
+
+	static constexpr size_t HEADER_SIZE = 8;
+
+	static constexpr size_t ROOT_BLOCK_LENGTH = 24;
+
+	static constexpr size_t GROUP_HEADER_SIZE = 4;
+
+	static constexpr size_t PREFIX_SIZE = HEADER_SIZE + ROOT_BLOCK_LENGTH + GROUP_HEADER_SIZE;
+
+	static constexpr size_t FIXED_ENTRY_SIZE = 18;
+
+	static constexpr size_t MAX_COMPACT_ENTRY_SIZE = 1 + 2 * core::MAX_VARINT_SIZE;
+
+	static constexpr size_t MAX_CHANGES = UINT16_MAX;
+
+	/*Buffer size that always fits count changes in the given encoding.*/
+	static constexpr auto max_size(DeltaEncoding encoding, size_t count) -> size_t
+	{
+		return PREFIX_SIZE + count * (encoding == DeltaEncoding::Fixed ? FIXED_ENTRY_SIZE : MAX_COMPACT_ENTRY_SIZE);
+	}
+};
+
+/*Writes level changes into caller buffers, nothing is allocated.*/
+class DeltaEncoder
+{
+public:
+	explicit DeltaEncoder(DeltaEncoding encoding = DeltaEncoding::Compact)
+		: m_encoding(encoding)
+	{
+	}
+
+	/*
+	 * Encodes the changes with the book's current best prices as references.
+	 * Returns the message size, 0 when out is too small or there are more than
+	 * MAX_CHANGES changes.
+	 */
+	auto encode(std::span<std::byte> out, uint64_t sequence, std::span<const LevelChange> changes, const OrderBook &book)
+		const -> size_t;
+
+	/*Same with explicit references, 0 stands for an empty side.*/
+	auto encode(
+		std::span<std::byte> out,
+		uint64_t sequence,
+		std::span<const LevelChange> changes,
+		uint64_t bid_reference,
+		uint64_t ask_reference
+	) const -> size_t;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_encoding() const noexcept -> DeltaEncoding
+	{
+		return m_encoding;
+	}
+
+private:
+	DeltaEncoding m_encoding;
+};
+
+/*
+ * Read-only view over an encoded message, the buffer must outlive it.
+ * parse() validates the whole message once so iteration decodes the entries
+ * in place without further bounds checks. Iterators copy what they need and
+ * stay valid after the view itself is gone.
+ */
+class DeltaMessageView
+{
+public:
+	class Iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+
+		using value_type = LevelChange;
+
+		using difference_type = std::ptrdiff_t;
+
+		using pointer = void;
+
+		using reference = LevelChange;
+
+		Iterator() = default;
+
+		auto operator*() const -> LevelChange
+		{
+			return m_current;
+		}
+
+		auto operator++() -> Iterator &
+		{
+			--m_remaining;
+			decode();
+			return *this;
+		}
+
+		auto operator++(int) -> Iterator
+		{
+			auto previous = *this;
+			++*this;
+			return previous;
+		}
+
+		friend auto operator==(const Iterator &lhs, const Iterator &rhs) -> bool
+		{
+			return lhs.m_remaining == rhs.m_remaining;
+		}
+
+	private:
+		friend class DeltaMessageView;
+
+		Iterator(const DeltaMessageView &view, size_t remaining)
+			: m_pos(view.m_entries)
+			, m_remaining(remaining)
+			, m_references { view.m_bid_reference, view.m_ask_reference }
+			, m_encoding(view.m_encoding)
+		{
+			decode();
+		}
+
+		void decode()
+		{
+			if (m_remaining == 0)
+			{
+				return;
+			}
+
+			if (m_encoding == DeltaEncoding::Fixed)
+			{
+				m_current.price = core::load_le<uint64_t>(m_pos);
+				m_current.quantity = core::load_le<uint64_t>(m_pos + 8);
+				m_current.side = static_cast<Side>(m_pos[16]);
+				m_current.action = static_cast<LevelAction>(m_pos[17]);
+				m_pos += DeltaFormat::FIXED_ENTRY_SIZE;
+				return;
+			}
+
+			// parse() checked every varint terminates inside the buffer.
+			const auto flags = static_cast<uint8_t>(*m_pos++);
+			m_current.side = static_cast<Side>(flags & 1);
+			m_current.action = static_cast<LevelAction>(flags >> 1);
+
+			uint64_t offset;
+			m_pos = core::read_varint(m_pos, m_pos + core::MAX_VARINT_SIZE, offset);
+			m_current.price = m_references[flags & 1] + static_cast<uint64_t>(core::zigzag_decode(offset));
+			m_pos = core::read_varint(m_pos, m_pos + core::MAX_VARINT_SIZE, m_current.quantity);
+		}
+
+		const std::byte *m_pos {};
+
+		size_t m_remaining {};
+
+		std::array<uint64_t, 2> m_references {};
+
+		DeltaEncoding m_encoding {};
+
+		LevelChange m_current {};
+	};
+
+	/*Validates the message at the start of in, std::nullopt if it is malformed or truncated.*/
+	[[nodiscard]] static auto parse(std::span<const std::byte> in) -> std::optional<DeltaMessageView>;
+
+	[[nodiscard]] auto begin() const -> Iterator
+	{
+		return { *this, m_count };
+	}
+
+	[[nodiscard]] auto end() const -> Iterator
+	{
+		return {};
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_encoding() const noexcept -> DeltaEncoding
+	{
+		return m_encoding;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_sequence() const noexcept -> uint64_t
+	{
+		return m_sequence;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_bid_reference() const noexcept -> uint64_t
+	{
+		return m_bid_reference;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_ask_reference() const noexcept -> uint64_t
+	{
+		return m_ask_reference;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_count;
+	}
+
+	/*Bytes taken by the message, the next one in a stream starts there.*/
+	[[nodiscard]] auto get_message_size() const noexcept -> size_t
+	{
+		return m_message_size;
+	}
+
+private:
+	const std::byte *m_entries {};
+
+	size_t m_count {};
+
+	size_t m_message_size {};
+
+	uint64_t m_sequence {};
+
+	uint64_t m_bid_reference {};
+
+	uint64_t m_ask_reference {};
+
+	DeltaEncoding m_encoding {};
+};
+
+} // namespace hft::orderbook
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/dllist.hpp>
+#include <core/stat_counter.hpp>
 
 namespace hft::orderbook {
 
@@ -13,6 +14,9 @@ struct Level
 	core::ci_dllink link;
 };
 
+/*Slots visited per lookup or insert, bucket i counts [2^i, 2^(i+1)) probes, the last one everything above.*/
+using ProbeHistogram = std::array<core::StatCounter, 8>;
+
 class L2HashTable
 {
 public:
@@ -56,7 +60,22 @@ public:
 		m_table.fill(L2Entry {});
 	}
 
+	/*Starts recording probe lengths into histogram, nullptr stops it.*/
+	void set_probe_histogram(ProbeHistogram *histogram) noexcept
+	{
+		m_probes = histogram;
+	}
+
 private:
+	void record_probes(size_t probes) const noexcept
+	{
+		if (m_probes)
+		{
+			const auto bucket = std::min<size_t>(std::bit_width(probes) - 1, m_probes->size() - 1);
+			(*m_probes)[bucket].add();
+		}
+	}
+
 	[[nodiscard]] auto hash1(uint64_t key) const -> size_t
 	{
 		return static_cast<size_t>(key) & ENTRIES_MASK;
@@ -88,6 +107,8 @@ private:
 	}
 
 	std::array<L2Entry, ENTRIES> m_table {};
+
+	ProbeHistogram *m_probes {};
 };
 
 } // namespace hft::orderbook
\ No newline at end of file
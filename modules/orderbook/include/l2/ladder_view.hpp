@@ -0,0 +1,147 @@
+#pragma once
+
+#include <l2/book_delta.hpp>
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+/*Sum over the levels whose price falls in [price, price + width).*/
+struct LadderBucket
+{
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	uint32_t levels {};
+
+	friend auto operator==(const LadderBucket &lhs, const LadderBucket &rhs) -> bool = default;
+};
+
+/*
+ * Price ladders of an OrderBook grouped into buckets of several widths.
+ * Every update applied through the view turns into at most three level
+ * deltas (the level itself, a hot tail the book evicts, a cold level a full
+ * cold tier drops), each added to one bucket per width, so neither updates
+ * nor reads depend on the number of buckets. The cold tier counts as part of
+ * the book when enabled.
+ *
+ * Buckets of a width live in a ring of BUCKETS slots keyed by price / width.
+ * Buckets BUCKETS apart share a slot: while one of them holds levels the
+ * other's levels are left out and counted in get_collisions(). The slot
+ * passes to another bucket only once the levels left out are gone as well,
+ * so removing one never takes from a bucket it was not added to.
+ */
+class LadderView
+{
+public:
+	static constexpr size_t MAX_WIDTHS = 4;
+
+	static constexpr size_t BUCKETS = 1024;
+
+	/*Attaches to the book and sums the levels it holds, throws std::runtime_error for a zero or too many widths.*/
+	LadderView(OrderBook &book, std::span<const uint64_t> widths);
+
+	LadderView(const LadderView &) = delete;
+
+	LadderView(LadderView &&) = delete;
+
+	auto operator=(const LadderView &) -> LadderView & = delete;
+
+	auto operator=(LadderView &&) -> LadderView & = delete;
+
+	~LadderView() = default;
+
+	void update_bid_side(uint64_t price, uint64_t qty);
+
+	void update_ask_side(uint64_t price, uint64_t qty);
+
+	/*Folds a delta produced elsewhere (see apply_update) into the ladders.*/
+	void apply_delta(const LevelDelta &delta);
+
+	/*Bucket of ladder holding price, empty when no level falls in it.*/
+	[[nodiscard]] auto get_bucket(size_t ladder, Side side, uint64_t price) const -> LadderBucket
+	{
+		assert(ladder < m_ladder_count);
+
+		const auto width = m_widths[ladder];
+		const auto index = price / width;
+		const auto &slot = m_buckets[slot_of(ladder, side, index)];
+		if (slot.index != index || slot.levels == 0)
+		{
+			return { index * width, 0, 0 };
+		}
+		return { index * width, slot.quantity, slot.levels };
+	}
+
+	[[nodiscard]] auto get_quantity(size_t ladder, Side side, uint64_t price) const -> uint64_t
+	{
+		return get_bucket(ladder, side, price).quantity;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_width(size_t ladder) const -> uint64_t
+	{
+		return m_widths[ladder];
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_ladder_count() const noexcept -> size_t
+	{
+		return m_ladder_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_collisions() const noexcept -> uint64_t
+	{
+		return m_collisions;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_book() const -> const OrderBook &
+	{
+		return m_book;
+	}
+
+private:
+	struct Slot
+	{
+		// Bucket number, price / width.
+		uint64_t index {};
+
+		uint64_t quantity {};
+
+		uint32_t levels {};
+
+		// Levels of other buckets left out while this one held the slot.
+		uint32_t skipped {};
+	};
+
+	[[nodiscard]] static auto slot_of(size_t ladder, Side side, uint64_t index) -> size_t
+	{
+		return (ladder * 2 + static_cast<size_t>(side == Side::Ask)) * BUCKETS + (index & (BUCKETS - 1));
+	}
+
+	void update_side(Side side, uint64_t price, uint64_t qty);
+
+	void add_level(Side side, uint64_t price, uint64_t qty);
+
+	void remove_level(Side side, uint64_t price, uint64_t qty);
+
+	/*Quantity at price across the hot and the cold tier.*/
+	[[nodiscard]] auto depth_quantity(Side side, uint64_t price) const -> uint64_t;
+
+	static_assert(std::has_single_bit(BUCKETS));
+
+	OrderBook &m_book;
+
+	std::array<uint64_t, MAX_WIDTHS> m_widths {};
+
+	size_t m_ladder_count {};
+
+	std::unique_ptr<Slot[]> m_buckets;
+
+	uint64_t m_collisions {};
+};
+
+} // namespace hft::orderbook
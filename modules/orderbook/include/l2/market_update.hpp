@@ -0,0 +1,42 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+/*One recorded L2 update of a symbol, quantity 0 deletes the level.*/
+struct MarketUpdate
+{
+	uint64_t timestamp_ns {};
+
+	// Venue sequence, 0 when the feed has none.
+	uint64_t sequence {};
+
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	Side side {};
+
+	friend auto operator==(const MarketUpdate &lhs, const MarketUpdate &rhs) -> bool = default;
+};
+
+inline void apply_market_update(OrderBook &book, const MarketUpdate &update)
+{
+	if (update.side == Side::Bid)
+	{
+		book.update_bid_side(update.price, update.quantity);
+	}
+	else
+	{
+		book.update_ask_side(update.price, update.quantity);
+	}
+
+	if (update.sequence != 0)
+	{
+		book.set_sequence(update.sequence);
+	}
+}
+
+} // namespace hft::orderbook
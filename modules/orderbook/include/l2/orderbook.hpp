@@ -1,6 +1,11 @@
+#pragma once
+
 #include <core/dllist.hpp>
 #include <core/memory_pool.hpp>
+#include <l2/book_counters.hpp>
+#include <l2/cold_tier.hpp>
 #include <l2/hashtable.hpp>
+#include <l2/types.hpp>
 
 namespace hft::orderbook {
 
@@ -11,6 +16,9 @@ public:
 
 	static constexpr size_t POOL_SIZE = MAX_LEVELS + 5;
 
+	// Levels per side kept outside the hot pool when the cold tier is enabled.
+	static constexpr size_t COLD_LEVELS = 64;
+
 	OrderBook()
 	{
 		ci_dllist_init(&m_bids_list);
@@ -39,6 +47,15 @@ public:
 
 	void update_ask_side(uint64_t price, uint64_t qty);
 
+	/*
+	 * Replaces both sides with a snapshot given best first, in one pass per
+	 * side. The best MAX_LEVELS levels go hot, allocated front to back from
+	 * the pools so they sit adjacent in memory; the rest go to the cold tier
+	 * when it is enabled and are dropped otherwise. Zero quantities and
+	 * levels not strictly worse than the one before are skipped.
+	 */
+	void load_snapshot(std::span<const PriceLevel> bids, std::span<const PriceLevel> asks);
+
 	void insert_bid_sorted(Level *level);
 
 	void insert_ask_sorted(Level *level);
@@ -47,6 +64,32 @@ public:
 
 	void clear_ask_side();
 
+	/*
+	 * With the cold tier enabled, levels evicted from or priced outside a full
+	 * side are kept in a sorted array and promoted back when hot levels go.
+	 * Disabling it drops whatever the cold tier holds.
+	 */
+	void set_cold_tier_enabled(bool enabled);
+
+	/*
+	 * Starts counting events and hash probe lengths into counters, which may
+	 * live in shared memory read by a monitor. Only the thread applying
+	 * updates may write them; nullptr stops counting.
+	 */
+	void set_counters(BookCounters *counters) noexcept;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_counters() const noexcept -> const BookCounters *
+	{
+		return m_counters;
+	}
+
+	/*Copies the best out.size() bids (best first), returns the number written.*/
+	auto get_bid_levels(std::span<PriceLevel> out) const -> size_t;
+
+	/*Copies the best out.size() asks (best first), returns the number written.*/
+	auto get_ask_levels(std::span<PriceLevel> out) const -> size_t;
+
 	[[nodiscard]] auto get_bid_tail_price() const -> uint64_t
 	{
 		using namespace core;
@@ -90,6 +133,48 @@ public:
 		return m_ask_count;
 	}
 
+	/*Sequence of the last feed update applied, kept for persistence and gap checks.*/
+	void set_sequence(uint64_t sequence) noexcept
+	{
+		m_sequence = sequence;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_sequence() const noexcept -> uint64_t
+	{
+		return m_sequence;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto is_cold_tier_enabled() const -> bool
+	{
+		return m_cold_tier_enabled;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_bids_cold_tier() const -> const ColdTier<Side::Bid, COLD_LEVELS> &
+	{
+		return m_bids_cold;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_asks_cold_tier() const -> const ColdTier<Side::Ask, COLD_LEVELS> &
+	{
+		return m_asks_cold;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_bids_pool() const noexcept -> const core::MemoryPool<Level, POOL_SIZE> &
+	{
+		return m_bids_pool;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_asks_pool() const noexcept -> const core::MemoryPool<Level, POOL_SIZE> &
+	{
+		return m_asks_pool;
+	}
+
 	/*Trivial getter.*/
 	[[nodiscard]] auto get_bids_list() const noexcept -> const core::ci_dllist *
 	{
@@ -103,10 +188,19 @@ public:
 	}
 
 private:
+	template<Side SIDE>
+	void load_side(std::span<const PriceLevel> levels);
+
+	void promote_bid();
+
+	void promote_ask();
+
 	size_t m_bid_count {};
 
 	size_t m_ask_count {};
 
+	uint64_t m_sequence {};
+
 	core::ci_dllist m_bids_list {};
 
 	core::ci_dllist m_asks_list {};
@@ -118,6 +212,14 @@ private:
 	core::MemoryPool<Level, POOL_SIZE> m_bids_pool {};
 
 	core::MemoryPool<Level, POOL_SIZE> m_asks_pool {};
+
+	bool m_cold_tier_enabled {};
+
+	ColdTier<Side::Bid, COLD_LEVELS> m_bids_cold {};
+
+	ColdTier<Side::Ask, COLD_LEVELS> m_asks_cold {};
+
+	BookCounters *m_counters {};
 };
 
 } // namespace hft::orderbook
\ No newline at end of file
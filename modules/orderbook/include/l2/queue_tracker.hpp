@@ -0,0 +1,210 @@
+#pragma once
+
+#include <core/dllist.hpp>
+#include <core/memory_pool.hpp>
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+enum class QueueModel : uint8_t
+{
+	// Every decrease of the level comes off the front, the queue ahead shrinks by all of it.
+	Fifo,
+
+	// Decreases hit the queue evenly, the queue ahead shrinks in proportion to the level.
+	ProRata
+};
+
+/*One of our resting orders with the estimated quantity queued in front of it.*/
+struct OwnOrder
+{
+	uint64_t id {};
+
+	Side side {};
+
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	uint64_t queue_ahead {};
+
+	core::ci_dllink link {};
+
+	// Tracked price slot the order hangs off.
+	uint8_t slot {};
+};
+
+/*
+ * Queue position estimates for our own orders on top of an OrderBook.
+ * Updates are forwarded to the book as usual. Each side tracks at most
+ * MAX_PRICES prices that hold our orders, found through a small bitmask, so
+ * updates at other prices cost one compare per occupied slot and nothing
+ * when a side has no orders. A tracked price keeps its own last quantity, so
+ * orders deeper than the book's levels are estimated as well. The book's
+ * quantities are taken as other participants' quantity.
+ */
+class QueueTracker
+{
+public:
+	static constexpr size_t MAX_ORDERS = 64;
+
+	static constexpr size_t MAX_PRICES = 16;
+
+	explicit QueueTracker(OrderBook &book, QueueModel model = QueueModel::Fifo);
+
+	QueueTracker(const QueueTracker &) = delete;
+
+	QueueTracker(QueueTracker &&) = delete;
+
+	auto operator=(const QueueTracker &) -> QueueTracker & = delete;
+
+	auto operator=(QueueTracker &&) -> QueueTracker & = delete;
+
+	~QueueTracker() = default;
+
+	void update_bid_side(uint64_t price, uint64_t qty);
+
+	void update_ask_side(uint64_t price, uint64_t qty);
+
+	/*
+	 * Joins the back of the queue at price, behind the book's current quantity.
+	 * Returns nullptr when out of order or price slots.
+	 */
+	auto add_order(uint64_t id, Side side, uint64_t price, uint64_t qty) -> OwnOrder *;
+
+	/*Drops a cancelled or completely filled order.*/
+	void remove_order(OwnOrder *order);
+
+	/*Takes a (partial) fill off the order, returns true when that removed it.*/
+	auto fill_order(OwnOrder *order, uint64_t qty) -> bool;
+
+	/*Calls fn with every order at price, front of the queue first.*/
+	template<typename Fn>
+	void for_each_order(Side side, uint64_t price, Fn &&fn) const
+	{
+		visit_price(side == Side::Bid ? m_bids : m_asks, price, fn);
+	}
+
+	template<typename Fn>
+	void for_each_order(Side side, uint64_t price, Fn &&fn)
+	{
+		visit_price(side == Side::Bid ? m_bids : m_asks, price, fn);
+	}
+
+	/*Calls fn with every order of the side.*/
+	template<typename Fn>
+	void for_each_order(Side side, Fn &&fn)
+	{
+		auto &state = side == Side::Bid ? m_bids : m_asks;
+		for (auto mask = state.used; mask != 0; mask &= static_cast<SlotMask>(mask - 1))
+		{
+			auto *list = &state.prices[static_cast<size_t>(std::countr_zero(mask))].orders;
+			core::ci_dllink *lnk = core::ci_dllist_start(list);
+			// fn may remove the order it is given.
+			while (lnk != core::ci_dllist_end(list))
+			{
+				auto *next = lnk->next;
+				fn(*container_of(lnk, OwnOrder, link));
+				lnk = next;
+			}
+		}
+	}
+
+	/*Last quantity seen at a price holding our orders, 0 for other prices.*/
+	[[nodiscard]] auto get_level_quantity(Side side, uint64_t price) const -> uint64_t
+	{
+		const auto &state = side == Side::Bid ? m_bids : m_asks;
+		const auto slot = find_slot(state, price);
+		return slot != NO_SLOT ? state.prices[slot].level_quantity : 0;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_order_count() const noexcept -> size_t
+	{
+		return m_order_count;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_model() const noexcept -> QueueModel
+	{
+		return m_model;
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_book() const -> const OrderBook &
+	{
+		return m_book;
+	}
+
+private:
+	static constexpr size_t NO_SLOT = MAX_PRICES;
+
+	using SlotMask = uint16_t;
+
+	static_assert(MAX_PRICES <= std::numeric_limits<SlotMask>::digits);
+
+	struct TrackedPrice
+	{
+		uint64_t price {};
+
+		// Last quantity of the level seen in the feed.
+		uint64_t level_quantity {};
+
+		core::ci_dllist orders {};
+	};
+
+	struct SideState
+	{
+		std::array<TrackedPrice, MAX_PRICES> prices {};
+
+		SlotMask used {};
+	};
+
+	[[nodiscard]] static auto find_slot(const SideState &state, uint64_t price) -> size_t
+	{
+		for (auto mask = state.used; mask != 0; mask &= static_cast<SlotMask>(mask - 1))
+		{
+			const auto slot = static_cast<size_t>(std::countr_zero(mask));
+			if (state.prices[slot].price == price)
+			{
+				return slot;
+			}
+		}
+		return NO_SLOT;
+	}
+
+	template<typename State, typename Fn>
+	static void visit_price(State &state, uint64_t price, Fn &fn)
+	{
+		const auto slot = find_slot(state, price);
+		if (slot == NO_SLOT)
+		{
+			return;
+		}
+
+		auto *list = &state.prices[slot].orders;
+		for (auto *lnk = core::ci_dllist_start(list); lnk != core::ci_dllist_end(list); lnk = lnk->next)
+		{
+			fn(*container_of(lnk, OwnOrder, link));
+		}
+	}
+
+	void on_level_update(TrackedPrice &tracked, uint64_t qty) const;
+
+	[[nodiscard]] auto level_quantity(Side side, uint64_t price) const -> uint64_t;
+
+	OrderBook &m_book;
+
+	QueueModel m_model;
+
+	SideState m_bids {};
+
+	SideState m_asks {};
+
+	core::MemoryPool<OwnOrder, MAX_ORDERS> m_orders {};
+
+	size_t m_order_count {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <core/work_stealing_pool.hpp>
+#include <l2/book_store.hpp>
+#include <l2/market_update.hpp>
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+struct ReplayResult
+{
+	// Book state after the last update of the symbol.
+	BookSnapshot final_book {};
+
+	uint64_t updates {};
+};
+
+/*
+ * Replays independent per-symbol update streams in parallel.
+ * Every symbol is one task on the work stealing pool with its own OrderBook,
+ * its updates are applied strictly in stream order and its result lands at
+ * its own index, so the output does not depend on scheduling. Progress can be
+ * read from any thread while run() executes.
+ */
+class ReplayRunner
+{
+public:
+	// Progress is published every this many updates.
+	static constexpr uint64_t PROGRESS_INTERVAL = 1024;
+
+	ReplayRunner(core::WorkStealingPool &pool, size_t symbols)
+		: m_pool(pool)
+		, m_symbols(symbols)
+		, m_progress(std::make_unique<Progress[]>(symbols))
+	{
+	}
+
+	ReplayRunner(const ReplayRunner &) = delete;
+
+	ReplayRunner(ReplayRunner &&) = delete;
+
+	auto operator=(const ReplayRunner &) -> ReplayRunner & = delete;
+
+	auto operator=(ReplayRunner &&) -> ReplayRunner & = delete;
+
+	~ReplayRunner() = default;
+
+	/*
+	 * Replays streams[symbol] for every symbol. visitor(symbol, book, update)
+	 * runs after each update; calls for one symbol are sequential, calls for
+	 * different symbols run concurrently.
+	 */
+	template<typename Visitor>
+	auto run(std::span<const std::span<const MarketUpdate>> streams, Visitor &&visitor) -> std::vector<ReplayResult>
+	{
+		assert(streams.size() == m_symbols);
+
+		for (size_t i = 0; i < m_symbols; ++i)
+		{
+			m_progress[i].updates.store(0, std::memory_order_relaxed);
+		}
+		m_completed.store(0, std::memory_order_relaxed);
+
+		std::vector<ReplayResult> results(m_symbols);
+		m_pool.parallel_for(
+			m_symbols,
+			[&](size_t symbol, size_t)
+			{
+				auto book = std::make_unique<OrderBook>();
+				auto &progress = m_progress[symbol].updates;
+
+				const auto updates = streams[symbol];
+				for (size_t i = 0; i < updates.size(); ++i)
+				{
+					apply_market_update(*book, updates[i]);
+					visitor(symbol, std::as_const(*book), updates[i]);
+
+					if ((i + 1) % PROGRESS_INTERVAL == 0) [[unlikely]]
+					{
+						progress.store(i + 1, std::memory_order_relaxed);
+					}
+				}
+
+				results[symbol] = { make_snapshot(*book), updates.size() };
+				progress.store(updates.size(), std::memory_order_relaxed);
+				m_completed.fetch_add(1, std::memory_order_relaxed);
+			}
+		);
+		return results;
+	}
+
+	auto run(std::span<const std::span<const MarketUpdate>> streams) -> std::vector<ReplayResult>
+	{
+		return run(streams, [](size_t, const OrderBook &, const MarketUpdate &) {});
+	}
+
+	/*Updates of the symbol applied so far, in steps of PROGRESS_INTERVAL until it completes.*/
+	[[nodiscard]] auto get_progress(size_t symbol) const -> uint64_t
+	{
+		return m_progress[symbol].updates.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] auto get_completed_symbols() const -> size_t
+	{
+		return m_completed.load(std::memory_order_relaxed);
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_symbol_count() const noexcept -> size_t
+	{
+		return m_symbols;
+	}
+
+private:
+	// Own cache line each, neighbouring symbols usually run on different workers.
+	struct alignas(64) Progress
+	{
+		std::atomic<uint64_t> updates {};
+	};
+
+	core::WorkStealingPool &m_pool;
+
+	size_t m_symbols;
+
+	std::unique_ptr<Progress[]> m_progress;
+
+	std::atomic<size_t> m_completed {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <core/wire.hpp>
+#include <l2/orderbook.hpp>
+
+/*
+ * Accessors for the depth messages of the Binance spot SBE market data
+ * stream schema (schema id 1). Each type below mirrors one composite or
+ * message of the XML schema, every field is a compile-time offset into its
+ * block, so reading one is a single unaligned load out of the receive buffer.
+ * When the schema changes, the offsets here change with it.
+ */
+namespace hft::orderbook::sbe {
+
+inline constexpr uint16_t SCHEMA_ID = 1;
+
+template<typename T, size_t OFFSET>
+struct Field
+{
+	using Type = T;
+
+	static constexpr size_t END = OFFSET + sizeof(T);
+
+	[[nodiscard]] static auto get(const std::byte *block) noexcept -> T
+	{
+		return core::load_le<T>(block + OFFSET);
+	}
+};
+
+/*<composite name="messageHeader">*/
+struct MessageHeader
+{
+	using BlockLength = Field<uint16_t, 0>;
+
+	using TemplateId = Field<uint16_t, 2>;
+
+	using SchemaId = Field<uint16_t, 4>;
+
+	using Version = Field<uint16_t, 6>;
+
+	static constexpr size_t SIZE = Version::END;
+};
+
+/*<composite name="groupSize16Encoding">*/
+struct GroupSize16Encoding
+{
+	using BlockLength = Field<uint16_t, 0>;
+
+	using NumInGroup = Field<uint16_t, 2>;
+
+	static constexpr size_t SIZE = NumInGroup::END;
+};
+
+/*Entry of the bids and asks groups, price and qty mantissas.*/
+struct LevelEntry
+{
+	using Price = Field<int64_t, 0>;
+
+	using Qty = Field<int64_t, 8>;
+
+	static constexpr size_t BLOCK_LENGTH = Qty::END;
+};
+
+/*<sbe:message name="DepthSnapshotStreamEvent" id="10002">*/
+struct DepthSnapshotStreamEvent
+{
+	static constexpr uint16_t TEMPLATE_ID = 10002;
+
+	using EventTime = Field<int64_t, 0>;
+
+	using BookUpdateId = Field<int64_t, 8>;
+
+	using PriceExponent = Field<int8_t, 16>;
+
+	using QtyExponent = Field<int8_t, 17>;
+
+	static constexpr size_t BLOCK_LENGTH = QtyExponent::END;
+};
+
+/*<sbe:message name="DepthDiffStreamEvent" id="10003">*/
+struct DepthDiffStreamEvent
+{
+	static constexpr uint16_t TEMPLATE_ID = 10003;
+
+	using EventTime = Field<int64_t, 0>;
+
+	using FirstBookUpdateId = Field<int64_t, 8>;
+
+	using LastBookUpdateId = Field<int64_t, 16>;
+
+	using PriceExponent = Field<int8_t, 24>;
+
+	using QtyExponent = Field<int8_t, 25>;
+
+	static constexpr size_t BLOCK_LENGTH = QtyExponent::END;
+};
+
+/*Bids or asks group left in the receive buffer.*/
+class LevelGroup
+{
+public:
+	LevelGroup() = default;
+
+	LevelGroup(const std::byte *entries, size_t block_length, size_t count)
+		: m_entries(entries)
+		, m_block_length(block_length)
+		, m_count(count)
+	{
+	}
+
+	[[nodiscard]] auto price(size_t index) const noexcept -> int64_t
+	{
+		return LevelEntry::Price::get(m_entries + index * m_block_length);
+	}
+
+	[[nodiscard]] auto qty(size_t index) const noexcept -> int64_t
+	{
+		return LevelEntry::Qty::get(m_entries + index * m_block_length);
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_count;
+	}
+
+private:
+	const std::byte *m_entries {};
+
+	size_t m_block_length {};
+
+	size_t m_count {};
+};
+
+/*Validated view of a snapshot or diff message, the buffer must outlive it.*/
+struct DepthMessage
+{
+	uint16_t template_id {};
+
+	int64_t event_time {};
+
+	// Equal for snapshots.
+	int64_t first_update_id {};
+
+	int64_t last_update_id {};
+
+	int8_t price_exponent {};
+
+	int8_t qty_exponent {};
+
+	LevelGroup bids {};
+
+	LevelGroup asks {};
+
+	std::string_view symbol {};
+
+	size_t message_size {};
+
+	[[nodiscard]] auto is_snapshot() const noexcept -> bool
+	{
+		return template_id == DepthSnapshotStreamEvent::TEMPLATE_ID;
+	}
+};
+
+/*
+ * Checks the header, both groups and the symbol against the buffer size.
+ * std::nullopt for other templates or schemas and for truncated messages.
+ * Root blocks and group entries are stepped over by their encoded length, so
+ * fields appended by newer schema versions are skipped.
+ */
+[[nodiscard]] auto parse_depth(std::span<const std::byte> in) -> std::optional<DepthMessage>;
+
+} // namespace hft::orderbook::sbe
+
+namespace hft::orderbook {
+
+struct SbeDepthConfig
+{
+	// Fixed point scale of prices and quantities stored in the book.
+	uint8_t price_decimals {};
+
+	uint8_t qty_decimals {};
+};
+
+enum class SbeApplyResult : uint8_t
+{
+	Applied,
+
+	// Not a depth message of this schema.
+	Ignored,
+
+	// Diff already covered by the book's sequence.
+	Stale,
+
+	// Diff starts after the book's sequence, the book needs a new snapshot.
+	Gap,
+
+	Malformed
+};
+
+/*
+ * Feeds SBE depth messages into a book.
+ * Group entries go straight from the receive buffer into the book's update
+ * path, rescaled only when the message exponents differ from the book's fixed
+ * point scale. Diffs follow the venue's update id rules against the book's
+ * sequence, snapshots replace the book.
+ */
+class SbeDepthDecoder
+{
+public:
+	explicit SbeDepthDecoder(SbeDepthConfig config = {})
+		: m_config(config)
+	{
+	}
+
+	auto apply(std::span<const std::byte> in, OrderBook &book) const -> SbeApplyResult;
+
+	/*Same for a message parsed beforehand.*/
+	auto apply(const sbe::DepthMessage &message, OrderBook &book) const -> SbeApplyResult;
+
+private:
+	SbeDepthConfig m_config;
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <core/spsc_queue.hpp>
+#include <l2/orderbook.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * On disk layout written by SnapshotExporter, native endian, one row per
+ * exported level:
+ *
+ *   FileHeader
+ *   ChunkHeader, columns of chunk 0
+ *   ChunkHeader, columns of chunk 1
+ *   ...
+ *
+ * The columns of a chunk follow its header back to back, each rows entries
+ * long: timestamp_ns u64, price u64, quantity u64, symbol u32, level u8,
+ * side u8 (0 bid, 1 ask), then zero padding up to ChunkHeader::size. Every
+ * column starts aligned to its element, so a reader can hand numpy views
+ * straight into a mapping of the file.
+ */
+namespace columnar {
+
+constexpr uint64_t MAGIC = 0x524c'4f43'5453'4e53ULL;
+
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader
+{
+	uint64_t magic {};
+
+	uint32_t version {};
+
+	// Levels exported per side and sample.
+	uint32_t depth {};
+};
+
+struct ChunkHeader
+{
+	uint64_t rows {};
+
+	// Bytes from this header to the next one.
+	uint64_t size {};
+
+	uint64_t first_timestamp_ns {};
+
+	uint64_t last_timestamp_ns {};
+};
+
+/*Bytes taken by a chunk of rows rows, header included.*/
+[[nodiscard]] constexpr auto chunk_size(uint64_t rows) -> uint64_t
+{
+	const auto columns = rows * (3 * sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(uint8_t));
+	return sizeof(ChunkHeader) + ((columns + 7) & ~uint64_t { 7 });
+}
+
+} // namespace columnar
+
+struct ExportConfig
+{
+	// Levels per side copied from every book sampled, at most OrderBook::MAX_LEVELS.
+	size_t depth = OrderBook::MAX_LEVELS;
+
+	// Rows per chunk written, the last chunk may hold fewer.
+	size_t chunk_rows = 1 << 16;
+
+	// Samples in flight between the sampling and the writing thread.
+	size_t queue_capacity = 1 << 14;
+};
+
+struct ExportStats
+{
+	uint64_t samples {};
+
+	// Samples lost because the writer fell behind by more than the queue.
+	uint64_t dropped {};
+
+	uint64_t rows {};
+
+	uint64_t chunks {};
+};
+
+/*
+ * Samples the top levels of books into a columnar file for research. The
+ * sampling thread only copies the levels into a slot of an SPSC ring; a
+ * background thread pivots samples into column chunks and writes them. When
+ * the ring is full the sample is dropped and counted, sampling never waits.
+ */
+class SnapshotExporter
+{
+public:
+	/*Creates or truncates the file at path and starts the writer, throws std::runtime_error on failure.*/
+	explicit SnapshotExporter(const std::string &path, const ExportConfig &config = {});
+
+	SnapshotExporter(const SnapshotExporter &) = delete;
+
+	SnapshotExporter(SnapshotExporter &&) = delete;
+
+	auto operator=(const SnapshotExporter &) -> SnapshotExporter & = delete;
+
+	auto operator=(SnapshotExporter &&) -> SnapshotExporter & = delete;
+
+	/*Finishes the file if that was not done, errors are lost.*/
+	~SnapshotExporter();
+
+	/*Queues the top levels of book, returns false if the sample was dropped. Only one thread may sample.*/
+	auto sample(uint64_t timestamp_ns, uint32_t symbol, const OrderBook &book) -> bool;
+
+	/*
+	 * Writes everything sampled so far, stops the writer and closes the
+	 * file. Rethrows the first write error as std::runtime_error. Nothing can
+	 * be sampled afterwards.
+	 */
+	void finish();
+
+	/*From the sampling thread. Rows and chunks only count what the writer already wrote.*/
+	[[nodiscard]] auto get_stats() const noexcept -> ExportStats;
+
+	/*Samples queued and not yet taken by the writer.*/
+	[[nodiscard]] auto get_pending() const noexcept -> size_t
+	{
+		return m_queue.size();
+	}
+
+private:
+	struct Sample
+	{
+		uint64_t timestamp_ns;
+
+		uint32_t symbol;
+
+		uint8_t bid_count;
+
+		uint8_t ask_count;
+
+		std::array<PriceLevel, OrderBook::MAX_LEVELS> bids;
+
+		std::array<PriceLevel, OrderBook::MAX_LEVELS> asks;
+	};
+
+	void writer_loop();
+
+	void append(const Sample &sample);
+
+	void append_side(const Sample &sample, std::span<const PriceLevel> levels, Side side);
+
+	void write_chunk();
+
+	std::string m_path;
+
+	int m_fd = -1;
+
+	size_t m_depth;
+
+	size_t m_chunk_rows;
+
+	core::SpscQueue<Sample> m_queue;
+
+	// Sampling thread only.
+	uint64_t m_samples {};
+
+	uint64_t m_dropped {};
+
+	// Writer thread only, published for get_stats().
+	std::atomic<uint64_t> m_rows {};
+
+	std::atomic<uint64_t> m_chunks {};
+
+	// Columns of the chunk being filled, owned by the writer thread.
+	std::vector<uint64_t> m_timestamps;
+
+	std::vector<uint64_t> m_prices;
+
+	std::vector<uint64_t> m_quantities;
+
+	std::vector<uint32_t> m_symbols;
+
+	std::vector<uint8_t> m_levels;
+
+	std::vector<uint8_t> m_sides;
+
+	std::vector<std::byte> m_buffer;
+
+	std::atomic<bool> m_stop {};
+
+	std::exception_ptr m_error;
+
+	std::thread m_writer;
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <l2/book_counters.hpp>
+
+namespace hft::orderbook {
+
+/*
+ * BookCounters for a set of books laid out in a shared file mapping, put it
+ * under /dev/shm to keep it off disk. The owning process hands get(i) to
+ * book i and never touches the region again; monitors open the same path
+ * with BookStatsReader and poll it without ever reaching the threads that
+ * apply updates. Counters start from zero every time the region is created.
+ */
+class BookStatsRegion
+{
+public:
+	static constexpr uint64_t MAGIC = 0x53544154'534b4f42ULL;
+
+	static constexpr uint32_t VERSION = 1;
+
+	/*
+	 * Creates the file at path for books entries, replacing any previous one
+	 * rather than truncating it. Throws std::runtime_error on failure.
+	 */
+	BookStatsRegion(const std::string &path, size_t books);
+
+	BookStatsRegion(const BookStatsRegion &) = delete;
+
+	BookStatsRegion(BookStatsRegion &&) = delete;
+
+	auto operator=(const BookStatsRegion &) -> BookStatsRegion & = delete;
+
+	auto operator=(BookStatsRegion &&) -> BookStatsRegion & = delete;
+
+	~BookStatsRegion();
+
+	[[nodiscard]] auto get(size_t index) noexcept -> BookCounters &
+	{
+		assert(index < m_size);
+		return m_counters[index];
+	}
+
+	/*Labels the entry for monitors, truncated to fit.*/
+	void set_name(size_t index, std::string_view name) noexcept;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_size;
+	}
+
+	struct alignas(64) Header
+	{
+		uint64_t magic {};
+
+		uint32_t version {};
+
+		uint32_t counters_size {};
+
+		uint64_t book_count {};
+	};
+
+private:
+	int m_fd = -1;
+
+	void *m_mapping {};
+
+	size_t m_mapping_size {};
+
+	BookCounters *m_counters {};
+
+	size_t m_size {};
+};
+
+/*Read only view of a region created by BookStatsRegion, possibly in another process.*/
+class BookStatsReader
+{
+public:
+	/*Maps the region at path, throws std::runtime_error if it is missing or of another format.*/
+	explicit BookStatsReader(const std::string &path);
+
+	BookStatsReader(const BookStatsReader &) = delete;
+
+	BookStatsReader(BookStatsReader &&) = delete;
+
+	auto operator=(const BookStatsReader &) -> BookStatsReader & = delete;
+
+	auto operator=(BookStatsReader &&) -> BookStatsReader & = delete;
+
+	~BookStatsReader();
+
+	[[nodiscard]] auto get(size_t index) const noexcept -> const BookCounters &
+	{
+		assert(index < m_size);
+		return m_counters[index];
+	}
+
+	/*Name of the entry up to its first NUL.*/
+	[[nodiscard]] auto get_name(size_t index) const noexcept -> std::string_view;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return m_size;
+	}
+
+private:
+	const void *m_mapping {};
+
+	size_t m_mapping_size {};
+
+	const BookCounters *m_counters {};
+
+	size_t m_size {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <l2/orderbook.hpp>
+#include <l2/types.hpp>
+
+namespace hft::orderbook {
+
+enum class ImpliedOp : uint8_t
+{
+	// X/Q and Y/Q imply X/Y, e.g. ETH/USDT / BTC/USDT = ETH/BTC.
+	Divide,
+
+	// X/Y and Y/Q imply X/Q, e.g. ETH/BTC * BTC/USDT = ETH/USDT.
+	Multiply
+};
+
+struct SyntheticConfig
+{
+	ImpliedOp op = ImpliedOp::Divide;
+
+	// Fixed point decimals of the first leg (X/Q or X/Y).
+	uint8_t base_price_decimals {};
+
+	uint8_t base_qty_decimals {};
+
+	// Fixed point decimals of the second leg (Y/Q).
+	uint8_t quote_price_decimals {};
+
+	uint8_t quote_qty_decimals {};
+
+	// Fixed point decimals of the implied book, quantities are in units of X.
+	uint8_t price_decimals {};
+
+	uint8_t qty_decimals {};
+
+	// Implied levels kept per side.
+	size_t depth = 2 * OrderBook::MAX_LEVELS;
+};
+
+/*
+ * Implied cross book derived from two source OrderBooks.
+ * Levels come from walking both legs' ladders and consuming the common
+ * currency capacity of each level (Q for Divide, Y for Multiply), so a deep
+ * level of one leg can back several implied levels. Implied bids round the
+ * price down and implied asks round it up, quantities always round down.
+ * refresh() re-reads the legs and only re-walks from the first implied level
+ * that depended on a changed source level.
+ */
+class SyntheticBook
+{
+public:
+	// A walk over two ladders produces at most N + M - 1 levels.
+	static constexpr size_t MAX_LEVELS = 2 * OrderBook::MAX_LEVELS;
+
+	SyntheticBook(const OrderBook &base, const OrderBook &quote, SyntheticConfig config);
+
+	SyntheticBook(const SyntheticBook &) = delete;
+
+	SyntheticBook(SyntheticBook &&) = delete;
+
+	auto operator=(const SyntheticBook &) -> SyntheticBook & = delete;
+
+	auto operator=(SyntheticBook &&) -> SyntheticBook & = delete;
+
+	~SyntheticBook() = default;
+
+	/*Picks up source changes, returns the number of implied levels that were recomputed.*/
+	auto refresh() -> size_t;
+
+	/*Implied bids, best first.*/
+	[[nodiscard]] auto get_bids() const -> std::span<const PriceLevel>
+	{
+		return { m_bids.levels.data(), m_bids.count };
+	}
+
+	/*Implied asks, best first.*/
+	[[nodiscard]] auto get_asks() const -> std::span<const PriceLevel>
+	{
+		return { m_asks.levels.data(), m_asks.count };
+	}
+
+private:
+	__extension__ typedef unsigned __int128 Amount;
+
+	struct LegLevels
+	{
+		std::array<PriceLevel, OrderBook::MAX_LEVELS> levels {};
+
+		size_t count {};
+	};
+
+	/*Position of the walk: current level per leg and the common currency left in it.*/
+	struct WalkState
+	{
+		size_t base {};
+
+		size_t quote {};
+
+		Amount base_left {};
+
+		Amount quote_left {};
+	};
+
+	struct Ladder
+	{
+		std::array<PriceLevel, MAX_LEVELS> levels {};
+
+		// starts[i] is the walk state that produced levels[i], starts[count] is the end state.
+		std::array<WalkState, MAX_LEVELS + 1> starts {};
+
+		size_t count {};
+	};
+
+	static auto read_leg(std::span<PriceLevel> out, const OrderBook &book, Side side) -> size_t;
+
+	static auto first_changed(const LegLevels &before, const LegLevels &after) -> size_t;
+
+	[[nodiscard]] auto base_capacity(const PriceLevel &level) const -> Amount;
+
+	[[nodiscard]] auto quote_capacity(const PriceLevel &level) const -> Amount;
+
+	[[nodiscard]] auto implied_price(uint64_t base_price, uint64_t quote_price, bool round_up) const
+		-> uint64_t;
+
+	auto walk(Ladder &ladder, const LegLevels &base, const LegLevels &quote, size_t base_rank, size_t quote_rank, bool is_bid)
+		-> size_t;
+
+	const OrderBook &m_base;
+
+	const OrderBook &m_quote;
+
+	SyntheticConfig m_config;
+
+	// Powers of ten derived from the config.
+	Amount m_base_scale {};
+
+	Amount m_quote_scale {};
+
+	Amount m_common_scale {};
+
+	LegLevels m_base_bids {};
+
+	LegLevels m_base_asks {};
+
+	LegLevels m_quote_bids {};
+
+	LegLevels m_quote_asks {};
+
+	Ladder m_bids {};
+
+	Ladder m_asks {};
+};
+
+} // namespace hft::orderbook
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace hft::orderbook {
+
+enum class Side : uint8_t
+{
+	Bid,
+	Ask
+};
+
+/*Plain price/quantity pair, used wherever levels leave the intrusive lists.*/
+struct PriceLevel
+{
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	friend auto operator==(const PriceLevel &lhs, const PriceLevel &rhs) -> bool = default;
+};
+
+} // namespace hft::orderbook
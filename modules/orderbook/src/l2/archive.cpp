@@ -0,0 +1,265 @@
+#include <fcntl.h>
+#include <l2/archive.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft::orderbook {
+
+using namespace archive;
+
+namespace {
+
+/*
+ * Whether the footer and index describe blocks back to back from the file
+ * header to the index, which seeks rely on to stay inside the mapping. Keys
+ * must start at 0 and never go backwards for the binary search.
+ */
+auto is_index_valid(const std::byte *mapping, size_t mapping_size, const Footer &footer) -> bool
+{
+	const auto index_end = mapping_size - sizeof(Footer);
+	if (footer.block_count == 0 || footer.block_count > index_end / sizeof(IndexEntry) ||
+		footer.index_offset != index_end - footer.block_count * sizeof(IndexEntry) ||
+		footer.index_offset % alignof(IndexEntry) != 0)
+	{
+		return false;
+	}
+
+	uint64_t block_start = sizeof(FileHeader);
+	uint64_t update_count = 0;
+	IndexEntry previous {};
+	for (uint64_t i = 0; i < footer.block_count; ++i)
+	{
+		IndexEntry entry;
+		std::memcpy(&entry, mapping + footer.index_offset + i * sizeof(IndexEntry), sizeof(entry));
+		if (entry.offset != block_start || footer.index_offset - entry.offset < sizeof(Checkpoint) ||
+			entry.update_count > (footer.index_offset - entry.offset - sizeof(Checkpoint)) / sizeof(MarketUpdate) ||
+			entry.timestamp_ns < previous.timestamp_ns || entry.sequence < previous.sequence)
+		{
+			return false;
+		}
+		block_start = entry.offset + sizeof(Checkpoint) + entry.update_count * sizeof(MarketUpdate);
+		update_count += entry.update_count;
+		previous = entry;
+	}
+
+	IndexEntry first;
+	std::memcpy(&first, mapping + footer.index_offset, sizeof(first));
+	return block_start == footer.index_offset && update_count == footer.update_count && first.timestamp_ns == 0 &&
+		   first.sequence == 0;
+}
+
+} // namespace
+
+ArchiveWriter::ArchiveWriter(const std::string &path, size_t checkpoint_interval)
+	: m_path(path)
+	, m_checkpoint_interval(std::max<size_t>(checkpoint_interval, 1))
+	, m_book(std::make_unique<OrderBook>())
+{
+	m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot open archive " + path + ": " + std::strerror(errno));
+	}
+	m_buffer.reserve(BUFFER_SIZE);
+
+	const FileHeader header { MAGIC, VERSION, static_cast<uint32_t>(OrderBook::MAX_LEVELS) };
+	write(&header, sizeof(header));
+	write_checkpoint();
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+	if (m_fd < 0)
+	{
+		return;
+	}
+
+	try
+	{
+		finish();
+	}
+	catch (const std::runtime_error &)
+	{
+		::close(m_fd);
+	}
+}
+
+auto ArchiveWriter::append(const MarketUpdate &update) -> bool
+{
+	assert(m_fd >= 0);
+
+	// Checkpoints carry the book's sequence, a reset would leave the index unsearchable by sequence.
+	const auto sequence_back = update.sequence != 0 && update.sequence < m_last_sequence;
+	if (update.timestamp_ns < m_last_timestamp || sequence_back) [[unlikely]]
+	{
+		return false;
+	}
+
+	if (m_index.back().update_count == m_checkpoint_interval)
+	{
+		write_checkpoint();
+	}
+
+	write(&update, sizeof(update));
+	apply_market_update(*m_book, update);
+	++m_index.back().update_count;
+	++m_update_count;
+	m_last_timestamp = update.timestamp_ns;
+	m_last_sequence = std::max(m_last_sequence, update.sequence);
+	return true;
+}
+
+void ArchiveWriter::finish()
+{
+	if (m_fd < 0)
+	{
+		return;
+	}
+
+	const Footer footer { m_offset, m_index.size(), m_update_count, MAGIC };
+	write(m_index.data(), m_index.size() * sizeof(IndexEntry));
+	write(&footer, sizeof(footer));
+	flush();
+
+	const auto fd = std::exchange(m_fd, -1);
+	if (::close(fd) != 0)
+	{
+		throw std::runtime_error("Cannot close archive " + m_path + ": " + std::strerror(errno));
+	}
+}
+
+void ArchiveWriter::write_checkpoint()
+{
+	const Checkpoint checkpoint { m_last_timestamp, make_snapshot(*m_book) };
+	m_index.push_back({ checkpoint.timestamp_ns, checkpoint.book.sequence, m_offset, 0 });
+	write(&checkpoint, sizeof(checkpoint));
+}
+
+void ArchiveWriter::write(const void *data, size_t size)
+{
+	const auto *bytes = static_cast<const std::byte *>(data);
+	m_offset += size;
+
+	if (m_buffer.size() + size > BUFFER_SIZE)
+	{
+		flush();
+	}
+	if (size >= BUFFER_SIZE)
+	{
+		m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+		flush();
+		return;
+	}
+	m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+void ArchiveWriter::flush()
+{
+	const auto *data = m_buffer.data();
+	auto left = m_buffer.size();
+	while (left != 0)
+	{
+		const auto written = ::write(m_fd, data, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::runtime_error("Cannot write archive " + m_path + ": " + std::strerror(errno));
+		}
+		data += written;
+		left -= static_cast<size_t>(written);
+	}
+	m_buffer.clear();
+}
+
+ArchiveReader::ArchiveReader(const std::string &path)
+{
+	m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot open archive " + path + ": " + std::strerror(errno));
+	}
+
+	struct stat info {};
+	if (::fstat(m_fd, &info) != 0)
+	{
+		::close(m_fd);
+		throw std::runtime_error("Cannot stat archive " + path + ": " + std::strerror(errno));
+	}
+
+	m_mapping_size = static_cast<size_t>(info.st_size);
+	if (m_mapping_size < sizeof(FileHeader) + sizeof(Checkpoint) + sizeof(IndexEntry) + sizeof(Footer))
+	{
+		::close(m_fd);
+		throw std::runtime_error("Archive " + path + " is truncated");
+	}
+
+	auto *mapping = ::mmap(nullptr, m_mapping_size, PROT_READ, MAP_SHARED, m_fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		::close(m_fd);
+		throw std::runtime_error("Cannot map archive " + path + ": " + std::strerror(errno));
+	}
+	m_mapping = static_cast<const std::byte *>(mapping);
+
+	// Seeks land anywhere, read ahead would only pull in pages of other blocks.
+	::madvise(mapping, m_mapping_size, MADV_RANDOM);
+
+	FileHeader header;
+	std::memcpy(&header, m_mapping, sizeof(header));
+	std::memcpy(&m_footer, m_mapping + m_mapping_size - sizeof(Footer), sizeof(Footer));
+
+	const auto valid = header.magic == MAGIC && header.version == VERSION &&
+					   header.max_levels == OrderBook::MAX_LEVELS && m_footer.magic == MAGIC &&
+					   is_index_valid(m_mapping, m_mapping_size, m_footer);
+	if (!valid)
+	{
+		::munmap(mapping, m_mapping_size);
+		::close(m_fd);
+		throw std::runtime_error("Archive " + path + " is not a finished archive of this version");
+	}
+
+	m_index = { reinterpret_cast<const IndexEntry *>(m_mapping + m_footer.index_offset), m_footer.block_count };
+}
+
+ArchiveReader::~ArchiveReader()
+{
+	::munmap(const_cast<std::byte *>(m_mapping), m_mapping_size);
+	::close(m_fd);
+}
+
+auto ArchiveReader::seek_time(uint64_t timestamp_ns, OrderBook &book) const -> size_t
+{
+	return seek(timestamp_ns, book, [](const auto &record) { return record.timestamp_ns; });
+}
+
+auto ArchiveReader::seek_sequence(uint64_t sequence, OrderBook &book) const -> size_t
+{
+	return seek(sequence, book, [](const auto &record) { return record.sequence; });
+}
+
+template<typename Key>
+auto ArchiveReader::seek(uint64_t target, OrderBook &book, Key &&key) const -> size_t
+{
+	// The first block starts from the empty book at 0, it always qualifies.
+	const auto next =
+		std::upper_bound(m_index.begin(), m_index.end(), target, [&](uint64_t t, const IndexEntry &e) { return t < key(e); });
+	const auto &entry = *std::prev(next);
+
+	const auto *checkpoint = reinterpret_cast<const Checkpoint *>(m_mapping + entry.offset);
+	restore_snapshot(book, checkpoint->book);
+
+	// Every update after the target is in this block or later, stop at the first one.
+	const auto *updates = reinterpret_cast<const MarketUpdate *>(m_mapping + entry.offset + sizeof(Checkpoint));
+	size_t replayed = 0;
+	while (replayed < entry.update_count && key(updates[replayed]) <= target)
+	{
+		apply_market_update(book, updates[replayed++]);
+	}
+	return replayed;
+}
+
+} // namespace hft::orderbook
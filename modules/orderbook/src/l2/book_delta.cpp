@@ -0,0 +1,58 @@
+#include <l2/book_delta.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+auto apply_update(OrderBook &book, Side side, uint64_t price, uint64_t qty, std::span<LevelDelta, 2> out)
+	-> size_t
+{
+	const auto is_bid = side == Side::Bid;
+	const auto &hash = is_bid ? book.get_bids_hash_table() : book.get_asks_hash_table();
+	const auto *list = is_bid ? book.get_bids_list() : book.get_asks_list();
+	const auto count = is_bid ? book.get_bid_count() : book.get_ask_count();
+
+	const auto *existing = hash.lookup(price);
+	const auto old_qty = existing ? existing->quantity : 0;
+
+	// A new level on a full side pushes the tail out, remember it before it is gone.
+	PriceLevel tail {};
+	if (!existing && qty != 0 && count >= OrderBook::MAX_LEVELS)
+	{
+		const auto *tail_level = container_of(ci_dllist_tail(list), Level, link);
+		tail = { tail_level->price, tail_level->quantity };
+	}
+
+	if (is_bid)
+	{
+		book.update_bid_side(price, qty);
+	}
+	else
+	{
+		book.update_ask_side(price, qty);
+	}
+
+	const auto *updated = hash.lookup(price);
+	const auto new_qty = updated ? updated->quantity : 0;
+
+	size_t written = 0;
+	if (tail.quantity != 0 && hash.lookup(tail.price) == nullptr)
+	{
+		out[written++] = { side, tail.price, tail.quantity, 0 };
+	}
+	if (old_qty != new_qty)
+	{
+		out[written++] = { side, price, old_qty, new_qty };
+	}
+
+	// A delete that leaves the count unchanged promoted a cold level into the tail.
+	const auto count_after = is_bid ? book.get_bid_count() : book.get_ask_count();
+	if (old_qty != 0 && new_qty == 0 && count_after == count)
+	{
+		const auto *promoted = container_of(ci_dllist_tail(list), Level, link);
+		out[written++] = { side, promoted->price, 0, promoted->quantity };
+	}
+	return written;
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,140 @@
+#include <l2/book_sampler.hpp>
+
+namespace hft::orderbook {
+
+namespace {
+
+auto sum_quantities(std::span<const PriceLevel> levels) noexcept -> uint64_t
+{
+	uint64_t sum = 0;
+	for (const auto &level : levels)
+	{
+		sum += level.quantity;
+	}
+	return sum;
+}
+
+} // namespace
+
+BookSampler::BookSampler(std::span<const OrderBook *const> books, const SamplerConfig &config)
+	: m_books(books.begin(), books.end())
+	, m_states(books.size())
+	, m_slots(books.size() * std::max<size_t>(config.ring_ticks, 2))
+	, m_interval_ns(std::max<uint64_t>(config.interval_ns, 1))
+	, m_depth(std::clamp<size_t>(config.depth, 1, OrderBook::MAX_LEVELS))
+	, m_ring_ticks(std::max<size_t>(config.ring_ticks, 2))
+	, m_next_boundary(config.start_ns + m_interval_ns)
+{
+	for (size_t i = 0; i < m_books.size(); ++i)
+	{
+		m_states[i].since_ns = config.start_ns;
+		refresh(i);
+	}
+}
+
+void BookSampler::on_update(size_t book, uint64_t timestamp_ns)
+{
+	assert(book < m_books.size());
+
+	if (timestamp_ns >= m_next_boundary) [[unlikely]]
+	{
+		advance(timestamp_ns);
+	}
+
+	auto &state = m_states[book];
+	accumulate(state, timestamp_ns);
+	refresh(book);
+}
+
+auto BookSampler::advance(uint64_t now_ns) -> size_t
+{
+	size_t closed = 0;
+	while (now_ns >= m_next_boundary)
+	{
+		close_tick();
+		m_next_boundary += m_interval_ns;
+		++closed;
+	}
+	return closed;
+}
+
+void BookSampler::accumulate(State &state, uint64_t until_ns) const noexcept
+{
+	// Updates stamped before the last one add no time, they only replace the state.
+	if (until_ns <= state.since_ns)
+	{
+		return;
+	}
+
+	const auto elapsed = static_cast<double>(until_ns - state.since_ns);
+	if (state.two_sided)
+	{
+		state.spread_area += static_cast<double>(state.spread) * elapsed;
+		state.spread_time += elapsed;
+	}
+	state.bid_depth_area += static_cast<double>(state.bid_depth) * elapsed;
+	state.ask_depth_area += static_cast<double>(state.ask_depth) * elapsed;
+	state.since_ns = until_ns;
+}
+
+void BookSampler::refresh(size_t book) noexcept
+{
+	const auto &source = *m_books[book];
+	auto &state = m_states[book];
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> bids;
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> asks;
+	const auto bid_count = source.get_bid_levels(std::span(bids).first(m_depth));
+	const auto ask_count = source.get_ask_levels(std::span(asks).first(m_depth));
+
+	state.two_sided = bid_count != 0 && ask_count != 0;
+	// Signed, a crossed book has its best ask below its best bid.
+	state.spread =
+		state.two_sided ? static_cast<int64_t>(asks[0].price) - static_cast<int64_t>(bids[0].price) : 0;
+	state.bid_depth = sum_quantities(std::span(bids).first(bid_count));
+	state.ask_depth = sum_quantities(std::span(asks).first(ask_count));
+	state.dirty = true;
+}
+
+void BookSampler::close_tick() noexcept
+{
+	const auto books = m_books.size();
+	auto *slots = m_slots.data() + (m_ticks % m_ring_ticks) * books;
+	const auto *previous = m_slots.data() + ((m_ticks + m_ring_ticks - 1) % m_ring_ticks) * books;
+	const auto interval = static_cast<double>(m_interval_ns);
+
+	for (size_t i = 0; i < books; ++i)
+	{
+		auto &state = m_states[i];
+		auto &slot = slots[i];
+		accumulate(state, m_next_boundary);
+
+		if (state.dirty || m_ticks == 0)
+		{
+			const auto &book = *m_books[i];
+			slot.bid_count = static_cast<uint8_t>(book.get_bid_levels(std::span(slot.bids).first(m_depth)));
+			slot.ask_count = static_cast<uint8_t>(book.get_ask_levels(std::span(slot.asks).first(m_depth)));
+			slot.sequence = book.get_sequence();
+			slot.changed = true;
+		}
+		else
+		{
+			slot = previous[i];
+			slot.changed = false;
+		}
+
+		slot.spread = state.spread_time > 0 ? state.spread_area / state.spread_time
+											: std::numeric_limits<double>::quiet_NaN();
+		slot.bid_depth = state.bid_depth_area / interval;
+		slot.ask_depth = state.ask_depth_area / interval;
+
+		state.spread_area = 0;
+		state.spread_time = 0;
+		state.bid_depth_area = 0;
+		state.ask_depth_area = 0;
+		state.dirty = false;
+	}
+	++m_ticks;
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,173 @@
+#include <core/crc32.hpp>
+#include <fcntl.h>
+#include <l2/book_store.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft::orderbook {
+
+auto make_snapshot(const OrderBook &book) -> BookSnapshot
+{
+	BookSnapshot snapshot;
+	snapshot.sequence = book.get_sequence();
+	snapshot.bid_count = static_cast<uint32_t>(book.get_bid_levels(snapshot.bids));
+	snapshot.ask_count = static_cast<uint32_t>(book.get_ask_levels(snapshot.asks));
+	return snapshot;
+}
+
+void restore_snapshot(OrderBook &book, const BookSnapshot &snapshot)
+{
+	book.load_snapshot(
+		std::span(snapshot.bids).first(snapshot.bid_count), std::span(snapshot.asks).first(snapshot.ask_count)
+	);
+	book.set_sequence(snapshot.sequence);
+}
+
+BookStore::BookStore(const std::string &path, size_t books)
+	: m_size(books)
+	, m_generations(books)
+{
+	m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot open book store " + path + ": " + std::strerror(errno));
+	}
+
+	m_mapping_size = sizeof(Header) + books * 2 * sizeof(Slot);
+
+	struct stat info {};
+	if (::fstat(m_fd, &info) != 0)
+	{
+		::close(m_fd);
+		throw std::runtime_error("Cannot stat book store " + path + ": " + std::strerror(errno));
+	}
+
+	Header header {};
+	if (static_cast<size_t>(info.st_size) == m_mapping_size)
+	{
+		if (::pread(m_fd, &header, sizeof(header), 0) != sizeof(header))
+		{
+			header = {};
+		}
+	}
+
+	const auto expected = make_header();
+	m_fresh = std::memcmp(&header, &expected, offsetof(Header, checksum) + sizeof(uint32_t)) != 0;
+	if (m_fresh)
+	{
+		// Truncating first zeroes every slot, stale data never survives a format change.
+		if (::ftruncate(m_fd, 0) != 0 || ::ftruncate(m_fd, static_cast<off_t>(m_mapping_size)) != 0)
+		{
+			::close(m_fd);
+			throw std::runtime_error("Cannot size book store " + path + ": " + std::strerror(errno));
+		}
+	}
+
+	// Populated up front so neither restore nor the first checkpoints take page faults.
+	m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, 0);
+	if (m_mapping == MAP_FAILED)
+	{
+		::close(m_fd);
+		throw std::runtime_error("Cannot map book store " + path + ": " + std::strerror(errno));
+	}
+
+	std::memcpy(m_mapping, &expected, sizeof(expected));
+	m_slots = reinterpret_cast<Slot *>(static_cast<std::byte *>(m_mapping) + sizeof(Header));
+
+	for (size_t i = 0; i < books; ++i)
+	{
+		const auto *latest = latest_slot(i);
+		m_generations[i] = latest ? latest->generation : 0;
+	}
+}
+
+BookStore::~BookStore()
+{
+	::munmap(m_mapping, m_mapping_size);
+	::close(m_fd);
+}
+
+auto BookStore::checkpoint(size_t index, const OrderBook &book) -> bool
+{
+	assert(index < m_size);
+
+	const auto snapshot = make_snapshot(book);
+
+	auto *pair = slots(index);
+	const auto generation = m_generations[index];
+	if (generation != 0 && pair[generation & 1].snapshot == snapshot)
+	{
+		return false;
+	}
+
+	auto &slot = pair[(generation + 1) & 1];
+	slot.generation = generation + 1;
+	slot.snapshot = snapshot;
+	slot.checksum = slot_checksum(slot);
+
+	m_generations[index] = generation + 1;
+	return true;
+}
+
+auto BookStore::restore(size_t index, OrderBook &book) const -> bool
+{
+	assert(index < m_size);
+
+	const auto *slot = latest_slot(index);
+	if (!slot)
+	{
+		return false;
+	}
+
+	restore_snapshot(book, slot->snapshot);
+	return true;
+}
+
+void BookStore::sync() const
+{
+	::msync(m_mapping, m_mapping_size, MS_ASYNC);
+}
+
+auto BookStore::make_header() const -> Header
+{
+	Header header;
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.max_levels = OrderBook::MAX_LEVELS;
+	header.book_count = m_size;
+	header.slot_size = sizeof(Slot);
+	header.checksum = core::crc32c(&header, offsetof(Header, checksum));
+	return header;
+}
+
+auto BookStore::latest_slot(size_t index) const -> const Slot *
+{
+	const Slot *latest = nullptr;
+
+	const auto *pair = slots(index);
+	for (size_t i = 0; i < 2; ++i)
+	{
+		const auto &slot = pair[i];
+		if (slot.generation == 0 || slot.checksum != slot_checksum(slot))
+		{
+			continue;
+		}
+		if (slot.snapshot.bid_count > OrderBook::MAX_LEVELS || slot.snapshot.ask_count > OrderBook::MAX_LEVELS)
+		{
+			continue;
+		}
+		if (!latest || slot.generation > latest->generation)
+		{
+			latest = &slot;
+		}
+	}
+	return latest;
+}
+
+auto BookStore::slot_checksum(const Slot &slot) -> uint32_t
+{
+	return core::crc32c(&slot, offsetof(Slot, checksum));
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,159 @@
+#include <l2/capture_codec.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+namespace {
+
+enum Column : size_t
+{
+	TIMESTAMP,
+	SEQUENCE,
+	PRICE,
+	QUANTITY
+};
+
+} // namespace
+
+auto CaptureEncoder::encode_block(std::span<const MarketUpdate> updates, std::span<std::byte> out) -> CaptureBlockInfo
+{
+	const auto limit = std::min(updates.size(), CaptureFormat::MAX_UPDATES);
+	if (limit == 0 || out.size() < CaptureFormat::max_block_size(limit))
+	{
+		return {};
+	}
+
+	const auto &first = updates[0];
+	auto prev_timestamp = first.timestamp_ns;
+	auto prev_sequence = first.sequence;
+	auto prev_price = first.price;
+	auto prev_quantity = first.quantity;
+	uint64_t timestamp_delta = 0;
+	uint64_t sequence_delta = 0;
+
+	size_t count = 0;
+	for (; count < limit; ++count)
+	{
+		const auto &update = updates[count];
+		const auto next_timestamp_delta = update.timestamp_ns - prev_timestamp;
+		const auto next_sequence_delta = update.sequence - prev_sequence;
+
+		const std::array<uint64_t, CaptureFormat::COLUMNS> values {
+			zigzag_encode(static_cast<int64_t>(next_timestamp_delta - timestamp_delta)),
+			zigzag_encode(static_cast<int64_t>(next_sequence_delta - sequence_delta)),
+			zigzag_encode(static_cast<int64_t>(update.price - prev_price)),
+			zigzag_encode(static_cast<int64_t>(update.quantity - prev_quantity)),
+		};
+		if (std::ranges::any_of(values, [](uint64_t value) { return value > UINT32_MAX; })) [[unlikely]]
+		{
+			break;
+		}
+
+		for (size_t column = 0; column < CaptureFormat::COLUMNS; ++column)
+		{
+			m_columns[column][count] = static_cast<uint32_t>(values[column]);
+		}
+		timestamp_delta = next_timestamp_delta;
+		sequence_delta = next_sequence_delta;
+		prev_timestamp = update.timestamp_ns;
+		prev_sequence = update.sequence;
+		prev_price = update.price;
+		prev_quantity = update.quantity;
+	}
+
+	auto *pos = out.data() + CaptureFormat::HEADER_SIZE;
+
+	const auto side_bytes = (count + 7) / 8;
+	std::memset(pos, 0, side_bytes);
+	for (size_t i = 0; i < count; ++i)
+	{
+		pos[i / 8] |= static_cast<std::byte>(static_cast<unsigned>(updates[i].side == Side::Ask) << (i % 8));
+	}
+	pos += side_bytes;
+
+	for (const auto &column : m_columns)
+	{
+		pos = stream_vbyte_encode(column.data(), count, pos);
+	}
+
+	const auto size = static_cast<size_t>(pos - out.data());
+	auto *header = out.data();
+	header = store_le(header, static_cast<uint32_t>(count));
+	header = store_le(header, static_cast<uint32_t>(size));
+	header = store_le(header, first.timestamp_ns);
+	header = store_le(header, first.sequence);
+	header = store_le(header, first.price);
+	store_le(header, first.quantity);
+	return { count, size };
+}
+
+auto CaptureDecoder::decode_block(std::span<const std::byte> in, std::span<MarketUpdate> out)
+	-> std::optional<CaptureBlockInfo>
+{
+	if (in.size() < CaptureFormat::HEADER_SIZE)
+	{
+		return std::nullopt;
+	}
+
+	const auto *src = in.data();
+	const auto count = size_t { load_le<uint32_t>(src) };
+	const auto size = size_t { load_le<uint32_t>(src + 4) };
+	if (count == 0 || count > CaptureFormat::MAX_UPDATES || count > out.size() || size > in.size() ||
+		size < CaptureFormat::HEADER_SIZE + (count + 7) / 8)
+	{
+		return std::nullopt;
+	}
+
+	auto timestamp = load_le<uint64_t>(src + 8);
+	auto sequence = load_le<uint64_t>(src + 16);
+	auto price = load_le<uint64_t>(src + 24);
+	auto quantity = load_le<uint64_t>(src + 32);
+
+	const auto *end = src + size;
+	const auto *sides = src + CaptureFormat::HEADER_SIZE;
+	const auto *pos = sides + (count + 7) / 8;
+	for (auto &column : m_columns)
+	{
+		pos = stream_vbyte_decode(pos, end, column.data(), count);
+		if (!pos)
+		{
+			return std::nullopt;
+		}
+	}
+	if (pos != end)
+	{
+		return std::nullopt;
+	}
+
+	// Column at a time, each loop carries a single dependency chain.
+	uint64_t delta = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		delta += static_cast<uint64_t>(zigzag_decode(m_columns[TIMESTAMP][i]));
+		timestamp += delta;
+		out[i].timestamp_ns = timestamp;
+	}
+	delta = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		delta += static_cast<uint64_t>(zigzag_decode(m_columns[SEQUENCE][i]));
+		sequence += delta;
+		out[i].sequence = sequence;
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		price += static_cast<uint64_t>(zigzag_decode(m_columns[PRICE][i]));
+		out[i].price = price;
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		quantity += static_cast<uint64_t>(zigzag_decode(m_columns[QUANTITY][i]));
+		out[i].quantity = quantity;
+		out[i].side = (static_cast<unsigned>(sides[i / 8]) >> (i % 8)) & 1 ? Side::Ask : Side::Bid;
+	}
+
+	return CaptureBlockInfo { count, size };
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,441 @@
+#include <fcntl.h>
+#include <l2/capture_sink.hpp>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace hft::orderbook::capture_file;
+
+namespace hft::orderbook {
+
+namespace {
+
+// O_DIRECT wants buffers, offsets and sizes aligned to the logical block size, a page covers every device.
+constexpr size_t ALIGNMENT = 4096;
+
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(100);
+
+// Writes inside the file size need no metadata update, so the kernel runs them inline instead of on a worker.
+constexpr uint64_t PREALLOCATE = 64 << 20;
+
+// Completion user_data: block in the low 16 bits, bytes written above them, this bit for in place flushes.
+constexpr uint64_t FLUSH_WRITE = uint64_t { 1 } << 63;
+
+constexpr auto round_up(size_t bytes) -> size_t
+{
+	return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+} // namespace
+
+CaptureSink::CaptureSink(const std::string &path, const CaptureSinkConfig &config)
+	: m_path(path)
+	, m_block_size((std::max(config.block_size, ALIGNMENT) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+	, m_block_count(std::max<size_t>(config.blocks, 2))
+	, m_records_per_block(records_per_block(m_block_size))
+	, m_flush_interval(config.flush_interval)
+	, m_queue(config.queue_capacity)
+{
+	constexpr auto FLAGS = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+	m_direct = config.direct;
+	m_fd = ::open(path.c_str(), FLAGS | (m_direct ? O_DIRECT : 0), 0644);
+	if (m_fd < 0 && m_direct && errno == EINVAL)
+	{
+		// tmpfs and a few others have no direct I/O.
+		m_direct = false;
+		m_fd = ::open(path.c_str(), FLAGS, 0644);
+	}
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot open capture " + path + ": " + std::strerror(errno));
+	}
+
+	auto *blocks = ::mmap(
+		nullptr, m_block_count * m_block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1,
+		0
+	);
+	if (blocks == MAP_FAILED)
+	{
+		const auto error = errno;
+		::close(m_fd);
+		throw std::runtime_error("Cannot allocate capture blocks: " + std::string(std::strerror(error)));
+	}
+	m_blocks = static_cast<std::byte *>(blocks);
+
+	if (config.io_uring)
+	{
+		try
+		{
+			m_ring = std::make_unique<core::IoRing>(static_cast<unsigned>(std::bit_ceil(m_block_count + 2)));
+		}
+		catch (const std::runtime_error &)
+		{
+			// Writes go through pwrite instead.
+		}
+	}
+	if (m_ring)
+	{
+		std::vector<iovec> buffers(m_block_count);
+		for (size_t i = 0; i < m_block_count; ++i)
+		{
+			buffers[i] = { block_data(i), m_block_size };
+		}
+		// Pinning can fail on a low RLIMIT_MEMLOCK, plain writes from the same blocks still work.
+		m_registered = m_ring->register_buffers(buffers);
+	}
+
+	for (size_t i = m_block_count; i-- > 0;)
+	{
+		m_free_blocks.push_back(i);
+	}
+	m_free_blocks.reserve(m_block_count);
+	acquire_block();
+
+	m_writer = std::thread([this] { writer_loop(); });
+}
+
+CaptureSink::~CaptureSink()
+{
+	try
+	{
+		finish();
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+	// The ring goes first, closing it waits for whatever the kernel still reads from the blocks.
+	m_ring.reset();
+	::munmap(m_blocks, m_block_count * m_block_size);
+}
+
+void CaptureSink::finish()
+{
+	if (!m_writer.joinable())
+	{
+		return;
+	}
+
+	m_stop.store(true, std::memory_order_release);
+	m_writer.join();
+
+	const auto closed = ::close(m_fd);
+	const auto error = errno;
+	m_fd = -1;
+
+	if (m_error)
+	{
+		std::rethrow_exception(m_error);
+	}
+	if (closed != 0)
+	{
+		throw std::runtime_error("Cannot close capture " + m_path + ": " + std::strerror(error));
+	}
+}
+
+auto CaptureSink::get_stats() const noexcept -> CaptureSinkStats
+{
+	return {
+		.records = m_records,
+		.dropped = m_dropped,
+		.blocks_written = m_blocks_written.load(std::memory_order_relaxed),
+		// Acquire, the bytes of a counted flush are in bytes_written and in the file.
+		.flushes = m_flushes.load(std::memory_order_acquire),
+		.bytes_written = m_bytes_written.load(std::memory_order_relaxed),
+		.disk_waits = m_disk_waits.load(std::memory_order_relaxed),
+		.queue_high_water = m_queue_high_water.load(std::memory_order_relaxed),
+	};
+}
+
+void CaptureSink::writer_loop()
+{
+	try
+	{
+		while (true)
+		{
+			if (m_ring)
+			{
+				reap_completions();
+			}
+
+			const auto pending = m_queue.size();
+			if (pending > m_queue_high_water.load(std::memory_order_relaxed))
+			{
+				m_queue_high_water.store(pending, std::memory_order_relaxed);
+			}
+
+			while (const auto *update = m_queue.front())
+			{
+				if (m_current_count == m_flushed_count)
+				{
+					m_current_since = std::chrono::steady_clock::now();
+				}
+				auto *records = block_data(m_current) + sizeof(BlockHeader);
+				std::memcpy(records + m_current_count * sizeof(MarketUpdate), update, sizeof(MarketUpdate));
+				m_queue.pop();
+
+				if (++m_current_count == m_records_per_block)
+				{
+					write_block();
+				}
+			}
+
+			// Records pushed before the stop flag are visible once it is, look once more.
+			if (m_stop.load(std::memory_order_acquire))
+			{
+				if (!m_queue.front())
+				{
+					break;
+				}
+				continue;
+			}
+
+			if (m_current_count != m_flushed_count &&
+				std::chrono::steady_clock::now() - m_current_since >= m_flush_interval)
+			{
+				flush_block();
+			}
+			std::this_thread::sleep_for(IDLE_SLEEP);
+		}
+
+		if (m_current_count != 0)
+		{
+			write_block();
+		}
+		while (m_in_flight != 0)
+		{
+			if (const auto result = m_ring->submit(1); result < 0)
+			{
+				throw std::runtime_error("Cannot wait for capture " + m_path + ": " + std::strerror(-result));
+			}
+			reap_completions();
+		}
+
+		// Drops the preallocated tail.
+		if (::ftruncate(m_fd, static_cast<off_t>(m_next_index * m_block_size)) != 0)
+		{
+			throw std::runtime_error("Cannot truncate capture " + m_path + ": " + std::strerror(errno));
+		}
+	}
+	catch (const std::runtime_error &)
+	{
+		// Nothing more is written, the appending thread drops once the ring fills.
+		m_error = std::current_exception();
+	}
+}
+
+void CaptureSink::reap_completions()
+{
+	while (const auto *completion = m_ring->peek())
+	{
+		const auto result = completion->res;
+		const auto user_data = completion->user_data;
+		m_ring->seen();
+
+		if (result < 0)
+		{
+			throw std::runtime_error("Cannot write capture " + m_path + ": " + std::strerror(-result));
+		}
+		const auto length = static_cast<size_t>((user_data & ~FLUSH_WRITE) >> 16);
+		if (static_cast<size_t>(result) != length)
+		{
+			throw std::runtime_error("Short write to capture " + m_path);
+		}
+
+		--m_in_flight;
+		m_bytes_written.store(m_bytes_written.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+		if ((user_data & FLUSH_WRITE) == 0)
+		{
+			m_free_blocks.push_back(static_cast<size_t>(user_data & 0xffff));
+			m_blocks_written.store(m_blocks_written.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+		else if (--m_flushes_in_flight == 0)
+		{
+			m_flushes.store(m_flushes.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+	}
+}
+
+void CaptureSink::wait_for_flushes()
+{
+	while (m_flushes_in_flight != 0)
+	{
+		if (const auto result = m_ring->submit(1); result < 0)
+		{
+			throw std::runtime_error("Cannot wait for capture " + m_path + ": " + std::strerror(-result));
+		}
+		reap_completions();
+	}
+}
+
+void CaptureSink::acquire_block()
+{
+	if (m_free_blocks.empty())
+	{
+		m_disk_waits.store(m_disk_waits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		while (m_free_blocks.empty())
+		{
+			if (const auto result = m_ring->submit(1); result < 0)
+			{
+				throw std::runtime_error("Cannot wait for capture " + m_path + ": " + std::strerror(-result));
+			}
+			reap_completions();
+		}
+	}
+	m_current = m_free_blocks.back();
+	m_free_blocks.pop_back();
+}
+
+void CaptureSink::write_header(size_t count)
+{
+	auto *data = block_data(m_current);
+	const BlockHeader header { MAGIC, m_next_index, m_block_size, static_cast<uint32_t>(count), sizeof(MarketUpdate) };
+	std::memcpy(data, &header, sizeof(header));
+
+	const auto offset = m_next_index * m_block_size;
+	if (offset + m_block_size > m_allocated)
+	{
+		// Filesystems without fallocate simply keep extending on every write.
+		const auto step = std::max<uint64_t>(PREALLOCATE, m_block_size);
+		if (::fallocate(m_fd, 0, static_cast<off_t>(m_allocated), static_cast<off_t>(step)) == 0)
+		{
+			m_allocated += step;
+		}
+	}
+}
+
+void CaptureSink::flush_block()
+{
+	// An earlier flush of this block may still be reading the header page, writes to one offset are not ordered.
+	wait_for_flushes();
+	write_header(m_current_count);
+
+	auto *data = block_data(m_current);
+	const auto used = sizeof(BlockHeader) + m_current_count * sizeof(MarketUpdate);
+	const auto end = std::min(round_up(used), m_block_size);
+	std::memset(data + used, 0, end - used);
+
+	// Pages up to the last flush are on disk already, except the header page and the one the last flush ended in.
+	const auto first = (sizeof(BlockHeader) + m_flushed_count * sizeof(MarketUpdate)) & ~(ALIGNMENT - 1);
+	if (first > ALIGNMENT)
+	{
+		write_range(0, ALIGNMENT, true);
+		write_range(first, end - first, true);
+	}
+	else
+	{
+		write_range(0, end, true);
+	}
+
+	m_flushed_count = m_current_count;
+	// Written already with pwrite, io_uring counts the flush once its last write completes.
+	if (m_flushes_in_flight == 0)
+	{
+		m_flushes.store(m_flushes.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+}
+
+void CaptureSink::write_block()
+{
+	wait_for_flushes();
+	write_header(m_current_count);
+
+	auto *data = block_data(m_current);
+	const auto used = sizeof(BlockHeader) + m_current_count * sizeof(MarketUpdate);
+	std::memset(data + used, 0, m_block_size - used);
+
+	write_range(0, m_block_size, false);
+	++m_next_index;
+	m_current_count = 0;
+	m_flushed_count = 0;
+	acquire_block();
+}
+
+void CaptureSink::write_range(size_t begin, size_t length, bool flush)
+{
+	auto *data = block_data(m_current) + begin;
+	const auto offset = m_next_index * m_block_size + begin;
+
+	if (m_ring)
+	{
+		// The ring has a slot per block and two for flushes, never full while a block is free to fill.
+		auto *sqe = m_ring->get_sqe();
+		sqe->opcode = m_registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		sqe->fd = m_fd;
+		sqe->addr = reinterpret_cast<uint64_t>(data);
+		sqe->len = static_cast<uint32_t>(length);
+		sqe->off = offset;
+		sqe->buf_index = m_registered ? static_cast<uint16_t>(m_current) : 0;
+		sqe->user_data = m_current | (static_cast<uint64_t>(length) << 16) | (flush ? FLUSH_WRITE : 0);
+		if (const auto result = m_ring->submit(); result < 0)
+		{
+			throw std::runtime_error("Cannot submit capture write " + m_path + ": " + std::strerror(-result));
+		}
+		++m_in_flight;
+		m_flushes_in_flight += flush ? 1 : 0;
+		return;
+	}
+
+	for (size_t written = 0; written < length;)
+	{
+		const auto result = ::pwrite(m_fd, data + written, length - written, static_cast<off_t>(offset + written));
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::runtime_error("Cannot write capture " + m_path + ": " + std::strerror(errno));
+		}
+		written += static_cast<size_t>(result);
+	}
+	if (!flush)
+	{
+		m_free_blocks.push_back(m_current);
+		m_blocks_written.store(m_blocks_written.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+	m_bytes_written.store(m_bytes_written.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+}
+
+auto read_capture_file(const std::string &path) -> std::vector<MarketUpdate>
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		throw std::runtime_error("Cannot open capture " + path);
+	}
+	const std::vector<char> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	std::vector<MarketUpdate> updates;
+	uint64_t index = 0;
+	for (size_t offset = 0; offset < bytes.size(); ++index)
+	{
+		BlockHeader header;
+		if (bytes.size() - offset < sizeof(header))
+		{
+			throw std::runtime_error("Capture " + path + " ends inside a block header");
+		}
+		std::memcpy(&header, bytes.data() + offset, sizeof(header));
+		if (header.magic == 0)
+		{
+			// Preallocated and never written, a writer that died leaves its tail like this.
+			break;
+		}
+		// The last block may be cut short where a writer that died had only flushed part of it.
+		if (header.magic != MAGIC || header.index != index || header.record_size != sizeof(MarketUpdate) ||
+			header.block_size < sizeof(header) || header.count > CaptureSink::records_per_block(header.block_size) ||
+			sizeof(header) + header.count * sizeof(MarketUpdate) > bytes.size() - offset)
+		{
+			throw std::runtime_error("Capture " + path + " has a malformed block " + std::to_string(index));
+		}
+
+		const auto *records = bytes.data() + offset + sizeof(header);
+		for (uint32_t i = 0; i < header.count; ++i)
+		{
+			auto &update = updates.emplace_back();
+			std::memcpy(&update, records + i * sizeof(MarketUpdate), sizeof(MarketUpdate));
+		}
+		offset += header.block_size;
+	}
+	return updates;
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,154 @@
+#include <charconv>
+#include <core/crc32.hpp>
+#include <l2/checksum.hpp>
+
+namespace hft::orderbook {
+
+namespace {
+
+constexpr auto POW10 = []
+{
+	std::array<uint64_t, 20> table {};
+	table[0] = 1;
+	for (size_t i = 1; i < table.size(); ++i)
+	{
+		table[i] = table[i - 1] * 10;
+	}
+	return table;
+}();
+
+auto append_integer(char *pos, uint64_t value) -> char *
+{
+	return std::to_chars(pos, pos + 20, value).ptr;
+}
+
+} // namespace
+
+BookChecksum::BookChecksum(ChecksumConfig config): m_config(config)
+{
+	if (m_config.depth == 0 || m_config.depth > MAX_DEPTH)
+	{
+		throw std::runtime_error("Checksum depth must be 1 to " + std::to_string(MAX_DEPTH));
+	}
+}
+
+auto BookChecksum::collect(const OrderBook &book, Side side, std::span<PriceLevel, MAX_DEPTH> out) const -> size_t
+{
+	const auto levels = out.first(m_config.depth);
+	auto count = side == Side::Bid ? book.get_bid_levels(levels) : book.get_ask_levels(levels);
+	if (!book.is_cold_tier_enabled())
+	{
+		return count;
+	}
+
+	// Cold levels are all worse than the hot ones and stored worst first.
+	const auto cold = side == Side::Bid ? book.get_bids_cold_tier().levels() : book.get_asks_cold_tier().levels();
+	for (auto it = cold.rbegin(); it != cold.rend() && count < levels.size(); ++it)
+	{
+		levels[count++] = *it;
+	}
+	return count;
+}
+
+auto BookChecksum::append_fixed(char *pos, uint64_t value, uint8_t decimals) const -> char *
+{
+	if (decimals == 0)
+	{
+		return append_integer(pos, value);
+	}
+
+	const auto scale = POW10[decimals];
+	pos = append_integer(pos, value / scale);
+
+	auto fraction = value % scale;
+	auto digits = static_cast<size_t>(decimals);
+	if (m_config.trim_trailing_zeros)
+	{
+		if (fraction == 0)
+		{
+			return pos;
+		}
+		while (fraction % 10 == 0)
+		{
+			fraction /= 10;
+			--digits;
+		}
+	}
+
+	*pos++ = '.';
+	for (auto i = digits; i > 0; --i)
+	{
+		pos[i - 1] = static_cast<char>('0' + fraction % 10);
+		fraction /= 10;
+	}
+	return pos + digits;
+}
+
+auto BookChecksum::format(const OrderBook &book, std::span<char> out) const -> size_t
+{
+	assert(out.size() >= MAX_STRING_SIZE);
+
+	if (m_config.depth > OrderBook::MAX_LEVELS && !book.is_cold_tier_enabled()) [[unlikely]]
+	{
+		throw std::runtime_error(
+			"Checksum depth " + std::to_string(m_config.depth) + " needs the cold tier, the book holds " +
+			std::to_string(OrderBook::MAX_LEVELS) + " levels"
+		);
+	}
+
+	std::array<PriceLevel, MAX_DEPTH> bids;
+	std::array<PriceLevel, MAX_DEPTH> asks;
+	const auto bid_count = collect(book, Side::Bid, bids);
+	const auto ask_count = collect(book, Side::Ask, asks);
+
+	auto *begin = out.data();
+	auto *pos = begin;
+
+	if (m_config.format == ChecksumFormat::Kraken)
+	{
+		for (size_t i = 0; i < ask_count; ++i)
+		{
+			pos = append_integer(pos, asks[i].price);
+			pos = append_integer(pos, asks[i].quantity);
+		}
+		for (size_t i = 0; i < bid_count; ++i)
+		{
+			pos = append_integer(pos, bids[i].price);
+			pos = append_integer(pos, bids[i].quantity);
+		}
+		return static_cast<size_t>(pos - begin);
+	}
+
+	const auto append_level = [&](const PriceLevel &level)
+	{
+		if (pos != begin)
+		{
+			*pos++ = ':';
+		}
+		pos = append_fixed(pos, level.price, m_config.price_decimals);
+		*pos++ = ':';
+		pos = append_fixed(pos, level.quantity, m_config.qty_decimals);
+	};
+
+	for (size_t i = 0; i < std::max(bid_count, ask_count); ++i)
+	{
+		if (i < bid_count)
+		{
+			append_level(bids[i]);
+		}
+		if (i < ask_count)
+		{
+			append_level(asks[i]);
+		}
+	}
+	return static_cast<size_t>(pos - begin);
+}
+
+auto BookChecksum::compute(const OrderBook &book) const -> uint32_t
+{
+	std::array<char, MAX_STRING_SIZE> buffer;
+	const auto len = format(book, buffer);
+	return core::crc32(buffer.data(), len);
+}
+
+} // namespace hft::orderbook
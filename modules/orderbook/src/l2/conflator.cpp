@@ -0,0 +1,177 @@
+#include <l2/conflator.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+Conflator::Conflator(OrderBook &book, ConflatorConfig config)
+	: m_book(book)
+	, m_config(config)
+{
+	m_config.depth = std::min(m_config.depth, OrderBook::MAX_LEVELS);
+
+	// Whatever the book already holds has never been published.
+	m_bids_dirty.set();
+	m_asks_dirty.set();
+}
+
+void Conflator::begin_update(uint64_t now_ns)
+{
+	if (m_pending_updates++ == 0)
+	{
+		m_batch_start_ns = now_ns;
+	}
+}
+
+void Conflator::update_bid_side(uint64_t price, uint64_t qty, uint64_t now_ns)
+{
+	begin_update(now_ns);
+
+	const auto &hash = m_book.get_bids_hash_table();
+	const auto &pool = m_book.get_bids_pool();
+
+	// The slot is marked before the update to catch deletes and after it to catch inserts.
+	if (const auto *level = hash.lookup(price))
+	{
+		m_bids_dirty.set(pool.index_of(level));
+	}
+
+	m_book.update_bid_side(price, qty);
+
+	if (const auto *level = hash.lookup(price))
+	{
+		m_bids_dirty.set(pool.index_of(level));
+	}
+}
+
+void Conflator::update_ask_side(uint64_t price, uint64_t qty, uint64_t now_ns)
+{
+	begin_update(now_ns);
+
+	const auto &hash = m_book.get_asks_hash_table();
+	const auto &pool = m_book.get_asks_pool();
+
+	if (const auto *level = hash.lookup(price))
+	{
+		m_asks_dirty.set(pool.index_of(level));
+	}
+
+	m_book.update_ask_side(price, qty);
+
+	if (const auto *level = hash.lookup(price))
+	{
+		m_asks_dirty.set(pool.index_of(level));
+	}
+}
+
+auto Conflator::flush_due(uint64_t now_ns) const -> bool
+{
+	if (m_pending_updates == 0)
+	{
+		return false;
+	}
+
+	if (m_config.max_updates != 0 && m_pending_updates >= m_config.max_updates)
+	{
+		return true;
+	}
+
+	return m_config.max_delay_ns != 0 && now_ns - m_batch_start_ns >= m_config.max_delay_ns;
+}
+
+auto Conflator::flush() -> const BookDiff &
+{
+	m_diff.count = 0;
+
+	if (m_bids_dirty.any())
+	{
+		diff_side(
+			Side::Bid,
+			m_book.get_bids_list(),
+			m_book.get_bids_pool(),
+			m_bids_dirty,
+			m_published_bids,
+			m_published_bid_count
+		);
+		m_bids_dirty.reset();
+	}
+
+	if (m_asks_dirty.any())
+	{
+		diff_side(
+			Side::Ask,
+			m_book.get_asks_list(),
+			m_book.get_asks_pool(),
+			m_asks_dirty,
+			m_published_asks,
+			m_published_ask_count
+		);
+		m_asks_dirty.reset();
+	}
+
+	m_pending_updates = 0;
+	return m_diff;
+}
+
+void Conflator::diff_side(
+	Side side,
+	const ci_dllist *list,
+	const MemoryPool<Level, OrderBook::POOL_SIZE> &pool,
+	const DirtySet &dirty,
+	Snapshot &published,
+	size_t &published_count
+)
+{
+	const auto is_better = [side](uint64_t lhs, uint64_t rhs)
+	{
+		return side == Side::Bid ? lhs > rhs : lhs < rhs;
+	};
+
+	// Both the published snapshot and the live list are sorted best first,
+	// so a single merge pass yields the minimal diff.
+	Snapshot current {};
+	size_t current_count = 0;
+	size_t prev = 0;
+
+	const ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH_CONST(lnk, list)
+	{
+		if (current_count == m_config.depth)
+		{
+			break;
+		}
+
+		const auto *level = container_of(lnk, Level, link);
+		current[current_count++] = { level->price, level->quantity };
+
+		while (prev < published_count && is_better(published[prev].price, level->price))
+		{
+			push_change(side, LevelAction::Remove, published[prev].price, 0);
+			++prev;
+		}
+
+		if (prev < published_count && published[prev].price == level->price)
+		{
+			// A clean slot cannot have changed quantity since the last flush.
+			if (dirty.test(pool.index_of(level)) && published[prev].quantity != level->quantity)
+			{
+				push_change(side, LevelAction::Change, level->price, level->quantity);
+			}
+			++prev;
+		}
+		else
+		{
+			push_change(side, LevelAction::Insert, level->price, level->quantity);
+		}
+	}
+
+	for (; prev < published_count; ++prev)
+	{
+		push_change(side, LevelAction::Remove, published[prev].price, 0);
+	}
+
+	published = current;
+	published_count = current_count;
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,258 @@
+#include <l2/consolidated_book.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+auto ConsolidatedBook::add_venue(OrderBook &book) -> VenueId
+{
+	if (m_venue_count >= MAX_VENUES)
+	{
+		throw std::runtime_error("Too many venues in consolidated book");
+	}
+
+	const auto venue = static_cast<VenueId>(m_venue_count++);
+	m_venues[venue] = &book;
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> levels {};
+
+	const auto bid_count = book.get_bid_levels(levels);
+	for (size_t i = 0; i < bid_count; ++i)
+	{
+		apply_bid_quantity(venue, levels[i].price, levels[i].quantity);
+	}
+
+	const auto ask_count = book.get_ask_levels(levels);
+	for (size_t i = 0; i < ask_count; ++i)
+	{
+		apply_ask_quantity(venue, levels[i].price, levels[i].quantity);
+	}
+
+	return venue;
+}
+
+void ConsolidatedBook::update_bid_side(VenueId venue, uint64_t price, uint64_t qty)
+{
+	update_side(venue, Side::Bid, price, qty);
+}
+
+void ConsolidatedBook::update_ask_side(VenueId venue, uint64_t price, uint64_t qty)
+{
+	update_side(venue, Side::Ask, price, qty);
+}
+
+void ConsolidatedBook::update_side(VenueId venue, Side side, uint64_t price, uint64_t qty)
+{
+	assert(venue < m_venue_count);
+
+	std::array<LevelDelta, 2> deltas;
+	const auto count = apply_update(*m_venues[venue], side, price, qty, deltas);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		apply_delta(venue, deltas[i]);
+	}
+}
+
+void ConsolidatedBook::apply_delta(VenueId venue, const LevelDelta &delta)
+{
+	if (delta.side == Side::Bid)
+	{
+		apply_bid_quantity(venue, delta.price, delta.new_quantity);
+	}
+	else
+	{
+		apply_ask_quantity(venue, delta.price, delta.new_quantity);
+	}
+}
+
+void ConsolidatedBook::apply_bid_quantity(VenueId venue, uint64_t price, uint64_t qty)
+{
+	const auto venue_bit = static_cast<uint16_t>(1U << venue);
+
+	auto *existing = m_bids_hash.lookup(price);
+	if (existing)
+	{
+		auto *merged = container_of(existing, ConsolidatedLevel, level);
+		auto &venue_qty = merged->venue_quantity[venue];
+
+		existing->quantity = existing->quantity - venue_qty + qty;
+		venue_qty = qty;
+
+		if (qty == 0)
+		{
+			merged->venue_mask &= static_cast<uint16_t>(~venue_bit);
+		}
+		else
+		{
+			merged->venue_mask |= venue_bit;
+		}
+
+		if (existing->quantity == 0)
+		{
+			ci_dllist_remove(&existing->link);
+			m_bids_hash.remove(price);
+			m_bids_pool.deallocate(merged);
+			--m_bid_count;
+		}
+		return;
+	}
+
+	if (qty == 0) [[unlikely]]
+	{
+		return;
+	}
+
+	auto *merged = m_bids_pool.allocate();
+	if (!merged) [[unlikely]]
+	{
+		return;
+	}
+
+	*merged = ConsolidatedLevel {};
+	merged->level.price = price;
+	merged->level.quantity = qty;
+	merged->venue_quantity[venue] = qty;
+	merged->venue_mask = venue_bit;
+	insert_bid_sorted(merged);
+	m_bids_hash.insert(price, &merged->level);
+
+	++m_bid_count;
+}
+
+void ConsolidatedBook::apply_ask_quantity(VenueId venue, uint64_t price, uint64_t qty)
+{
+	const auto venue_bit = static_cast<uint16_t>(1U << venue);
+
+	auto *existing = m_asks_hash.lookup(price);
+	if (existing)
+	{
+		auto *merged = container_of(existing, ConsolidatedLevel, level);
+		auto &venue_qty = merged->venue_quantity[venue];
+
+		existing->quantity = existing->quantity - venue_qty + qty;
+		venue_qty = qty;
+
+		if (qty == 0)
+		{
+			merged->venue_mask &= static_cast<uint16_t>(~venue_bit);
+		}
+		else
+		{
+			merged->venue_mask |= venue_bit;
+		}
+
+		if (existing->quantity == 0)
+		{
+			ci_dllist_remove(&existing->link);
+			m_asks_hash.remove(price);
+			m_asks_pool.deallocate(merged);
+			--m_ask_count;
+		}
+		return;
+	}
+
+	if (qty == 0) [[unlikely]]
+	{
+		return;
+	}
+
+	auto *merged = m_asks_pool.allocate();
+	if (!merged) [[unlikely]]
+	{
+		return;
+	}
+
+	*merged = ConsolidatedLevel {};
+	merged->level.price = price;
+	merged->level.quantity = qty;
+	merged->venue_quantity[venue] = qty;
+	merged->venue_mask = venue_bit;
+	insert_ask_sorted(merged);
+	m_asks_hash.insert(price, &merged->level);
+
+	++m_ask_count;
+}
+
+void ConsolidatedBook::insert_bid_sorted(ConsolidatedLevel *level)
+{
+	auto *pos = &m_bids_list.l;
+
+	ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH(lnk, &m_bids_list)
+	{
+		auto *cur = container_of(lnk, Level, link);
+		if (cur->price < level->level.price)
+		{
+			break;
+		}
+		pos = lnk;
+	}
+	ci_dllist_insert_after(pos, &level->level.link);
+}
+
+void ConsolidatedBook::insert_ask_sorted(ConsolidatedLevel *level)
+{
+	auto *pos = &m_asks_list.l;
+
+	ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH(lnk, &m_asks_list)
+	{
+		auto *cur = container_of(lnk, Level, link);
+		if (cur->price > level->level.price)
+		{
+			pos = lnk;
+			break;
+		}
+	}
+	ci_dllist_insert_before(pos, &level->level.link);
+}
+
+auto ConsolidatedBook::lookup_bid(uint64_t price) const -> const ConsolidatedLevel *
+{
+	const auto *level = m_bids_hash.lookup(price);
+	return level ? container_of(level, ConsolidatedLevel, level) : nullptr;
+}
+
+auto ConsolidatedBook::lookup_ask(uint64_t price) const -> const ConsolidatedLevel *
+{
+	const auto *level = m_asks_hash.lookup(price);
+	return level ? container_of(level, ConsolidatedLevel, level) : nullptr;
+}
+
+auto ConsolidatedBook::best_bid() const -> std::optional<ConsolidatedBest>
+{
+	return make_best(&m_bids_list);
+}
+
+auto ConsolidatedBook::best_ask() const -> std::optional<ConsolidatedBest>
+{
+	return make_best(&m_asks_list);
+}
+
+auto ConsolidatedBook::make_best(const ci_dllist *list) -> std::optional<ConsolidatedBest>
+{
+	if (ci_dllist_is_empty(list))
+	{
+		return std::nullopt;
+	}
+
+	const auto *level = container_of(ci_dllist_head(list), Level, link);
+	const auto *merged = container_of(level, ConsolidatedLevel, level);
+
+	ConsolidatedBest best { level->price, level->quantity, 0, merged->venue_mask };
+
+	uint64_t best_qty = 0;
+	for (auto mask = merged->venue_mask; mask != 0; mask &= static_cast<uint16_t>(mask - 1))
+	{
+		const auto venue = std::countr_zero(mask);
+		if (merged->venue_quantity[static_cast<size_t>(venue)] > best_qty)
+		{
+			best_qty = merged->venue_quantity[static_cast<size_t>(venue)];
+			best.venue = static_cast<VenueId>(venue);
+		}
+	}
+	return best;
+}
+
+} // namespace hft::orderbook
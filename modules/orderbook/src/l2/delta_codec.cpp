@@ -0,0 +1,189 @@
+#include <l2/delta_codec.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+auto DeltaEncoder::encode(
+	std::span<std::byte> out,
+	uint64_t sequence,
+	std::span<const LevelChange> changes,
+	const OrderBook &book
+) const -> size_t
+{
+	std::array<PriceLevel, 1> best {};
+	const auto bid_reference = book.get_bid_levels(best) != 0 ? best[0].price : 0;
+	const auto ask_reference = book.get_ask_levels(best) != 0 ? best[0].price : 0;
+
+	return encode(out, sequence, changes, bid_reference, ask_reference);
+}
+
+auto DeltaEncoder::encode(
+	std::span<std::byte> out,
+	uint64_t sequence,
+	std::span<const LevelChange> changes,
+	uint64_t bid_reference,
+	uint64_t ask_reference
+) const -> size_t
+{
+	if (changes.size() > DeltaFormat::MAX_CHANGES) [[unlikely]]
+	{
+		return 0;
+	}
+
+	const auto fixed = m_encoding == DeltaEncoding::Fixed;
+	const auto fixed_size = DeltaFormat::max_size(DeltaEncoding::Fixed, changes.size());
+	if (out.size() < (fixed ? fixed_size : DeltaFormat::PREFIX_SIZE))
+	{
+		return 0;
+	}
+
+	auto *pos = out.data();
+	pos = store_le(pos, static_cast<uint16_t>(DeltaFormat::ROOT_BLOCK_LENGTH));
+	pos = store_le(pos, fixed ? DeltaFormat::FIXED_TEMPLATE_ID : DeltaFormat::COMPACT_TEMPLATE_ID);
+	pos = store_le(pos, DeltaFormat::SCHEMA_ID);
+	pos = store_le(pos, DeltaFormat::VERSION);
+
+	pos = store_le(pos, sequence);
+	pos = store_le(pos, bid_reference);
+	pos = store_le(pos, ask_reference);
+
+	pos = store_le(pos, static_cast<uint16_t>(fixed ? DeltaFormat::FIXED_ENTRY_SIZE : 0));
+	pos = store_le(pos, static_cast<uint16_t>(changes.size()));
+
+	if (fixed)
+	{
+		for (const auto &change : changes)
+		{
+			pos = store_le(pos, change.price);
+			pos = store_le(pos, change.quantity);
+			pos = store_le(pos, change.side);
+			pos = store_le(pos, change.action);
+		}
+		return static_cast<size_t>(pos - out.data());
+	}
+
+	const std::array<uint64_t, 2> references { bid_reference, ask_reference };
+	auto *end = out.data() + out.size();
+	for (const auto &change : changes)
+	{
+		// Close to the end of the buffer an entry goes through scratch space first.
+		std::array<std::byte, DeltaFormat::MAX_COMPACT_ENTRY_SIZE> scratch;
+		const auto remaining = static_cast<size_t>(end - pos);
+		const auto near_end = remaining < DeltaFormat::MAX_COMPACT_ENTRY_SIZE;
+		auto *dst = near_end ? scratch.data() : pos;
+
+		const auto side = static_cast<uint8_t>(change.side);
+		*dst = static_cast<std::byte>(side | static_cast<uint8_t>(static_cast<uint8_t>(change.action) << 1));
+		auto *dst_end = write_varint(dst + 1, zigzag_encode(static_cast<int64_t>(change.price - references[side])));
+		dst_end = write_varint(dst_end, change.quantity);
+
+		if (near_end) [[unlikely]]
+		{
+			const auto size = static_cast<size_t>(dst_end - dst);
+			if (size > remaining)
+			{
+				return 0;
+			}
+			std::memcpy(pos, scratch.data(), size);
+			pos += size;
+			continue;
+		}
+		pos = dst_end;
+	}
+	return static_cast<size_t>(pos - out.data());
+}
+
+auto DeltaMessageView::parse(std::span<const std::byte> in) -> std::optional<DeltaMessageView>
+{
+	if (in.size() < DeltaFormat::PREFIX_SIZE)
+	{
+		return std::nullopt;
+	}
+
+	const auto *pos = in.data();
+	const auto *end = in.data() + in.size();
+
+	const auto block_length = load_le<uint16_t>(pos);
+	const auto template_id = load_le<uint16_t>(pos + 2);
+	const auto schema_id = load_le<uint16_t>(pos + 4);
+	const auto version = load_le<uint16_t>(pos + 6);
+	if (schema_id != DeltaFormat::SCHEMA_ID || version != DeltaFormat::VERSION ||
+		block_length != DeltaFormat::ROOT_BLOCK_LENGTH)
+	{
+		return std::nullopt;
+	}
+	if (template_id != DeltaFormat::FIXED_TEMPLATE_ID && template_id != DeltaFormat::COMPACT_TEMPLATE_ID)
+	{
+		return std::nullopt;
+	}
+	pos += DeltaFormat::HEADER_SIZE;
+
+	DeltaMessageView view;
+	view.m_encoding = template_id == DeltaFormat::FIXED_TEMPLATE_ID ? DeltaEncoding::Fixed : DeltaEncoding::Compact;
+	view.m_sequence = load_le<uint64_t>(pos);
+	view.m_bid_reference = load_le<uint64_t>(pos + 8);
+	view.m_ask_reference = load_le<uint64_t>(pos + 16);
+	pos += DeltaFormat::ROOT_BLOCK_LENGTH;
+
+	const auto entry_length = load_le<uint16_t>(pos);
+	view.m_count = load_le<uint16_t>(pos + 2);
+	pos += DeltaFormat::GROUP_HEADER_SIZE;
+	view.m_entries = pos;
+
+	constexpr auto valid_flags = [](uint8_t side, uint8_t action)
+	{
+		return side <= static_cast<uint8_t>(Side::Ask) && action <= static_cast<uint8_t>(LevelAction::Change);
+	};
+
+	if (view.m_encoding == DeltaEncoding::Fixed)
+	{
+		if (entry_length != DeltaFormat::FIXED_ENTRY_SIZE ||
+			static_cast<size_t>(end - pos) < view.m_count * DeltaFormat::FIXED_ENTRY_SIZE)
+		{
+			return std::nullopt;
+		}
+		for (size_t i = 0; i < view.m_count; ++i, pos += DeltaFormat::FIXED_ENTRY_SIZE)
+		{
+			if (!valid_flags(static_cast<uint8_t>(pos[16]), static_cast<uint8_t>(pos[17])))
+			{
+				return std::nullopt;
+			}
+		}
+	}
+	else
+	{
+		if (entry_length != 0)
+		{
+			return std::nullopt;
+		}
+		for (size_t i = 0; i < view.m_count; ++i)
+		{
+			if (pos == end)
+			{
+				return std::nullopt;
+			}
+			const auto flags = static_cast<uint8_t>(*pos++);
+			if (!valid_flags(flags & 1, static_cast<uint8_t>(flags >> 1)))
+			{
+				return std::nullopt;
+			}
+
+			uint64_t value;
+			pos = read_varint(pos, end, value);
+			if (pos)
+			{
+				pos = read_varint(pos, end, value);
+			}
+			if (!pos)
+			{
+				return std::nullopt;
+			}
+		}
+	}
+
+	view.m_message_size = static_cast<size_t>(pos - in.data());
+	return view;
+}
+
+} // namespace hft::orderbook
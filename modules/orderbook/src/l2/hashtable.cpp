@@ -1,4 +1,5 @@
 #include <l2/hashtable.hpp>
+#include <logging/logger.hpp>
 
 namespace hft::orderbook {
 
@@ -6,23 +7,28 @@ auto L2HashTable::lookup(uint64_t price) const -> Level *
 {
 	const auto first_index = hash1(price);
 	auto index = first_index;
+	size_t probes = 0;
 	do
 	{
+		++probes;
 		const auto &entry = m_table[index];
 		if (is_occupied(entry))
 		{
 			if (matches(entry, price))
 			{
+				record_probes(probes);
 				return entry.ptr;
 			}
 		}
 		else if (!is_tombstone(entry))
 		{
+			record_probes(probes);
 			return nullptr;
 		}
 		index = (index + hash2(price)) & ENTRIES_MASK;
 	} while (index != first_index);
 
+	record_probes(probes);
 	return nullptr;
 }
 
@@ -30,8 +36,10 @@ auto L2HashTable::insert(uint64_t price, Level *level) -> bool
 {
 	const auto first_index = hash1(price);
 	auto index = first_index;
+	size_t probes = 0;
 	do
 	{
+		++probes;
 		auto &entry = m_table[index];
 
 		entry.route_count++;
@@ -40,17 +48,20 @@ auto L2HashTable::insert(uint64_t price, Level *level) -> bool
 		{
 			entry.price = price;
 			entry.ptr = level;
+			record_probes(probes);
 			return true;
 		}
 
 		if (matches(entry, price))
 		{
+			HFT_LOG_ERROR("Duplicate price {} inserted into level table", price);
 			throw std::runtime_error("Adding a duplicate entry is illegal");
 		}
 
 		index = (index + hash2(price)) & ENTRIES_MASK;
 	} while (index != first_index);
 
+	record_probes(probes);
 	return false; // Full (probe cycle exhausted)
 }
 
@@ -0,0 +1,166 @@
+#include <l2/ladder_view.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+LadderView::LadderView(OrderBook &book, std::span<const uint64_t> widths)
+	: m_book(book)
+{
+	if (widths.size() > MAX_WIDTHS || std::ranges::find(widths, 0) != widths.end())
+	{
+		throw std::runtime_error("Ladder view needs at most " + std::to_string(MAX_WIDTHS) + " non zero widths");
+	}
+
+	m_ladder_count = widths.size();
+	std::copy(widths.begin(), widths.end(), m_widths.begin());
+	m_buckets = std::make_unique<Slot[]>(m_ladder_count * 2 * BUCKETS);
+
+	std::array<PriceLevel, OrderBook::MAX_LEVELS> levels {};
+	for (const auto side : { Side::Bid, Side::Ask })
+	{
+		const auto count = side == Side::Bid ? book.get_bid_levels(levels) : book.get_ask_levels(levels);
+		for (size_t i = 0; i < count; ++i)
+		{
+			add_level(side, levels[i].price, levels[i].quantity);
+		}
+
+		const auto cold = side == Side::Bid ? book.get_bids_cold_tier().levels() : book.get_asks_cold_tier().levels();
+		for (const auto &level : cold)
+		{
+			add_level(side, level.price, level.quantity);
+		}
+	}
+}
+
+void LadderView::update_bid_side(uint64_t price, uint64_t qty)
+{
+	update_side(Side::Bid, price, qty);
+}
+
+void LadderView::update_ask_side(uint64_t price, uint64_t qty)
+{
+	update_side(Side::Ask, price, qty);
+}
+
+void LadderView::update_side(Side side, uint64_t price, uint64_t qty)
+{
+	const auto is_bid = side == Side::Bid;
+	const auto count = is_bid ? m_book.get_bid_count() : m_book.get_ask_count();
+
+	// Every level whose depth quantity the update may change, as it was before.
+	std::array<PriceLevel, 3> touched;
+	size_t touched_count = 0;
+	touched[touched_count++] = { price, depth_quantity(side, price) };
+
+	if (count >= OrderBook::MAX_LEVELS)
+	{
+		const auto *tail = container_of(ci_dllist_tail(is_bid ? m_book.get_bids_list() : m_book.get_asks_list()), Level, link);
+		if (tail->price != price)
+		{
+			touched[touched_count++] = { tail->price, tail->quantity };
+		}
+	}
+
+	if (m_book.is_cold_tier_enabled())
+	{
+		const auto cold = is_bid ? m_book.get_bids_cold_tier().levels() : m_book.get_asks_cold_tier().levels();
+		if (cold.size() == OrderBook::COLD_LEVELS && cold.front().price != price)
+		{
+			touched[touched_count++] = cold.front();
+		}
+	}
+
+	if (is_bid)
+	{
+		m_book.update_bid_side(price, qty);
+	}
+	else
+	{
+		m_book.update_ask_side(price, qty);
+	}
+
+	for (size_t i = 0; i < touched_count; ++i)
+	{
+		const auto &before = touched[i];
+		const auto after = depth_quantity(side, before.price);
+		if (after != before.quantity)
+		{
+			apply_delta({ side, before.price, before.quantity, after });
+		}
+	}
+}
+
+void LadderView::apply_delta(const LevelDelta &delta)
+{
+	if (delta.old_quantity != 0)
+	{
+		remove_level(delta.side, delta.price, delta.old_quantity);
+	}
+	if (delta.new_quantity != 0)
+	{
+		add_level(delta.side, delta.price, delta.new_quantity);
+	}
+}
+
+void LadderView::add_level(Side side, uint64_t price, uint64_t qty)
+{
+	for (size_t ladder = 0; ladder < m_ladder_count; ++ladder)
+	{
+		const auto index = price / m_widths[ladder];
+		auto &slot = m_buckets[slot_of(ladder, side, index)];
+		if (slot.index != index)
+		{
+			if (slot.levels != 0 || slot.skipped != 0) [[unlikely]]
+			{
+				++slot.skipped;
+				++m_collisions;
+				continue;
+			}
+			slot = { index, 0, 0, 0 };
+		}
+		slot.quantity += qty;
+		++slot.levels;
+	}
+}
+
+void LadderView::remove_level(Side side, uint64_t price, uint64_t qty)
+{
+	for (size_t ladder = 0; ladder < m_ladder_count; ++ladder)
+	{
+		const auto index = price / m_widths[ladder];
+		auto &slot = m_buckets[slot_of(ladder, side, index)];
+
+		// The slot only changes bucket with no level left out, so a level of another bucket is one of those.
+		if (slot.index != index) [[unlikely]]
+		{
+			assert(slot.skipped != 0);
+			--slot.skipped;
+			continue;
+		}
+		slot.quantity -= std::min(slot.quantity, qty);
+		--slot.levels;
+	}
+}
+
+auto LadderView::depth_quantity(Side side, uint64_t price) const -> uint64_t
+{
+	if (side == Side::Bid)
+	{
+		if (const auto *level = m_book.get_bids_hash_table().lookup(price))
+		{
+			return level->quantity;
+		}
+		const auto *cold = m_book.is_cold_tier_enabled() ? m_book.get_bids_cold_tier().find(price) : nullptr;
+		return cold ? cold->quantity : 0;
+	}
+
+	if (const auto *level = m_book.get_asks_hash_table().lookup(price))
+	{
+		return level->quantity;
+	}
+	const auto *cold = m_book.is_cold_tier_enabled() ? m_book.get_asks_cold_tier().find(price) : nullptr;
+	return cold ? cold->quantity : 0;
+}
+
+} // namespace hft::orderbook
@@ -1,4 +1,5 @@
 #include <l2/orderbook.hpp>
+#include <logging/logger.hpp>
 
 using namespace hft::core;
 
@@ -24,20 +25,42 @@ void OrderBook::add_bid_side(uint64_t price, uint64_t qty)
 		const auto tail_price = get_bid_tail_price();
 		if (price <= tail_price)
 		{
+			if (m_cold_tier_enabled)
+			{
+				m_bids_cold.update(price, qty);
+			}
+			else if (m_counters)
+			{
+				m_counters->bids.out_of_range.add();
+			}
 			return;
 		}
 
 		// Remove tail
 		auto *tail_link = ci_dllist_tail(&m_bids_list);
 		auto *tail_level = container_of(tail_link, Level, link);
+		if (m_cold_tier_enabled)
+		{
+			m_bids_cold.update(tail_level->price, tail_level->quantity);
+		}
 		ci_dllist_remove(tail_link);
 		m_bids_hash.remove(tail_level->price);
 		m_bids_pool.deallocate(tail_level);
+		--m_bid_count;
+		if (m_counters)
+		{
+			m_counters->bids.evictions.add();
+		}
 	}
 
 	auto *new_level = m_bids_pool.allocate();
 	if (!new_level) [[unlikely]]
 	{
+		if (m_counters)
+		{
+			m_counters->bids.pool_exhausted.add();
+		}
+		HFT_LOG_ERROR("Level pool exhausted, bid {} qty {} dropped", price, qty);
 		return;
 	}
 
@@ -48,6 +71,10 @@ void OrderBook::add_bid_side(uint64_t price, uint64_t qty)
 	m_bids_hash.insert(price, new_level);
 
 	++m_bid_count;
+	if (m_counters)
+	{
+		m_counters->bids.inserts.add();
+	}
 }
 
 void OrderBook::add_ask_side(uint64_t price, uint64_t qty)
@@ -70,20 +97,42 @@ void OrderBook::add_ask_side(uint64_t price, uint64_t qty)
 		const auto tail_price = get_ask_tail_price();
 		if (price >= tail_price)
 		{
+			if (m_cold_tier_enabled)
+			{
+				m_asks_cold.update(price, qty);
+			}
+			else if (m_counters)
+			{
+				m_counters->asks.out_of_range.add();
+			}
 			return;
 		}
 
 		// Remove tail
 		auto *tail_link = ci_dllist_tail(&m_asks_list);
 		auto *tail_level = container_of(tail_link, Level, link);
+		if (m_cold_tier_enabled)
+		{
+			m_asks_cold.update(tail_level->price, tail_level->quantity);
+		}
 		ci_dllist_remove(tail_link);
 		m_asks_hash.remove(tail_level->price);
 		m_asks_pool.deallocate(tail_level);
+		--m_ask_count;
+		if (m_counters)
+		{
+			m_counters->asks.evictions.add();
+		}
 	}
 
 	auto *new_level = m_asks_pool.allocate();
 	if (!new_level) [[unlikely]]
 	{
+		if (m_counters)
+		{
+			m_counters->asks.pool_exhausted.add();
+		}
+		HFT_LOG_ERROR("Level pool exhausted, ask {} qty {} dropped", price, qty);
 		return;
 	}
 
@@ -94,10 +143,19 @@ void OrderBook::add_ask_side(uint64_t price, uint64_t qty)
 	m_asks_hash.insert(price, new_level);
 
 	++m_ask_count;
+	if (m_counters)
+	{
+		m_counters->asks.inserts.add();
+	}
 }
 
 void OrderBook::update_bid_side(uint64_t price, uint64_t qty)
 {
+	if (m_counters)
+	{
+		m_counters->bids.updates.add();
+	}
+
 	auto *level = m_bids_hash.lookup(price);
 
 	if (level)
@@ -108,6 +166,15 @@ void OrderBook::update_bid_side(uint64_t price, uint64_t qty)
 			m_bids_hash.remove(price);
 			m_bids_pool.deallocate(level);
 			--m_bid_count;
+			if (m_counters)
+			{
+				m_counters->bids.deletes.add();
+			}
+
+			if (!m_bids_cold.empty()) [[unlikely]]
+			{
+				promote_bid();
+			}
 		}
 		else
 		{
@@ -118,6 +185,10 @@ void OrderBook::update_bid_side(uint64_t price, uint64_t qty)
 
 	if (qty == 0) [[unlikely]]
 	{
+		if (!m_bids_cold.empty())
+		{
+			m_bids_cold.update(price, 0);
+		}
 		return;
 	}
 	/*Insert New*/
@@ -126,6 +197,11 @@ void OrderBook::update_bid_side(uint64_t price, uint64_t qty)
 
 void OrderBook::update_ask_side(uint64_t price, uint64_t qty)
 {
+	if (m_counters)
+	{
+		m_counters->asks.updates.add();
+	}
+
 	auto *level = m_asks_hash.lookup(price);
 
 	if (level)
@@ -136,6 +212,15 @@ void OrderBook::update_ask_side(uint64_t price, uint64_t qty)
 			m_asks_hash.remove(price);
 			m_asks_pool.deallocate(level);
 			--m_ask_count;
+			if (m_counters)
+			{
+				m_counters->asks.deletes.add();
+			}
+
+			if (!m_asks_cold.empty()) [[unlikely]]
+			{
+				promote_ask();
+			}
 		}
 		else
 		{
@@ -146,12 +231,86 @@ void OrderBook::update_ask_side(uint64_t price, uint64_t qty)
 
 	if (qty == 0) [[unlikely]]
 	{
+		if (!m_asks_cold.empty())
+		{
+			m_asks_cold.update(price, 0);
+		}
 		return;
 	}
 	/*Insert New*/
 	add_ask_side(price, qty);
 }
 
+void OrderBook::load_snapshot(std::span<const PriceLevel> bids, std::span<const PriceLevel> asks)
+{
+	clear_bid_side();
+	clear_ask_side();
+	load_side<Side::Bid>(bids);
+	load_side<Side::Ask>(asks);
+}
+
+template<Side SIDE>
+void OrderBook::load_side(std::span<const PriceLevel> levels)
+{
+	constexpr auto IS_BID = SIDE == Side::Bid;
+	auto &list = IS_BID ? m_bids_list : m_asks_list;
+	auto &hash = IS_BID ? m_bids_hash : m_asks_hash;
+	auto &pool = IS_BID ? m_bids_pool : m_asks_pool;
+	auto &count = IS_BID ? m_bid_count : m_ask_count;
+	auto &cold = [this]() -> auto &
+	{
+		if constexpr (IS_BID)
+		{
+			return m_bids_cold;
+		}
+		else
+		{
+			return m_asks_cold;
+		}
+	}();
+
+	// The side is empty, so every level is back in the pool.
+	pool.reset();
+
+	std::array<PriceLevel, COLD_LEVELS> overflow;
+	size_t overflow_count = 0;
+
+	uint64_t previous = 0;
+	for (const auto &level : levels)
+	{
+		const auto worse = IS_BID ? level.price < previous : level.price > previous;
+		if (level.quantity == 0 || (count + overflow_count != 0 && !worse)) [[unlikely]]
+		{
+			continue;
+		}
+		previous = level.price;
+
+		if (count < MAX_LEVELS)
+		{
+			auto *slot = pool.allocate();
+			assert(slot && "The pool holds more than MAX_LEVELS levels");
+			slot->price = level.price;
+			slot->quantity = level.quantity;
+			ci_dllist_push_tail(&list, &slot->link);
+			hash.insert(level.price, slot);
+			++count;
+		}
+		else if (m_cold_tier_enabled && overflow_count < COLD_LEVELS)
+		{
+			overflow[overflow_count++] = level;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (overflow_count != 0)
+	{
+		cold.assign({ overflow.data(), overflow_count });
+	}
+}
+
 void OrderBook::insert_bid_sorted(Level *level)
 {
 	auto *link_pos = &level->link;
@@ -199,6 +358,7 @@ void OrderBook::clear_bid_side()
 	}
 	m_bid_count = 0;
 	ci_dllist_init(&m_bids_list);
+	m_bids_cold.clear();
 }
 
 void OrderBook::clear_ask_side()
@@ -212,6 +372,103 @@ void OrderBook::clear_ask_side()
 	}
 	m_ask_count = 0;
 	ci_dllist_init(&m_asks_list);
+	m_asks_cold.clear();
+}
+
+void OrderBook::set_cold_tier_enabled(bool enabled)
+{
+	m_cold_tier_enabled = enabled;
+	if (!enabled)
+	{
+		m_bids_cold.clear();
+		m_asks_cold.clear();
+	}
+}
+
+void OrderBook::set_counters(BookCounters *counters) noexcept
+{
+	m_counters = counters;
+	m_bids_hash.set_probe_histogram(counters ? &counters->bids.probes : nullptr);
+	m_asks_hash.set_probe_histogram(counters ? &counters->asks.probes : nullptr);
+}
+
+void OrderBook::promote_bid()
+{
+	// Cold levels are all worse than the hot ones, the promoted level becomes the new tail.
+	auto *level = m_bids_pool.allocate();
+	if (!level) [[unlikely]]
+	{
+		if (m_counters)
+		{
+			m_counters->bids.pool_exhausted.add();
+		}
+		HFT_LOG_ERROR("Level pool exhausted, bid not promoted from the cold tier");
+		return;
+	}
+
+	const auto promoted = m_bids_cold.pop_best();
+	level->price = promoted.price;
+	level->quantity = promoted.quantity;
+	ci_dllist_push_tail(&m_bids_list, &level->link);
+	m_bids_hash.insert(promoted.price, level);
+
+	++m_bid_count;
+}
+
+void OrderBook::promote_ask()
+{
+	auto *level = m_asks_pool.allocate();
+	if (!level) [[unlikely]]
+	{
+		if (m_counters)
+		{
+			m_counters->asks.pool_exhausted.add();
+		}
+		HFT_LOG_ERROR("Level pool exhausted, ask not promoted from the cold tier");
+		return;
+	}
+
+	const auto promoted = m_asks_cold.pop_best();
+	level->price = promoted.price;
+	level->quantity = promoted.quantity;
+	ci_dllist_push_tail(&m_asks_list, &level->link);
+	m_asks_hash.insert(promoted.price, level);
+
+	++m_ask_count;
+}
+
+auto OrderBook::get_bid_levels(std::span<PriceLevel> out) const -> size_t
+{
+	size_t count = 0;
+
+	const ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH_CONST(lnk, &m_bids_list)
+	{
+		if (count == out.size())
+		{
+			break;
+		}
+		const auto *level = container_of(lnk, Level, link);
+		out[count++] = { level->price, level->quantity };
+	}
+	return count;
+}
+
+auto OrderBook::get_ask_levels(std::span<PriceLevel> out) const -> size_t
+{
+	size_t count = 0;
+
+	const ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH_CONST(lnk, &m_asks_list)
+	{
+		if (count == out.size())
+		{
+			break;
+		}
+		const auto *level = container_of(lnk, Level, link);
+		out[count++] = { level->price, level->quantity };
+	}
+	return count;
 }
 
 } // namespace hft::orderbook
\ No newline at end of file
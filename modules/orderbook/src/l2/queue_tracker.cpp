@@ -0,0 +1,149 @@
+#include <l2/queue_tracker.hpp>
+
+using namespace hft::core;
+
+namespace hft::orderbook {
+
+QueueTracker::QueueTracker(OrderBook &book, QueueModel model)
+	: m_book(book)
+	, m_model(model)
+{
+	for (auto *state : { &m_bids, &m_asks })
+	{
+		for (auto &tracked : state->prices)
+		{
+			ci_dllist_init(&tracked.orders);
+		}
+	}
+}
+
+void QueueTracker::update_bid_side(uint64_t price, uint64_t qty)
+{
+	m_book.update_bid_side(price, qty);
+
+	const auto slot = find_slot(m_bids, price);
+	if (slot != NO_SLOT) [[unlikely]]
+	{
+		on_level_update(m_bids.prices[slot], qty);
+	}
+}
+
+void QueueTracker::update_ask_side(uint64_t price, uint64_t qty)
+{
+	m_book.update_ask_side(price, qty);
+
+	const auto slot = find_slot(m_asks, price);
+	if (slot != NO_SLOT) [[unlikely]]
+	{
+		on_level_update(m_asks.prices[slot], qty);
+	}
+}
+
+void QueueTracker::on_level_update(TrackedPrice &tracked, uint64_t qty) const
+{
+	const auto old_qty = tracked.level_quantity;
+	tracked.level_quantity = qty;
+
+	// Growth joins behind us.
+	if (qty >= old_qty)
+	{
+		return;
+	}
+
+	const auto decrease = old_qty - qty;
+
+	ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH(lnk, &tracked.orders)
+	{
+		auto *order = container_of(lnk, OwnOrder, link);
+		if (m_model == QueueModel::Fifo)
+		{
+			order->queue_ahead = order->queue_ahead > decrease ? order->queue_ahead - decrease : 0;
+		}
+		else
+		{
+			__extension__ typedef unsigned __int128 Wide;
+			order->queue_ahead = static_cast<uint64_t>(Wide { order->queue_ahead } * qty / old_qty);
+		}
+		order->queue_ahead = std::min(order->queue_ahead, qty);
+	}
+}
+
+auto QueueTracker::add_order(uint64_t id, Side side, uint64_t price, uint64_t qty) -> OwnOrder *
+{
+	auto &state = side == Side::Bid ? m_bids : m_asks;
+
+	auto slot = find_slot(state, price);
+	if (slot == NO_SLOT)
+	{
+		const auto free = static_cast<SlotMask>(~state.used);
+		if (free == 0 || m_orders.empty())
+		{
+			return nullptr;
+		}
+		slot = static_cast<size_t>(std::countr_zero(free));
+		state.used |= static_cast<SlotMask>(1U << slot);
+		state.prices[slot].price = price;
+		state.prices[slot].level_quantity = level_quantity(side, price);
+	}
+
+	auto *order = m_orders.allocate();
+	if (!order) [[unlikely]]
+	{
+		return nullptr;
+	}
+
+	auto &tracked = state.prices[slot];
+	*order = { id, side, price, qty, tracked.level_quantity, {}, static_cast<uint8_t>(slot) };
+	ci_dllist_push_tail(&tracked.orders, &order->link);
+	++m_order_count;
+	return order;
+}
+
+void QueueTracker::remove_order(OwnOrder *order)
+{
+	auto &state = order->side == Side::Bid ? m_bids : m_asks;
+	auto &tracked = state.prices[order->slot];
+
+	ci_dllist_remove(&order->link);
+	if (ci_dllist_is_empty(&tracked.orders))
+	{
+		state.used &= static_cast<SlotMask>(~(1U << order->slot));
+	}
+
+	m_orders.deallocate(order);
+	--m_order_count;
+}
+
+auto QueueTracker::fill_order(OwnOrder *order, uint64_t qty) -> bool
+{
+	if (qty < order->quantity)
+	{
+		order->quantity -= qty;
+		return false;
+	}
+	remove_order(order);
+	return true;
+}
+
+auto QueueTracker::level_quantity(Side side, uint64_t price) const -> uint64_t
+{
+	if (side == Side::Bid)
+	{
+		if (const auto *level = m_book.get_bids_hash_table().lookup(price))
+		{
+			return level->quantity;
+		}
+		const auto *cold = m_book.get_bids_cold_tier().find(price);
+		return cold ? cold->quantity : 0;
+	}
+
+	if (const auto *level = m_book.get_asks_hash_table().lookup(price))
+	{
+		return level->quantity;
+	}
+	const auto *cold = m_book.get_asks_cold_tier().find(price);
+	return cold ? cold->quantity : 0;
+}
+
+} // namespace hft::orderbook
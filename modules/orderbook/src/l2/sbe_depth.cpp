@@ -0,0 +1,238 @@
+#include <l2/sbe_depth.hpp>
+
+namespace hft::orderbook::sbe {
+
+namespace {
+
+/*Reads a groupSize16Encoding group at pos, nullptr if it does not fit before end.*/
+auto parse_group(const std::byte *pos, const std::byte *end, LevelGroup &group) -> const std::byte *
+{
+	if (static_cast<size_t>(end - pos) < GroupSize16Encoding::SIZE)
+	{
+		return nullptr;
+	}
+
+	const size_t block_length = GroupSize16Encoding::BlockLength::get(pos);
+	const size_t count = GroupSize16Encoding::NumInGroup::get(pos);
+	pos += GroupSize16Encoding::SIZE;
+
+	if (block_length < LevelEntry::BLOCK_LENGTH || static_cast<size_t>(end - pos) < block_length * count)
+	{
+		return nullptr;
+	}
+
+	group = { pos, block_length, count };
+	return pos + block_length * count;
+}
+
+} // namespace
+
+auto parse_depth(std::span<const std::byte> in) -> std::optional<DepthMessage>
+{
+	if (in.size() < MessageHeader::SIZE)
+	{
+		return std::nullopt;
+	}
+
+	const auto *pos = in.data();
+	const auto *end = in.data() + in.size();
+
+	DepthMessage message;
+	message.template_id = MessageHeader::TemplateId::get(pos);
+	const size_t block_length = MessageHeader::BlockLength::get(pos);
+	if (MessageHeader::SchemaId::get(pos) != SCHEMA_ID)
+	{
+		return std::nullopt;
+	}
+	pos += MessageHeader::SIZE;
+
+	if (static_cast<size_t>(end - pos) < block_length)
+	{
+		return std::nullopt;
+	}
+
+	switch (message.template_id)
+	{
+	case DepthSnapshotStreamEvent::TEMPLATE_ID:
+		if (block_length < DepthSnapshotStreamEvent::BLOCK_LENGTH)
+		{
+			return std::nullopt;
+		}
+		message.event_time = DepthSnapshotStreamEvent::EventTime::get(pos);
+		message.first_update_id = DepthSnapshotStreamEvent::BookUpdateId::get(pos);
+		message.last_update_id = message.first_update_id;
+		message.price_exponent = DepthSnapshotStreamEvent::PriceExponent::get(pos);
+		message.qty_exponent = DepthSnapshotStreamEvent::QtyExponent::get(pos);
+		break;
+
+	case DepthDiffStreamEvent::TEMPLATE_ID:
+		if (block_length < DepthDiffStreamEvent::BLOCK_LENGTH)
+		{
+			return std::nullopt;
+		}
+		message.event_time = DepthDiffStreamEvent::EventTime::get(pos);
+		message.first_update_id = DepthDiffStreamEvent::FirstBookUpdateId::get(pos);
+		message.last_update_id = DepthDiffStreamEvent::LastBookUpdateId::get(pos);
+		message.price_exponent = DepthDiffStreamEvent::PriceExponent::get(pos);
+		message.qty_exponent = DepthDiffStreamEvent::QtyExponent::get(pos);
+		break;
+
+	default:
+		return std::nullopt;
+	}
+	pos += block_length;
+
+	pos = parse_group(pos, end, message.bids);
+	if (!pos)
+	{
+		return std::nullopt;
+	}
+	pos = parse_group(pos, end, message.asks);
+	if (!pos)
+	{
+		return std::nullopt;
+	}
+
+	// <data name="symbol" type="varString8"/>
+	if (pos == end)
+	{
+		return std::nullopt;
+	}
+	const auto symbol_length = static_cast<size_t>(*pos++);
+	if (static_cast<size_t>(end - pos) < symbol_length)
+	{
+		return std::nullopt;
+	}
+	message.symbol = { reinterpret_cast<const char *>(pos), symbol_length };
+	pos += symbol_length;
+
+	message.message_size = static_cast<size_t>(pos - in.data());
+	return message;
+}
+
+} // namespace hft::orderbook::sbe
+
+namespace hft::orderbook {
+
+namespace {
+
+constexpr int MAX_SHIFT = 19;
+
+constexpr auto POWERS_OF_TEN = []
+{
+	std::array<uint64_t, MAX_SHIFT + 1> powers {};
+	powers[0] = 1;
+	for (size_t i = 1; i < powers.size(); ++i)
+	{
+		powers[i] = powers[i - 1] * 10;
+	}
+	return powers;
+}();
+
+/*Converts mantissas with one exponent to the book's fixed point scale.*/
+class Scaler
+{
+public:
+	Scaler(int8_t exponent, uint8_t decimals)
+		: m_shift(exponent + decimals)
+	{
+		if (valid())
+		{
+			m_factor = POWERS_OF_TEN[static_cast<size_t>(std::abs(m_shift))];
+		}
+	}
+
+	[[nodiscard]] auto valid() const -> bool
+	{
+		return std::abs(m_shift) <= MAX_SHIFT;
+	}
+
+	[[nodiscard]] auto operator()(int64_t mantissa) const -> uint64_t
+	{
+		const auto value = static_cast<uint64_t>(mantissa);
+		if (m_shift == 0) [[likely]]
+		{
+			return value;
+		}
+		return m_shift > 0 ? value * m_factor : value / m_factor;
+	}
+
+private:
+	int m_shift;
+
+	uint64_t m_factor = 1;
+};
+
+} // namespace
+
+auto SbeDepthDecoder::apply(std::span<const std::byte> in, OrderBook &book) const -> SbeApplyResult
+{
+	if (in.size() >= sbe::MessageHeader::SIZE)
+	{
+		const auto template_id = sbe::MessageHeader::TemplateId::get(in.data());
+		if (sbe::MessageHeader::SchemaId::get(in.data()) != sbe::SCHEMA_ID ||
+			(template_id != sbe::DepthSnapshotStreamEvent::TEMPLATE_ID &&
+			 template_id != sbe::DepthDiffStreamEvent::TEMPLATE_ID))
+		{
+			return SbeApplyResult::Ignored;
+		}
+	}
+
+	const auto message = sbe::parse_depth(in);
+	if (!message)
+	{
+		return SbeApplyResult::Malformed;
+	}
+	return apply(*message, book);
+}
+
+auto SbeDepthDecoder::apply(const sbe::DepthMessage &message, OrderBook &book) const -> SbeApplyResult
+{
+	const Scaler price(message.price_exponent, m_config.price_decimals);
+	const Scaler qty(message.qty_exponent, m_config.qty_decimals);
+	if (!price.valid() || !qty.valid())
+	{
+		return SbeApplyResult::Malformed;
+	}
+
+	const auto sequence = book.get_sequence();
+	const auto first = static_cast<uint64_t>(message.first_update_id);
+	const auto last = static_cast<uint64_t>(message.last_update_id);
+
+	if (message.is_snapshot())
+	{
+		book.clear_bid_side();
+		book.clear_ask_side();
+	}
+	else if (last <= sequence)
+	{
+		return SbeApplyResult::Stale;
+	}
+	else if (first > sequence + 1)
+	{
+		return SbeApplyResult::Gap;
+	}
+
+	const auto &bids = message.bids;
+	for (size_t i = 0; i < bids.size(); ++i)
+	{
+		if (bids.price(i) >= 0 && bids.qty(i) >= 0) [[likely]]
+		{
+			book.update_bid_side(price(bids.price(i)), qty(bids.qty(i)));
+		}
+	}
+
+	const auto &asks = message.asks;
+	for (size_t i = 0; i < asks.size(); ++i)
+	{
+		if (asks.price(i) >= 0 && asks.qty(i) >= 0) [[likely]]
+		{
+			book.update_ask_side(price(asks.price(i)), qty(asks.qty(i)));
+		}
+	}
+
+	book.set_sequence(last);
+	return SbeApplyResult::Applied;
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,223 @@
+#include <fcntl.h>
+#include <l2/snapshot_exporter.hpp>
+#include <unistd.h>
+
+using namespace hft::orderbook::columnar;
+
+namespace hft::orderbook {
+
+namespace {
+
+// Writer back off when the ring is empty, far below any sampling cadence worth exporting.
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(100);
+
+template<typename T>
+auto append_column(std::byte *out, const std::vector<T> &column) -> std::byte *
+{
+	const auto size = column.size() * sizeof(T);
+	std::memcpy(out, column.data(), size);
+	return out + size;
+}
+
+} // namespace
+
+SnapshotExporter::SnapshotExporter(const std::string &path, const ExportConfig &config)
+	: m_path(path)
+	, m_depth(std::clamp<size_t>(config.depth, 1, OrderBook::MAX_LEVELS))
+	, m_chunk_rows(std::max<size_t>(config.chunk_rows, 1))
+	, m_queue(config.queue_capacity)
+{
+	m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot open export " + path + ": " + std::strerror(errno));
+	}
+
+	const FileHeader header { MAGIC, VERSION, static_cast<uint32_t>(m_depth) };
+	if (::write(m_fd, &header, sizeof(header)) != sizeof(header))
+	{
+		const auto error = errno;
+		::close(m_fd);
+		throw std::runtime_error("Cannot write export " + path + ": " + std::strerror(error));
+	}
+
+	m_timestamps.reserve(m_chunk_rows);
+	m_prices.reserve(m_chunk_rows);
+	m_quantities.reserve(m_chunk_rows);
+	m_symbols.reserve(m_chunk_rows);
+	m_levels.reserve(m_chunk_rows);
+	m_sides.reserve(m_chunk_rows);
+	m_buffer.resize(chunk_size(m_chunk_rows));
+
+	m_writer = std::thread([this] { writer_loop(); });
+}
+
+SnapshotExporter::~SnapshotExporter()
+{
+	try
+	{
+		finish();
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+}
+
+auto SnapshotExporter::sample(uint64_t timestamp_ns, uint32_t symbol, const OrderBook &book) -> bool
+{
+	++m_samples;
+
+	auto *slot = m_queue.claim();
+	if (!slot) [[unlikely]]
+	{
+		++m_dropped;
+		return false;
+	}
+
+	slot->timestamp_ns = timestamp_ns;
+	slot->symbol = symbol;
+	slot->bid_count = static_cast<uint8_t>(book.get_bid_levels(std::span(slot->bids).first(m_depth)));
+	slot->ask_count = static_cast<uint8_t>(book.get_ask_levels(std::span(slot->asks).first(m_depth)));
+	m_queue.publish();
+	return true;
+}
+
+void SnapshotExporter::finish()
+{
+	if (!m_writer.joinable())
+	{
+		return;
+	}
+
+	m_stop.store(true, std::memory_order_release);
+	m_writer.join();
+
+	const auto closed = ::close(m_fd);
+	const auto error = errno;
+	m_fd = -1;
+
+	if (m_error)
+	{
+		std::rethrow_exception(m_error);
+	}
+	if (closed != 0)
+	{
+		throw std::runtime_error("Cannot close export " + m_path + ": " + std::strerror(error));
+	}
+}
+
+auto SnapshotExporter::get_stats() const noexcept -> ExportStats
+{
+	return {
+		.samples = m_samples,
+		.dropped = m_dropped,
+		.rows = m_rows.load(std::memory_order_relaxed),
+		.chunks = m_chunks.load(std::memory_order_relaxed),
+	};
+}
+
+void SnapshotExporter::writer_loop()
+{
+	try
+	{
+		while (true)
+		{
+			if (const auto *sample = m_queue.front())
+			{
+				append(*sample);
+				m_queue.pop();
+				continue;
+			}
+			// Samples published before the stop flag are visible once it is, look once more.
+			if (m_stop.load(std::memory_order_acquire))
+			{
+				if (!m_queue.front())
+				{
+					break;
+				}
+				continue;
+			}
+			std::this_thread::sleep_for(IDLE_SLEEP);
+		}
+
+		if (!m_timestamps.empty())
+		{
+			write_chunk();
+		}
+	}
+	catch (const std::runtime_error &)
+	{
+		// Nothing more is written, the sampling thread drops once the ring fills.
+		m_error = std::current_exception();
+	}
+}
+
+void SnapshotExporter::append(const Sample &sample)
+{
+	append_side(sample, std::span(sample.bids).first(sample.bid_count), Side::Bid);
+	append_side(sample, std::span(sample.asks).first(sample.ask_count), Side::Ask);
+}
+
+void SnapshotExporter::append_side(const Sample &sample, std::span<const PriceLevel> levels, Side side)
+{
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		m_timestamps.push_back(sample.timestamp_ns);
+		m_prices.push_back(levels[i].price);
+		m_quantities.push_back(levels[i].quantity);
+		m_symbols.push_back(sample.symbol);
+		m_levels.push_back(static_cast<uint8_t>(i));
+		m_sides.push_back(static_cast<uint8_t>(side));
+
+		if (m_timestamps.size() == m_chunk_rows)
+		{
+			write_chunk();
+		}
+	}
+}
+
+void SnapshotExporter::write_chunk()
+{
+	const auto rows = m_timestamps.size();
+	const auto size = chunk_size(rows);
+
+	const ChunkHeader header { rows, size, m_timestamps.front(), m_timestamps.back() };
+	std::memcpy(m_buffer.data(), &header, sizeof(header));
+	auto *out = m_buffer.data() + sizeof(header);
+	out = append_column(out, m_timestamps);
+	out = append_column(out, m_prices);
+	out = append_column(out, m_quantities);
+	out = append_column(out, m_symbols);
+	out = append_column(out, m_levels);
+	out = append_column(out, m_sides);
+	std::fill(out, m_buffer.data() + size, std::byte {});
+
+	const auto *data = m_buffer.data();
+	auto left = static_cast<size_t>(size);
+	while (left != 0)
+	{
+		const auto written = ::write(m_fd, data, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::runtime_error("Cannot write export " + m_path + ": " + std::strerror(errno));
+		}
+		data += written;
+		left -= static_cast<size_t>(written);
+	}
+
+	m_timestamps.clear();
+	m_prices.clear();
+	m_quantities.clear();
+	m_symbols.clear();
+	m_levels.clear();
+	m_sides.clear();
+
+	m_rows.store(m_rows.load(std::memory_order_relaxed) + rows, std::memory_order_relaxed);
+	m_chunks.store(m_chunks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,126 @@
+#include <fcntl.h>
+#include <l2/stats_region.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft::orderbook {
+
+BookStatsRegion::BookStatsRegion(const std::string &path, size_t books)
+	: m_size(books)
+{
+	// A fresh file renamed over path: a monitor still mapping the previous one keeps reading its last counts,
+	// truncating that file in place would fault its every read. The new file also starts with every counter zero.
+	auto temp_path = path + ".XXXXXX";
+	m_fd = ::mkostemp(temp_path.data(), O_CLOEXEC);
+	if (m_fd < 0)
+	{
+		throw std::runtime_error("Cannot create stats region " + path + ": " + std::strerror(errno));
+	}
+
+	const auto fail = [&](const std::string &what)
+	{
+		const auto error = errno;
+		::unlink(temp_path.c_str());
+		::close(m_fd);
+		throw std::runtime_error(what + " " + path + ": " + std::strerror(error));
+	};
+
+	m_mapping_size = sizeof(Header) + books * sizeof(BookCounters);
+	if (::fchmod(m_fd, 0644) != 0 || ::ftruncate(m_fd, static_cast<off_t>(m_mapping_size)) != 0)
+	{
+		fail("Cannot size stats region");
+	}
+
+	// Populated up front so the first count of every book takes no page fault.
+	m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, 0);
+	if (m_mapping == MAP_FAILED)
+	{
+		fail("Cannot map stats region");
+	}
+
+	m_counters = reinterpret_cast<BookCounters *>(static_cast<std::byte *>(m_mapping) + sizeof(Header));
+	for (size_t i = 0; i < books; ++i)
+	{
+		new (&m_counters[i]) BookCounters {};
+	}
+
+	// Header last, a reader that sees it valid sees every counter constructed.
+	Header header;
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.counters_size = sizeof(BookCounters);
+	header.book_count = books;
+	std::memcpy(m_mapping, &header, sizeof(header));
+
+	// Monitors opening path from here on find the region complete.
+	if (::rename(temp_path.c_str(), path.c_str()) != 0)
+	{
+		::munmap(m_mapping, m_mapping_size);
+		fail("Cannot publish stats region");
+	}
+}
+
+BookStatsRegion::~BookStatsRegion()
+{
+	::munmap(m_mapping, m_mapping_size);
+	::close(m_fd);
+}
+
+void BookStatsRegion::set_name(size_t index, std::string_view name) noexcept
+{
+	auto &target = get(index).name;
+	target.fill('\0');
+	std::memcpy(target.data(), name.data(), std::min(name.size(), target.size() - 1));
+}
+
+BookStatsReader::BookStatsReader(const std::string &path)
+{
+	const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Cannot open stats region " + path + ": " + std::strerror(errno));
+	}
+
+	struct stat info {};
+	BookStatsRegion::Header header {};
+	if (::fstat(fd, &info) != 0 || ::pread(fd, &header, sizeof(header), 0) != sizeof(header))
+	{
+		::close(fd);
+		throw std::runtime_error("Cannot read stats region " + path);
+	}
+
+	m_mapping_size = sizeof(header) + header.book_count * sizeof(BookCounters);
+	if (header.magic != BookStatsRegion::MAGIC || header.version != BookStatsRegion::VERSION ||
+		header.counters_size != sizeof(BookCounters) || static_cast<size_t>(info.st_size) != m_mapping_size)
+	{
+		::close(fd);
+		throw std::runtime_error("Stats region " + path + " has an unknown format");
+	}
+
+	// The mapping outlives the descriptor, nothing here ever writes.
+	const auto *mapping = ::mmap(nullptr, m_mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+	const auto error = errno;
+	::close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error("Cannot map stats region " + path + ": " + std::strerror(error));
+	}
+
+	m_mapping = mapping;
+	m_counters = reinterpret_cast<const BookCounters *>(static_cast<const std::byte *>(m_mapping) + sizeof(header));
+	m_size = header.book_count;
+}
+
+BookStatsReader::~BookStatsReader()
+{
+	::munmap(const_cast<void *>(m_mapping), m_mapping_size);
+}
+
+auto BookStatsReader::get_name(size_t index) const noexcept -> std::string_view
+{
+	const auto &name = get(index).name;
+	return { name.data(), ::strnlen(name.data(), name.size()) };
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,243 @@
+#include <l2/synthetic_book.hpp>
+
+namespace hft::orderbook {
+
+namespace {
+
+constexpr size_t NO_CHANGE = std::numeric_limits<size_t>::max();
+
+__extension__ typedef unsigned __int128 uint128;
+
+auto pow10(unsigned exponent) -> uint128
+{
+	uint128 value = 1;
+	while (exponent-- > 0)
+	{
+		value *= 10;
+	}
+	return value;
+}
+
+} // namespace
+
+SyntheticBook::SyntheticBook(const OrderBook &base, const OrderBook &quote, SyntheticConfig config)
+	: m_base(base)
+	, m_quote(quote)
+	, m_config(config)
+{
+	m_config.depth = std::min(m_config.depth, MAX_LEVELS);
+
+	// Capacity of a base level is qty * price in Q (Divide) or Y (Multiply) units.
+	// Quote levels are worth qty * price in Q (Divide) or just qty in Y (Multiply).
+	const unsigned base_exponent = m_config.base_qty_decimals + m_config.base_price_decimals;
+	const unsigned quote_exponent = m_config.op == ImpliedOp::Divide
+		? m_config.quote_qty_decimals + m_config.quote_price_decimals
+		: m_config.quote_qty_decimals;
+	const auto common_exponent = std::max(base_exponent, quote_exponent);
+
+	m_base_scale = pow10(common_exponent - base_exponent);
+	m_quote_scale = pow10(common_exponent - quote_exponent);
+	m_common_scale = pow10(common_exponent);
+}
+
+auto SyntheticBook::read_leg(std::span<PriceLevel> out, const OrderBook &book, Side side) -> size_t
+{
+	return side == Side::Bid ? book.get_bid_levels(out) : book.get_ask_levels(out);
+}
+
+auto SyntheticBook::first_changed(const LegLevels &before, const LegLevels &after) -> size_t
+{
+	const auto common = std::min(before.count, after.count);
+	for (size_t i = 0; i < common; ++i)
+	{
+		if (before.levels[i] != after.levels[i])
+		{
+			return i;
+		}
+	}
+	return before.count == after.count ? NO_CHANGE : common;
+}
+
+auto SyntheticBook::base_capacity(const PriceLevel &level) const -> Amount
+{
+	return Amount { level.quantity } * level.price * m_base_scale;
+}
+
+auto SyntheticBook::quote_capacity(const PriceLevel &level) const -> Amount
+{
+	if (m_config.op == ImpliedOp::Divide)
+	{
+		return Amount { level.quantity } * level.price * m_quote_scale;
+	}
+	return Amount { level.quantity } * m_quote_scale;
+}
+
+auto SyntheticBook::implied_price(uint64_t base_price, uint64_t quote_price, bool round_up) const
+	-> uint64_t
+{
+	Amount numerator;
+	Amount denominator;
+	if (m_config.op == ImpliedOp::Divide)
+	{
+		numerator = Amount { base_price } * pow10(m_config.quote_price_decimals) * pow10(m_config.price_decimals);
+		denominator = Amount { quote_price } * pow10(m_config.base_price_decimals);
+	}
+	else
+	{
+		numerator = Amount { base_price } * quote_price * pow10(m_config.price_decimals);
+		denominator = pow10(m_config.base_price_decimals) * pow10(m_config.quote_price_decimals);
+	}
+
+	const auto price = round_up ? (numerator + denominator - 1) / denominator : numerator / denominator;
+	return static_cast<uint64_t>(price);
+}
+
+auto SyntheticBook::walk(
+	Ladder &ladder,
+	const LegLevels &base,
+	const LegLevels &quote,
+	size_t base_rank,
+	size_t quote_rank,
+	bool is_bid
+) -> size_t
+{
+	// A level depends on every source level up to the one its walk ended in,
+	// which counts only when part of it was actually consumed.
+	const auto consumed = [](size_t index, Amount left, size_t rank)
+	{
+		return left == 0 ? index > rank : index >= rank;
+	};
+
+	// The first level that consumed a changed source level, earlier levels stay as they are.
+	size_t restart = 0;
+	while (restart < ladder.count)
+	{
+		const auto &end = ladder.starts[restart + 1];
+		if (consumed(end.base, end.base_left, base_rank) || consumed(end.quote, end.quote_left, quote_rank))
+		{
+			break;
+		}
+		++restart;
+	}
+
+	if (restart == ladder.count)
+	{
+		// Every level is intact, the walk only continues if it ran out of source levels that changed since.
+		const auto &end = ladder.starts[restart];
+		if (ladder.count == m_config.depth || (end.base < base_rank && end.quote < quote_rank))
+		{
+			return 0;
+		}
+	}
+
+	auto state = ladder.starts[restart];
+	ladder.count = restart;
+
+	const auto qty_numerator = pow10(m_config.base_price_decimals) * pow10(m_config.qty_decimals);
+
+	while (ladder.count < m_config.depth)
+	{
+		// Source levels are loaded lazily, so a level starts before its first load.
+		const auto step_start = state;
+
+		if (state.base_left == 0)
+		{
+			if (state.base >= base.count)
+			{
+				break;
+			}
+			state.base_left = base_capacity(base.levels[state.base]);
+			if (state.base_left == 0) [[unlikely]]
+			{
+				++state.base;
+				continue;
+			}
+		}
+
+		if (state.quote_left == 0)
+		{
+			if (state.quote >= quote.count)
+			{
+				break;
+			}
+			state.quote_left = quote_capacity(quote.levels[state.quote]);
+			if (state.quote_left == 0) [[unlikely]]
+			{
+				++state.quote;
+				continue;
+			}
+		}
+
+		const auto &base_level = base.levels[state.base];
+		const auto &quote_level = quote.levels[state.quote];
+
+		const auto taken = std::min(state.base_left, state.quote_left);
+		const auto price = implied_price(base_level.price, quote_level.price, !is_bid);
+		const auto qty = static_cast<uint64_t>(
+			taken * qty_numerator / (m_common_scale * Amount { base_level.price })
+		);
+
+		if (qty != 0)
+		{
+			if (ladder.count != 0 && ladder.levels[ladder.count - 1].price == price)
+			{
+				ladder.levels[ladder.count - 1].quantity += qty;
+			}
+			else
+			{
+				ladder.starts[ladder.count] = step_start;
+				ladder.levels[ladder.count++] = { price, qty };
+			}
+		}
+
+		state.base_left -= taken;
+		state.quote_left -= taken;
+
+		if (state.base_left == 0)
+		{
+			++state.base;
+		}
+		if (state.quote_left == 0)
+		{
+			++state.quote;
+		}
+	}
+
+	ladder.starts[ladder.count] = state;
+	return ladder.count - restart;
+}
+
+auto SyntheticBook::refresh() -> size_t
+{
+	LegLevels base_bids;
+	LegLevels base_asks;
+	LegLevels quote_bids;
+	LegLevels quote_asks;
+
+	base_bids.count = read_leg(base_bids.levels, m_base, Side::Bid);
+	base_asks.count = read_leg(base_asks.levels, m_base, Side::Ask);
+	quote_bids.count = read_leg(quote_bids.levels, m_quote, Side::Bid);
+	quote_asks.count = read_leg(quote_asks.levels, m_quote, Side::Ask);
+
+	const auto base_bid_rank = first_changed(m_base_bids, base_bids);
+	const auto base_ask_rank = first_changed(m_base_asks, base_asks);
+	const auto quote_bid_rank = first_changed(m_quote_bids, quote_bids);
+	const auto quote_ask_rank = first_changed(m_quote_asks, quote_asks);
+
+	m_base_bids = base_bids;
+	m_base_asks = base_asks;
+	m_quote_bids = quote_bids;
+	m_quote_asks = quote_asks;
+
+	// Selling X: sell on the base bids, then buy Y on the quote asks (Divide)
+	// or sell Y on the quote bids (Multiply). Buying X mirrors it.
+	if (m_config.op == ImpliedOp::Divide)
+	{
+		return walk(m_bids, m_base_bids, m_quote_asks, base_bid_rank, quote_ask_rank, true)
+			+ walk(m_asks, m_base_asks, m_quote_bids, base_ask_rank, quote_bid_rank, false);
+	}
+	return walk(m_bids, m_base_bids, m_quote_bids, base_bid_rank, quote_bid_rank, true)
+		+ walk(m_asks, m_base_asks, m_quote_asks, base_ask_rank, quote_ask_rank, false);
+}
+
+} // namespace hft::orderbook
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <l2/archive.hpp>
+
+using namespace hft::orderbook;
+
+class ArchiveTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		path = ::testing::TempDir() + "archive_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+			   ".bin";
+		std::filesystem::remove(path);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(path);
+	}
+
+	// Several updates share each timestamp, so checkpoints fall between equal timestamps.
+	static auto make_updates(size_t count) -> std::vector<MarketUpdate>
+	{
+		std::vector<MarketUpdate> updates;
+		std::mt19937_64 rng(7);
+		uint64_t timestamp = 1000;
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			timestamp += rng() % 3 == 0 ? 10U : 0U;
+			const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			const auto price = side == Side::Bid ? 1000 - rng() % 10 : 1001 + rng() % 10;
+			updates.push_back({ timestamp, i + 1, price, rng() % 4 == 0 ? 0 : 1 + rng() % 100, side });
+		}
+		return updates;
+	}
+
+	void write_archive(const std::vector<MarketUpdate> &updates, size_t interval)
+	{
+		ArchiveWriter writer(path, interval);
+		for (const auto &update : updates)
+		{
+			ASSERT_TRUE(writer.append(update));
+		}
+		writer.finish();
+	}
+
+	/*Book after every update the predicate accepts, replayed from the start.*/
+	template<typename Pred>
+	static auto replay_until(const std::vector<MarketUpdate> &updates, Pred &&pred) -> BookSnapshot
+	{
+		OrderBook book;
+		for (const auto &update : updates)
+		{
+			if (!pred(update))
+			{
+				break;
+			}
+			apply_market_update(book, update);
+		}
+		return make_snapshot(book);
+	}
+
+	std::string path;
+};
+
+TEST_F(ArchiveTest, SeekTime_MatchesReplayFromStart)
+{
+	const auto updates = make_updates(5000);
+	write_archive(updates, 64);
+
+	ArchiveReader reader(path);
+	EXPECT_EQ(reader.get_update_count(), updates.size());
+	EXPECT_EQ(reader.get_index().size(), (updates.size() + 63) / 64);
+
+	OrderBook book;
+	const auto last = updates.back().timestamp_ns;
+	for (uint64_t t = 0; t <= last + 10; t += 5)
+	{
+		const auto replayed = reader.seek_time(t, book);
+		EXPECT_LE(replayed, 64);
+		ASSERT_EQ(make_snapshot(book), replay_until(updates, [&](const MarketUpdate &u) { return u.timestamp_ns <= t; }))
+			<< t;
+	}
+}
+
+TEST_F(ArchiveTest, SeekSequence_MatchesReplayFromStart)
+{
+	const auto updates = make_updates(3000);
+	write_archive(updates, 100);
+
+	ArchiveReader reader(path);
+	OrderBook book;
+	for (uint64_t sequence = 0; sequence <= updates.size(); sequence += 7)
+	{
+		reader.seek_sequence(sequence, book);
+		ASSERT_EQ(make_snapshot(book), replay_until(updates, [&](const MarketUpdate &u) { return u.sequence <= sequence; }))
+			<< sequence;
+	}
+	reader.seek_sequence(updates.size(), book);
+	EXPECT_EQ(book.get_sequence(), updates.size());
+}
+
+TEST_F(ArchiveTest, SeekBeforeFirstUpdate_GivesEmptyBook)
+{
+	write_archive(make_updates(100), 10);
+
+	ArchiveReader reader(path);
+	OrderBook book;
+	book.update_bid_side(5, 5);
+	EXPECT_EQ(reader.seek_time(999, book), 0);
+	EXPECT_EQ(book.get_bid_count(), 0);
+	EXPECT_EQ(book.get_ask_count(), 0);
+}
+
+TEST_F(ArchiveTest, Append_RejectsTimestampGoingBack)
+{
+	ArchiveWriter writer(path);
+	EXPECT_TRUE(writer.append({ 100, 1, 1000, 10, Side::Bid }));
+	EXPECT_FALSE(writer.append({ 99, 2, 1000, 20, Side::Bid }));
+	EXPECT_TRUE(writer.append({ 100, 3, 1001, 10, Side::Ask }));
+	writer.finish();
+
+	ArchiveReader reader(path);
+	EXPECT_EQ(reader.get_update_count(), 2);
+}
+
+TEST_F(ArchiveTest, Append_RejectsSequenceGoingBack)
+{
+	{
+		ArchiveWriter writer(path, 2);
+		EXPECT_TRUE(writer.append({ 100, 100, 1000, 10, Side::Bid }));
+		EXPECT_TRUE(writer.append({ 100, 101, 1001, 10, Side::Bid }));
+		EXPECT_TRUE(writer.append({ 100, 102, 1002, 10, Side::Bid }));
+		// A sequence reset, the writer's checkpoints would go backwards.
+		EXPECT_FALSE(writer.append({ 100, 1, 1003, 10, Side::Bid }));
+		EXPECT_FALSE(writer.append({ 101, 2, 1004, 10, Side::Bid }));
+		// Updates without a sequence keep the book's.
+		EXPECT_TRUE(writer.append({ 101, 0, 1005, 10, Side::Bid }));
+		EXPECT_TRUE(writer.append({ 101, 102, 1006, 10, Side::Bid }));
+		EXPECT_TRUE(writer.append({ 102, 103, 1007, 10, Side::Bid }));
+		writer.finish();
+	}
+
+	ArchiveReader reader(path);
+	EXPECT_EQ(reader.get_update_count(), 6);
+	OrderBook book;
+	EXPECT_EQ(reader.seek_sequence(102, book), 1);
+	EXPECT_EQ(book.get_bid_count(), 5);
+}
+
+TEST_F(ArchiveTest, Destructor_FinishesArchive)
+{
+	{
+		ArchiveWriter writer(path, 2);
+		for (const auto &update : make_updates(10))
+		{
+			writer.append(update);
+		}
+	}
+
+	ArchiveReader reader(path);
+	EXPECT_EQ(reader.get_update_count(), 10);
+	EXPECT_EQ(reader.get_index().size(), 5);
+}
+
+TEST_F(ArchiveTest, UnfinishedOrForeignFile_IsRefused)
+{
+	write_archive(make_updates(100), 10);
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	EXPECT_THROW(ArchiveReader { path }, std::runtime_error);
+
+	std::ofstream(path, std::ios::trunc) << std::string(4096, 'x');
+	EXPECT_THROW(ArchiveReader { path }, std::runtime_error);
+
+	EXPECT_THROW(ArchiveReader { path + ".missing" }, std::runtime_error);
+}
+
+TEST_F(ArchiveTest, CorruptIndex_IsRefused)
+{
+	write_archive(make_updates(100), 10);
+	const auto size = std::filesystem::file_size(path);
+	EXPECT_NO_THROW(ArchiveReader { path });
+
+	archive::Footer footer;
+	{
+		std::ifstream stream(path, std::ios::binary);
+		stream.seekg(static_cast<std::streamoff>(size - sizeof(footer)));
+		stream.read(reinterpret_cast<char *>(&footer), sizeof(footer));
+	}
+
+	// Each field pushed out of the file or out of its block, the first one overflowing the index size.
+	const auto entry = [&](size_t i, size_t field) { return footer.index_offset + i * sizeof(archive::IndexEntry) + field; };
+	const std::vector<std::pair<uint64_t, uint64_t>> corruptions {
+		{ size - sizeof(footer) + offsetof(archive::Footer, block_count), (uint64_t { 1 } << 60) + footer.block_count },
+		{ entry(3, offsetof(archive::IndexEntry, offset)), size * 2 },
+		{ entry(3, offsetof(archive::IndexEntry, update_count)), uint64_t { 1 } << 62 },
+		{ entry(9, offsetof(archive::IndexEntry, update_count)), 11 },
+		{ entry(0, offsetof(archive::IndexEntry, timestamp_ns)), 5000 },
+	};
+	for (const auto &[position, value] : corruptions)
+	{
+		write_archive(make_updates(100), 10);
+		{
+			std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+			stream.seekp(static_cast<std::streamoff>(position));
+			stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+		}
+		EXPECT_THROW(ArchiveReader { path }, std::runtime_error) << "at " << position;
+	}
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <l2/book_sampler.hpp>
+
+using namespace hft::orderbook;
+
+class BookSamplerTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		for (auto &book : books)
+		{
+			book.update_bid_side(100, 10);
+			book.update_ask_side(102, 5);
+		}
+	}
+
+	auto make_sampler(size_t ring_ticks = 16) -> BookSampler
+	{
+		const std::array<const OrderBook *, 2> pointers { &books[0], &books[1] };
+		return { pointers, { .interval_ns = 100, .start_ns = 1000, .depth = 3, .ring_ticks = ring_ticks } };
+	}
+
+	std::array<OrderBook, 2> books;
+};
+
+TEST_F(BookSamplerTest, Averages_WeightStatesByDuration)
+{
+	auto sampler = make_sampler();
+
+	sampler.advance(1025);
+	books[0].update_ask_side(102, 0);
+	books[0].update_ask_side(104, 7);
+	sampler.on_update(0, 1025);
+
+	EXPECT_EQ(sampler.advance(1100), 1U);
+	const auto &sample = sampler.get_tick(0)[0];
+	EXPECT_DOUBLE_EQ(sample.spread, (2.0 * 25 + 4.0 * 75) / 100);
+	EXPECT_DOUBLE_EQ(sample.bid_depth, 10.0);
+	EXPECT_DOUBLE_EQ(sample.ask_depth, (5.0 * 25 + 7.0 * 75) / 100);
+	ASSERT_EQ(sample.ask_count, 1U);
+	EXPECT_EQ(sample.asks[0], (PriceLevel { 104, 7 }));
+
+	const auto &untouched = sampler.get_tick(0)[1];
+	EXPECT_DOUBLE_EQ(untouched.spread, 2.0);
+	EXPECT_DOUBLE_EQ(untouched.ask_depth, 5.0);
+}
+
+TEST_F(BookSamplerTest, UnchangedBooks_AreCarriedForward)
+{
+	auto sampler = make_sampler();
+	sampler.advance(1100);
+
+	books[0].update_bid_side(101, 3);
+	sampler.on_update(0, 1150);
+	// Changed behind the sampler's back, an unchanged book is not read again.
+	books[1].update_bid_side(99, 1);
+
+	EXPECT_EQ(sampler.advance(1200), 1U);
+	const auto tick = sampler.get_tick(1);
+
+	EXPECT_TRUE(tick[0].changed);
+	EXPECT_EQ(tick[0].bid_count, 2U);
+	EXPECT_EQ(tick[0].bids[0], (PriceLevel { 101, 3 }));
+
+	EXPECT_FALSE(tick[1].changed);
+	EXPECT_EQ(tick[1].bid_count, 1U);
+	EXPECT_EQ(tick[1].bids[0], sampler.get_tick(0)[1].bids[0]);
+}
+
+TEST_F(BookSamplerTest, QuietPeriod_ClosesEveryInterval)
+{
+	auto sampler = make_sampler();
+
+	EXPECT_EQ(sampler.advance(1599), 5U);
+	EXPECT_EQ(sampler.get_tick_count(), 5U);
+	EXPECT_EQ(sampler.get_next_boundary(), 1600U);
+	EXPECT_TRUE(sampler.get_tick(0)[0].changed);
+	for (uint64_t tick = 1; tick < 5; ++tick)
+	{
+		EXPECT_FALSE(sampler.get_tick(tick)[0].changed);
+		EXPECT_DOUBLE_EQ(sampler.get_tick(tick)[0].spread, 2.0);
+	}
+
+	// An update past several boundaries closes them first.
+	sampler.on_update(1, 1850);
+	EXPECT_EQ(sampler.get_tick_count(), 8U);
+}
+
+TEST_F(BookSamplerTest, OneSidedInterval_HasNoSpread)
+{
+	books[1].update_ask_side(102, 0);
+	auto sampler = make_sampler();
+	sampler.advance(1100);
+
+	const auto &sample = sampler.get_tick(0)[1];
+	EXPECT_TRUE(std::isnan(sample.spread));
+	EXPECT_EQ(sample.ask_count, 0U);
+	EXPECT_DOUBLE_EQ(sample.ask_depth, 0.0);
+}
+
+TEST_F(BookSamplerTest, CrossedBook_HasNegativeSpread)
+{
+	auto sampler = make_sampler();
+	sampler.advance(1050);
+	books[0].update_bid_side(103, 4);
+	sampler.on_update(0, 1050);
+
+	sampler.advance(1100);
+	EXPECT_DOUBLE_EQ(sampler.get_tick(0)[0].spread, (2.0 * 50 - 1.0 * 50) / 100);
+}
+
+TEST_F(BookSamplerTest, Ring_ReusesOldestSlot)
+{
+	auto sampler = make_sampler(2);
+	sampler.advance(1100);
+	books[0].update_bid_side(100, 20);
+	sampler.on_update(0, 1150);
+	sampler.advance(1200);
+	books[0].update_bid_side(100, 30);
+	sampler.on_update(0, 1250);
+	sampler.advance(1300);
+
+	EXPECT_EQ(sampler.get_tick(1)[0].bids[0].quantity, 20U);
+	EXPECT_EQ(sampler.get_tick(2)[0].bids[0].quantity, 30U);
+	EXPECT_DOUBLE_EQ(sampler.get_tick(2)[0].bid_depth, (20.0 * 50 + 30.0 * 50) / 100);
+}
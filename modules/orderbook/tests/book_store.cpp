@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <l2/book_store.hpp>
+
+using namespace hft::orderbook;
+
+class BookStoreTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		path = ::testing::TempDir() + "book_store_" +
+			   ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+		std::filesystem::remove(path);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(path);
+	}
+
+	static void fill(OrderBook &book, uint64_t sequence)
+	{
+		for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+		{
+			book.update_bid_side(1000 - i, 10 + i);
+			book.update_ask_side(1001 + i, 20 + i);
+		}
+		book.set_sequence(sequence);
+	}
+
+	static void flip_byte(const std::string &file, size_t offset)
+	{
+		std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+		stream.seekg(static_cast<std::streamoff>(offset));
+		const auto byte = static_cast<char>(stream.get() ^ 0xff);
+		stream.seekp(static_cast<std::streamoff>(offset));
+		stream.put(byte);
+	}
+
+	std::string path;
+};
+
+TEST_F(BookStoreTest, Reopen_RestoresLevelsAndSequence)
+{
+	OrderBook book;
+	fill(book, 42);
+
+	{
+		BookStore store(path, 2);
+		EXPECT_TRUE(store.is_fresh());
+		EXPECT_TRUE(store.checkpoint(1, book));
+	}
+
+	BookStore store(path, 2);
+	EXPECT_FALSE(store.is_fresh());
+
+	OrderBook restored;
+	EXPECT_FALSE(store.restore(0, restored));
+	ASSERT_TRUE(store.restore(1, restored));
+
+	EXPECT_EQ(make_snapshot(restored), make_snapshot(book));
+	EXPECT_EQ(restored.get_sequence(), 42);
+	EXPECT_EQ(restored.get_bid_count(), OrderBook::MAX_LEVELS);
+	EXPECT_EQ(restored.get_ask_count(), OrderBook::MAX_LEVELS);
+}
+
+TEST_F(BookStoreTest, UnchangedBook_SkipsCheckpoint)
+{
+	OrderBook book;
+	fill(book, 1);
+
+	BookStore store(path, 1);
+	EXPECT_TRUE(store.checkpoint(0, book));
+	EXPECT_FALSE(store.checkpoint(0, book));
+
+	book.update_bid_side(1000, 99);
+	EXPECT_TRUE(store.checkpoint(0, book));
+}
+
+TEST_F(BookStoreTest, CorruptedLatestSlot_FallsBackToPrevious)
+{
+	OrderBook book;
+	fill(book, 1);
+
+	{
+		BookStore store(path, 1);
+		store.checkpoint(0, book);
+		book.update_bid_side(1000, 99);
+		book.set_sequence(2);
+		store.checkpoint(0, book);
+	}
+
+	// Generation 2 lives in the first slot, corrupt its best bid price.
+	flip_byte(path, 64 + 8 + 16);
+
+	BookStore store(path, 1);
+	OrderBook restored;
+	ASSERT_TRUE(store.restore(0, restored));
+	EXPECT_EQ(restored.get_sequence(), 1);
+	EXPECT_EQ(restored.get_bids_hash_table().lookup(1000)->quantity, 10);
+
+	// The next checkpoint overwrites the corrupted slot.
+	restored.set_sequence(3);
+	store.checkpoint(0, restored);
+	OrderBook again;
+	ASSERT_TRUE(store.restore(0, again));
+	EXPECT_EQ(again.get_sequence(), 3);
+}
+
+TEST_F(BookStoreTest, DifferentBookCount_Reinitialises)
+{
+	OrderBook book;
+	fill(book, 7);
+
+	{
+		BookStore store(path, 4);
+		store.checkpoint(0, book);
+	}
+
+	BookStore store(path, 8);
+	EXPECT_TRUE(store.is_fresh());
+
+	OrderBook restored;
+	EXPECT_FALSE(store.restore(0, restored));
+}
+
+TEST_F(BookStoreTest, CorruptedHeader_Reinitialises)
+{
+	OrderBook book;
+	fill(book, 7);
+
+	{
+		BookStore store(path, 1);
+		store.checkpoint(0, book);
+	}
+
+	flip_byte(path, 8);
+
+	BookStore store(path, 1);
+	EXPECT_TRUE(store.is_fresh());
+	OrderBook restored;
+	EXPECT_FALSE(store.restore(0, restored));
+}
+
+TEST_F(BookStoreTest, RestoreSnapshot_ReplacesExistingLevels)
+{
+	OrderBook book;
+	fill(book, 5);
+	const auto snapshot = make_snapshot(book);
+
+	OrderBook other;
+	other.update_bid_side(1, 1);
+	other.update_ask_side(5000, 1);
+	restore_snapshot(other, snapshot);
+
+	EXPECT_EQ(make_snapshot(other), snapshot);
+	EXPECT_EQ(other.get_bids_hash_table().lookup(1), nullptr);
+}
+
+TEST(BookStoreErrorTest, UnopenablePath_Throws)
+{
+	EXPECT_THROW(BookStore("/nonexistent/dir/books.bin", 1), std::runtime_error);
+}
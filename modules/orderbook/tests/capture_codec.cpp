@@ -0,0 +1,159 @@
+#include <core/stream_vbyte.hpp>
+#include <gtest/gtest.h>
+#include <l2/capture_codec.hpp>
+
+using namespace hft::orderbook;
+using namespace hft::core;
+
+namespace {
+
+auto make_updates(size_t count) -> std::vector<MarketUpdate>
+{
+	std::vector<MarketUpdate> updates;
+	std::mt19937_64 rng(21);
+	uint64_t timestamp = 1'700'000'000'000'000'000;
+	uint64_t mid = 50'000;
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		timestamp += rng() % 8 == 0 ? rng() % 1'000'000 : rng() % 200;
+		mid = mid + rng() % 3 - 1;
+		const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+		const auto price = side == Side::Bid ? mid - rng() % 10 : mid + 1 + rng() % 10;
+		updates.push_back({ timestamp, i + 1, price, rng() % 4 == 0 ? 0 : rng() % 5000, side });
+	}
+	return updates;
+}
+
+/*Encodes everything, decodes it back block by block.*/
+auto round_trip(const std::vector<MarketUpdate> &updates, size_t *blocks = nullptr) -> std::vector<MarketUpdate>
+{
+	CaptureEncoder encoder;
+	std::vector<std::byte> buffer;
+	size_t block_count = 0;
+	for (size_t offset = 0; offset < updates.size(); ++block_count)
+	{
+		const auto start = buffer.size();
+		buffer.resize(start + CaptureFormat::max_block_size(CaptureFormat::MAX_UPDATES));
+		const auto block = encoder.encode_block(std::span(updates).subspan(offset), std::span(buffer).subspan(start));
+		EXPECT_NE(block.count, 0);
+		buffer.resize(start + block.size);
+		offset += block.count;
+	}
+	if (blocks)
+	{
+		*blocks = block_count;
+	}
+
+	CaptureDecoder decoder;
+	std::vector<MarketUpdate> decoded(updates.size());
+	size_t produced = 0;
+	for (size_t offset = 0; offset < buffer.size();)
+	{
+		const auto block = decoder.decode_block(std::span(buffer).subspan(offset), std::span(decoded).subspan(produced));
+		if (!block)
+		{
+			ADD_FAILURE() << "block at " << offset;
+			break;
+		}
+		offset += block->size;
+		produced += block->count;
+	}
+	decoded.resize(produced);
+	return decoded;
+}
+
+} // namespace
+
+TEST(StreamVByteTest, RoundTrip_EveryLengthAndTail)
+{
+	std::vector<uint32_t> values;
+	std::mt19937 rng(5);
+	for (size_t i = 0; i < 1001; ++i)
+	{
+		// Cycle through 1 to 4 byte values.
+		values.push_back(static_cast<uint32_t>(rng() >> (8 * (i % 4))));
+	}
+
+	for (const auto count : { 0UL, 1UL, 3UL, 4UL, 5UL, 17UL, values.size() })
+	{
+		std::vector<std::byte> encoded(stream_vbyte_max_size(count));
+		const auto *end = stream_vbyte_encode(values.data(), count, encoded.data());
+		const auto size = static_cast<size_t>(end - encoded.data());
+
+		std::vector<uint32_t> decoded(count);
+		EXPECT_EQ(stream_vbyte_decode(encoded.data(), end, decoded.data(), count), end) << count;
+		EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), values.begin())) << count;
+
+		if (size != 0)
+		{
+			EXPECT_EQ(stream_vbyte_decode(encoded.data(), end - 1, decoded.data(), count), nullptr) << count;
+		}
+	}
+}
+
+TEST(CaptureCodecTest, RoundTrip_RestoresEveryField)
+{
+	const auto updates = make_updates(10'000);
+	size_t blocks = 0;
+	EXPECT_EQ(round_trip(updates, &blocks), updates);
+	EXPECT_EQ(blocks, (updates.size() + CaptureFormat::MAX_UPDATES - 1) / CaptureFormat::MAX_UPDATES);
+}
+
+TEST(CaptureCodecTest, RegularStream_CompressesWell)
+{
+	std::vector<MarketUpdate> updates;
+	for (uint64_t i = 0; i < CaptureFormat::MAX_UPDATES; ++i)
+	{
+		updates.push_back({ 1000 + i * 100, 7 + i, 100 + i % 3, 10 + i % 2, i % 2 == 0 ? Side::Bid : Side::Ask });
+	}
+
+	CaptureEncoder encoder;
+	std::vector<std::byte> buffer(CaptureFormat::max_block_size(updates.size()));
+	const auto block = encoder.encode_block(updates, buffer);
+	EXPECT_EQ(block.count, updates.size());
+	// A control byte per four values and one data byte per value per column, plus the side bits.
+	EXPECT_LE(block.size, CaptureFormat::HEADER_SIZE + updates.size() / 8 + 4 * (updates.size() * 5 / 4));
+}
+
+TEST(CaptureCodecTest, LargeValues_EndBlockEarly)
+{
+	std::vector<MarketUpdate> updates {
+		{ 1000, 1, 100, 10, Side::Bid },
+		{ 1100, 2, 101, 20, Side::Ask },
+		{ 3600'000'000'000, 3, 102, 30, Side::Bid }, // an hour later
+		{ 3600'000'000'100, 4, 103, 1ULL << 40, Side::Ask },
+		{ 3600'000'000'200, 5, 104, 50, Side::Bid },
+	};
+
+	size_t blocks = 0;
+	EXPECT_EQ(round_trip(updates, &blocks), updates);
+	EXPECT_EQ(blocks, 4);
+}
+
+TEST(CaptureCodecTest, Malformed_IsRejected)
+{
+	const auto updates = make_updates(100);
+	CaptureEncoder encoder;
+	std::vector<std::byte> buffer(CaptureFormat::max_block_size(updates.size()));
+	const auto block = encoder.encode_block(updates, buffer);
+	buffer.resize(block.size);
+
+	CaptureDecoder decoder;
+	std::vector<MarketUpdate> out(updates.size());
+	ASSERT_TRUE(decoder.decode_block(buffer, out));
+
+	EXPECT_FALSE(decoder.decode_block(std::span(buffer).first(buffer.size() - 1), out));
+	EXPECT_FALSE(decoder.decode_block(buffer, std::span(out).first(10)));
+
+	auto bad_count = buffer;
+	store_le(bad_count.data(), uint32_t { 0 });
+	EXPECT_FALSE(decoder.decode_block(bad_count, out));
+
+	// Claims a shorter block than the columns need.
+	auto bad_size = buffer;
+	store_le(bad_size.data() + 4, static_cast<uint32_t>(block.size - 8));
+	EXPECT_FALSE(decoder.decode_block(bad_size, out));
+
+	std::vector<std::byte> small(CaptureFormat::max_block_size(updates.size()) - 1);
+	EXPECT_EQ(encoder.encode_block(updates, small).count, 0);
+}
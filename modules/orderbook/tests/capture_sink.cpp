@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <l2/capture_sink.hpp>
+
+using namespace hft::orderbook;
+
+class CaptureSinkTest: public ::testing::TestWithParam<std::tuple<bool, bool>>
+{
+protected:
+	void SetUp() override
+	{
+		auto name = std::string(::testing::UnitTest::GetInstance()->current_test_info()->name());
+		std::ranges::replace(name, '/', '_');
+		path = ::testing::TempDir() + "capture_sink_" + name + ".bin";
+		std::filesystem::remove(path);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(path);
+	}
+
+	static auto make_updates(size_t count) -> std::vector<MarketUpdate>
+	{
+		std::vector<MarketUpdate> updates;
+		std::mt19937_64 rng(13);
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			updates.push_back({ 1000 + i * 10, i + 1, 1000 + rng() % 20, rng() % 100, side });
+		}
+		return updates;
+	}
+
+	[[nodiscard]] auto config() const -> CaptureSinkConfig
+	{
+		const auto [io_uring, direct] = GetParam();
+		return { .block_size = 4096, .blocks = 4, .queue_capacity = 256, .direct = direct, .io_uring = io_uring };
+	}
+
+	std::string path;
+};
+
+TEST_P(CaptureSinkTest, RoundTrip_EveryRecordAcrossBlocks)
+{
+	const auto updates = make_updates(1000);
+	const auto per_block = CaptureSink::records_per_block(4096);
+
+	CaptureSink sink(path, config());
+	for (const auto &update : updates)
+	{
+		// Retry instead of dropping so the file is complete.
+		while (!sink.append(update))
+		{
+			std::this_thread::yield();
+		}
+	}
+	sink.finish();
+
+	const auto stats = sink.get_stats();
+	EXPECT_EQ(stats.records, updates.size());
+	EXPECT_EQ(stats.blocks_written, (updates.size() + per_block - 1) / per_block);
+	EXPECT_EQ(stats.bytes_written, (stats.blocks_written + stats.flushes) * 4096);
+	EXPECT_EQ(std::filesystem::file_size(path), stats.blocks_written * 4096);
+	EXPECT_EQ(read_capture_file(path), updates);
+}
+
+TEST_P(CaptureSinkTest, FullQueue_DropsAreCounted)
+{
+	const auto updates = make_updates(50000);
+
+	auto small = config();
+	small.queue_capacity = 16;
+	CaptureSink sink(path, small);
+
+	std::vector<MarketUpdate> accepted;
+	for (const auto &update : updates)
+	{
+		if (sink.append(update))
+		{
+			accepted.push_back(update);
+		}
+	}
+	sink.finish();
+
+	const auto stats = sink.get_stats();
+	EXPECT_EQ(stats.records + stats.dropped, updates.size());
+	EXPECT_EQ(stats.records, accepted.size());
+	EXPECT_LE(stats.queue_high_water, 16U);
+	EXPECT_EQ(read_capture_file(path), accepted);
+}
+
+TEST_P(CaptureSinkTest, PartialBlock_RewrittenInPlaceAfterFlushInterval)
+{
+	constexpr size_t PAGE = 4096;
+	constexpr size_t HEADER = sizeof(capture_file::BlockHeader);
+	constexpr size_t RECORD = sizeof(MarketUpdate);
+
+	auto quick = config();
+	quick.block_size = 4 * PAGE;
+	quick.flush_interval = std::chrono::milliseconds(1);
+	CaptureSink sink(path, quick);
+
+	const auto updates = make_updates(CaptureSink::records_per_block(quick.block_size));
+	size_t appended = 0;
+	const auto flush_up_to = [&](size_t count, uint64_t flushes)
+	{
+		for (; appended < count; ++appended)
+		{
+			ASSERT_TRUE(sink.append(updates[appended]));
+		}
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (sink.get_stats().flushes < flushes && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		ASSERT_EQ(sink.get_stats().flushes, flushes);
+		EXPECT_EQ(read_capture_file(path), std::vector(updates.begin(), updates.begin() + static_cast<ptrdiff_t>(count)));
+	};
+
+	// The first flush writes the one page in use and leaves the block current.
+	flush_up_to(3, 1);
+	EXPECT_EQ(sink.get_stats().blocks_written, 0U);
+	EXPECT_EQ(sink.get_stats().bytes_written, PAGE);
+
+	// Into the third page: everything from the page the last flush ended in.
+	const auto third_page = (2 * PAGE - HEADER) / RECORD + 1;
+	flush_up_to(third_page, 2);
+	EXPECT_EQ(sink.get_stats().bytes_written, PAGE + 3 * PAGE);
+
+	// Still in the third page: the header page and the third page only.
+	flush_up_to(third_page + 1, 3);
+	EXPECT_EQ(sink.get_stats().bytes_written, 4 * PAGE + 2 * PAGE);
+	EXPECT_EQ(sink.get_stats().blocks_written, 0U);
+
+	sink.finish();
+	EXPECT_EQ(sink.get_stats().blocks_written, 1U);
+	EXPECT_EQ(std::filesystem::file_size(path), quick.block_size);
+	EXPECT_EQ(read_capture_file(path), std::vector(updates.begin(), updates.begin() + static_cast<ptrdiff_t>(appended)));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+	Writers,
+	CaptureSinkTest,
+	::testing::Combine(::testing::Bool(), ::testing::Bool()),
+	[](const auto &writer)
+	{
+		return std::string(std::get<0>(writer.param) ? "IoUring" : "Pwrite") +
+			   (std::get<1>(writer.param) ? "Direct" : "Buffered");
+	}
+);
+
+TEST(CaptureFileTest, MalformedBlock_Throws)
+{
+	const auto path = ::testing::TempDir() + "capture_file_malformed.bin";
+	{
+		CaptureSink sink(path, { .block_size = 4096, .queue_capacity = 1024 });
+		for (uint64_t i = 0; i < 200; ++i)
+		{
+			ASSERT_TRUE(sink.append({ i, i, 100, 1, Side::Bid }));
+		}
+	}
+	EXPECT_EQ(read_capture_file(path).size(), 200U);
+
+	{
+		std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+		stream.seekp(4096 + offsetof(capture_file::BlockHeader, index));
+		stream.put(7);
+	}
+	EXPECT_THROW(static_cast<void>(read_capture_file(path)), std::runtime_error);
+
+	// A zeroed block, as a dead writer leaves its preallocated tail, ends the records.
+	{
+		std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+		stream.seekp(4096);
+		const std::string zeros(4096, '\0');
+		stream.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+	}
+	EXPECT_EQ(read_capture_file(path).size(), CaptureSink::records_per_block(4096));
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,146 @@
+#include <core/crc32.hpp>
+#include <gtest/gtest.h>
+#include <l2/checksum.hpp>
+
+using namespace hft::orderbook;
+using namespace hft::core;
+
+class BookChecksumTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		// Venue depths go past the hot levels.
+		book.set_cold_tier_enabled(true);
+	}
+
+	OrderBook book;
+
+	static auto format_string(const BookChecksum &checksum, const OrderBook &book) -> std::string
+	{
+		std::array<char, BookChecksum::MAX_STRING_SIZE> buffer {};
+		const auto len = checksum.format(book, buffer);
+		return { buffer.data(), len };
+	}
+};
+
+TEST(Crc32Test, KnownVectors)
+{
+	const std::string_view input = "123456789";
+	EXPECT_EQ(crc32(input.data(), input.size()), 0xCBF43926U);
+	EXPECT_EQ(crc32c(input.data(), input.size()), 0xE3069283U);
+}
+
+TEST(Crc32Test, FoldedPathMatchesBytewise)
+{
+	std::vector<uint8_t> data(1000);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 31 + 7);
+	}
+
+	uint32_t bytewise = 0;
+	for (const auto byte : data)
+	{
+		bytewise = crc32(&byte, 1, bytewise);
+	}
+
+	EXPECT_EQ(crc32(data.data(), data.size()), 0x8902161EU);
+	EXPECT_EQ(bytewise, 0x8902161EU);
+
+	// Split at an odd offset so both the folded and the table tails run.
+	const auto head = crc32(data.data(), 77);
+	EXPECT_EQ(crc32(data.data() + 77, data.size() - 77, head), 0x8902161EU);
+}
+
+TEST_F(BookChecksumTest, Okx_InterleavesSides)
+{
+	book.add_bid_side(33661, 7);
+	book.add_bid_side(33660, 6);
+	book.add_ask_side(33668, 9);
+	book.add_ask_side(33680, 8);
+
+	BookChecksum checksum({ .format = ChecksumFormat::Okx, .price_decimals = 1 });
+
+	EXPECT_EQ(format_string(checksum, book), "3366.1:7:3366.8:9:3366:6:3368:8");
+	EXPECT_EQ(checksum.compute(book), 0x8FE1FFEAU);
+	EXPECT_TRUE(checksum.verify(book, 0x8FE1FFEAU));
+}
+
+TEST_F(BookChecksumTest, Okx_LongerSideContinuesAlone)
+{
+	book.add_bid_side(1000, 1);
+	book.add_bid_side(990, 2);
+	book.add_bid_side(980, 3);
+	book.add_ask_side(1010, 4);
+
+	BookChecksum checksum({ .format = ChecksumFormat::Bitget });
+
+	EXPECT_EQ(format_string(checksum, book), "1000:1:1010:4:990:2:980:3");
+}
+
+TEST_F(BookChecksumTest, FixedDecimals_KeepTrailingZeros)
+{
+	book.add_bid_side(1050, 2500);
+	book.add_ask_side(1100, 5);
+
+	BookChecksum checksum({ .price_decimals = 2, .qty_decimals = 3, .trim_trailing_zeros = false });
+
+	EXPECT_EQ(format_string(checksum, book), "10.50:2.500:11.00:0.005");
+}
+
+TEST_F(BookChecksumTest, Kraken_AsksThenBidsWithoutDecimalPoint)
+{
+	book.add_bid_side(1000, 3);
+	book.add_bid_side(990, 12);
+	book.add_ask_side(1010, 5);
+	book.add_ask_side(1020, 7);
+
+	BookChecksum checksum({ .format = ChecksumFormat::Kraken, .depth = 10, .price_decimals = 1 });
+
+	EXPECT_EQ(format_string(checksum, book), "10105102071000399012");
+	EXPECT_EQ(checksum.compute(book), 0x2A2E0DB4U);
+}
+
+TEST_F(BookChecksumTest, DetectsDivergence)
+{
+	book.add_bid_side(1000, 3);
+	book.add_ask_side(1010, 5);
+
+	BookChecksum checksum({});
+	const auto expected = checksum.compute(book);
+
+	book.update_ask_side(1010, 6);
+	EXPECT_FALSE(checksum.verify(book, expected));
+}
+
+TEST_F(BookChecksumTest, FullVenueDepth_ReachesIntoColdTier)
+{
+	std::string expected;
+	for (uint64_t i = 0; i < 30; ++i)
+	{
+		book.update_bid_side(1000 - i, i + 1);
+		book.update_ask_side(1001 + i, i + 1);
+	}
+	for (uint64_t i = 0; i < 25; ++i)
+	{
+		std::ostringstream level;
+		level << (i == 0 ? "" : ":") << 1000 - i << ':' << i + 1 << ':' << 1001 + i << ':' << i + 1;
+		expected += level.str();
+	}
+
+	const BookChecksum checksum({});
+	EXPECT_EQ(format_string(checksum, book), expected);
+	EXPECT_TRUE(checksum.verify(book, crc32(expected.data(), expected.size())));
+}
+
+TEST_F(BookChecksumTest, DepthBeyondBook_Throws)
+{
+	EXPECT_THROW(BookChecksum({ .depth = 0 }), std::runtime_error);
+	EXPECT_THROW(BookChecksum({ .depth = BookChecksum::MAX_DEPTH + 1 }), std::runtime_error);
+
+	OrderBook hot_only;
+	hot_only.add_bid_side(1000, 1);
+	EXPECT_THROW(static_cast<void>(BookChecksum({ .depth = 10 }).compute(hot_only)), std::runtime_error);
+	EXPECT_NO_THROW(static_cast<void>(BookChecksum({ .depth = OrderBook::MAX_LEVELS }).compute(hot_only)));
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <l2/conflator.hpp>
+
+using namespace hft::orderbook;
+
+class ConflatorTest: public ::testing::Test
+{
+protected:
+	OrderBook book;
+
+	static auto changes_of(const BookDiff &diff) -> std::vector<LevelChange>
+	{
+		auto changes = diff.get_changes();
+		return { changes.begin(), changes.end() };
+	}
+};
+
+TEST_F(ConflatorTest, FirstFlush_PublishesExistingLevels)
+{
+	book.add_bid_side(1000, 10);
+	book.add_ask_side(1010, 20);
+
+	Conflator conflator(book);
+	auto changes = changes_of(conflator.flush());
+
+	ASSERT_EQ(changes.size(), 2);
+	EXPECT_EQ(changes[0], (LevelChange { Side::Bid, LevelAction::Insert, 1000, 10 }));
+	EXPECT_EQ(changes[1], (LevelChange { Side::Ask, LevelAction::Insert, 1010, 20 }));
+}
+
+TEST_F(ConflatorTest, BurstOnSameLevel_EmitsSingleChange)
+{
+	Conflator conflator(book);
+	conflator.update_bid_side(1000, 10);
+	conflator.flush();
+
+	for (uint64_t qty = 11; qty < 300; ++qty)
+	{
+		conflator.update_bid_side(1000, qty);
+	}
+
+	auto changes = changes_of(conflator.flush());
+	ASSERT_EQ(changes.size(), 1);
+	EXPECT_EQ(changes[0], (LevelChange { Side::Bid, LevelAction::Change, 1000, 299 }));
+}
+
+TEST_F(ConflatorTest, InsertThenDeleteWithinBatch_EmitsNothing)
+{
+	Conflator conflator(book);
+	conflator.update_ask_side(1010, 10);
+	conflator.flush();
+
+	conflator.update_ask_side(1005, 5);
+	conflator.update_ask_side(1005, 0);
+
+	EXPECT_TRUE(conflator.flush().empty());
+}
+
+TEST_F(ConflatorTest, QtyRestoredWithinBatch_EmitsNothing)
+{
+	Conflator conflator(book);
+	conflator.update_bid_side(1000, 10);
+	conflator.flush();
+
+	conflator.update_bid_side(1000, 50);
+	conflator.update_bid_side(1000, 10);
+
+	EXPECT_TRUE(conflator.flush().empty());
+}
+
+TEST_F(ConflatorTest, MixedBatch_EmitsMinimalDiff)
+{
+	Conflator conflator(book);
+	conflator.update_bid_side(1000, 10);
+	conflator.update_bid_side(990, 10);
+	conflator.update_bid_side(980, 10);
+	conflator.flush();
+
+	conflator.update_bid_side(1010, 7); // insert at the top
+	conflator.update_bid_side(990, 0);  // remove
+	conflator.update_bid_side(980, 3);  // change
+
+	auto changes = changes_of(conflator.flush());
+	ASSERT_EQ(changes.size(), 3);
+	EXPECT_EQ(changes[0], (LevelChange { Side::Bid, LevelAction::Insert, 1010, 7 }));
+	EXPECT_EQ(changes[1], (LevelChange { Side::Bid, LevelAction::Remove, 990, 0 }));
+	EXPECT_EQ(changes[2], (LevelChange { Side::Bid, LevelAction::Change, 980, 3 }));
+}
+
+TEST_F(ConflatorTest, LimitedDepth_LevelPushedOutIsRemoved)
+{
+	Conflator conflator(book, { .depth = 2 });
+	conflator.update_ask_side(1010, 1);
+	conflator.update_ask_side(1020, 2);
+	conflator.flush();
+
+	conflator.update_ask_side(1000, 3);
+
+	auto changes = changes_of(conflator.flush());
+	ASSERT_EQ(changes.size(), 2);
+	EXPECT_EQ(changes[0], (LevelChange { Side::Ask, LevelAction::Insert, 1000, 3 }));
+	EXPECT_EQ(changes[1], (LevelChange { Side::Ask, LevelAction::Remove, 1020, 0 }));
+}
+
+TEST_F(ConflatorTest, Thresholds_CountAndTime)
+{
+	Conflator conflator(book, { .max_updates = 3, .max_delay_ns = 1000 });
+	EXPECT_FALSE(conflator.flush_due(0));
+
+	conflator.update_bid_side(1000, 1, 100);
+	conflator.update_bid_side(1000, 2, 200);
+	EXPECT_FALSE(conflator.flush_due(200));
+	EXPECT_TRUE(conflator.flush_due(1100));
+
+	conflator.update_bid_side(1000, 3, 300);
+	EXPECT_TRUE(conflator.flush_due(300));
+
+	conflator.flush();
+	EXPECT_EQ(conflator.get_pending_updates(), 0);
+	EXPECT_FALSE(conflator.flush_due(5000));
+}
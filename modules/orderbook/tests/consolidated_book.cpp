@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <l2/consolidated_book.hpp>
+
+using namespace hft::orderbook;
+using namespace hft::core;
+
+class ConsolidatedBookTest: public ::testing::Test
+{
+protected:
+	std::array<OrderBook, 3> venues;
+
+	ConsolidatedBook consolidated;
+
+	auto get_bid_levels() const -> std::vector<std::pair<uint64_t, uint64_t>>
+	{
+		std::vector<std::pair<uint64_t, uint64_t>> levels;
+
+		const ci_dllink *lnk;
+		CI_DLLIST_FOR_EACH_CONST(lnk, consolidated.get_bids_list())
+		{
+			auto *level = container_of(lnk, Level, link);
+			levels.emplace_back(level->price, level->quantity);
+		}
+		return levels;
+	}
+};
+
+TEST(BookDeltaTest, ReportsEvictedTail)
+{
+	OrderBook book;
+	std::array<LevelDelta, 2> deltas;
+
+	for (uint64_t price = 1000; price < 1005; ++price)
+	{
+		ASSERT_EQ(apply_update(book, Side::Bid, price, 1, deltas), 1);
+	}
+
+	ASSERT_EQ(apply_update(book, Side::Bid, 1010, 7, deltas), 2);
+	EXPECT_EQ(deltas[0], (LevelDelta { Side::Bid, 1000, 1, 0 }));
+	EXPECT_EQ(deltas[1], (LevelDelta { Side::Bid, 1010, 0, 7 }));
+
+	// Out of range and no-op updates change nothing.
+	EXPECT_EQ(apply_update(book, Side::Bid, 900, 7, deltas), 0);
+	EXPECT_EQ(apply_update(book, Side::Bid, 1010, 7, deltas), 0);
+}
+
+TEST_F(ConsolidatedBookTest, AddVenue_MergesExistingLevels)
+{
+	venues[0].add_bid_side(1000, 10);
+	venues[1].add_bid_side(1000, 5);
+	venues[1].add_bid_side(1001, 3);
+
+	EXPECT_EQ(consolidated.add_venue(venues[0]), 0);
+	EXPECT_EQ(consolidated.add_venue(venues[1]), 1);
+
+	auto levels = get_bid_levels();
+	ASSERT_EQ(levels.size(), 2);
+	EXPECT_EQ(levels[0], std::make_pair(1001UL, 3UL));
+	EXPECT_EQ(levels[1], std::make_pair(1000UL, 15UL));
+}
+
+TEST_F(ConsolidatedBookTest, BestBid_AttributesLargestVenue)
+{
+	for (auto &venue : venues)
+	{
+		consolidated.add_venue(venue);
+	}
+
+	consolidated.update_bid_side(0, 1000, 10);
+	consolidated.update_bid_side(1, 1000, 30);
+	consolidated.update_bid_side(2, 999, 50);
+
+	auto best = consolidated.best_bid();
+	ASSERT_TRUE(best.has_value());
+	EXPECT_EQ(best->price, 1000);
+	EXPECT_EQ(best->quantity, 40);
+	EXPECT_EQ(best->venue, 1);
+	EXPECT_EQ(best->venue_mask, 0b011);
+
+	consolidated.update_bid_side(1, 1000, 0);
+	best = consolidated.best_bid();
+	ASSERT_TRUE(best.has_value());
+	EXPECT_EQ(best->quantity, 10);
+	EXPECT_EQ(best->venue, 0);
+	EXPECT_EQ(best->venue_mask, 0b001);
+}
+
+TEST_F(ConsolidatedBookTest, BestAsk_LevelRemovedWhenAllVenuesLeave)
+{
+	consolidated.add_venue(venues[0]);
+	consolidated.add_venue(venues[1]);
+
+	consolidated.update_ask_side(0, 1010, 1);
+	consolidated.update_ask_side(1, 1010, 2);
+	consolidated.update_ask_side(1, 1011, 3);
+
+	consolidated.update_ask_side(0, 1010, 0);
+	consolidated.update_ask_side(1, 1010, 0);
+
+	auto best = consolidated.best_ask();
+	ASSERT_TRUE(best.has_value());
+	EXPECT_EQ(best->price, 1011);
+	EXPECT_EQ(best->venue, 1);
+	EXPECT_EQ(consolidated.get_ask_count(), 1);
+	EXPECT_EQ(consolidated.lookup_ask(1010), nullptr);
+}
+
+TEST_F(ConsolidatedBookTest, VenueEviction_PropagatesToMergedLadder)
+{
+	consolidated.add_venue(venues[0]);
+	consolidated.add_venue(venues[1]);
+
+	consolidated.update_bid_side(1, 1000, 4);
+	for (uint64_t price = 1000; price < 1005; ++price)
+	{
+		consolidated.update_bid_side(0, price, 1);
+	}
+
+	// Venue 0 is full, a better price evicts its 1000 level.
+	consolidated.update_bid_side(0, 1010, 1);
+
+	const auto *level = consolidated.lookup_bid(1000);
+	ASSERT_NE(level, nullptr);
+	EXPECT_EQ(level->level.quantity, 4);
+	EXPECT_EQ(level->venue_mask, 0b10);
+	EXPECT_EQ(consolidated.best_bid()->price, 1010);
+}
+
+TEST_F(ConsolidatedBookTest, EmptyBook_HasNoBest)
+{
+	EXPECT_FALSE(consolidated.best_bid().has_value());
+	EXPECT_FALSE(consolidated.best_ask().has_value());
+}
+
+TEST(BookDeltaTest, ReportsColdTierPromotion)
+{
+	OrderBook book;
+	book.set_cold_tier_enabled(true);
+	std::array<LevelDelta, 2> deltas;
+
+	for (uint64_t price = 1000; price < 1006; ++price)
+	{
+		apply_update(book, Side::Ask, price, 1, deltas);
+	}
+
+	ASSERT_EQ(apply_update(book, Side::Ask, 1000, 0, deltas), 2);
+	EXPECT_EQ(deltas[0], (LevelDelta { Side::Ask, 1000, 1, 0 }));
+	EXPECT_EQ(deltas[1], (LevelDelta { Side::Ask, 1005, 0, 1 }));
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <l2/delta_codec.hpp>
+
+using namespace hft::orderbook;
+
+class DeltaCodecTest: public ::testing::TestWithParam<DeltaEncoding>
+{
+protected:
+	static auto decode(std::span<const std::byte> buffer) -> std::vector<LevelChange>
+	{
+		auto view = DeltaMessageView::parse(buffer);
+		EXPECT_TRUE(view.has_value());
+		if (!view)
+		{
+			return {};
+		}
+		return { view->begin(), view->end() };
+	}
+
+	const std::vector<LevelChange> changes {
+		{ Side::Bid, LevelAction::Insert, 1000, 10 },
+		{ Side::Bid, LevelAction::Remove, 990, 0 },
+		{ Side::Ask, LevelAction::Change, 1010, 123456789 },
+		{ Side::Ask, LevelAction::Insert, 1001, 1 },
+	};
+};
+
+TEST_P(DeltaCodecTest, RoundTrip_PreservesChangesAndHeader)
+{
+	DeltaEncoder encoder(GetParam());
+	std::vector<std::byte> buffer(DeltaFormat::max_size(GetParam(), changes.size()));
+
+	const auto size = encoder.encode(buffer, 77, changes, 1000, 1005);
+	ASSERT_GT(size, 0);
+
+	auto view = DeltaMessageView::parse({ buffer.data(), size });
+	ASSERT_TRUE(view.has_value());
+	EXPECT_EQ(view->get_encoding(), GetParam());
+	EXPECT_EQ(view->get_sequence(), 77);
+	EXPECT_EQ(view->get_bid_reference(), 1000);
+	EXPECT_EQ(view->get_ask_reference(), 1005);
+	EXPECT_EQ(view->get_message_size(), size);
+	EXPECT_EQ(view->size(), changes.size());
+	EXPECT_EQ(std::vector<LevelChange>(view->begin(), view->end()), changes);
+}
+
+TEST_P(DeltaCodecTest, EncodeFromBook_UsesBestPricesAsReferences)
+{
+	OrderBook book;
+	book.update_bid_side(1000, 10);
+	book.update_bid_side(999, 10);
+	book.update_ask_side(1002, 10);
+
+	DeltaEncoder encoder(GetParam());
+	std::vector<std::byte> buffer(DeltaFormat::max_size(GetParam(), changes.size()));
+	const auto size = encoder.encode(buffer, 1, changes, book);
+
+	auto view = DeltaMessageView::parse({ buffer.data(), size });
+	ASSERT_TRUE(view.has_value());
+	EXPECT_EQ(view->get_bid_reference(), 1000);
+	EXPECT_EQ(view->get_ask_reference(), 1002);
+	EXPECT_EQ(decode({ buffer.data(), size }), changes);
+}
+
+TEST_P(DeltaCodecTest, SmallBuffer_ReturnsZero)
+{
+	DeltaEncoder encoder(GetParam());
+	std::vector<std::byte> buffer(DeltaFormat::max_size(GetParam(), changes.size()));
+	const auto size = encoder.encode(buffer, 1, changes, 1000, 1005);
+
+	std::vector<std::byte> small(size - 1);
+	EXPECT_EQ(encoder.encode(small, 1, changes, 1000, 1005), 0);
+}
+
+TEST_P(DeltaCodecTest, TruncatedMessage_IsRejected)
+{
+	DeltaEncoder encoder(GetParam());
+	std::vector<std::byte> buffer(DeltaFormat::max_size(GetParam(), changes.size()));
+	const auto size = encoder.encode(buffer, 1, changes, 1000, 1005);
+
+	for (size_t length = 0; length < size; ++length)
+	{
+		EXPECT_FALSE(DeltaMessageView::parse({ buffer.data(), length }).has_value()) << length;
+	}
+}
+
+TEST_P(DeltaCodecTest, ConsecutiveMessages_AreSplitByMessageSize)
+{
+	DeltaEncoder encoder(GetParam());
+	std::vector<std::byte> stream(2 * DeltaFormat::max_size(GetParam(), changes.size()));
+
+	const auto first = encoder.encode(stream, 1, changes, 1000, 1005);
+	const auto second = encoder.encode(std::span(stream).subspan(first), 2, std::span(changes).first(1), 1000, 1005);
+
+	auto view = DeltaMessageView::parse(stream);
+	ASSERT_TRUE(view.has_value());
+	EXPECT_EQ(view->get_message_size(), first);
+
+	auto next = DeltaMessageView::parse(std::span<const std::byte>(stream).subspan(view->get_message_size()));
+	ASSERT_TRUE(next.has_value());
+	EXPECT_EQ(next->get_sequence(), 2);
+	EXPECT_EQ(next->get_message_size(), second);
+	EXPECT_EQ(*next->begin(), changes[0]);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+	Encodings,
+	DeltaCodecTest,
+	::testing::Values(DeltaEncoding::Fixed, DeltaEncoding::Compact),
+	[](const auto &test_info) { return test_info.param == DeltaEncoding::Fixed ? "Fixed" : "Compact"; }
+);
+
+TEST(DeltaCodecFormatTest, Compact_IsSmallerNearTheTouch)
+{
+	std::vector<LevelChange> changes;
+	for (uint64_t i = 0; i < 10; ++i)
+	{
+		changes.push_back({ Side::Bid, LevelAction::Change, 100'000'000 - i, 500 + i });
+		changes.push_back({ Side::Ask, LevelAction::Change, 100'000'001 + i, 500 + i });
+	}
+
+	std::vector<std::byte> buffer(DeltaFormat::max_size(DeltaEncoding::Fixed, changes.size()));
+	const auto fixed = DeltaEncoder(DeltaEncoding::Fixed).encode(buffer, 1, changes, 100'000'000, 100'000'001);
+	const auto compact = DeltaEncoder(DeltaEncoding::Compact).encode(buffer, 1, changes, 100'000'000, 100'000'001);
+
+	EXPECT_EQ(fixed, DeltaFormat::PREFIX_SIZE + 20 * DeltaFormat::FIXED_ENTRY_SIZE);
+	// Flags, one byte offset and two byte quantity.
+	EXPECT_EQ(compact, DeltaFormat::PREFIX_SIZE + 20 * 4);
+}
+
+TEST(DeltaCodecFormatTest, CorruptedHeaderOrFlags_AreRejected)
+{
+	const std::array changes { LevelChange { Side::Ask, LevelAction::Insert, 1010, 5 } };
+	std::array<std::byte, 64> buffer {};
+	const auto size = DeltaEncoder(DeltaEncoding::Compact).encode(buffer, 1, changes, 1000, 1010);
+	ASSERT_TRUE(DeltaMessageView::parse({ buffer.data(), size }).has_value());
+
+	auto wrong_schema = buffer;
+	wrong_schema[4] = std::byte { 0 };
+	EXPECT_FALSE(DeltaMessageView::parse({ wrong_schema.data(), size }).has_value());
+
+	auto wrong_action = buffer;
+	wrong_action[DeltaFormat::PREFIX_SIZE] = std::byte { 0x7 };
+	EXPECT_FALSE(DeltaMessageView::parse({ wrong_action.data(), size }).has_value());
+}
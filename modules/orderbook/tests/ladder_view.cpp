@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <l2/ladder_view.hpp>
+
+using namespace hft::orderbook;
+
+namespace {
+
+constexpr std::array<uint64_t, 3> WIDTHS { 1, 10, 100 };
+
+/*Bucket sums recomputed from every level the book holds.*/
+auto expected_buckets(const OrderBook &book, Side side, uint64_t width) -> std::map<uint64_t, LadderBucket>
+{
+	std::vector<PriceLevel> levels(OrderBook::MAX_LEVELS);
+	levels.resize(side == Side::Bid ? book.get_bid_levels(levels) : book.get_ask_levels(levels));
+	if (book.is_cold_tier_enabled())
+	{
+		const auto cold = side == Side::Bid ? book.get_bids_cold_tier().levels() : book.get_asks_cold_tier().levels();
+		levels.insert(levels.end(), cold.begin(), cold.end());
+	}
+
+	std::map<uint64_t, LadderBucket> buckets;
+	for (const auto &level : levels)
+	{
+		const auto start = level.price / width * width;
+		auto &bucket = buckets[start];
+		bucket.price = start;
+		bucket.quantity += level.quantity;
+		++bucket.levels;
+	}
+	return buckets;
+}
+
+void expect_matches_book(const LadderView &view, uint64_t low, uint64_t high)
+{
+	for (size_t ladder = 0; ladder < view.get_ladder_count(); ++ladder)
+	{
+		const auto width = view.get_width(ladder);
+		for (const auto side : { Side::Bid, Side::Ask })
+		{
+			const auto expected = expected_buckets(view.get_book(), side, width);
+			for (auto price = low / width * width; price <= high; price += width)
+			{
+				const auto it = expected.find(price);
+				const auto bucket = it != expected.end() ? it->second : LadderBucket { price, 0, 0 };
+				ASSERT_EQ(view.get_bucket(ladder, side, price + width - 1), bucket)
+					<< "width " << width << " price " << price << " side " << static_cast<int>(side);
+			}
+		}
+	}
+}
+
+void run_random_updates(bool cold_tier)
+{
+	auto book = std::make_unique<OrderBook>();
+	book->set_cold_tier_enabled(cold_tier);
+	LadderView view(*book, WIDTHS);
+
+	std::mt19937_64 rng(cold_tier ? 3 : 4);
+	for (int i = 0; i < 20'000; ++i)
+	{
+		const auto qty = rng() % 4 == 0 ? 0 : 1 + rng() % 100;
+		if (rng() % 2 == 0)
+		{
+			view.update_bid_side(10'000 - rng() % 300, qty);
+		}
+		else
+		{
+			view.update_ask_side(10'001 + rng() % 300, qty);
+		}
+
+		if (i % 500 == 0)
+		{
+			expect_matches_book(view, 9'600, 10'400);
+		}
+	}
+	expect_matches_book(view, 9'600, 10'400);
+	EXPECT_EQ(view.get_collisions(), 0);
+}
+
+} // namespace
+
+TEST(LadderViewTest, RandomUpdates_MatchBook)
+{
+	run_random_updates(false);
+}
+
+TEST(LadderViewTest, RandomUpdates_MatchBookWithColdTier)
+{
+	run_random_updates(true);
+}
+
+TEST(LadderViewTest, Attach_SumsExistingLevels)
+{
+	OrderBook book;
+	book.set_cold_tier_enabled(true);
+	for (uint64_t i = 0; i < 20; ++i)
+	{
+		book.update_bid_side(1000 - i, 1 + i);
+		book.update_ask_side(1001 + i, 2 + i);
+	}
+
+	const LadderView view(book, WIDTHS);
+	expect_matches_book(view, 900, 1100);
+
+	// 990 to 999, hot and cold levels alike.
+	EXPECT_EQ(view.get_bucket(1, Side::Bid, 995), (LadderBucket { 990, (2 + 11) * 10 / 2, 10 }));
+	EXPECT_EQ(view.get_quantity(2, Side::Ask, 1001), (2 + 21) * 20 / 2);
+}
+
+TEST(LadderViewTest, ApplyDelta_FoldsDeltasFromElsewhere)
+{
+	OrderBook book;
+	const std::array<uint64_t, 1> widths { 10 };
+	LadderView view(book, widths);
+
+	std::array<LevelDelta, 2> deltas;
+	for (uint64_t price = 1000; price < 1010; ++price)
+	{
+		const auto count = apply_update(book, Side::Ask, price, 5, deltas);
+		for (size_t i = 0; i < count; ++i)
+		{
+			view.apply_delta(deltas[i]);
+		}
+	}
+
+	// The book keeps the best five, worse asks on a full side are ignored.
+	EXPECT_EQ(view.get_bucket(0, Side::Ask, 1000), (LadderBucket { 1000, 25, 5 }));
+	expect_matches_book(view, 990, 1020);
+}
+
+TEST(LadderViewTest, FarApartBuckets_CountCollisions)
+{
+	OrderBook book;
+	const std::array<uint64_t, 1> widths { 1 };
+	LadderView view(book, widths);
+
+	view.update_bid_side(5000, 10);
+	view.update_bid_side(5000 - LadderView::BUCKETS, 20);
+	EXPECT_EQ(view.get_collisions(), 1);
+	EXPECT_EQ(view.get_quantity(0, Side::Bid, 5000), 10);
+	EXPECT_EQ(view.get_quantity(0, Side::Bid, 5000 - LadderView::BUCKETS), 0);
+
+	// Once the slot is free the other bucket takes it over.
+	view.update_bid_side(5000, 0);
+	view.update_bid_side(5000 - LadderView::BUCKETS, 30);
+	EXPECT_EQ(view.get_quantity(0, Side::Bid, 5000 - LadderView::BUCKETS), 30);
+}
+
+TEST(LadderViewTest, Collision_LeftOutLevelNeverRemovedFromReclaimedSlot)
+{
+	OrderBook book;
+	const std::array<uint64_t, 1> widths { 10 };
+	LadderView view(book, widths);
+	constexpr uint64_t FAR = 1000 + LadderView::BUCKETS * 10;
+
+	view.update_bid_side(1000, 5);
+	view.update_bid_side(FAR, 7);
+	EXPECT_EQ(view.get_collisions(), 1);
+
+	// The first bucket drains while a level of the far one is still left out, the far bucket cannot take the slot yet.
+	view.update_bid_side(1000, 0);
+	view.update_bid_side(FAR + 5, 9);
+	EXPECT_EQ(view.get_collisions(), 2);
+	EXPECT_EQ(view.get_bucket(0, Side::Bid, FAR), (LadderBucket { FAR, 0, 0 }));
+
+	view.update_bid_side(FAR, 0);
+	view.update_bid_side(FAR + 5, 0);
+	view.update_bid_side(FAR + 1, 4);
+	EXPECT_EQ(view.get_bucket(0, Side::Bid, FAR), (LadderBucket { FAR, 4, 1 }));
+	expect_matches_book(view, FAR - 20, FAR + 20);
+}
+
+TEST(LadderViewTest, InvalidWidths_Throw)
+{
+	OrderBook book;
+	const std::array<uint64_t, 2> zero { 10, 0 };
+	EXPECT_THROW(LadderView(book, zero), std::runtime_error);
+
+	const std::array<uint64_t, LadderView::MAX_WIDTHS + 1> too_many { 1, 2, 3, 4, 5 };
+	EXPECT_THROW(LadderView(book, too_many), std::runtime_error);
+}
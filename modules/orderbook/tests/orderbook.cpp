@@ -284,4 +284,160 @@ TEST_F(FixedSizeL2OrderBookTest, InsertIntoEmptyBookAfterClear)
 	ASSERT_EQ(levels.size(), 1);
 	EXPECT_EQ(levels[0].first, 2000);
 	EXPECT_EQ(levels[0].second, 30);
-}
\ No newline at end of file
+}
+
+// ==================== COLD TIER TESTS ====================
+
+TEST_F(FixedSizeL2OrderBookTest, ColdTier_EvictedLevelPromotedOnDelete)
+{
+	book.set_cold_tier_enabled(true);
+
+	book.add_bid_side(1000, 10);
+	book.add_bid_side(1100, 20);
+	book.add_bid_side(1200, 30);
+	book.add_bid_side(1300, 40);
+	book.add_bid_side(1400, 50);
+
+	// Evicts 1000 into the cold tier.
+	book.add_bid_side(1250, 99);
+	EXPECT_EQ(book.get_bids_cold_tier().size(), 1);
+
+	book.update_bid_side(1400, 0);
+
+	auto levels = get_bid_levels();
+	ASSERT_EQ(levels.size(), 5);
+	EXPECT_EQ(levels[4].first, 1000);
+	EXPECT_EQ(levels[4].second, 10);
+	EXPECT_NE(book.get_bids_hash_table().lookup(1000), nullptr);
+	EXPECT_TRUE(book.get_bids_cold_tier().empty());
+}
+
+TEST_F(FixedSizeL2OrderBookTest, ColdTier_OutOfRangeLevelsPromotedInOrder)
+{
+	book.set_cold_tier_enabled(true);
+
+	book.add_ask_side(1000, 1);
+	book.add_ask_side(1010, 1);
+	book.add_ask_side(1020, 1);
+	book.add_ask_side(1030, 1);
+	book.add_ask_side(1040, 1);
+
+	// Worse than the tail: kept cold instead of dropped.
+	book.update_ask_side(1060, 6);
+	book.update_ask_side(1050, 5);
+	EXPECT_EQ(book.get_ask_count(), 5);
+	EXPECT_EQ(book.get_asks_cold_tier().size(), 2);
+
+	book.update_ask_side(1000, 0);
+	book.update_ask_side(1010, 0);
+
+	auto levels = get_ask_levels();
+	ASSERT_EQ(levels.size(), 5);
+	EXPECT_EQ(levels[3], std::make_pair(1050UL, 5UL));
+	EXPECT_EQ(levels[4], std::make_pair(1060UL, 6UL));
+}
+
+TEST_F(FixedSizeL2OrderBookTest, ColdTier_UpdatesAndDeletesColdLevels)
+{
+	book.set_cold_tier_enabled(true);
+
+	for (uint64_t price = 1000; price < 1005; ++price)
+	{
+		book.add_bid_side(price, 1);
+	}
+	book.update_bid_side(990, 7);
+	book.update_bid_side(990, 8);
+	book.update_bid_side(980, 9);
+	book.update_bid_side(980, 0);
+
+	const auto &cold = book.get_bids_cold_tier();
+	ASSERT_EQ(cold.size(), 1);
+	ASSERT_NE(cold.find(990), nullptr);
+	EXPECT_EQ(cold.find(990)->quantity, 8);
+	EXPECT_EQ(cold.find(980), nullptr);
+}
+
+TEST_F(FixedSizeL2OrderBookTest, ColdTier_DisabledDropsAsBefore)
+{
+	for (uint64_t price = 1000; price < 1005; ++price)
+	{
+		book.add_bid_side(price, 1);
+	}
+	book.add_bid_side(1010, 1);
+	book.update_bid_side(1010, 0);
+
+	EXPECT_EQ(book.get_bid_count(), 4);
+	EXPECT_TRUE(book.get_bids_cold_tier().empty());
+}
+
+// ==================== SNAPSHOT LOAD TESTS ====================
+
+TEST_F(FixedSizeL2OrderBookTest, LoadSnapshot_HotLevelsAdjacentInPool)
+{
+	book.update_bid_side(500, 1);
+	book.update_ask_side(600, 1);
+
+	std::vector<PriceLevel> bids;
+	std::vector<PriceLevel> asks;
+	for (uint64_t i = 0; i < 1000; ++i)
+	{
+		bids.push_back({ 1000 - i, i + 1 });
+		asks.push_back({ 1001 + i, i + 1 });
+	}
+	book.load_snapshot(bids, asks);
+
+	ASSERT_EQ(book.get_bid_count(), OrderBook::MAX_LEVELS);
+	ASSERT_EQ(book.get_ask_count(), OrderBook::MAX_LEVELS);
+	EXPECT_EQ(get_bid_levels().front(), std::make_pair(1000UL, 1UL));
+	EXPECT_EQ(get_bid_levels().back(), std::make_pair(996UL, 5UL));
+	EXPECT_EQ(get_ask_levels().back(), std::make_pair(1005UL, 5UL));
+	EXPECT_EQ(book.get_bids_hash_table().lookup(500), nullptr);
+	EXPECT_TRUE(book.get_bids_cold_tier().empty());
+
+	size_t slot = 0;
+	const ci_dllink *lnk;
+	CI_DLLIST_FOR_EACH_CONST(lnk, book.get_bids_list())
+	{
+		const auto *level = container_of(lnk, Level, link);
+		EXPECT_EQ(book.get_bids_pool().index_of(level), slot++);
+		EXPECT_EQ(book.get_bids_hash_table().lookup(level->price), level);
+	}
+}
+
+TEST_F(FixedSizeL2OrderBookTest, LoadSnapshot_OverflowGoesCold)
+{
+	book.set_cold_tier_enabled(true);
+
+	std::vector<PriceLevel> asks;
+	for (uint64_t i = 0; i < 100; ++i)
+	{
+		asks.push_back({ 1000 + i, 1 });
+	}
+	book.load_snapshot({}, asks);
+
+	const auto &cold = book.get_asks_cold_tier();
+	ASSERT_EQ(cold.size(), OrderBook::COLD_LEVELS);
+	EXPECT_EQ(cold.best().price, 1005);
+	EXPECT_EQ(cold.levels().front().price, 1005 + OrderBook::COLD_LEVELS - 1);
+
+	// Deleting a hot level pulls the best cold one back in.
+	book.update_ask_side(1000, 0);
+	EXPECT_EQ(book.get_ask_count(), OrderBook::MAX_LEVELS);
+	EXPECT_EQ(get_ask_levels().back(), std::make_pair(1005UL, 1UL));
+}
+
+TEST_F(FixedSizeL2OrderBookTest, LoadSnapshot_SkipsEmptyAndMisorderedLevels)
+{
+	const std::vector<PriceLevel> bids { { 1000, 1 }, { 999, 0 }, { 1001, 5 }, { 1000, 6 }, { 998, 2 } };
+	book.load_snapshot(bids, {});
+
+	const std::vector<std::pair<uint64_t, uint64_t>> expected { { 1000, 1 }, { 998, 2 } };
+	EXPECT_EQ(get_bid_levels(), expected);
+	EXPECT_EQ(book.get_ask_count(), 0);
+
+	// The loaded book keeps taking updates.
+	book.update_bid_side(999, 3);
+	book.update_bid_side(1000, 0);
+	const std::vector<std::pair<uint64_t, uint64_t>> updated { { 999, 3 }, { 998, 2 } };
+	EXPECT_EQ(get_bid_levels(), updated);
+}
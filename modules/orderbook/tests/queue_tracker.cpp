@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <l2/queue_tracker.hpp>
+
+using namespace hft::orderbook;
+
+class QueueTrackerTest: public ::testing::Test
+{
+protected:
+	OrderBook book;
+};
+
+TEST_F(QueueTrackerTest, NewOrder_JoinsBehindLevel)
+{
+	QueueTracker tracker(book);
+	tracker.update_bid_side(1000, 50);
+
+	auto *order = tracker.add_order(1, Side::Bid, 1000, 5);
+	ASSERT_NE(order, nullptr);
+	EXPECT_EQ(order->queue_ahead, 50);
+
+	// Quantity added after us queues behind.
+	tracker.update_bid_side(1000, 80);
+	EXPECT_EQ(order->queue_ahead, 50);
+}
+
+TEST_F(QueueTrackerTest, Fifo_DecreaseComesOffTheFront)
+{
+	QueueTracker tracker(book, QueueModel::Fifo);
+	tracker.update_ask_side(1010, 100);
+	auto *order = tracker.add_order(1, Side::Ask, 1010, 5);
+	tracker.update_ask_side(1010, 150);
+
+	tracker.update_ask_side(1010, 120);
+	EXPECT_EQ(order->queue_ahead, 70);
+
+	tracker.update_ask_side(1010, 30);
+	EXPECT_EQ(order->queue_ahead, 0);
+}
+
+TEST_F(QueueTrackerTest, ProRata_DecreaseScalesQueueAhead)
+{
+	QueueTracker tracker(book, QueueModel::ProRata);
+	tracker.update_bid_side(1000, 100);
+	auto *order = tracker.add_order(1, Side::Bid, 1000, 5);
+	tracker.update_bid_side(1000, 200);
+
+	tracker.update_bid_side(1000, 100);
+	EXPECT_EQ(order->queue_ahead, 50);
+}
+
+TEST_F(QueueTrackerTest, LevelDeleted_NothingAhead)
+{
+	QueueTracker tracker(book);
+	tracker.update_bid_side(1000, 100);
+	auto *order = tracker.add_order(1, Side::Bid, 1000, 5);
+
+	tracker.update_bid_side(1000, 0);
+	EXPECT_EQ(order->queue_ahead, 0);
+	EXPECT_EQ(book.get_bid_count(), 0);
+}
+
+TEST_F(QueueTrackerTest, OrdersAtSamePrice_KeepArrivalOrder)
+{
+	QueueTracker tracker(book);
+	tracker.update_bid_side(1000, 10);
+	tracker.add_order(1, Side::Bid, 1000, 5);
+	tracker.update_bid_side(1000, 15);
+	tracker.add_order(2, Side::Bid, 1000, 5);
+
+	std::vector<std::pair<uint64_t, uint64_t>> orders;
+	tracker.for_each_order(Side::Bid, 1000, [&](const OwnOrder &order) { orders.emplace_back(order.id, order.queue_ahead); });
+	EXPECT_EQ(orders, (std::vector<std::pair<uint64_t, uint64_t>> { { 1, 10 }, { 2, 15 } }));
+}
+
+TEST_F(QueueTrackerTest, DeepPrice_TrackedBeyondBookLevels)
+{
+	QueueTracker tracker(book);
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		tracker.update_bid_side(1000 - i, 10);
+	}
+
+	auto *order = tracker.add_order(1, Side::Bid, 900, 5);
+	ASSERT_NE(order, nullptr);
+	EXPECT_EQ(order->queue_ahead, 0);
+
+	// The book ignores the level, the tracker still follows it.
+	tracker.update_bid_side(900, 40);
+	auto *behind = tracker.add_order(2, Side::Bid, 900, 5);
+	EXPECT_EQ(behind->queue_ahead, 40);
+
+	tracker.update_bid_side(900, 25);
+	EXPECT_EQ(behind->queue_ahead, 25);
+	EXPECT_EQ(order->queue_ahead, 0);
+	EXPECT_EQ(book.get_bids_hash_table().lookup(900), nullptr);
+}
+
+TEST_F(QueueTrackerTest, FillAndRemove_ReleaseSlots)
+{
+	QueueTracker tracker(book);
+	auto *order = tracker.add_order(1, Side::Ask, 1010, 5);
+
+	EXPECT_FALSE(tracker.fill_order(order, 2));
+	EXPECT_EQ(order->quantity, 3);
+	EXPECT_TRUE(tracker.fill_order(order, 3));
+	EXPECT_EQ(tracker.get_order_count(), 0);
+
+	size_t visited = 0;
+	tracker.for_each_order(Side::Ask, 1010, [&](const OwnOrder &) { ++visited; });
+	EXPECT_EQ(visited, 0);
+}
+
+TEST_F(QueueTrackerTest, Capacity_IsBounded)
+{
+	QueueTracker tracker(book);
+	for (uint64_t i = 0; i < QueueTracker::MAX_PRICES; ++i)
+	{
+		ASSERT_NE(tracker.add_order(i, Side::Bid, 1000 - i, 1), nullptr);
+	}
+	EXPECT_EQ(tracker.add_order(99, Side::Bid, 1, 1), nullptr);
+
+	// Existing prices still take orders, until the order pool runs out.
+	for (uint64_t i = QueueTracker::MAX_PRICES; i < QueueTracker::MAX_ORDERS; ++i)
+	{
+		ASSERT_NE(tracker.add_order(i, Side::Bid, 1000, 1), nullptr);
+	}
+	EXPECT_EQ(tracker.add_order(100, Side::Bid, 1000, 1), nullptr);
+	EXPECT_EQ(tracker.get_order_count(), QueueTracker::MAX_ORDERS);
+}
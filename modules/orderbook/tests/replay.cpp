@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <l2/replay.hpp>
+
+using namespace hft::orderbook;
+using hft::core::WorkStealingPool;
+
+namespace {
+
+auto make_streams(size_t symbols, size_t updates) -> std::vector<std::vector<MarketUpdate>>
+{
+	std::vector<std::vector<MarketUpdate>> streams(symbols);
+	std::mt19937_64 rng(1);
+	for (size_t s = 0; s < symbols; ++s)
+	{
+		// Uneven stream lengths so workers run out at different times.
+		const auto count = updates + rng() % updates;
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const auto side = rng() % 2 == 0 ? Side::Bid : Side::Ask;
+			const auto price = side == Side::Bid ? 1000 - rng() % 10 : 1001 + rng() % 10;
+			const auto qty = rng() % 4 == 0 ? 0 : 1 + rng() % 100;
+			streams[s].push_back({ i * 1000, i + 1, price, qty, side });
+		}
+	}
+	return streams;
+}
+
+auto as_spans(const std::vector<std::vector<MarketUpdate>> &streams) -> std::vector<std::span<const MarketUpdate>>
+{
+	return { streams.begin(), streams.end() };
+}
+
+} // namespace
+
+TEST(WorkStealingPoolTest, EveryTaskRunsOnce)
+{
+	WorkStealingPool pool(4);
+	std::vector<std::atomic<int>> runs(1000);
+
+	for (int round = 0; round < 3; ++round)
+	{
+		pool.parallel_for(runs.size(), [&](size_t task, size_t) { runs[task].fetch_add(1); });
+	}
+
+	for (const auto &count : runs)
+	{
+		EXPECT_EQ(count.load(), 3);
+	}
+}
+
+TEST(WorkStealingPoolTest, IdleWorkers_StealSlowTasks)
+{
+	WorkStealingPool pool(4);
+	constexpr size_t TASKS = 16;
+	std::array<size_t, TASKS> ran_on {};
+
+	// Worker 0 owns the first quarter of the tasks, make those slow.
+	pool.parallel_for(
+		TASKS,
+		[&](size_t task, size_t worker)
+		{
+			ran_on[task] = worker;
+			if (task < TASKS / 4)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			}
+		}
+	);
+
+	const auto stolen = std::count_if(ran_on.begin(), ran_on.begin() + TASKS / 4, [](size_t w) { return w != 0; });
+	EXPECT_GT(stolen, 0);
+}
+
+TEST(WorkStealingPoolTest, Exception_IsRethrownAfterAllTasks)
+{
+	WorkStealingPool pool(3);
+	std::atomic<size_t> completed {};
+
+	EXPECT_THROW(
+		pool.parallel_for(
+			100,
+			[&](size_t task, size_t)
+			{
+				if (task == 42)
+				{
+					throw std::runtime_error("task failed");
+				}
+				completed.fetch_add(1);
+			}
+		),
+		std::runtime_error
+	);
+	EXPECT_EQ(completed.load(), 99);
+
+	// The pool stays usable.
+	pool.parallel_for(10, [&](size_t, size_t) { completed.fetch_add(1); });
+	EXPECT_EQ(completed.load(), 109);
+}
+
+TEST(ReplayRunnerTest, Results_MatchSequentialReplay)
+{
+	const auto streams = make_streams(64, 500);
+	const auto spans = as_spans(streams);
+
+	WorkStealingPool pool(4);
+	ReplayRunner runner(pool, streams.size());
+	const auto results = runner.run(spans);
+
+	ASSERT_EQ(results.size(), streams.size());
+	for (size_t s = 0; s < streams.size(); ++s)
+	{
+		OrderBook book;
+		for (const auto &update : streams[s])
+		{
+			apply_market_update(book, update);
+		}
+		EXPECT_EQ(results[s].final_book, make_snapshot(book)) << s;
+		EXPECT_EQ(results[s].updates, streams[s].size());
+		EXPECT_EQ(runner.get_progress(s), streams[s].size());
+	}
+	EXPECT_EQ(runner.get_completed_symbols(), streams.size());
+}
+
+TEST(ReplayRunnerTest, Visitor_SeesEachSymbolInOrder)
+{
+	const auto streams = make_streams(32, 2000);
+	const auto spans = as_spans(streams);
+
+	WorkStealingPool pool(4);
+	ReplayRunner runner(pool, streams.size());
+
+	std::vector<uint64_t> last_sequence(streams.size());
+	std::vector<uint64_t> out_of_order(streams.size());
+	runner.run(
+		spans,
+		[&](size_t symbol, const OrderBook &book, const MarketUpdate &update)
+		{
+			out_of_order[symbol] += update.sequence != last_sequence[symbol] + 1 ? 1U : 0U;
+			out_of_order[symbol] += book.get_sequence() != update.sequence ? 1U : 0U;
+			last_sequence[symbol] = update.sequence;
+		}
+	);
+
+	for (size_t s = 0; s < streams.size(); ++s)
+	{
+		EXPECT_EQ(out_of_order[s], 0);
+		EXPECT_EQ(last_sequence[s], streams[s].size());
+	}
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <l2/sbe_depth.hpp>
+
+using namespace hft::orderbook;
+using hft::core::store_le;
+
+class SbeDepthTest: public ::testing::Test
+{
+protected:
+	using Levels = std::vector<std::pair<int64_t, int64_t>>;
+
+	static auto build(
+		uint16_t template_id,
+		int64_t first,
+		int64_t last,
+		const Levels &bids,
+		const Levels &asks,
+		int8_t price_exponent = -2,
+		int8_t qty_exponent = -3,
+		uint16_t entry_length = sbe::LevelEntry::BLOCK_LENGTH
+	) -> std::vector<std::byte>
+	{
+		const auto snapshot = template_id == sbe::DepthSnapshotStreamEvent::TEMPLATE_ID;
+		const size_t block_length = snapshot ? sbe::DepthSnapshotStreamEvent::BLOCK_LENGTH
+											 : sbe::DepthDiffStreamEvent::BLOCK_LENGTH;
+		constexpr std::string_view symbol = "BTCUSDT";
+
+		std::vector<std::byte> buffer(
+			sbe::MessageHeader::SIZE + block_length + 2 * sbe::GroupSize16Encoding::SIZE +
+			(bids.size() + asks.size()) * entry_length + 1 + symbol.size()
+		);
+
+		auto *pos = buffer.data();
+		pos = store_le(pos, static_cast<uint16_t>(block_length));
+		pos = store_le(pos, template_id);
+		pos = store_le(pos, sbe::SCHEMA_ID);
+		pos = store_le(pos, uint16_t { 0 });
+
+		pos = store_le(pos, int64_t { 1'700'000'000'000'000 });
+		pos = store_le(pos, first);
+		if (!snapshot)
+		{
+			pos = store_le(pos, last);
+		}
+		pos = store_le(pos, price_exponent);
+		pos = store_le(pos, qty_exponent);
+
+		for (const auto *levels : { &bids, &asks })
+		{
+			pos = store_le(pos, entry_length);
+			pos = store_le(pos, static_cast<uint16_t>(levels->size()));
+			for (const auto &[price, qty] : *levels)
+			{
+				store_le(pos, price);
+				store_le(pos + 8, qty);
+				pos += entry_length;
+			}
+		}
+
+		pos = store_le(pos, static_cast<uint8_t>(symbol.size()));
+		std::memcpy(pos, symbol.data(), symbol.size());
+		return buffer;
+	}
+
+	static auto snapshot(int64_t update_id, const Levels &bids, const Levels &asks) -> std::vector<std::byte>
+	{
+		return build(sbe::DepthSnapshotStreamEvent::TEMPLATE_ID, update_id, update_id, bids, asks);
+	}
+
+	static auto diff(int64_t first, int64_t last, const Levels &bids, const Levels &asks) -> std::vector<std::byte>
+	{
+		return build(sbe::DepthDiffStreamEvent::TEMPLATE_ID, first, last, bids, asks);
+	}
+
+	OrderBook book;
+
+	// Prices with 2 decimals, quantities with 3, as the messages carry them.
+	SbeDepthDecoder decoder { { 2, 3 } };
+};
+
+TEST_F(SbeDepthTest, ParseDiff_ExposesFieldsAndGroups)
+{
+	const auto buffer = diff(11, 15, { { 100000, 5 }, { 99990, 0 } }, { { 100010, 7 } });
+	const auto message = sbe::parse_depth(buffer);
+
+	ASSERT_TRUE(message.has_value());
+	EXPECT_FALSE(message->is_snapshot());
+	EXPECT_EQ(message->first_update_id, 11);
+	EXPECT_EQ(message->last_update_id, 15);
+	EXPECT_EQ(message->price_exponent, -2);
+	EXPECT_EQ(message->qty_exponent, -3);
+	ASSERT_EQ(message->bids.size(), 2);
+	EXPECT_EQ(message->bids.price(1), 99990);
+	EXPECT_EQ(message->bids.qty(1), 0);
+	ASSERT_EQ(message->asks.size(), 1);
+	EXPECT_EQ(message->asks.price(0), 100010);
+	EXPECT_EQ(message->symbol, "BTCUSDT");
+	EXPECT_EQ(message->message_size, buffer.size());
+}
+
+TEST_F(SbeDepthTest, SnapshotThenDiffs_FollowUpdateIds)
+{
+	EXPECT_EQ(decoder.apply(snapshot(10, { { 100000, 5 }, { 99990, 6 } }, { { 100010, 7 } }), book),
+			  SbeApplyResult::Applied);
+	EXPECT_EQ(book.get_sequence(), 10);
+	EXPECT_EQ(book.get_bid_count(), 2);
+
+	// Already covered by the snapshot.
+	EXPECT_EQ(decoder.apply(diff(5, 10, { { 100000, 1 } }, {}), book), SbeApplyResult::Stale);
+
+	// Straddles the snapshot, applies.
+	EXPECT_EQ(decoder.apply(diff(8, 12, { { 99990, 0 } }, { { 100020, 3 } }), book), SbeApplyResult::Applied);
+	EXPECT_EQ(book.get_sequence(), 12);
+	EXPECT_EQ(book.get_bid_count(), 1);
+	EXPECT_EQ(book.get_ask_count(), 2);
+
+	EXPECT_EQ(decoder.apply(diff(14, 15, { { 100000, 1 } }, {}), book), SbeApplyResult::Gap);
+	EXPECT_EQ(book.get_bids_hash_table().lookup(100000)->quantity, 5);
+}
+
+TEST_F(SbeDepthTest, DifferentExponents_AreRescaled)
+{
+	const auto buffer = build(sbe::DepthSnapshotStreamEvent::TEMPLATE_ID, 1, 1, { { 1000000, 12345 } }, {}, -3, -5);
+	ASSERT_EQ(decoder.apply(buffer, book), SbeApplyResult::Applied);
+
+	// 1000.000 at 2 decimals, 0.12345 truncated to 3 decimals.
+	const auto *level = book.get_bids_hash_table().lookup(100000);
+	ASSERT_NE(level, nullptr);
+	EXPECT_EQ(level->quantity, 123);
+}
+
+TEST_F(SbeDepthTest, LongerEntries_AreSkippedByBlockLength)
+{
+	const auto buffer = build(
+		sbe::DepthDiffStreamEvent::TEMPLATE_ID, 1, 1, { { 100000, 5 }, { 99990, 6 } }, { { 100010, 7 } }, -2, -3, 24
+	);
+	const auto message = sbe::parse_depth(buffer);
+
+	ASSERT_TRUE(message.has_value());
+	EXPECT_EQ(message->bids.price(1), 99990);
+	EXPECT_EQ(message->asks.qty(0), 7);
+	EXPECT_EQ(message->symbol, "BTCUSDT");
+}
+
+TEST_F(SbeDepthTest, TruncatedMessage_IsMalformed)
+{
+	const auto buffer = diff(1, 1, { { 100000, 5 } }, { { 100010, 7 } });
+	for (size_t length = sbe::MessageHeader::SIZE; length < buffer.size(); ++length)
+	{
+		EXPECT_FALSE(sbe::parse_depth({ buffer.data(), length }).has_value()) << length;
+		EXPECT_EQ(decoder.apply({ buffer.data(), length }, book), SbeApplyResult::Malformed) << length;
+	}
+	EXPECT_EQ(book.get_bid_count(), 0);
+}
+
+TEST_F(SbeDepthTest, OtherTemplate_IsIgnored)
+{
+	auto buffer = diff(1, 1, { { 100000, 5 } }, {});
+	// TradesStreamEvent
+	store_le(buffer.data() + 2, uint16_t { 10000 });
+
+	EXPECT_EQ(decoder.apply(buffer, book), SbeApplyResult::Ignored);
+	EXPECT_FALSE(sbe::parse_depth(buffer).has_value());
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include <l2/snapshot_exporter.hpp>
+
+using namespace hft::orderbook;
+
+namespace {
+
+struct Row
+{
+	uint64_t timestamp_ns;
+
+	uint64_t price;
+
+	uint64_t quantity;
+
+	uint32_t symbol;
+
+	uint8_t level;
+
+	uint8_t side;
+
+	auto operator==(const Row &) const -> bool = default;
+};
+
+} // namespace
+
+class SnapshotExporterTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		path = ::testing::TempDir() + "snapshot_exporter_" +
+			   ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+		std::filesystem::remove(path);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(path);
+	}
+
+	/*Parses the file back through the documented layout.*/
+	auto read_rows(uint32_t expected_depth, size_t &chunks) const -> std::vector<Row>
+	{
+		std::ifstream stream(path, std::ios::binary);
+		const std::vector<char> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		columnar::FileHeader header;
+		EXPECT_GE(bytes.size(), sizeof(header));
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		EXPECT_EQ(header.magic, columnar::MAGIC);
+		EXPECT_EQ(header.version, columnar::VERSION);
+		EXPECT_EQ(header.depth, expected_depth);
+
+		std::vector<Row> rows;
+		chunks = 0;
+		for (size_t offset = sizeof(header); offset < bytes.size(); ++chunks)
+		{
+			columnar::ChunkHeader chunk;
+			std::memcpy(&chunk, bytes.data() + offset, sizeof(chunk));
+			EXPECT_EQ(chunk.size, columnar::chunk_size(chunk.rows));
+			EXPECT_LE(offset + chunk.size, bytes.size());
+
+			const auto *column = bytes.data() + offset + sizeof(chunk);
+			const auto n = static_cast<size_t>(chunk.rows);
+			const auto *timestamps = column;
+			const auto *prices = timestamps + n * sizeof(uint64_t);
+			const auto *quantities = prices + n * sizeof(uint64_t);
+			const auto *symbols = quantities + n * sizeof(uint64_t);
+			const auto *levels = symbols + n * sizeof(uint32_t);
+			const auto *sides = levels + n;
+			for (size_t i = 0; i < n; ++i)
+			{
+				Row row {};
+				std::memcpy(&row.timestamp_ns, timestamps + i * sizeof(uint64_t), sizeof(uint64_t));
+				std::memcpy(&row.price, prices + i * sizeof(uint64_t), sizeof(uint64_t));
+				std::memcpy(&row.quantity, quantities + i * sizeof(uint64_t), sizeof(uint64_t));
+				std::memcpy(&row.symbol, symbols + i * sizeof(uint32_t), sizeof(uint32_t));
+				row.level = static_cast<uint8_t>(levels[i]);
+				row.side = static_cast<uint8_t>(sides[i]);
+				rows.push_back(row);
+			}
+			if (n != 0)
+			{
+				EXPECT_EQ(chunk.first_timestamp_ns, rows[rows.size() - n].timestamp_ns);
+				EXPECT_EQ(chunk.last_timestamp_ns, rows.back().timestamp_ns);
+			}
+			offset += chunk.size;
+		}
+		return rows;
+	}
+
+	/*Rows the exporter should produce for one sample of book.*/
+	static void expect_rows(std::vector<Row> &rows, uint64_t timestamp, uint32_t symbol, const OrderBook &book, size_t depth)
+	{
+		std::array<PriceLevel, OrderBook::MAX_LEVELS> levels {};
+		const auto bids = book.get_bid_levels(std::span(levels).first(depth));
+		for (size_t i = 0; i < bids; ++i)
+		{
+			rows.push_back({ timestamp, levels[i].price, levels[i].quantity, symbol, static_cast<uint8_t>(i), 0 });
+		}
+		const auto asks = book.get_ask_levels(std::span(levels).first(depth));
+		for (size_t i = 0; i < asks; ++i)
+		{
+			rows.push_back({ timestamp, levels[i].price, levels[i].quantity, symbol, static_cast<uint8_t>(i), 1 });
+		}
+	}
+
+	std::string path;
+};
+
+TEST_F(SnapshotExporterTest, RoundTrip_RowsMatchBooksAcrossChunks)
+{
+	std::array<OrderBook, 3> books;
+	std::mt19937_64 rng(9);
+	std::vector<Row> expected;
+
+	{
+		SnapshotExporter exporter(path, { .depth = 3, .chunk_rows = 7, .queue_capacity = 1024 });
+		for (uint64_t t = 0; t < 200; ++t)
+		{
+			for (uint32_t symbol = 0; symbol < books.size(); ++symbol)
+			{
+				auto &book = books[symbol];
+				book.update_bid_side(1000 - rng() % 8, rng() % 3 == 0 ? 0 : 1 + rng() % 50);
+				book.update_ask_side(1001 + rng() % 8, rng() % 3 == 0 ? 0 : 1 + rng() % 50);
+
+				// A full ring only drops, retry until the writer caught up so the test stays deterministic.
+				while (!exporter.sample(1000 + t, symbol, book))
+				{
+					std::this_thread::yield();
+				}
+				expect_rows(expected, 1000 + t, symbol, book, 3);
+			}
+		}
+		exporter.finish();
+
+		const auto stats = exporter.get_stats();
+		EXPECT_EQ(stats.rows, expected.size());
+		EXPECT_EQ(stats.chunks, (expected.size() + 6) / 7);
+	}
+
+	size_t chunks = 0;
+	EXPECT_EQ(read_rows(3, chunks), expected);
+	EXPECT_EQ(chunks, (expected.size() + 6) / 7);
+}
+
+TEST_F(SnapshotExporterTest, SmallRing_DropsAreCountedNotWritten)
+{
+	OrderBook book;
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		book.update_bid_side(1000 - i, 10 + i);
+		book.update_ask_side(1001 + i, 20 + i);
+	}
+
+	uint64_t accepted = 0;
+	SnapshotExporter exporter(path, { .chunk_rows = 64, .queue_capacity = 2 });
+	for (uint64_t t = 0; t < 20000; ++t)
+	{
+		accepted += exporter.sample(t, 7, book) ? 1U : 0U;
+	}
+	exporter.finish();
+
+	const auto stats = exporter.get_stats();
+	EXPECT_EQ(stats.samples, 20000U);
+	EXPECT_EQ(stats.samples, accepted + stats.dropped);
+	EXPECT_EQ(stats.rows, accepted * 2 * OrderBook::MAX_LEVELS);
+
+	size_t chunks = 0;
+	const auto rows = read_rows(OrderBook::MAX_LEVELS, chunks);
+	EXPECT_EQ(rows.size(), stats.rows);
+	EXPECT_TRUE(std::ranges::is_sorted(rows, {}, &Row::timestamp_ns));
+}
+
+TEST_F(SnapshotExporterTest, EmptyExport_HasOnlyTheFileHeader)
+{
+	{
+		SnapshotExporter exporter(path);
+	}
+	EXPECT_EQ(std::filesystem::file_size(path), sizeof(columnar::FileHeader));
+}
+
+TEST_F(SnapshotExporterTest, MissingDirectory_Throws)
+{
+	EXPECT_THROW(SnapshotExporter { "/nonexistent/export.bin" }, std::runtime_error);
+}
+
+TEST(SpscQueueTest, ClaimFailsWhenFullAndWrapsAround)
+{
+	hft::core::SpscQueue<uint64_t> queue(3);
+	ASSERT_EQ(queue.capacity(), 4U);
+
+	for (uint64_t round = 0; round < 3; ++round)
+	{
+		for (uint64_t i = 0; i < 4; ++i)
+		{
+			EXPECT_TRUE(queue.try_push(round * 10 + i));
+		}
+		EXPECT_FALSE(queue.try_push(99));
+		EXPECT_EQ(queue.size(), 4U);
+
+		for (uint64_t i = 0; i < 4; ++i)
+		{
+			const auto *front = queue.front();
+			ASSERT_NE(front, nullptr);
+			EXPECT_EQ(*front, round * 10 + i);
+			queue.pop();
+		}
+		EXPECT_EQ(queue.front(), nullptr);
+	}
+}
+
+TEST(SpscQueueTest, CrossThread_PreservesOrder)
+{
+	constexpr uint64_t COUNT = 1 << 18;
+	hft::core::SpscQueue<uint64_t> queue(64);
+
+	std::thread producer(
+		[&]
+		{
+			for (uint64_t i = 0; i < COUNT;)
+			{
+				if (queue.try_push(i))
+				{
+					++i;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+	);
+
+	uint64_t expected = 0;
+	bool ordered = true;
+	while (expected < COUNT)
+	{
+		if (const auto *front = queue.front())
+		{
+			ordered &= *front == expected++;
+			queue.pop();
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	EXPECT_TRUE(ordered);
+	EXPECT_EQ(queue.front(), nullptr);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <l2/orderbook.hpp>
+#include <l2/stats_region.hpp>
+
+using namespace hft::orderbook;
+
+class StatsRegionTest: public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		path = ::testing::TempDir() + "stats_region_" +
+			   ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+		std::filesystem::remove(path);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(path);
+	}
+
+	static auto total(const ProbeHistogram &histogram) -> uint64_t
+	{
+		uint64_t sum = 0;
+		for (const auto &bucket : histogram)
+		{
+			sum += bucket.get();
+		}
+		return sum;
+	}
+
+	std::string path;
+};
+
+TEST_F(StatsRegionTest, Counters_TrackEveryBookEvent)
+{
+	BookCounters counters;
+	OrderBook book;
+	book.set_counters(&counters);
+
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		book.update_bid_side(1000 - i, 10);
+	}
+	book.update_bid_side(1000, 11);
+	book.update_bid_side(1001, 10); // Evicts 996
+	book.update_bid_side(900, 10);	// Worse than the tail, dropped
+	book.update_bid_side(1001, 0);
+	book.update_ask_side(2000, 0); // Unknown price, nothing to delete
+
+	EXPECT_EQ(counters.bids.updates.get(), 9U);
+	EXPECT_EQ(counters.bids.inserts.get(), OrderBook::MAX_LEVELS + 1);
+	EXPECT_EQ(counters.bids.evictions.get(), 1U);
+	EXPECT_EQ(counters.bids.out_of_range.get(), 1U);
+	EXPECT_EQ(counters.bids.deletes.get(), 1U);
+	EXPECT_EQ(counters.bids.pool_exhausted.get(), 0U);
+
+	EXPECT_EQ(counters.asks.updates.get(), 1U);
+	EXPECT_EQ(counters.asks.inserts.get(), 0U);
+	EXPECT_EQ(counters.asks.deletes.get(), 0U);
+}
+
+TEST_F(StatsRegionTest, Counters_ColdTierKeepsWorsePrices)
+{
+	BookCounters counters;
+	OrderBook book;
+	book.set_cold_tier_enabled(true);
+	book.set_counters(&counters);
+
+	for (uint64_t i = 0; i < OrderBook::MAX_LEVELS; ++i)
+	{
+		book.update_ask_side(1000 + i, 10);
+	}
+	book.update_ask_side(2000, 10);
+
+	EXPECT_EQ(counters.asks.out_of_range.get(), 0U);
+	EXPECT_EQ(book.get_asks_cold_tier().size(), 1U);
+}
+
+TEST_F(StatsRegionTest, ProbeHistogram_BucketsByProbeLength)
+{
+	ProbeHistogram histogram;
+	std::array<Level, 3> levels {};
+
+	L2HashTable table;
+	table.set_probe_histogram(&histogram);
+
+	// Same home slot, every insert walks past the ones before it.
+	for (uint64_t i = 0; i < levels.size(); ++i)
+	{
+		ASSERT_TRUE(table.insert(7 + i * L2HashTable::ENTRIES, &levels[i]));
+	}
+	EXPECT_EQ(histogram[0].get(), 1U);
+	EXPECT_EQ(histogram[1].get(), 2U);
+
+	EXPECT_EQ(table.lookup(7 + 2 * L2HashTable::ENTRIES), &levels[2]);
+	EXPECT_EQ(histogram[1].get(), 3U);
+	EXPECT_EQ(total(histogram), 4U);
+
+	table.set_probe_histogram(nullptr);
+	EXPECT_EQ(table.lookup(7), &levels[0]);
+	EXPECT_EQ(total(histogram), 4U);
+}
+
+TEST_F(StatsRegionTest, OrderBook_CountsProbesOfBothSides)
+{
+	BookCounters counters;
+	OrderBook book;
+	book.set_counters(&counters);
+
+	book.update_bid_side(100, 1);
+	book.update_ask_side(101, 1);
+	EXPECT_GT(total(counters.bids.probes), 0U);
+	EXPECT_GT(total(counters.asks.probes), 0U);
+
+	book.set_counters(nullptr);
+	const auto bid_probes = total(counters.bids.probes);
+	book.update_bid_side(100, 0);
+	EXPECT_EQ(total(counters.bids.probes), bid_probes);
+	EXPECT_EQ(counters.bids.deletes.get(), 0U);
+}
+
+TEST_F(StatsRegionTest, Reader_SeesCountsOfWriter)
+{
+	BookStatsRegion region(path, 3);
+	region.set_name(0, "BTC-USDT");
+	region.set_name(2, "an instrument name too long to fit in the entry");
+
+	OrderBook book;
+	book.set_counters(&region.get(2));
+	book.update_bid_side(100, 1);
+	book.update_ask_side(101, 1);
+	book.update_ask_side(101, 0);
+
+	const BookStatsReader reader(path);
+	ASSERT_EQ(reader.size(), 3U);
+	EXPECT_EQ(reader.get_name(0), "BTC-USDT");
+	EXPECT_EQ(reader.get_name(1), "");
+	EXPECT_EQ(reader.get_name(2).size(), 31U);
+
+	EXPECT_EQ(reader.get(0).bids.updates.get(), 0U);
+	EXPECT_EQ(reader.get(2).bids.inserts.get(), 1U);
+	EXPECT_EQ(reader.get(2).asks.deletes.get(), 1U);
+
+	// Shared mapping, later counts show without reopening.
+	book.update_bid_side(99, 1);
+	EXPECT_EQ(reader.get(2).bids.inserts.get(), 2U);
+}
+
+TEST_F(StatsRegionTest, Region_RestartsFromZero)
+{
+	std::optional<BookStatsReader> previous;
+	{
+		BookStatsRegion region(path, 1);
+		region.get(0).bids.updates.add(5);
+		previous.emplace(path);
+	}
+
+	const BookStatsRegion region(path, 2);
+	const BookStatsReader reader(path);
+	EXPECT_EQ(reader.size(), 2U);
+	EXPECT_EQ(reader.get(0).bids.updates.get(), 0U);
+
+	// A monitor still mapping the previous run keeps reading its file instead of faulting.
+	EXPECT_EQ(previous->get(0).bids.updates.get(), 5U);
+	EXPECT_EQ(std::filesystem::file_size(path), sizeof(BookStatsRegion::Header) + 2 * sizeof(BookCounters));
+}
+
+TEST_F(StatsRegionTest, Reader_RejectsMissingOrForeignFiles)
+{
+	EXPECT_THROW(BookStatsReader { path }, std::runtime_error);
+
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream << std::string(256, 'x');
+	}
+	EXPECT_THROW(BookStatsReader { path }, std::runtime_error);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <l2/synthetic_book.hpp>
+
+using namespace hft::orderbook;
+
+class SyntheticBookTest: public ::testing::Test
+{
+protected:
+	// ETH/USDT: price 2 decimals, qty 4 decimals.
+	OrderBook eth_usdt;
+
+	// BTC/USDT: price 2 decimals, qty 5 decimals.
+	OrderBook btc_usdt;
+
+	static constexpr SyntheticConfig ETH_BTC_CONFIG {
+		.op = ImpliedOp::Divide,
+		.base_price_decimals = 2,
+		.base_qty_decimals = 4,
+		.quote_price_decimals = 2,
+		.quote_qty_decimals = 5,
+		.price_decimals = 6,
+		.qty_decimals = 4,
+	};
+};
+
+TEST_F(SyntheticBookTest, Divide_WalksBothLadders)
+{
+	eth_usdt.add_bid_side(200000, 10000); // 2000.00 x 1
+	eth_usdt.add_bid_side(199900, 20000); // 1999.00 x 2
+	btc_usdt.add_ask_side(4000000, 5000);   // 40000.00 x 0.05
+	btc_usdt.add_ask_side(4001000, 100000); // 40010.00 x 1
+
+	eth_usdt.add_ask_side(200100, 10000);  // 2001.00 x 1
+	btc_usdt.add_bid_side(3999000, 100000); // 39990.00 x 1
+
+	SyntheticBook eth_btc(eth_usdt, btc_usdt, ETH_BTC_CONFIG);
+	EXPECT_EQ(eth_btc.refresh(), 3);
+
+	auto bids = eth_btc.get_bids();
+	ASSERT_EQ(bids.size(), 2);
+	EXPECT_EQ(bids[0], (PriceLevel { 50000, 10000 })); // 0.050000 x 1
+	EXPECT_EQ(bids[1], (PriceLevel { 49962, 20000 })); // 1999 / 40010 rounded down x 2
+
+	auto asks = eth_btc.get_asks();
+	ASSERT_EQ(asks.size(), 1);
+	EXPECT_EQ(asks[0], (PriceLevel { 50038, 10000 })); // 2001 / 39990 rounded up x 1
+}
+
+TEST_F(SyntheticBookTest, Divide_DeepLevelBacksSeveralImpliedLevels)
+{
+	eth_usdt.add_bid_side(200000, 10000); // 2000 USDT worth
+	eth_usdt.add_bid_side(199000, 10000); // 1990 USDT worth
+	btc_usdt.add_ask_side(4000000, 10000); // 4000 USDT worth
+
+	SyntheticBook eth_btc(eth_usdt, btc_usdt, ETH_BTC_CONFIG);
+	eth_btc.refresh();
+
+	auto bids = eth_btc.get_bids();
+	ASSERT_EQ(bids.size(), 2);
+	EXPECT_EQ(bids[0], (PriceLevel { 50000, 10000 }));
+	EXPECT_EQ(bids[1], (PriceLevel { 49750, 10000 }));
+}
+
+TEST_F(SyntheticBookTest, Multiply_ChainsThroughIntermediate)
+{
+	OrderBook eth_btc;
+	eth_btc.add_bid_side(5000, 20000);     // 0.05000 x 2 ETH
+	btc_usdt.add_bid_side(4000000, 5000); // 40000.00 x 0.05 BTC
+
+	SyntheticBook eth_usd(
+		eth_btc,
+		btc_usdt,
+		{ .op = ImpliedOp::Multiply,
+		  .base_price_decimals = 5,
+		  .base_qty_decimals = 4,
+		  .quote_price_decimals = 2,
+		  .quote_qty_decimals = 5,
+		  .price_decimals = 2,
+		  .qty_decimals = 4 }
+	);
+	eth_usd.refresh();
+
+	auto bids = eth_usd.get_bids();
+	ASSERT_EQ(bids.size(), 1);
+	EXPECT_EQ(bids[0], (PriceLevel { 200000, 10000 })); // 2000.00 x 1 ETH, capped by BTC leg
+	EXPECT_TRUE(eth_usd.get_asks().empty());
+}
+
+TEST_F(SyntheticBookTest, Refresh_RecomputesOnlyAffectedLevels)
+{
+	eth_usdt.add_bid_side(200000, 10000);
+	eth_usdt.add_bid_side(199900, 20000);
+	btc_usdt.add_ask_side(4000000, 5000);
+	btc_usdt.add_ask_side(4001000, 100000);
+
+	SyntheticBook eth_btc(eth_usdt, btc_usdt, ETH_BTC_CONFIG);
+	EXPECT_EQ(eth_btc.refresh(), 2);
+
+	// Nothing changed.
+	EXPECT_EQ(eth_btc.refresh(), 0);
+
+	// Unrelated side of a source.
+	btc_usdt.update_bid_side(3000000, 1);
+	EXPECT_EQ(eth_btc.refresh(), 0);
+
+	// Second level of the BTC asks only feeds the second implied bid.
+	btc_usdt.update_ask_side(4001000, 200000);
+	EXPECT_EQ(eth_btc.refresh(), 1);
+	EXPECT_EQ(eth_btc.get_bids()[0], (PriceLevel { 50000, 10000 }));
+	EXPECT_EQ(eth_btc.get_bids()[1], (PriceLevel { 49962, 20000 }));
+
+	// A new best level invalidates everything below it.
+	eth_usdt.update_bid_side(200100, 10000);
+	eth_btc.refresh();
+	EXPECT_EQ(eth_btc.get_bids()[0].price, 50025);
+}
+
+TEST_F(SyntheticBookTest, Refresh_ContinuesWhenLegGrows)
+{
+	eth_usdt.add_bid_side(200000, 20000);
+	btc_usdt.add_ask_side(4000000, 5000);
+
+	SyntheticBook eth_btc(eth_usdt, btc_usdt, ETH_BTC_CONFIG);
+	eth_btc.refresh();
+	ASSERT_EQ(eth_btc.get_bids().size(), 1);
+
+	btc_usdt.update_ask_side(4002000, 5000);
+	EXPECT_EQ(eth_btc.refresh(), 1);
+
+	auto bids = eth_btc.get_bids();
+	ASSERT_EQ(bids.size(), 2);
+	EXPECT_EQ(bids[0], (PriceLevel { 50000, 10000 }));
+	EXPECT_EQ(bids[1], (PriceLevel { 49975, 10000 }));
+}
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include <perf_counters.hpp>
+#include <trades/trade_tape.hpp>
+
+using namespace hft::trades;
+using hft::common::PerfCounters;
+
+namespace {
+
+// 1s, 10s, 1m and 5m windows.
+constexpr std::array<uint64_t, 4> WINDOWS { 1'000'000'000, 10'000'000'000, 60'000'000'000, 300'000'000'000 };
+
+// Pregenerated random walk so the loop only measures the tape.
+auto make_trades(size_t count) -> std::vector<Trade>
+{
+	std::vector<Trade> trades(count);
+	std::mt19937_64 rng(42);
+	uint64_t price = 100'000;
+	uint64_t now = 0;
+	for (auto &trade : trades)
+	{
+		now += 1'000'000 + rng() % 10'000'000;
+		price = price + rng() % 21 - 10;
+		trade = { now, price, 1 + rng() % 100, rng() % 2 == 0 ? TradeSide::Buy : TradeSide::Sell };
+	}
+	return trades;
+}
+
+} // namespace
+
+static void BM_SingleSymbol(benchmark::State &state)
+{
+	const auto trades = make_trades(1 << 16);
+	auto tape = std::make_unique<TradeTape>(WINDOWS);
+
+	PerfCounters counters;
+	counters.start();
+
+	size_t i = 0;
+	uint64_t offset = 0;
+	for (auto _ : state)
+	{
+		auto trade = trades[i];
+		trade.timestamp_ns += offset;
+		tape->on_trade(trade);
+		if (++i == trades.size())
+		{
+			// Keep time moving forward when the walk wraps.
+			i = 0;
+			offset += trades.back().timestamp_ns;
+		}
+	}
+	benchmark::DoNotOptimize(tape->get_stats(0));
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SingleSymbol);
+
+static void BM_ManySymbols(benchmark::State &state)
+{
+	const auto symbols = static_cast<size_t>(state.range(0));
+	const auto trades = make_trades(1 << 16);
+	TradeTapeArena arena(symbols, WINDOWS);
+
+	PerfCounters counters;
+	counters.start();
+
+	size_t i = 0;
+	size_t symbol = 0;
+	uint64_t offset = 0;
+	for (auto _ : state)
+	{
+		auto trade = trades[i];
+		trade.timestamp_ns += offset;
+		arena.on_trade(symbol, trade);
+		if (++symbol == symbols)
+		{
+			symbol = 0;
+		}
+		if (++i == trades.size())
+		{
+			i = 0;
+			offset += trades.back().timestamp_ns;
+		}
+	}
+	benchmark::DoNotOptimize(arena.get(0).get_stats(0));
+
+	counters.stop();
+	counters.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ManySymbols)->Arg(16)->Arg(1000);
+
+static void BM_GetStats(benchmark::State &state)
+{
+	const auto trades = make_trades(TradeTape::RING_CAPACITY);
+	auto tape = std::make_unique<TradeTape>(WINDOWS);
+	for (const auto &trade : trades)
+	{
+		tape->on_trade(trade);
+	}
+
+	size_t window = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(tape->get_stats(window));
+		window = (window + 1) % WINDOWS.size();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetStats);
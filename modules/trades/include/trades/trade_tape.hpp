@@ -0,0 +1,207 @@
+#pragma once
+
+namespace hft::trades {
+
+enum class TradeSide : uint8_t
+{
+	Buy,
+	Sell
+};
+
+struct Trade
+{
+	uint64_t timestamp_ns {};
+
+	uint64_t price {};
+
+	uint64_t quantity {};
+
+	// Aggressor side.
+	TradeSide side {};
+};
+
+/*Statistics of the trades inside one rolling window, all zero for an empty window.*/
+struct WindowStats
+{
+	uint64_t open {};
+
+	uint64_t high {};
+
+	uint64_t low {};
+
+	uint64_t close {};
+
+	uint64_t volume {};
+
+	uint64_t buy_volume {};
+
+	uint64_t sell_volume {};
+
+	uint64_t trade_count {};
+
+	double vwap {};
+
+	// Square root of the summed squared log returns between consecutive trades.
+	double realized_volatility {};
+};
+
+/*
+ * Rolling-window statistics over the trade stream of one symbol.
+ * Trades live in a fixed ring shared by every window, each window only keeps
+ * its oldest sequence and running sums that are adjusted as trades enter and
+ * expire. High and low come from one pair of monotonic queues over the ring,
+ * which a window queries from its own oldest trade on. Nothing allocates after
+ * construction.
+ */
+class TradeTape
+{
+public:
+	static constexpr size_t MAX_WINDOWS = 4;
+
+	// Trades retained per symbol, older trades leave every window even if still in time.
+	static constexpr size_t RING_CAPACITY = 1024;
+
+	static_assert(std::has_single_bit(RING_CAPACITY), "Ring capacity must be a power of two");
+
+	TradeTape() = default;
+
+	explicit TradeTape(std::span<const uint64_t> windows_ns)
+	{
+		configure(windows_ns);
+	}
+
+	TradeTape(const TradeTape &) = delete;
+
+	TradeTape(TradeTape &&) = delete;
+
+	auto operator=(const TradeTape &) -> TradeTape & = delete;
+
+	auto operator=(TradeTape &&) -> TradeTape & = delete;
+
+	~TradeTape() = default;
+
+	/*Sets the window lengths and drops every trade.*/
+	void configure(std::span<const uint64_t> windows_ns);
+
+	void on_trade(const Trade &trade);
+
+	/*Expires trades that fell out of their windows without a new trade arriving.*/
+	void advance(uint64_t now_ns);
+
+	[[nodiscard]] auto get_stats(size_t window) const -> WindowStats;
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto get_window_count() const -> size_t
+	{
+		return m_window_count;
+	}
+
+	/*Trades pushed out of the ring while still inside a window.*/
+	[[nodiscard]] auto get_truncated_count() const -> uint64_t
+	{
+		return m_truncated;
+	}
+
+private:
+	static constexpr size_t MASK = RING_CAPACITY - 1;
+
+	__extension__ typedef unsigned __int128 Notional;
+
+	struct Entry
+	{
+		Trade trade {};
+
+		// Log return against the previous trade, 0 for the first one.
+		double log_return {};
+	};
+
+	struct Window
+	{
+		uint64_t duration_ns {};
+
+		// Sequence of the oldest trade in the window.
+		uint64_t tail {};
+
+		uint64_t volume {};
+
+		uint64_t buy_volume {};
+
+		Notional notional {};
+
+		double squared_returns {};
+	};
+
+	/*Ring of sequences with monotonic prices, the front is the extreme of the oldest window.*/
+	struct MonotonicQueue
+	{
+		std::array<uint64_t, RING_CAPACITY> seqs {};
+
+		uint64_t front {};
+
+		uint64_t back {};
+	};
+
+	[[nodiscard]] auto entry(uint64_t seq) const -> const Entry &
+	{
+		return m_ring[seq & MASK];
+	}
+
+	void expire_front(Window &window);
+
+	void trim_queues();
+
+	template<typename Compare>
+	void push_queue(MonotonicQueue &queue, uint64_t seq, Compare &&replaces);
+
+	[[nodiscard]] auto query_queue(const MonotonicQueue &queue, uint64_t tail) const -> uint64_t;
+
+	std::array<Entry, RING_CAPACITY> m_ring {};
+
+	std::array<Window, MAX_WINDOWS> m_windows {};
+
+	size_t m_window_count {};
+
+	// Sequence the next trade gets.
+	uint64_t m_head {};
+
+	uint64_t m_truncated {};
+
+	MonotonicQueue m_highs {};
+
+	MonotonicQueue m_lows {};
+};
+
+/*Trade tapes of many symbols, allocated once up front like the book pools.*/
+class TradeTapeArena
+{
+public:
+	TradeTapeArena(size_t symbols, std::span<const uint64_t> windows_ns);
+
+	void on_trade(size_t symbol, const Trade &trade)
+	{
+		m_tapes[symbol].on_trade(trade);
+	}
+
+	[[nodiscard]] auto get(size_t symbol) -> TradeTape &
+	{
+		return m_tapes[symbol];
+	}
+
+	[[nodiscard]] auto get(size_t symbol) const -> const TradeTape &
+	{
+		return m_tapes[symbol];
+	}
+
+	/*Trivial getter.*/
+	[[nodiscard]] auto size() const -> size_t
+	{
+		return m_size;
+	}
+
+private:
+	std::unique_ptr<TradeTape[]> m_tapes;
+
+	size_t m_size {};
+};
+
+} // namespace hft::trades
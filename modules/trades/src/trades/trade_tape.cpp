@@ -0,0 +1,190 @@
+#include <trades/trade_tape.hpp>
+
+namespace hft::trades {
+
+void TradeTape::configure(std::span<const uint64_t> windows_ns)
+{
+	assert(windows_ns.size() <= MAX_WINDOWS);
+
+	m_window_count = std::min(windows_ns.size(), MAX_WINDOWS);
+	m_windows.fill(Window {});
+	for (size_t i = 0; i < m_window_count; ++i)
+	{
+		m_windows[i].duration_ns = windows_ns[i];
+	}
+
+	m_head = 0;
+	m_truncated = 0;
+	m_highs = {};
+	m_lows = {};
+}
+
+void TradeTape::on_trade(const Trade &trade)
+{
+	if (m_head >= RING_CAPACITY) [[unlikely]]
+	{
+		// The slot about to be reused still belongs to the longest windows.
+		const auto oldest = m_head - RING_CAPACITY;
+		bool truncated = false;
+		for (size_t i = 0; i < m_window_count; ++i)
+		{
+			if (m_windows[i].tail == oldest)
+			{
+				expire_front(m_windows[i]);
+				truncated = true;
+			}
+		}
+		m_truncated += truncated ? 1 : 0;
+		trim_queues();
+	}
+
+	double log_return = 0;
+	if (m_head != 0)
+	{
+		const auto previous = entry(m_head - 1).trade.price;
+		if (previous != 0 && trade.price != 0) [[likely]]
+		{
+			log_return = std::log(static_cast<double>(trade.price) / static_cast<double>(previous));
+		}
+	}
+
+	m_ring[m_head & MASK] = { trade, log_return };
+
+	const auto notional = Notional { trade.price } * trade.quantity;
+	const auto buy_quantity = trade.side == TradeSide::Buy ? trade.quantity : 0;
+	for (size_t i = 0; i < m_window_count; ++i)
+	{
+		auto &window = m_windows[i];
+		// The return only counts when the previous trade is in the window too.
+		if (window.tail != m_head)
+		{
+			window.squared_returns += log_return * log_return;
+		}
+		window.volume += trade.quantity;
+		window.buy_volume += buy_quantity;
+		window.notional += notional;
+	}
+
+	push_queue(m_highs, m_head, [](uint64_t incoming, uint64_t queued) { return incoming >= queued; });
+	push_queue(m_lows, m_head, [](uint64_t incoming, uint64_t queued) { return incoming <= queued; });
+	++m_head;
+
+	advance(trade.timestamp_ns);
+}
+
+void TradeTape::advance(uint64_t now_ns)
+{
+	for (size_t i = 0; i < m_window_count; ++i)
+	{
+		auto &window = m_windows[i];
+		while (window.tail != m_head && entry(window.tail).trade.timestamp_ns + window.duration_ns <= now_ns)
+		{
+			expire_front(window);
+		}
+	}
+	trim_queues();
+}
+
+void TradeTape::expire_front(Window &window)
+{
+	const auto &expired = entry(window.tail).trade;
+
+	window.volume -= expired.quantity;
+	window.buy_volume -= expired.side == TradeSide::Buy ? expired.quantity : 0;
+	window.notional -= Notional { expired.price } * expired.quantity;
+	++window.tail;
+
+	if (window.tail == m_head)
+	{
+		// Empty window, also drops any accumulated floating point drift.
+		window.squared_returns = 0;
+		return;
+	}
+
+	// The new oldest trade's return pointed at the expired one.
+	const auto log_return = entry(window.tail).log_return;
+	window.squared_returns = std::max(0.0, window.squared_returns - log_return * log_return);
+}
+
+void TradeTape::trim_queues()
+{
+	auto min_tail = m_head;
+	for (size_t i = 0; i < m_window_count; ++i)
+	{
+		min_tail = std::min(min_tail, m_windows[i].tail);
+	}
+
+	for (auto *queue : { &m_highs, &m_lows })
+	{
+		while (queue->front != queue->back && queue->seqs[queue->front & MASK] < min_tail)
+		{
+			++queue->front;
+		}
+	}
+}
+
+template<typename Compare>
+void TradeTape::push_queue(MonotonicQueue &queue, uint64_t seq, Compare &&replaces)
+{
+	const auto price = entry(seq).trade.price;
+	while (queue.back != queue.front && replaces(price, entry(queue.seqs[(queue.back - 1) & MASK]).trade.price))
+	{
+		--queue.back;
+	}
+	queue.seqs[queue.back & MASK] = seq;
+	++queue.back;
+}
+
+auto TradeTape::query_queue(const MonotonicQueue &queue, uint64_t tail) const -> uint64_t
+{
+	// Sequences increase from front to back, the first one inside the window is its extreme.
+	auto low = queue.front;
+	auto high = queue.back;
+	while (low < high)
+	{
+		const auto mid = low + (high - low) / 2;
+		if (queue.seqs[mid & MASK] < tail)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return entry(queue.seqs[low & MASK]).trade.price;
+}
+
+auto TradeTape::get_stats(size_t window_index) const -> WindowStats
+{
+	const auto &window = m_windows[window_index];
+	if (window.tail == m_head)
+	{
+		return {};
+	}
+
+	WindowStats stats;
+	stats.open = entry(window.tail).trade.price;
+	stats.close = entry(m_head - 1).trade.price;
+	stats.high = query_queue(m_highs, window.tail);
+	stats.low = query_queue(m_lows, window.tail);
+	stats.volume = window.volume;
+	stats.buy_volume = window.buy_volume;
+	stats.sell_volume = window.volume - window.buy_volume;
+	stats.trade_count = m_head - window.tail;
+	stats.vwap = window.volume != 0 ? static_cast<double>(window.notional) / static_cast<double>(window.volume) : 0;
+	stats.realized_volatility = std::sqrt(window.squared_returns);
+	return stats;
+}
+
+TradeTapeArena::TradeTapeArena(size_t symbols, std::span<const uint64_t> windows_ns)
+	: m_tapes(std::make_unique<TradeTape[]>(symbols))
+	, m_size(symbols)
+{
+	for (size_t i = 0; i < symbols; ++i)
+	{
+		m_tapes[i].configure(windows_ns);
+	}
+}
+
+} // namespace hft::trades
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <trades/trade_tape.hpp>
+
+using namespace hft::trades;
+
+class TradeTapeTest: public ::testing::Test
+{
+protected:
+	static constexpr std::array<uint64_t, 2> WINDOWS { 1000, 10000 };
+
+	TradeTape tape { WINDOWS };
+};
+
+TEST_F(TradeTapeTest, EmptyWindow_ReturnsZeroStats)
+{
+	const auto stats = tape.get_stats(0);
+
+	EXPECT_EQ(stats.trade_count, 0);
+	EXPECT_EQ(stats.volume, 0);
+	EXPECT_EQ(stats.high, 0);
+	EXPECT_EQ(stats.vwap, 0);
+}
+
+TEST_F(TradeTapeTest, Trades_AggregateOhlcvAndVwap)
+{
+	tape.on_trade({ 100, 1000, 2, TradeSide::Buy });
+	tape.on_trade({ 200, 1010, 1, TradeSide::Sell });
+	tape.on_trade({ 300, 990, 3, TradeSide::Sell });
+	tape.on_trade({ 400, 1005, 4, TradeSide::Buy });
+
+	const auto stats = tape.get_stats(0);
+
+	EXPECT_EQ(stats.open, 1000);
+	EXPECT_EQ(stats.high, 1010);
+	EXPECT_EQ(stats.low, 990);
+	EXPECT_EQ(stats.close, 1005);
+	EXPECT_EQ(stats.volume, 10);
+	EXPECT_EQ(stats.buy_volume, 6);
+	EXPECT_EQ(stats.sell_volume, 4);
+	EXPECT_EQ(stats.trade_count, 4);
+	EXPECT_DOUBLE_EQ(stats.vwap, (1000.0 * 2 + 1010 + 990.0 * 3 + 1005.0 * 4) / 10);
+}
+
+TEST_F(TradeTapeTest, ExpiredTrades_LeaveShortWindowOnly)
+{
+	tape.on_trade({ 0, 1200, 1, TradeSide::Buy });
+	tape.on_trade({ 500, 900, 1, TradeSide::Sell });
+	tape.on_trade({ 1500, 1000, 5, TradeSide::Buy });
+
+	const auto short_window = tape.get_stats(0);
+	EXPECT_EQ(short_window.trade_count, 1);
+	EXPECT_EQ(short_window.open, 1000);
+	EXPECT_EQ(short_window.high, 1000);
+	EXPECT_EQ(short_window.low, 1000);
+	EXPECT_EQ(short_window.volume, 5);
+	EXPECT_EQ(short_window.realized_volatility, 0);
+
+	const auto long_window = tape.get_stats(1);
+	EXPECT_EQ(long_window.trade_count, 3);
+	EXPECT_EQ(long_window.open, 1200);
+	EXPECT_EQ(long_window.high, 1200);
+	EXPECT_EQ(long_window.low, 900);
+	EXPECT_EQ(long_window.volume, 7);
+}
+
+TEST_F(TradeTapeTest, Advance_ExpiresWithoutNewTrades)
+{
+	tape.on_trade({ 0, 1000, 1, TradeSide::Buy });
+	tape.on_trade({ 100, 1100, 1, TradeSide::Buy });
+
+	tape.advance(1050);
+	EXPECT_EQ(tape.get_stats(0).trade_count, 1);
+	EXPECT_EQ(tape.get_stats(0).low, 1100);
+
+	tape.advance(1100);
+	EXPECT_EQ(tape.get_stats(0).trade_count, 0);
+	EXPECT_EQ(tape.get_stats(1).trade_count, 2);
+}
+
+TEST_F(TradeTapeTest, RealizedVolatility_SumsReturnsInsideWindow)
+{
+	tape.on_trade({ 0, 1000, 1, TradeSide::Buy });
+	tape.on_trade({ 600, 1100, 1, TradeSide::Buy });
+	tape.on_trade({ 1200, 1000, 1, TradeSide::Sell });
+
+	// The first return points at a trade that already left the short window.
+	const auto second = std::log(1000.0 / 1100.0);
+	EXPECT_NEAR(tape.get_stats(0).realized_volatility, std::abs(second), 1e-12);
+
+	const auto first = std::log(1100.0 / 1000.0);
+	EXPECT_NEAR(tape.get_stats(1).realized_volatility, std::sqrt(first * first + second * second), 1e-12);
+}
+
+TEST_F(TradeTapeTest, RingOverflow_TruncatesLongWindow)
+{
+	const auto trades = TradeTape::RING_CAPACITY + 10;
+	for (uint64_t i = 0; i < trades; ++i)
+	{
+		tape.on_trade({ 5000 + i, 1000 + (i % 7), 1, TradeSide::Buy });
+	}
+
+	const auto stats = tape.get_stats(1);
+	EXPECT_EQ(stats.trade_count, TradeTape::RING_CAPACITY);
+	EXPECT_EQ(stats.volume, TradeTape::RING_CAPACITY);
+	EXPECT_EQ(stats.open, 1000 + (10 % 7));
+	EXPECT_EQ(stats.high, 1006);
+	EXPECT_EQ(stats.low, 1000);
+	EXPECT_EQ(tape.get_truncated_count(), 10);
+}
+
+TEST_F(TradeTapeTest, SlidingExtremes_MatchBruteForce)
+{
+	std::vector<Trade> trades;
+	uint64_t price = 10000;
+	for (uint64_t i = 0; i < 5000; ++i)
+	{
+		price = price + (i * 2654435761U % 21) - 10;
+		trades.push_back({ i * 37, price, 1 + i % 3, i % 2 == 0 ? TradeSide::Buy : TradeSide::Sell });
+		tape.on_trade(trades.back());
+
+		for (size_t w = 0; w < WINDOWS.size(); ++w)
+		{
+			uint64_t high = 0;
+			uint64_t low = UINT64_MAX;
+			uint64_t volume = 0;
+			size_t count = 0;
+			for (auto it = trades.rbegin(); it != trades.rend() && count < TradeTape::RING_CAPACITY; ++it, ++count)
+			{
+				if (it->timestamp_ns + WINDOWS[w] <= trades.back().timestamp_ns)
+				{
+					break;
+				}
+				high = std::max(high, it->price);
+				low = std::min(low, it->price);
+				volume += it->quantity;
+			}
+
+			const auto stats = tape.get_stats(w);
+			ASSERT_EQ(stats.trade_count, count);
+			ASSERT_EQ(stats.high, high);
+			ASSERT_EQ(stats.low, low);
+			ASSERT_EQ(stats.volume, volume);
+		}
+	}
+}
+
+TEST(TradeTapeArenaTest, Symbols_AreIndependent)
+{
+	constexpr std::array<uint64_t, 1> windows { 1000 };
+	TradeTapeArena arena(3, windows);
+
+	arena.on_trade(0, { 10, 1000, 1, TradeSide::Buy });
+	arena.on_trade(2, { 10, 2000, 4, TradeSide::Sell });
+	arena.on_trade(2, { 20, 2100, 1, TradeSide::Sell });
+
+	EXPECT_EQ(arena.size(), 3);
+	EXPECT_EQ(arena.get(0).get_stats(0).volume, 1);
+	EXPECT_EQ(arena.get(1).get_stats(0).trade_count, 0);
+	EXPECT_EQ(arena.get(2).get_stats(0).high, 2100);
+	EXPECT_EQ(arena.get(2).get_stats(0).sell_volume, 5);
+}
@@ -2,6 +2,11 @@ if(ENABLE_UNIT_TESTING)
     find_package(GTest REQUIRED)
 endif()
 
+if(ENABLE_BENCHMARKS)
+    find_package(benchmark REQUIRED)
+endif()
+
 find_package(spdlog REQUIRED)
+find_package(Threads REQUIRED)
 
 include(GoogleTest)